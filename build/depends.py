@@ -742,6 +742,7 @@ class MixxxCore(Feature):
         sources = ["src/control/control.cpp",
                    "src/control/controlaudiotaperpot.cpp",
                    "src/control/controlbehavior.cpp",
+                   "src/control/controlchangebatcher.cpp",
                    "src/control/controleffectknob.cpp",
                    "src/control/controlindicator.cpp",
                    "src/control/controllinpotmeter.cpp",
@@ -752,6 +753,7 @@ class MixxxCore(Feature):
                    "src/control/controlpotmeter.cpp",
                    "src/control/controlproxy.cpp",
                    "src/control/controlpushbutton.cpp",
+                   "src/control/controlregistry.cpp",
                    "src/control/controlttrotary.cpp",
                    "src/control/controlencoder.cpp",
 
@@ -869,9 +871,11 @@ class MixxxCore(Feature):
                    "src/engine/enginesidechaincompressor.cpp",
                    "src/engine/sidechain/enginesidechain.cpp",
                    "src/engine/sidechain/networkoutputstreamworker.cpp",
+                   "src/engine/sidechain/sharedbroadcastencoder.cpp",
                    "src/engine/sidechain/networkinputstreamworker.cpp",
                    "src/engine/enginexfader.cpp",
-                   "src/engine/channelmixer_autogen.cpp",
+                   "src/engine/channelmixer.cpp",
+                   "src/engine/channelprocessingpool.cpp",
                    "src/engine/positionscratchcontroller.cpp",
                    "src/engine/controls/bpmcontrol.cpp",
                    "src/engine/controls/clockcontrol.cpp",
@@ -885,10 +889,13 @@ class MixxxCore(Feature):
                    "src/engine/enginetalkoverducking.cpp",
                    "src/engine/cachingreader/cachingreader.cpp",
                    "src/engine/cachingreader/cachingreaderchunk.cpp",
+                   "src/engine/cachingreader/cachingreaderchunkpool.cpp",
+                   "src/engine/cachingreader/cachingreaderdiskcache.cpp",
                    "src/engine/cachingreader/cachingreaderworker.cpp",
 
                    "src/analyzer/trackanalysisscheduler.cpp",
                    "src/analyzer/analyzerthread.cpp",
+                   "src/analyzer/analyzerchunkqueue.cpp",
                    "src/analyzer/analyzerwaveform.cpp",
                    "src/analyzer/analyzergain.cpp",
                    "src/analyzer/analyzerbeats.cpp",
@@ -934,6 +941,7 @@ class MixxxCore(Feature):
                    "src/controllers/midi/midicontrollerpreset.cpp",
                    "src/controllers/midi/midicontrollerpresetfilehandler.cpp",
                    "src/controllers/midi/midienumerator.cpp",
+                   "src/controllers/midi/midiinputdispatchtable.cpp",
                    "src/controllers/midi/midioutputhandler.cpp",
                    "src/controllers/softtakeover.cpp",
                    "src/controllers/keyboard/keyboardeventfilter.cpp",
@@ -946,6 +954,7 @@ class MixxxCore(Feature):
                    "src/sources/audiosource.cpp",
                    "src/sources/audiosourcestereoproxy.cpp",
                    "src/sources/metadatasourcetaglib.cpp",
+                   "src/sources/mp3seekindexcache.cpp",
                    "src/sources/readaheadframebuffer.cpp",
                    "src/sources/soundsource.cpp",
                    "src/sources/soundsourceprovider.cpp",
@@ -1039,10 +1048,12 @@ class MixxxCore(Feature):
                    "src/library/basesqltablemodel.cpp",
                    "src/library/basetrackcache.cpp",
                    "src/library/basetracktablemodel.cpp",
+                   "src/library/columnartrackindex.cpp",
                    "src/library/columncache.cpp",
                    "src/library/librarytablemodel.cpp",
                    "src/library/searchquery.cpp",
                    "src/library/searchqueryparser.cpp",
+                   "src/library/trigramindex.cpp",
                    "src/library/analysislibrarytablemodel.cpp",
                    "src/library/missingtablemodel.cpp",
                    "src/library/hiddentablemodel.cpp",
@@ -1299,6 +1310,7 @@ class MixxxCore(Feature):
                    "src/util/duration.cpp",
                    "src/util/time.cpp",
                    "src/util/timer.cpp",
+                   "src/util/tracing.cpp",
                    "src/util/performancetimer.cpp",
                    "src/util/threadcputimer.cpp",
                    "src/util/version.cpp",
@@ -1332,6 +1344,10 @@ class MixxxCore(Feature):
                    "src/util/db/sqltransaction.cpp",
                    "src/util/imageutils.cpp",
                    "src/util/sample.cpp",
+                   "src/util/samplekernels.cpp",
+                   "src/util/samplekernels_neon.cpp",
+                   "src/util/samplekernels_x86.cpp",
+                   "src/util/cpufeatures.cpp",
                    "src/util/samplebuffer.cpp",
                    "src/util/readaheadsamplebuffer.cpp",
                    "src/util/rotary.cpp",
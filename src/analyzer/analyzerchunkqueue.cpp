@@ -0,0 +1,106 @@
+#include "analyzer/analyzerchunkqueue.h"
+
+#include <algorithm>
+
+#include "util/assert.h"
+
+AnalyzerChunkQueue::AnalyzerChunkQueue(
+        int capacity,
+        SINT chunkSize,
+        int consumerCount)
+        : m_chunkLengths(capacity, 0),
+          m_writePosition(0),
+          m_readPositions(consumerCount, 0),
+          m_finished(false),
+          m_aborted(false) {
+    DEBUG_ASSERT(capacity > 0);
+    DEBUG_ASSERT(consumerCount > 0);
+    m_chunks.reserve(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        m_chunks.emplace_back(chunkSize);
+    }
+}
+
+quint64 AnalyzerChunkQueue::minReadPosition() const {
+    DEBUG_ASSERT(!m_readPositions.empty());
+    return *std::min_element(m_readPositions.begin(), m_readPositions.end());
+}
+
+mixxx::SampleBuffer::WritableSlice AnalyzerChunkQueue::beginWrite() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    DEBUG_ASSERT(!m_finished);
+    m_cond.wait(lock, [this] {
+        return m_aborted || (m_writePosition - minReadPosition() < m_chunks.size());
+    });
+    if (m_aborted) {
+        return mixxx::SampleBuffer::WritableSlice();
+    }
+    // No consumer is reading this chunk, because all of them have
+    // already passed it
+    return mixxx::SampleBuffer::WritableSlice(
+            m_chunks[m_writePosition % m_chunks.size()]);
+}
+
+void AnalyzerChunkQueue::endWrite(SINT length) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_aborted) {
+            return;
+        }
+        const auto index = m_writePosition % m_chunks.size();
+        DEBUG_ASSERT(length <= m_chunks[index].size());
+        m_chunkLengths[index] = length;
+        ++m_writePosition;
+    }
+    m_cond.notify_all();
+}
+
+void AnalyzerChunkQueue::finish() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished = true;
+    }
+    m_cond.notify_all();
+}
+
+void AnalyzerChunkQueue::abort() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_aborted = true;
+    }
+    m_cond.notify_all();
+}
+
+mixxx::SampleBuffer::ReadableSlice AnalyzerChunkQueue::beginRead(int consumer) {
+    DEBUG_ASSERT(consumer >= 0);
+    DEBUG_ASSERT(consumer < consumerCount());
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const quint64 readPosition = m_readPositions[consumer];
+    m_cond.wait(lock, [this, readPosition] {
+        return m_aborted || m_finished || (readPosition < m_writePosition);
+    });
+    if (m_aborted || (readPosition >= m_writePosition)) {
+        return mixxx::SampleBuffer::ReadableSlice();
+    }
+    // The producer doesn't overwrite this chunk until it has been
+    // released by endRead()
+    const auto index = readPosition % m_chunks.size();
+    return mixxx::SampleBuffer::ReadableSlice(
+            m_chunks[index], 0, m_chunkLengths[index]);
+}
+
+void AnalyzerChunkQueue::endRead(int consumer) {
+    DEBUG_ASSERT(consumer >= 0);
+    DEBUG_ASSERT(consumer < consumerCount());
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        DEBUG_ASSERT(m_readPositions[consumer] < m_writePosition);
+        // Only the slowest consumer frees a chunk for the producer
+        notify = m_readPositions[consumer] == minReadPosition();
+        ++m_readPositions[consumer];
+    }
+    if (notify) {
+        m_cond.notify_all();
+    }
+}
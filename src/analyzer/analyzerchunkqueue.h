@@ -0,0 +1,68 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+// A bounded ring of decoded chunks of audio data with a single producer,
+// the decoder, and a fixed number of consumers that each process all
+// chunks in the same order.
+//
+// The producer fills the next free chunk without holding the lock and
+// blocks while all chunks are still needed by at least one consumer.
+// Consumers read their next chunk without holding the lock and block
+// while they have caught up with the producer. This allows to decode
+// ahead while multiple analyzers are processing the previous chunks
+// in parallel.
+class AnalyzerChunkQueue final {
+  public:
+    AnalyzerChunkQueue(
+            int capacity,
+            SINT chunkSize,
+            int consumerCount);
+
+    int consumerCount() const {
+        return static_cast<int>(m_readPositions.size());
+    }
+
+    // Returns the next chunk for writing. Blocks until a chunk becomes
+    // available and returns an empty slice if the queue has been aborted.
+    mixxx::SampleBuffer::WritableSlice beginWrite();
+    // Publishes the chunk that has been returned by beginWrite() with
+    // the given number of samples to all consumers.
+    void endWrite(SINT length);
+
+    // Signals that no more chunks will be written. Consumers still
+    // receive all chunks that have been written before.
+    void finish();
+    // Discards all pending chunks and unblocks both the producer and
+    // all consumers.
+    void abort();
+
+    // Returns the next chunk for the given consumer. Blocks until a chunk
+    // becomes available and returns an empty slice if either all chunks
+    // have been read after finish() or if the queue has been aborted.
+    mixxx::SampleBuffer::ReadableSlice beginRead(int consumer);
+    // Releases the chunk that has been returned by beginRead()
+    void endRead(int consumer);
+
+  private:
+    quint64 minReadPosition() const;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+
+    std::vector<mixxx::SampleBuffer> m_chunks;
+    std::vector<SINT> m_chunkLengths;
+
+    // Positions are counted continuously and mapped onto the chunks
+    // modulo the capacity
+    quint64 m_writePosition;
+    std::vector<quint64> m_readPositions;
+
+    bool m_finished;
+    bool m_aborted;
+};
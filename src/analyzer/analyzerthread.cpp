@@ -1,5 +1,8 @@
 #include "analyzer/analyzerthread.h"
 
+#include <QThread>
+#include <algorithm>
+#include <cstring>
 #include <mutex>
 
 #include "analyzer/analyzerbeats.h"
@@ -35,6 +38,60 @@ mixxx::Logger kLogger("AnalyzerThread");
 // continuous feedback.
 const mixxx::Duration kBusyProgressInhibitDuration = mixxx::Duration::fromMillis(60);
 
+// The number of decoded chunks the decoder may run ahead of the slowest
+// analyzer stage. 8 chunks of 4096 stereo frames occupy 256 KiB.
+constexpr int kChunkQueueCapacity = 8;
+
+// Analyzers that are assigned to the same stage process the decoded
+// chunks one after another on the same thread. The beat and the key
+// detection are by far the most expensive analyzers and each get a
+// stage of their own. All the lightweight analyzers share a stage.
+enum AnalyzerStage {
+    kDefaultStage = 0,
+    kBeatsStage,
+    kKeyStage,
+    kStageCount,
+};
+
+void processChunks(
+        const std::vector<AnalyzerWithState*>& analyzers,
+        AnalyzerChunkQueue* pChunkQueue,
+        int consumer) {
+    while (true) {
+        const auto chunk = pChunkQueue->beginRead(consumer);
+        if (chunk.empty()) {
+            return;
+        }
+        for (auto* pAnalyzer : analyzers) {
+            pAnalyzer->processSamples(chunk.data(), chunk.length());
+        }
+        pChunkQueue->endRead(consumer);
+    }
+}
+
+// Runs a single analyzer stage
+class AnalyzerStageThread : public QThread {
+  public:
+    AnalyzerStageThread(
+            const std::vector<AnalyzerWithState*>* pAnalyzers,
+            AnalyzerChunkQueue* pChunkQueue,
+            int consumer)
+            : m_pAnalyzers(pAnalyzers),
+              m_pChunkQueue(pChunkQueue),
+              m_consumer(consumer) {
+    }
+
+  protected:
+    void run() override {
+        processChunks(*m_pAnalyzers, m_pChunkQueue, m_consumer);
+    }
+
+  private:
+    const std::vector<AnalyzerWithState*>* const m_pAnalyzers;
+    AnalyzerChunkQueue* const m_pChunkQueue;
+    const int m_consumer;
+};
+
 void deleteAnalyzerThread(AnalyzerThread* plainPtr) {
     if (plainPtr) {
         plainPtr->deleteAfterFinished();
@@ -83,12 +140,19 @@ AnalyzerThread::AnalyzerThread(
           m_pConfig(pConfig),
           m_modeFlags(modeFlags),
           m_nextTrack(2), // minimum capacity
-          m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
           m_emittedState(AnalyzerThreadState::Void) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
 }
 
 void AnalyzerThread::doRun() {
+    std::vector<AnalyzerStage> analyzerStages;
+    const auto addAnalyzer = [this, &analyzerStages](
+                                     AnalyzerPtr pAnalyzer,
+                                     AnalyzerStage stage) {
+        m_analyzers.push_back(AnalyzerWithState(std::move(pAnalyzer)));
+        analyzerStages.push_back(stage);
+    };
+
     std::unique_ptr<AnalysisDao> pAnalysisDao;
     // The thread-local database connection  must not be closed
     // before returning from this function.
@@ -102,23 +166,30 @@ void AnalyzerThread::doRun() {
             return;
         }
         QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_dbConnectionPool);
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
+        addAnalyzer(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection), kDefaultStage);
     }
     if (AnalyzerGain::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig)));
+        addAnalyzer(std::make_unique<AnalyzerGain>(m_pConfig), kDefaultStage);
     }
     if (AnalyzerEbur128::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerEbur128>(m_pConfig)));
+        addAnalyzer(std::make_unique<AnalyzerEbur128>(m_pConfig), kDefaultStage);
     }
     // BPM detection might be disabled in the config, but can be overridden
     // and enabled by explicitly setting the mode flag.
     const bool enforceBpmDetection = (m_modeFlags & AnalyzerModeFlags::WithBeats) != 0;
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerKey>(m_pConfig)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerSilence>(m_pConfig)));
+    addAnalyzer(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection), kBeatsStage);
+    addAnalyzer(std::make_unique<AnalyzerKey>(m_pConfig), kKeyStage);
+    addAnalyzer(std::make_unique<AnalyzerSilence>(m_pConfig), kDefaultStage);
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    // Collect the pointers only after m_analyzers is complete, because
+    // adding elements may reallocate its storage
+    m_analyzerStages.resize(kStageCount);
+    for (std::size_t i = 0; i < m_analyzers.size(); ++i) {
+        m_analyzerStages[analyzerStages[i]].push_back(&m_analyzers[i]);
+    }
+
     m_lastBusyProgressEmittedTimer.start();
 
     mixxx::AudioSource::OpenParams openParams;
@@ -180,6 +251,7 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    m_analyzerStages.clear();
     m_analyzers.clear();
 
     kLogger.debug() << "Exiting worker thread";
@@ -222,6 +294,58 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         const mixxx::AudioSourcePointer& audioSource) {
     DEBUG_ASSERT(m_currentTrack);
 
+    // Only stages with at least one initialized analyzer need to
+    // consume the decoded audio data
+    std::vector<const std::vector<AnalyzerWithState*>*> activeStages;
+    for (const auto& stage : m_analyzerStages) {
+        if (std::any_of(stage.begin(), stage.end(), [](const AnalyzerWithState* pAnalyzer) {
+                return pAnalyzer->isActive();
+            })) {
+            activeStages.push_back(&stage);
+        }
+    }
+    DEBUG_ASSERT(!activeStages.empty());
+
+    AnalyzerChunkQueue chunkQueue(
+            kChunkQueueCapacity,
+            mixxx::kAnalysisSamplesPerChunk,
+            static_cast<int>(activeStages.size()));
+
+    // The stages only process samples. Initializing the analyzers and
+    // storing their results is still done by this thread, which owns
+    // the database connection. Starting and joining the stage threads
+    // ensures that all modifications of the analyzers become visible.
+    std::vector<std::unique_ptr<QThread>> stageThreads;
+    stageThreads.reserve(activeStages.size());
+    for (int consumer = 0; consumer < static_cast<int>(activeStages.size()); ++consumer) {
+        auto pStageThread = std::make_unique<AnalyzerStageThread>(
+                activeStages[consumer],
+                &chunkQueue,
+                consumer);
+        pStageThread->setObjectName(
+                QStringLiteral("%1 stage %2").arg(objectName()).arg(consumer));
+        pStageThread->start(priority());
+        stageThreads.push_back(std::move(pStageThread));
+    }
+
+    const auto analysisResult = decodeAudioSource(audioSource, &chunkQueue);
+    if (analysisResult == AnalysisResult::Finished) {
+        // Let the stages process all remaining chunks
+        chunkQueue.finish();
+    } else {
+        chunkQueue.abort();
+    }
+    for (const auto& pStageThread : stageThreads) {
+        pStageThread->wait();
+    }
+    return analysisResult;
+}
+
+AnalyzerThread::AnalysisResult AnalyzerThread::decodeAudioSource(
+        const mixxx::AudioSourcePointer& audioSource,
+        AnalyzerChunkQueue* pChunkQueue) {
+    DEBUG_ASSERT(m_currentTrack);
+
     mixxx::AudioSourceStereoProxy audioSourceProxy(
             audioSource,
             mixxx::kAnalysisFramesPerChunk);
@@ -247,12 +371,21 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                         math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
         DEBUG_ASSERT(!chunkFrameRange.empty());
 
+        // Decode directly into the next free chunk of the queue. Blocks
+        // while the slowest stage is lagging behind. The same chunk is
+        // returned again if it has not been published in the previous
+        // iteration.
+        const auto chunk = pChunkQueue->beginWrite();
+        if (chunk.empty()) {
+            return AnalysisResult::Cancelled;
+        }
+
         // Request the next chunk of audio data
         const auto readableSampleFrames =
                 audioSourceProxy.readSampleFrames(
                         mixxx::WritableSampleFrames(
                                 chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+                                chunk));
         // The returned range fits into the requested range
         DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
 
@@ -295,13 +428,17 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
             return AnalysisResult::Cancelled;
         }
 
-        // 2nd: step: Analyze chunk of decoded audio data
+        // 2nd: step: Pass the decoded chunk on to the analyzer stages
         if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
+            DEBUG_ASSERT(readableSampleFrames.readableLength() <= chunk.length());
+            if (readableSampleFrames.readableData() != chunk.data()) {
+                // The first frames of the chunk could not be read
+                std::memmove(
+                        chunk.data(),
                         readableSampleFrames.readableData(),
-                        readableSampleFrames.readableLength());
+                        readableSampleFrames.readableLength() * sizeof(CSAMPLE));
             }
+            pChunkQueue->endWrite(readableSampleFrames.readableLength());
         }
 
         // Don't check again for paused/stopped again and simply finish
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerchunkqueue.h"
 #include "analyzer/analyzerprogress.h"
 #include "preferences/usersettings.h"
 #include "rigtorp/SPSCQueue.h"
@@ -12,7 +13,6 @@
 #include "util/db/dbconnectionpool.h"
 #include "util/memory.h"
 #include "util/performancetimer.h"
-#include "util/samplebuffer.h"
 #include "util/workerthread.h"
 
 enum AnalyzerModeFlags {
@@ -116,7 +116,10 @@ class AnalyzerThread : public WorkerThread {
 
     std::vector<AnalyzerWithState> m_analyzers;
 
-    mixxx::SampleBuffer m_sampleBuffer;
+    // The analyzers grouped into stages that process the decoded audio
+    // data in parallel, each on its own thread. All pointers reference
+    // elements of m_analyzers.
+    std::vector<std::vector<AnalyzerWithState*>> m_analyzerStages;
 
     TrackPointer m_currentTrack;
 
@@ -131,6 +134,11 @@ class AnalyzerThread : public WorkerThread {
     };
     AnalysisResult analyzeAudioSource(
             const mixxx::AudioSourcePointer& audioSource);
+    // Decodes the audio source chunk by chunk into the queue while
+    // the analyzer stages consume the decoded chunks concurrently
+    AnalysisResult decodeAudioSource(
+            const mixxx::AudioSourcePointer& audioSource,
+            AnalyzerChunkQueue* pChunkQueue);
 
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
@@ -189,6 +189,8 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* buffer, const int bufferLen
     m_waveform->setSaveState(Waveform::SaveState::NotSaved);
     m_waveformSummary->setSaveState(Waveform::SaveState::NotSaved);
 
+    const int firstStride = m_currentStride;
+    const int firstSummaryStride = m_currentSummaryStride;
     for (int i = 0; i < bufferLength; i += 2) {
         // Take max value, not average of data
         CSAMPLE cover[2] = {fabs(buffer[i]), fabs(buffer[i + 1])};
@@ -251,6 +253,12 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* buffer, const int bufferLen
         }
     }
 
+    // Keep the pre-aggregated peaks for wide zoom levels up to date.
+    // Only the RGB renderer reads them, but the summary is stored with
+    // its levels as well and must not contain stale values.
+    m_waveform->updateLevels(firstStride, m_currentStride);
+    m_waveformSummary->updateLevels(firstSummaryStride, m_currentSummaryStride);
+
     //kLogger.debug() << "process - m_waveform->getCompletion()" << m_waveform->getCompletion() << "off" << m_waveform->getDataSize();
     //kLogger.debug() << "process - m_waveformSummary->getCompletion()" << m_waveformSummary->getCompletion() << "off" << m_waveformSummary->getDataSize();
     return true;
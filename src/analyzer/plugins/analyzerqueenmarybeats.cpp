@@ -13,7 +13,8 @@ namespace {
 // This determines the resolution of the resulting BeatMap.
 // ~12 ms (86 Hz) is a fair compromise between accuracy and analysis speed,
 // also matching the preferred window/step sizes from BeatTrack VAMP.
-// For a 44.1 kHz track, we go in 512 sample steps
+// For a 44.1 kHz track that is analyzed at the reduced sample rate of
+// 22.05 kHz, we go in 256 sample steps, i.e. 512 frames of the track
 // TODO: kStepSecs and the waveform sample rate of 441
 // (defined in AnalyzerWaveform::initialize) do not align well and thus
 // generate interference. Currently we are at this odd factor: 441 * 0.01161 = 5.12.
@@ -38,8 +39,10 @@ DFConfig makeDetectionFunctionConfig(int stepSize, int windowSize) {
 
 } // namespace
 
-AnalyzerQueenMaryBeats::AnalyzerQueenMaryBeats()
-        : m_iSampleRate(0),
+AnalyzerQueenMaryBeats::AnalyzerQueenMaryBeats(bool reducedSampleRate)
+        : m_reducedSampleRate(reducedSampleRate),
+          m_iSampleRate(0),
+          m_decimationFactor(1),
           m_windowSize(0),
           m_stepSize(0) {
 }
@@ -49,20 +52,30 @@ AnalyzerQueenMaryBeats::~AnalyzerQueenMaryBeats() {
 
 bool AnalyzerQueenMaryBeats::initialize(int samplerate) {
     m_detectionResults.clear();
-    m_iSampleRate = samplerate;
+    m_decimationFactor = m_reducedSampleRate
+            ? DownmixAndOverlapHelper::decimationFactorForSampleRate(samplerate)
+            : 1;
+    // The detection function and the tempo tracker operate at the
+    // reduced sample rate
+    m_iSampleRate = samplerate / m_decimationFactor;
     m_stepSize = static_cast<int>(m_iSampleRate * kStepSecs);
     m_windowSize = MathUtilities::nextPowerOfTwo(m_iSampleRate / kMaximumBinSizeHz);
     m_pDetectionFunction = std::make_unique<DetectionFunction>(
             makeDetectionFunctionConfig(m_stepSize, m_windowSize));
-    qDebug() << "input sample rate is " << m_iSampleRate << ", step size is " << m_stepSize;
+    qDebug() << "input sample rate is " << samplerate
+             << ", analysis sample rate is " << m_iSampleRate
+             << ", step size is " << m_stepSize;
 
     m_helper.initialize(
-            m_windowSize, m_stepSize, [this](double* pWindow, size_t) {
+            m_windowSize,
+            m_stepSize,
+            [this](double* pWindow, size_t) {
                 // TODO(rryan) reserve?
                 m_detectionResults.push_back(
                         m_pDetectionFunction->processTimeDomain(pWindow));
                 return true;
-            });
+            },
+            m_decimationFactor);
     return true;
 }
 
@@ -106,7 +119,8 @@ bool AnalyzerQueenMaryBeats::finalize() {
     m_resultBeats.reserve(beats.size());
     for (size_t i = 0; i < beats.size(); ++i) {
         double result = (beats.at(i) * m_stepSize) - m_stepSize / 2;
-        m_resultBeats.push_back(result);
+        // Convert the position back to the sample rate of the track
+        m_resultBeats.push_back(result * m_decimationFactor);
     }
 
     m_pDetectionFunction.reset();
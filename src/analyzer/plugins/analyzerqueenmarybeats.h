@@ -26,7 +26,9 @@ class AnalyzerQueenMaryBeats : public AnalyzerBeatsPlugin {
                 true);
     }
 
-    AnalyzerQueenMaryBeats();
+    // The audio signal is analyzed at a reduced sample rate of about
+    // 22 kHz unless disabled
+    explicit AnalyzerQueenMaryBeats(bool reducedSampleRate = true);
     ~AnalyzerQueenMaryBeats() override;
 
     AnalyzerPluginInfo info() const override {
@@ -48,7 +50,10 @@ class AnalyzerQueenMaryBeats : public AnalyzerBeatsPlugin {
   private:
     std::unique_ptr<DetectionFunction> m_pDetectionFunction;
     DownmixAndOverlapHelper m_helper;
+    const bool m_reducedSampleRate;
+    // The sample rate of the analyzed signal
     int m_iSampleRate;
+    int m_decimationFactor;
     int m_windowSize;
     int m_stepSize;
     std::vector<double> m_detectionResults;
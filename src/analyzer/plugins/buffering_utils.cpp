@@ -3,13 +3,163 @@
 #include "util/math.h"
 #include "util/sample.h"
 
-#include <string.h>
+#include <algorithm>
+#include <cmath>
 
 namespace mixxx {
 
+namespace {
+
+// Sample rates are only reduced as long as they stay above this limit.
+// The usual 44.1 kHz and 48 kHz are halved, 88.2 kHz and 96 kHz are
+// divided by 4.
+constexpr int kMinDecimatedSampleRate = 22050;
+constexpr int kMaxDecimationFactor = 8;
+
+// The input block size of the decimator in frames. Must be a multiple
+// of all supported decimation factors.
+constexpr size_t kDecimatorBlockFrames = 1024;
+
+// The number of filter coefficients on each side of the center per
+// output frame. Together with the Kaiser window this results in a
+// transition band from 80% of the reduced Nyquist frequency up to
+// the reduced Nyquist frequency itself.
+constexpr size_t kDecimationFilterHalfLength = 16;
+// The cutoff frequency relative to the reduced sample rate, i.e. in
+// the middle of the transition band
+constexpr double kDecimationFilterCutoff = 0.45;
+// Results in a stopband attenuation of about 60 dB
+constexpr double kKaiserBeta = 5.65;
+
+// Zeroth order modified Bessel function of the first kind
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; term > sum * 1e-12; ++k) {
+        const double factor = x / (2.0 * k);
+        term *= factor * factor;
+        sum += term;
+    }
+    return sum;
+}
+
+void downmixStereo(double* pDownmix, const CSAMPLE* pInput, size_t numFrames) {
+    for (size_t i = 0; i < numFrames; ++i) {
+        // We analyze a mono downmix of the signal since we don't think
+        // stereo does us any good.
+        pDownmix[i] = (pInput[i * 2] + pInput[i * 2 + 1]) * 0.5;
+    }
+}
+
+} // anonymous namespace
+
+DecimationFilter::DecimationFilter(int decimationFactor, size_t blockSize)
+        : m_decimationFactor(decimationFactor),
+          m_blockSize(blockSize),
+          m_coefficients(2 * kDecimationFilterHalfLength * decimationFactor + 1),
+          m_delay(kDecimationFilterHalfLength),
+          m_buffer(m_coefficients.size() - 1 + blockSize, 0.0) {
+    DEBUG_ASSERT(decimationFactor > 0);
+    DEBUG_ASSERT(blockSize % decimationFactor == 0);
+    const double cutoff = kDecimationFilterCutoff / decimationFactor;
+    const double center = (m_coefficients.size() - 1) / 2.0;
+    double sum = 0.0;
+    for (size_t i = 0; i < m_coefficients.size(); ++i) {
+        const double x = i - center;
+        const double sinc = (x == 0.0)
+                ? 2.0 * cutoff
+                : std::sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+        const double ratio = x / center;
+        const double window = besselI0(kKaiserBeta * std::sqrt(1.0 - ratio * ratio)) /
+                besselI0(kKaiserBeta);
+        m_coefficients[i] = sinc * window;
+        sum += m_coefficients[i];
+    }
+    // Unity gain for DC
+    for (auto& coefficient : m_coefficients) {
+        coefficient /= sum;
+    }
+}
+
+void DecimationFilter::process(const double* pInput, double* pOutput) {
+    const size_t historySize = m_coefficients.size() - 1;
+    std::copy(pInput, pInput + m_blockSize, m_buffer.begin() + historySize);
+    const size_t numOutputFrames = m_blockSize / m_decimationFactor;
+    for (size_t i = 0; i < numOutputFrames; ++i) {
+        const double* pFrames = &m_buffer[i * m_decimationFactor];
+        // Independent partial sums allow to pipeline the additions
+        double sum0 = 0.0;
+        double sum1 = 0.0;
+        double sum2 = 0.0;
+        double sum3 = 0.0;
+        size_t j = 0;
+        for (; j + 4 <= m_coefficients.size(); j += 4) {
+            sum0 += m_coefficients[j] * pFrames[j];
+            sum1 += m_coefficients[j + 1] * pFrames[j + 1];
+            sum2 += m_coefficients[j + 2] * pFrames[j + 2];
+            sum3 += m_coefficients[j + 3] * pFrames[j + 3];
+        }
+        for (; j < m_coefficients.size(); ++j) {
+            sum0 += m_coefficients[j] * pFrames[j];
+        }
+        pOutput[i] = (sum0 + sum1) + (sum2 + sum3);
+    }
+    // Keep the tail as the history for the next block
+    std::copy(m_buffer.end() - historySize, m_buffer.end(), m_buffer.begin());
+}
+
+DownmixAndOverlapHelper::DownmixAndOverlapHelper() = default;
+
+DownmixAndOverlapHelper::~DownmixAndOverlapHelper() = default;
+
+template<typename FillFunction>
+bool DownmixAndOverlapHelper::processInner(
+        size_t numInputFrames, FillFunction fillFrames) {
+    size_t inRead = 0;
+    double* pDownmix = m_buffer.data();
+
+    while (inRead < numInputFrames) {
+        size_t readAvailable = numInputFrames - inRead;
+        DEBUG_ASSERT(m_bufferWritePosition <= m_windowSize);
+        size_t writeAvailable = m_windowSize - m_bufferWritePosition;
+        size_t numFrames = math_min(readAvailable, writeAvailable);
+        fillFrames(pDownmix + m_bufferWritePosition, inRead, numFrames);
+        m_bufferWritePosition += numFrames;
+        inRead += numFrames;
+
+        if (m_bufferWritePosition == m_windowSize) {
+            bool result = m_callback(pDownmix, m_windowSize);
+
+            // If the callback said not to continue then stop.
+            if (!result) {
+                return false;
+            }
+
+            // If the window size equals the step size then this will result
+            // in m_bufferWritePosition == 0.
+            for (size_t i = 0; i < (m_windowSize - m_stepSize); ++i) {
+                pDownmix[i] = pDownmix[i + m_stepSize];
+            }
+            m_bufferWritePosition -= m_stepSize;
+        }
+    }
+    return true;
+}
+
+// static
+int DownmixAndOverlapHelper::decimationFactorForSampleRate(int sampleRate) {
+    int decimationFactor = 1;
+    while (decimationFactor < kMaxDecimationFactor &&
+            sampleRate / (decimationFactor * 2) >= kMinDecimatedSampleRate) {
+        decimationFactor *= 2;
+    }
+    return decimationFactor;
+}
+
 bool DownmixAndOverlapHelper::initialize(size_t windowSize,
         size_t stepSize,
-        const WindowReadyCallback& callback) {
+        const WindowReadyCallback& callback,
+        int decimationFactor) {
     m_buffer.assign(windowSize, 0.0);
     m_callback = callback;
     m_windowSize = windowSize;
@@ -17,16 +167,59 @@ bool DownmixAndOverlapHelper::initialize(size_t windowSize,
     // make sure the first frame is centered into the fft window. This makes sure
     // that the result is significant starting fom the first step.
     m_bufferWritePosition = windowSize / 2;
+
+    VERIFY_OR_DEBUG_ASSERT(decimationFactor >= 1 &&
+            kDecimatorBlockFrames % decimationFactor == 0) {
+        return false;
+    }
+    if (decimationFactor > 1) {
+        m_pDecimator = std::make_unique<DecimationFilter>(
+                decimationFactor, kDecimatorBlockFrames);
+        m_decimatorInput.assign(kDecimatorBlockFrames, 0.0);
+        m_decimatorOutput.assign(kDecimatorBlockFrames / decimationFactor, 0.0);
+        // Compensate the delay of the filter to keep the windows aligned
+        // with the signal like without decimation
+        m_decimatorDelayRemaining = m_pDecimator->delay();
+    } else {
+        m_pDecimator.reset();
+        m_decimatorInput.clear();
+        m_decimatorOutput.clear();
+        m_decimatorDelayRemaining = 0;
+    }
+    m_decimatorInputPosition = 0;
+
     return m_windowSize > 0 && m_stepSize > 0 &&
             m_stepSize <= m_windowSize && callback;
 }
 
 bool DownmixAndOverlapHelper::processStereoSamples(const CSAMPLE* pInput, size_t inputStereoSamples) {
     const size_t numInputFrames = inputStereoSamples / 2;
-    return processInner(pInput, numInputFrames);
+    if (m_pDecimator) {
+        return processDecimated(pInput, numInputFrames);
+    }
+    return processInner(numInputFrames,
+            [pInput](double* pDownmix, size_t inRead, size_t numFrames) {
+                downmixStereo(pDownmix, pInput + inRead * 2, numFrames);
+            });
 }
 
 bool DownmixAndOverlapHelper::finalize() {
+    if (m_pDecimator) {
+        // Flush the frames that are delayed by the filter and complete
+        // the pending block of the decimator with silence
+        size_t numInputFrames =
+                m_pDecimator->delay() * m_pDecimator->decimationFactor();
+        const size_t blockRemainder =
+                (m_decimatorInputPosition + numInputFrames) % m_decimatorInput.size();
+        if (blockRemainder > 0) {
+            numInputFrames += m_decimatorInput.size() - blockRemainder;
+        }
+        if (!processDecimated(nullptr, numInputFrames)) {
+            return false;
+        }
+        DEBUG_ASSERT(m_decimatorInputPosition == 0);
+    }
+
     // We need to append at least m_windowSize / 2 - m_stepSize silence
     // to have a valid analysis results for the last track samples.
     // Since we proceed in fixed steps, up to "m_stepSize - 1" sample remain
@@ -34,51 +227,48 @@ bool DownmixAndOverlapHelper::finalize() {
     // instead of "m_windowSize / 2 - m_stepSize"
     size_t framesToFillWindow = m_windowSize - m_bufferWritePosition;
     size_t numInputFrames = math_max(framesToFillWindow, m_windowSize / 2 - 1);
-    return processInner(nullptr, numInputFrames);
+    // we are in the finalize call. Add silence to
+    // complete samples left in th buffer.
+    return processInner(numInputFrames,
+            [](double* pDownmix, size_t, size_t numFrames) {
+                std::fill(pDownmix, pDownmix + numFrames, 0.0);
+            });
 }
 
-bool DownmixAndOverlapHelper::processInner(
+bool DownmixAndOverlapHelper::processDecimated(
         const CSAMPLE* pInput, size_t numInputFrames) {
+    DEBUG_ASSERT(m_pDecimator);
     size_t inRead = 0;
-    double* pDownmix = m_buffer.data();
-
     while (inRead < numInputFrames) {
-        size_t readAvailable = numInputFrames - inRead;
-        DEBUG_ASSERT(m_bufferWritePosition <= m_windowSize);
-        size_t writeAvailable = m_windowSize - m_bufferWritePosition;
-        size_t numFrames = math_min(readAvailable, writeAvailable);
+        const size_t numFrames = math_min(numInputFrames - inRead,
+                m_decimatorInput.size() - m_decimatorInputPosition);
+        double* pDownmix = &m_decimatorInput[m_decimatorInputPosition];
         if (pInput) {
-            for (size_t i = 0; i < numFrames; ++i) {
-                // We analyze a mono downmix of the signal since we don't think
-                // stereo does us any good.
-                pDownmix[m_bufferWritePosition + i] = (pInput[(inRead + i) * 2] +
-                                                              pInput[(inRead + i) * 2 + 1]) *
-                        0.5;
-            }
+            downmixStereo(pDownmix, pInput + inRead * 2, numFrames);
         } else {
-            // we are in the finalize call. Add silence to
-            // complete samples left in th buffer.
-            for (size_t i = 0; i < numFrames; ++i) {
-                pDownmix[m_bufferWritePosition + i] = 0;
-            }
+            std::fill(pDownmix, pDownmix + numFrames, 0.0);
         }
-        m_bufferWritePosition += numFrames;
+        m_decimatorInputPosition += numFrames;
         inRead += numFrames;
 
-        if (m_bufferWritePosition == m_windowSize) {
-            bool result = m_callback(pDownmix, m_windowSize);
-
-            // If the callback said not to continue then stop.
+        if (m_decimatorInputPosition == m_decimatorInput.size()) {
+            m_pDecimator->process(
+                    m_decimatorInput.data(),
+                    m_decimatorOutput.data());
+            m_decimatorInputPosition = 0;
+            const size_t skippedFrames = math_min(
+                    m_decimatorDelayRemaining, m_decimatorOutput.size());
+            m_decimatorDelayRemaining -= skippedFrames;
+            const double* pDecimated = m_decimatorOutput.data() + skippedFrames;
+            const bool result = processInner(m_decimatorOutput.size() - skippedFrames,
+                    [pDecimated](double* pDownmix, size_t inRead, size_t numFrames) {
+                        std::copy(pDecimated + inRead,
+                                pDecimated + inRead + numFrames,
+                                pDownmix);
+                    });
             if (!result) {
                 return false;
             }
-
-            // If the window size equals the step size then this will result
-            // in m_bufferWritePosition == 0.
-            for (size_t i = 0; i < (m_windowSize - m_stepSize); ++i) {
-                pDownmix[i] = pDownmix[i + m_stepSize];
-            }
-            m_bufferWritePosition -= m_stepSize;
         }
     }
     return true;
@@ -2,24 +2,69 @@
 
 #include <vector>
 #include <functional>
+#include <memory>
 
 #include "util/types.h"
 
 namespace mixxx {
 
+// Reduces the sample rate of a mono signal by an integer factor. The signal
+// is band-limited by a linear-phase FIR low-pass filter, a Kaiser-windowed
+// sinc, that attenuates aliasing by about 60 dB. The signal is processed in
+// blocks of a fixed size, where the block size must be a multiple of the
+// decimation factor.
+class DecimationFilter {
+  public:
+    DecimationFilter(int decimationFactor, size_t blockSize);
+
+    int decimationFactor() const {
+        return m_decimationFactor;
+    }
+    size_t blockSize() const {
+        return m_blockSize;
+    }
+    // The delay of the output signal in frames at the reduced sample rate
+    size_t delay() const {
+        return m_delay;
+    }
+
+    // Filters blockSize() input frames and writes blockSize() divided by
+    // decimationFactor() frames to the output
+    void process(const double* pInput, double* pOutput);
+
+  private:
+    const int m_decimationFactor;
+    const size_t m_blockSize;
+    std::vector<double> m_coefficients;
+    size_t m_delay;
+    // The tail of the previous block followed by the current block
+    std::vector<double> m_buffer;
+};
+
 // This is used for downmixing a stereo buffer into mono and framing it into
 // overlapping windows as is typically necessary when taking a short-time
 // Fourier transform.
+//
+// Optionally the sample rate of the mono signal is reduced by a power-of-two
+// factor before framing it. The window and step size are then given in frames
+// at the reduced sample rate.
 class DownmixAndOverlapHelper {
   public:
-    DownmixAndOverlapHelper() = default;
+    DownmixAndOverlapHelper();
+    ~DownmixAndOverlapHelper();
 
     typedef std::function<bool(double* pBuffer, size_t frames)> WindowReadyCallback;
 
+    // Returns the decimation factor that reduces the given sample rate to
+    // about 22 kHz, which is sufficient for beat detection. Lower
+    // sample rates are not reduced and 1 is returned.
+    static int decimationFactorForSampleRate(int sampleRate);
+
     bool initialize(
             size_t windowSize,
             size_t stepSize,
-            const WindowReadyCallback& callback);
+            const WindowReadyCallback& callback,
+            int decimationFactor = 1);
 
     bool processStereoSamples(
             const CSAMPLE* pInput,
@@ -28,7 +73,9 @@ class DownmixAndOverlapHelper {
     bool finalize();
 
   private:
-    bool processInner(const CSAMPLE* pInput, size_t numInputFrames);
+    bool processDecimated(const CSAMPLE* pInput, size_t numInputFrames);
+    template<typename FillFunction>
+    bool processInner(size_t numInputFrames, FillFunction fillFrames);
 
     std::vector<double> m_buffer;
     // The window size in frames.
@@ -37,6 +84,14 @@ class DownmixAndOverlapHelper {
     size_t m_stepSize = 0;
     size_t m_bufferWritePosition = 0;
     WindowReadyCallback m_callback;
+
+    // Only used if the sample rate is reduced
+    std::unique_ptr<DecimationFilter> m_pDecimator;
+    std::vector<double> m_decimatorInput;
+    std::vector<double> m_decimatorOutput;
+    size_t m_decimatorInputPosition = 0;
+    // The number of delayed output frames that still need to be skipped
+    size_t m_decimatorDelayRemaining = 0;
 };
 
 } // namespace mixxx
@@ -10,7 +10,13 @@ namespace {
 
 mixxx::Logger kLogger("TrackAnalysisScheduler");
 
-constexpr QThread::Priority kWorkerThreadPriority = QThread::LowPriority;
+// Batch analysis runs in the background, while the analysis of tracks
+// that have just been loaded into players must finish as soon as possible
+QThread::Priority workerThreadPriority(AnalyzerModeFlags modeFlags) {
+    return (modeFlags & AnalyzerModeFlags::LowPriority)
+            ? QThread::LowPriority
+            : QThread::NormalPriority;
+}
 
 // Maximum frequency of progress updates
 constexpr std::chrono::milliseconds kProgressInhibitDuration(100);
@@ -80,7 +86,7 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
     // 2nd pass: Start worker threads in a suspended state
     for (const auto& worker: m_workers) {
         worker.thread()->suspend();
-        worker.thread()->start(kWorkerThreadPriority);
+        worker.thread()->start(workerThreadPriority(modeFlags));
     }
 }
 
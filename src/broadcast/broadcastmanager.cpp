@@ -24,7 +24,8 @@ BroadcastManager::BroadcastManager(SettingsManager* pSettingsManager,
                                    SoundManager* pSoundManager)
         : m_pConfig(pSettingsManager->settings()),
           m_pBroadcastSettings(pSettingsManager->broadcastSettings()),
-          m_pNetworkStream(pSoundManager->getNetworkStream()) {
+          m_pNetworkStream(pSoundManager->getNetworkStream()),
+          m_pEncoderRegistry(new SharedBroadcastEncoderRegistry()) {
     const bool persist = true;
     m_pBroadcastEnabled = new ControlPushButton(
             ConfigKey(BROADCAST_PREF_KEY,"enabled"), persist);
@@ -41,6 +42,10 @@ BroadcastManager::BroadcastManager(SettingsManager* pSettingsManager,
     // Initialize libshout
     shout_init();
 
+    // The shared encoders receive the master mix only once
+    m_pNetworkStream->addOutputWorker(m_pEncoderRegistry);
+    m_pEncoderRegistry->start(QThread::HighPriority);
+
     // Initialize connections list from the current state of BroadcastSettings
     QList<BroadcastProfilePtr> profiles = m_pBroadcastSettings->profiles();
     for (const BroadcastProfilePtr& profile : profiles) {
@@ -71,6 +76,9 @@ BroadcastManager::~BroadcastManager() {
     delete m_pStatusCO;
     delete m_pBroadcastEnabled;
 
+    m_pNetworkStream->removeOutputWorker(m_pEncoderRegistry);
+    m_pEncoderRegistry->shutdown();
+
     shout_shutdown();
 }
 
@@ -159,7 +167,7 @@ bool BroadcastManager::addConnection(BroadcastProfilePtr profile) {
         return false;
     }
 
-    ShoutConnectionPtr connection(new ShoutConnection(profile, m_pConfig));
+    ShoutConnectionPtr connection(new ShoutConnection(profile, m_pConfig, m_pEncoderRegistry));
     m_pNetworkStream->addOutputWorker(connection);
 
     connect(profile.data(),
@@ -52,6 +52,7 @@ class BroadcastManager : public QObject {
     UserSettingsPointer m_pConfig;
     BroadcastSettingsPointer m_pBroadcastSettings;
     QSharedPointer<EngineNetworkStream> m_pNetworkStream;
+    SharedBroadcastEncoderRegistryPtr m_pEncoderRegistry;
 
     ControlPushButton* m_pBroadcastEnabled;
     ControlObject* m_pStatusCO;
@@ -1,5 +1,6 @@
 #include "control/control.h"
 
+#include "control/controlchangebatcher.h"
 #include "control/controlobject.h"
 #include "util/stat.h"
 
@@ -7,15 +8,14 @@
 UserSettingsPointer ControlDoublePrivate::s_pUserConfig;
 
 //static
-QHash<ConfigKey, QWeakPointer<ControlDoublePrivate>> ControlDoublePrivate::s_qCOHash
-        GUARDED_BY(ControlDoublePrivate::s_qCOHashMutex);
+ControlRegistry ControlDoublePrivate::s_registry;
 
 //static
 QHash<ConfigKey, ConfigKey> ControlDoublePrivate::s_qCOAliasHash
-        GUARDED_BY(ControlDoublePrivate::s_qCOHashMutex);
+        GUARDED_BY(ControlDoublePrivate::s_qCOAliasHashMutex);
 
 //static
-MMutex ControlDoublePrivate::s_qCOHashMutex;
+MMutex ControlDoublePrivate::s_qCOAliasHashMutex;
 
 ControlDoublePrivate::ControlDoublePrivate(
         const ConfigKey& key,
@@ -32,7 +32,8 @@ ControlDoublePrivate::ControlDoublePrivate(
           m_trackType(Stat::UNSPECIFIED),
           m_trackFlags(Stat::COUNT | Stat::SUM | Stat::AVERAGE |
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
-          m_confirmRequired(false) {
+          m_confirmRequired(false),
+          m_changeBatcherSlot(-1) {
     initialize(defaultValue);
 }
 
@@ -59,10 +60,17 @@ void ControlDoublePrivate::initialize(double defaultValue) {
 }
 
 ControlDoublePrivate::~ControlDoublePrivate() {
-    s_qCOHashMutex.lock();
-    //qDebug() << "ControlDoublePrivate::s_qCOHash.remove(" << m_key.group << "," << m_key.item << ")";
-    s_qCOHash.remove(m_key);
-    s_qCOHashMutex.unlock();
+    // The key might have been reused by a new control in the meantime
+    s_registry.removeExpired(m_key);
+    {
+        // Aliases are not reused by a new control with the same key
+        MMutexLocker locker(&s_qCOAliasHashMutex);
+        const auto it = s_qCOAliasHash.constFind(m_key);
+        if (it != s_qCOAliasHash.constEnd() &&
+                s_registry.removeExpired(it.value())) {
+            s_qCOAliasHash.erase(it);
+        }
+    }
 
     if (m_bPersistInConfiguration) {
         UserSettingsPointer pConfig = ControlDoublePrivate::s_pUserConfig;
@@ -74,22 +82,16 @@ ControlDoublePrivate::~ControlDoublePrivate() {
 
 // static
 void ControlDoublePrivate::insertAlias(const ConfigKey& alias, const ConfigKey& key) {
-    MMutexLocker locker(&s_qCOHashMutex);
+    MMutexLocker locker(&s_qCOAliasHashMutex);
 
-    auto it = s_qCOHash.constFind(key);
-    if (it == s_qCOHash.constEnd()) {
-        qWarning() << "WARNING: ControlDoublePrivate::insertAlias called for null control" << key;
-        return;
-    }
-
-    QSharedPointer<ControlDoublePrivate> pControl = it.value();
+    QSharedPointer<ControlDoublePrivate> pControl = s_registry.lookup(key);
     if (pControl.isNull()) {
-        qWarning() << "WARNING: ControlDoublePrivate::insertAlias called for expired control" << key;
+        qWarning() << "WARNING: ControlDoublePrivate::insertAlias called for null or expired control" << key;
         return;
     }
 
     s_qCOAliasHash.insert(key, alias);
-    s_qCOHash.insert(alias, pControl);
+    s_registry.insert(alias, pControl);
 }
 
 // static
@@ -107,26 +109,19 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
         return nullptr;
     }
 
-    // Scope for MMutexLocker.
+    // Lock-free lookup
     {
-        const MMutexLocker locker(&s_qCOHashMutex);
-        const auto it = s_qCOHash.find(key);
-        if (it != s_qCOHash.end()) {
-            auto pControl = it.value().lock();
-            if (pControl) {
-                // Control object already exists
-                VERIFY_OR_DEBUG_ASSERT(!pCreatorCO) {
-                    qWarning()
-                            << "ControlObject"
-                            << key.group << key.item
-                            << "already created";
-                    return nullptr;
-                }
-                return pControl;
-            } else {
-                // The weak pointer has become invalid and can be cleaned up
-                s_qCOHash.erase(it);
+        auto pControl = s_registry.lookup(key);
+        if (pControl) {
+            // Control object already exists
+            VERIFY_OR_DEBUG_ASSERT(!pCreatorCO) {
+                qWarning()
+                        << "ControlObject"
+                        << key.group << key.item
+                        << "already created";
+                return nullptr;
             }
+            return pControl;
         }
     }
 
@@ -138,9 +133,8 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
                         bTrack,
                         bPersist,
                         defaultValue));
-        const MMutexLocker locker(&s_qCOHashMutex);
-        //qDebug() << "ControlDoublePrivate::s_qCOHash.insert(" << key.group << "," << key.item << ")";
-        s_qCOHash.insert(key, pControl);
+        //qDebug() << "ControlDoublePrivate::s_registry.insert(" << key.group << "," << key.item << ")";
+        s_registry.insert(key, pControl);
         return pControl;
     }
 
@@ -154,34 +148,12 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
 
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::getAllInstances() {
-    QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.begin(); it != s_qCOHash.end(); ++it) {
-        auto pControl = it.value().lock();
-        if (pControl) {
-            result.append(std::move(pControl));
-        } else {
-            // The weak pointer has become invalid and can be cleaned up
-            s_qCOHash.erase(it);
-        }
-    }
-    return result;
+    return s_registry.getAll();
 }
 
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::takeAllInstances() {
-    QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.begin(); it != s_qCOHash.end(); ++it) {
-        auto pControl = it.value().lock();
-        if (pControl) {
-            result.append(std::move(pControl));
-        }
-    }
-    s_qCOHash.clear();
-    return result;
+    return s_registry.takeAll();
 }
 
 void ControlDoublePrivate::deleteCreatorCO() {
@@ -218,6 +190,10 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
         return;
     }
     m_value.setValue(value);
+    const int changeBatcherSlot = m_changeBatcherSlot.load(std::memory_order_acquire);
+    if (changeBatcherSlot >= 0) {
+        ControlChangeBatcher::markDirty(changeBatcherSlot);
+    }
     emit valueChanged(value, pSender);
 
     if (m_bTrack) {
@@ -5,8 +5,10 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
+#include <atomic>
 
 #include "control/controlbehavior.h"
+#include "control/controlregistry.h"
 #include "control/controlvalue.h"
 #include "preferences/usersettings.h"
 #include "util/mutex.h"
@@ -64,6 +66,7 @@ class ControlDoublePrivate : public QObject {
     static QList<QSharedPointer<ControlDoublePrivate>> takeAllInstances();
 
     static QHash<ConfigKey, ConfigKey> getControlAliases() {
+        const MMutexLocker locker(&s_qCOAliasHashMutex);
         // Implicitly shared classes can safely be copied across threads
         return s_qCOAliasHash;
     }
@@ -137,6 +140,13 @@ class ControlDoublePrivate : public QObject {
         return m_key;
     }
 
+    // Sets the slot in the dirty set of the ControlChangeBatcher that is
+    // marked on every change or -1 if no coalesced notifications have
+    // been requested.
+    void setChangeBatcherSlot(int slot) {
+        m_changeBatcherSlot.store(slot, std::memory_order_release);
+    }
+
     // Connects a slot to the ValueChange request for CO validation. All change
     // requests issued by set are routed though the connected slot. This can
     // decide with its own thread safe solution if the requested value can be
@@ -193,6 +203,8 @@ class ControlDoublePrivate : public QObject {
     int m_trackFlags;
     bool m_confirmRequired;
 
+    std::atomic<int> m_changeBatcherSlot;
+
     // User-visible, i18n name for what the control is.
     QString m_name;
 
@@ -214,13 +226,14 @@ class ControlDoublePrivate : public QObject {
     // configuration object would be arduous.
     static UserSettingsPointer s_pUserConfig;
 
-    // Hash of ControlDoublePrivate instantiations.
-    static QHash<ConfigKey, QWeakPointer<ControlDoublePrivate>> s_qCOHash;
+    // Index of ControlDoublePrivate instantiations (and aliases) with
+    // lock-free lookups.
+    static ControlRegistry s_registry;
 
     // Hash of aliases between ConfigKeys. Solely used for looking up the first
     // alias associated with a key.
     static QHash<ConfigKey, ConfigKey> s_qCOAliasHash;
 
-    // Mutex guarding access to s_qCOHash and s_qCOAliasHash.
-    static MMutex s_qCOHashMutex;
+    // Mutex guarding access to s_qCOAliasHash.
+    static MMutex s_qCOAliasHashMutex;
 };
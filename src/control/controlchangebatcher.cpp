@@ -0,0 +1,117 @@
+#include "control/controlchangebatcher.h"
+
+#include <QtDebug>
+
+#include "control/control.h"
+#include "control/controlproxy.h"
+#include "util/assert.h"
+
+// static
+std::array<std::atomic<std::uint64_t>, ControlChangeBatcher::kMaxSlots / ControlChangeBatcher::kSlotsPerWord>
+        ControlChangeBatcher::s_dirtySlots{};
+
+// static
+QVector<ControlChangeBatcher::Slot> ControlChangeBatcher::s_slots;
+
+// static
+QVector<int> ControlChangeBatcher::s_freeSlots;
+
+// static
+QHash<ControlDoublePrivate*, int> ControlChangeBatcher::s_slotsByControl;
+
+// static
+bool ControlChangeBatcher::subscribe(ControlProxy* pProxy,
+        const QSharedPointer<ControlDoublePrivate>& pControl) {
+    VERIFY_OR_DEBUG_ASSERT(pControl) {
+        return false;
+    }
+    int slot;
+    const auto it = s_slotsByControl.constFind(pControl.data());
+    if (it != s_slotsByControl.constEnd()) {
+        slot = it.value();
+    } else {
+        if (!s_freeSlots.isEmpty()) {
+            slot = s_freeSlots.takeLast();
+        } else if (s_slots.size() < kMaxSlots) {
+            slot = s_slots.size();
+            s_slots.append(Slot());
+        } else {
+            qWarning() << "ControlChangeBatcher: No slot available for"
+                       << pControl->getKey();
+            return false;
+        }
+        s_slots[slot].pControl = pControl;
+        s_slotsByControl.insert(pControl.data(), slot);
+        pControl->setChangeBatcherSlot(slot);
+    }
+    s_slots[slot].subscribers.append(Subscriber{pProxy, pControl->get()});
+    return true;
+}
+
+// static
+void ControlChangeBatcher::unsubscribe(ControlProxy* pProxy,
+        const QSharedPointer<ControlDoublePrivate>& pControl) {
+    const auto it = s_slotsByControl.find(pControl.data());
+    VERIFY_OR_DEBUG_ASSERT(it != s_slotsByControl.end()) {
+        return;
+    }
+    const int slot = it.value();
+    auto& subscribers = s_slots[slot].subscribers;
+    for (int i = 0; i < subscribers.size(); ++i) {
+        if (subscribers[i].pProxy == pProxy) {
+            subscribers.remove(i);
+            break;
+        }
+    }
+    if (subscribers.isEmpty()) {
+        pControl->setChangeBatcherSlot(-1);
+        s_slots[slot].pControl.clear();
+        s_slotsByControl.erase(it);
+        s_freeSlots.append(slot);
+    }
+}
+
+// static
+void ControlChangeBatcher::notifySubscribers() {
+    const int numWords = (s_slots.size() + kSlotsPerWord - 1) / kSlotsPerWord;
+    for (int word = 0; word < numWords; ++word) {
+        if (s_dirtySlots[word].load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        std::uint64_t dirtySlots =
+                s_dirtySlots[word].exchange(0, std::memory_order_acquire);
+        for (int bit = 0; dirtySlots != 0; ++bit, dirtySlots >>= 1) {
+            if (dirtySlots & 1) {
+                notifySlot(word * kSlotsPerWord + bit);
+            }
+        }
+    }
+}
+
+// static
+void ControlChangeBatcher::notifySlot(int slot) {
+    const QSharedPointer<ControlDoublePrivate> pControl = s_slots[slot].pControl;
+    if (!pControl) {
+        // Stale mark of a free slot
+        return;
+    }
+    const double value = pControl->get();
+    // Subscribers might subscribe or unsubscribe proxies when being
+    // notified, iterate over a copy
+    const auto subscribers = s_slots[slot].subscribers;
+    for (const Subscriber& subscriber : subscribers) {
+        if (subscriber.lastValue == value) {
+            continue;
+        }
+        if (s_slots[slot].pControl != pControl) {
+            return;
+        }
+        for (Subscriber& current : s_slots[slot].subscribers) {
+            if (current.pProxy == subscriber.pProxy) {
+                current.lastValue = value;
+                current.pProxy->emitValueChanged();
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QHash>
+#include <QSharedPointer>
+#include <QVarLengthArray>
+#include <QVector>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+class ControlDoublePrivate;
+class ControlProxy;
+
+// Batched, coalesced change notifications for controls that are changed
+// frequently outside of the GUI thread, e.g. VU meters, play positions
+// or beat indicators.
+//
+// Instead of a queued signal per change, the setter only marks the
+// control in a lock-free dirty set. The GUI thread drains this set once
+// per GuiTick and notifies the subscribed ControlProxys about the latest
+// value of each changed control. The CPU load in the GUI thread thereby
+// only depends on the number of changed controls and the frame rate, not
+// on how often the controls are changed.
+//
+// Each subscribed control occupies a slot, i.e. a bit in the dirty set.
+// Slots are reused after all subscribers of a control have been deleted.
+// A stale mark of a reused slot only causes a redundant notification,
+// which is suppressed if the value has not changed.
+//
+// Apart from markDirty() all functions must be called from the GUI thread.
+class ControlChangeBatcher final {
+  public:
+    static constexpr int kMaxSlots = 8192;
+
+    // Marks the control that occupies the slot as changed. Wait-free,
+    // may be called from any thread.
+    static void markDirty(int slot) {
+        s_dirtySlots[slot / kSlotsPerWord].fetch_or(
+                std::uint64_t(1) << (slot % kSlotsPerWord),
+                std::memory_order_release);
+    }
+
+    // Subscribes the proxy to coalesced notifications about changes of
+    // the control. Returns false if no slot is available.
+    static bool subscribe(ControlProxy* pProxy,
+            const QSharedPointer<ControlDoublePrivate>& pControl);
+    static void unsubscribe(ControlProxy* pProxy,
+            const QSharedPointer<ControlDoublePrivate>& pControl);
+
+    // Notifies the subscribers of all controls that have changed since
+    // the last invocation. Called once per GuiTick.
+    static void notifySubscribers();
+
+  private:
+    static constexpr int kSlotsPerWord = 64;
+
+    struct Subscriber {
+        ControlProxy* pProxy;
+        double lastValue;
+    };
+
+    struct Slot {
+        // Keeps the control alive while it is subscribed
+        QSharedPointer<ControlDoublePrivate> pControl;
+        QVarLengthArray<Subscriber, 4> subscribers;
+    };
+
+    static void notifySlot(int slot);
+
+    static std::array<std::atomic<std::uint64_t>, kMaxSlots / kSlotsPerWord> s_dirtySlots;
+
+    static QVector<Slot> s_slots;
+    static QVector<int> s_freeSlots;
+    static QHash<ControlDoublePrivate*, int> s_slotsByControl;
+};
@@ -2,6 +2,7 @@
 
 #include "control/controlproxy.h"
 #include "control/control.h"
+#include "control/controlchangebatcher.h"
 
 ControlProxy::ControlProxy(const QString& g, const QString& i, QObject* pParent, ControlFlags flags)
         : ControlProxy(ConfigKey(g, i), pParent, flags) {
@@ -13,7 +14,8 @@ ControlProxy::ControlProxy(const char* g, const char* i, QObject* pParent, Contr
 
 ControlProxy::ControlProxy(const ConfigKey& key, QObject* pParent, ControlFlags flags)
         : QObject(pParent),
-          m_pControl(nullptr) {
+          m_pControl(nullptr),
+          m_bCoalesced(false) {
     DEBUG_ASSERT(key.isValid() || flags.testFlag(ControlFlag::AllowInvalidKey));
     m_key = key;
 
@@ -38,4 +40,12 @@ void ControlProxy::initialize(ControlFlags flags) {
 
 ControlProxy::~ControlProxy() {
     //qDebug() << "ControlProxy::~ControlProxy()";
+    if (m_bCoalesced) {
+        ControlChangeBatcher::unsubscribe(this, m_pControl);
+    }
+}
+
+bool ControlProxy::subscribeCoalesced() {
+    m_bCoalesced = ControlChangeBatcher::subscribe(this, m_pControl);
+    return m_bCoalesced;
 }
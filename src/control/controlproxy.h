@@ -109,6 +109,25 @@ class ControlProxy : public QObject {
         return true;
     }
 
+    // Like connectValueChanged(), but the receiver is not notified about
+    // every single change. Instead, it receives the latest value once per
+    // GuiTick if the value has changed in the meantime. Intended for
+    // displaying controls that are changed frequently by the engine.
+    // Must be called from the GUI thread and only once per proxy. Falls back
+    // to connectValueChanged() if coalesced notifications are not available.
+    template<typename Receiver, typename Slot>
+    bool connectValueChangedCoalesced(Receiver receiver, Slot func) {
+        if (!m_pControl) {
+            return false;
+        }
+        DEBUG_ASSERT(!m_bCoalesced);
+        if (!subscribeCoalesced()) {
+            return connectValueChanged(receiver, func);
+        }
+        // The notifications are emitted from the GUI thread
+        return connect(this, &ControlProxy::valueChanged, receiver, func, Qt::DirectConnection);
+    }
+
     // Called from update();
     virtual void emitValueChanged() {
         emit valueChanged(get());
@@ -206,6 +225,11 @@ class ControlProxy : public QObject {
     ConfigKey m_key;
     // Pointer to connected control.
     QSharedPointer<ControlDoublePrivate> m_pControl;
+
+  private:
+    bool subscribeCoalesced();
+
+    bool m_bCoalesced;
 };
 
 #endif // CONTROLPROXY_H
@@ -0,0 +1,133 @@
+#include "control/controlregistry.h"
+
+#include <QThread>
+
+#include "control/control.h"
+
+// Announces a reader for the lifetime of the object. All snapshots that
+// are loaded during this time stay valid until it is destroyed.
+class ControlRegistry::ReadSection final {
+  public:
+    explicit ReadSection(const ControlRegistry* pRegistry)
+            : m_pRegistry(pRegistry) {
+        while (true) {
+            m_index = m_pRegistry->m_epoch.load() & 1;
+            m_pRegistry->m_readers[m_index].fetch_add(1);
+            // If the writer has flipped the epoch in the meantime it might
+            // not wait for this counter, retry with the current one
+            if ((m_pRegistry->m_epoch.load() & 1) == m_index) {
+                break;
+            }
+            m_pRegistry->m_readers[m_index].fetch_sub(1, std::memory_order_release);
+        }
+    }
+    ~ReadSection() {
+        m_pRegistry->m_readers[m_index].fetch_sub(1, std::memory_order_release);
+    }
+
+  private:
+    const ControlRegistry* const m_pRegistry;
+    unsigned int m_index;
+};
+
+ControlRegistry::ControlRegistry()
+        : m_epoch(0) {
+    for (auto& shard : m_shards) {
+        shard.store(new Shard());
+    }
+    for (auto& readers : m_readers) {
+        readers.store(0);
+    }
+}
+
+ControlRegistry::~ControlRegistry() {
+    for (auto& shard : m_shards) {
+        delete shard.load();
+    }
+}
+
+QSharedPointer<ControlDoublePrivate> ControlRegistry::lookup(const ConfigKey& key) const {
+    const ReadSection readSection(this);
+    const Shard* pShard = m_shards[shardIndex(key)].load();
+    const auto it = pShard->constFind(key);
+    if (it == pShard->constEnd()) {
+        return nullptr;
+    }
+    // The snapshot is immutable, creating a strong reference from the
+    // shared weak pointer is thread-safe
+    return it.value().toStrongRef();
+}
+
+void ControlRegistry::insert(
+        const ConfigKey& key,
+        const QSharedPointer<ControlDoublePrivate>& pControl) {
+    const int index = shardIndex(key);
+    const MMutexLocker locker(&m_writeMutex);
+    Shard* pShard = new Shard(*m_shards[index].load());
+    pShard->insert(key, pControl);
+    replaceShard(index, pShard);
+}
+
+bool ControlRegistry::removeExpired(const ConfigKey& key) {
+    const int index = shardIndex(key);
+    const MMutexLocker locker(&m_writeMutex);
+    const Shard* pOldShard = m_shards[index].load();
+    const auto it = pOldShard->constFind(key);
+    if (it == pOldShard->constEnd() || !it.value().isNull()) {
+        return false;
+    }
+    Shard* pShard = new Shard(*pOldShard);
+    pShard->remove(key);
+    replaceShard(index, pShard);
+    return true;
+}
+
+QList<QSharedPointer<ControlDoublePrivate>> ControlRegistry::getAll() const {
+    QList<QSharedPointer<ControlDoublePrivate>> result;
+    const ReadSection readSection(this);
+    for (const auto& shard : m_shards) {
+        const Shard* pShard = shard.load();
+        for (auto it = pShard->constBegin(); it != pShard->constEnd(); ++it) {
+            auto pControl = it.value().toStrongRef();
+            if (pControl) {
+                result.append(std::move(pControl));
+            }
+        }
+    }
+    return result;
+}
+
+QList<QSharedPointer<ControlDoublePrivate>> ControlRegistry::takeAll() {
+    QList<QSharedPointer<ControlDoublePrivate>> result;
+    const MMutexLocker locker(&m_writeMutex);
+    std::array<const Shard*, kNumShards> oldShards;
+    for (int i = 0; i < kNumShards; ++i) {
+        oldShards[i] = m_shards[i].exchange(new Shard());
+    }
+    waitForReaders();
+    for (const Shard* pShard : oldShards) {
+        for (auto it = pShard->constBegin(); it != pShard->constEnd(); ++it) {
+            auto pControl = it.value().toStrongRef();
+            if (pControl) {
+                result.append(std::move(pControl));
+            }
+        }
+        delete pShard;
+    }
+    return result;
+}
+
+void ControlRegistry::replaceShard(int index, const Shard* pShard) {
+    const Shard* pOldShard = m_shards[index].exchange(pShard);
+    waitForReaders();
+    delete pOldShard;
+}
+
+void ControlRegistry::waitForReaders() {
+    // New readers only see the new snapshots, flip the epoch and wait
+    // until all readers that started before have finished
+    const unsigned int index = m_epoch.fetch_add(1) & 1;
+    while (m_readers[index].load(std::memory_order_acquire) > 0) {
+        QThread::yieldCurrentThread();
+    }
+}
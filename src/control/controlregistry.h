@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QWeakPointer>
+#include <array>
+#include <atomic>
+
+#include "preferences/configobject.h"
+#include "util/mutex.h"
+
+class ControlDoublePrivate;
+
+// Read-mostly index of all ControlDoublePrivate instances by ConfigKey.
+//
+// Lookups are lock-free and never contend with each other, no matter
+// from which thread they are performed. The keys are distributed over
+// a fixed number of shards. Each shard is an immutable hash snapshot
+// that is replaced as a whole (copy-on-write) when a control is added
+// or removed. Writers are serialized by a mutex and only copy the
+// affected shard.
+//
+// Replaced snapshots are deleted after a grace period, i.e. when all
+// readers that might still access them have finished their lookup
+// (RCU). Readers announce themselves in one of two counters selected
+// by the parity of an epoch that is flipped by the writer.
+class ControlRegistry final {
+  public:
+    ControlRegistry();
+    ~ControlRegistry();
+
+    ControlRegistry(const ControlRegistry&) = delete;
+    ControlRegistry& operator=(const ControlRegistry&) = delete;
+
+    // Returns the control for the key or nullptr if it doesn't exist
+    // or has already expired. Lock-free.
+    QSharedPointer<ControlDoublePrivate> lookup(const ConfigKey& key) const;
+
+    // Adds or replaces the control for the key.
+    void insert(const ConfigKey& key, const QSharedPointer<ControlDoublePrivate>& pControl);
+
+    // Removes the key if the corresponding control has expired. Keys that
+    // have already been reused by a new control are kept. Returns true if
+    // the key has been removed.
+    bool removeExpired(const ConfigKey& key);
+
+    // Returns all controls that have not expired yet.
+    QList<QSharedPointer<ControlDoublePrivate>> getAll() const;
+    // Removes all keys and returns the controls that have not
+    // expired yet.
+    QList<QSharedPointer<ControlDoublePrivate>> takeAll();
+
+  private:
+    typedef QHash<ConfigKey, QWeakPointer<ControlDoublePrivate>> Shard;
+
+    // 256 shards keep the copy costs of a write low for the few thousand
+    // controls that exist in a typical setup
+    static constexpr int kNumShards = 256;
+
+    static int shardIndex(const ConfigKey& key) {
+        return static_cast<int>(qHash(key) % kNumShards);
+    }
+
+    class ReadSection;
+
+    // Publishes the new snapshot and deletes the previous snapshot
+    // after the grace period.
+    void replaceShard(int index, const Shard* pShard) REQUIRES(m_writeMutex);
+    void waitForReaders() REQUIRES(m_writeMutex);
+
+    std::array<std::atomic<const Shard*>, kNumShards> m_shards;
+
+    mutable std::atomic<unsigned int> m_epoch;
+    mutable std::array<std::atomic<int>, 2> m_readers;
+
+    MMutex m_writeMutex;
+};
@@ -1,5 +1,7 @@
 #include "controllers/engine/controllerengine.h"
 
+#include <atomic>
+
 #include "control/controlobject.h"
 #include "control/controlobjectscript.h"
 #include "controllers/controller.h"
@@ -21,6 +23,10 @@ constexpr int kDecks = 16;
 constexpr int kScratchTimerMs = 1;
 constexpr double kAlphaBetaDt = kScratchTimerMs / 1000.0;
 
+// Shared by all controllers, so functions that have been wrapped by another
+// engine instance are never mistaken for valid ones.
+std::atomic<int> s_scriptEngineGenerations(0);
+
 inline ControlFlags onlyAssertOnControllerDebug() {
     if (ControllerDebug::enabled()) {
         return ControlFlag::None;
@@ -34,6 +40,7 @@ ControllerEngine::ControllerEngine(Controller* controller)
         : m_bDisplayingExceptionDialog(false),
           m_pScriptEngine(nullptr),
           m_pController(controller),
+          m_iScriptEngineGeneration(0),
           m_bTesting(false) {
     // Handle error dialog buttons
     qRegisterMetaType<QMessageBox::StandardButton>("QMessageBox::StandardButton");
@@ -204,6 +211,7 @@ void ControllerEngine::initializeScriptEngine() {
 
     // Create the Script Engine
     m_pScriptEngine = new QJSEngine(this);
+    m_iScriptEngineGeneration = ++s_scriptEngineGenerations;
 
     m_pScriptEngine->installExtensions(QJSEngine::ConsoleExtension);
 
@@ -36,6 +36,12 @@ class ControllerEngine : public QObject {
     /// and ensures the function is executed with the correct 'this' object.
     QJSValue wrapFunctionCode(const QString& codeSnippet, int numberOfArgs);
 
+    /// Changes whenever the script engine is (re-)initialized. Functions that
+    /// have been wrapped before are invalid afterwards.
+    int scriptEngineGeneration() const {
+        return m_iScriptEngineGeneration;
+    }
+
     /// Look up registered script function prefixes
     const QList<QString>& getScriptFunctionPrefixes() {
         return m_scriptFunctionPrefixes;
@@ -174,6 +180,7 @@ class ControllerEngine : public QObject {
     QFileSystemWatcher m_scriptWatcher;
     QFileInfo m_moduleFileInfo;
     QList<ControllerPreset::ScriptFileInfo> m_lastScriptFiles;
+    int m_iScriptEngineGeneration;
 
     bool m_bTesting;
 
@@ -38,6 +38,7 @@ QString MidiController::presetExtension() {
 
 void MidiController::visit(const MidiControllerPreset* preset) {
     m_preset = *preset;
+    m_inputDispatchTable.compile(m_preset.getInputMappings());
     emit presetLoaded(getPreset());
 }
 
@@ -177,10 +178,12 @@ void MidiController::learnTemporaryInputMappings(const MidiInputMappings& mappin
         qDebug() << "Set mapping for" << message << "to"
                  << mapping.control.group << mapping.control.item;
     }
+    m_temporaryInputDispatchTable.compile(m_temporaryInputMappings);
 }
 
 void MidiController::clearTemporaryInputMappings() {
     m_temporaryInputMappings.clear();
+    m_temporaryInputDispatchTable.clear();
 }
 
 void MidiController::commitTemporaryInputMappings() {
@@ -200,6 +203,24 @@ void MidiController::commitTemporaryInputMappings() {
         m_preset.addInputMapping(it.key(), it.value());
     }
     m_temporaryInputMappings.clear();
+    m_temporaryInputDispatchTable.clear();
+    m_inputDispatchTable.compile(m_preset.getInputMappings());
+}
+
+MidiInputDispatchTable::Range MidiController::findInputMappings(
+        unsigned char status, unsigned char control) {
+    ControllerEngine* pEngine = getEngine();
+    // pEngine is nullptr in tests.
+    const int scriptEngineGeneration = pEngine ? pEngine->scriptEngineGeneration() : -1;
+    if (isLearning()) {
+        m_temporaryInputDispatchTable.setScriptEngineGeneration(scriptEngineGeneration);
+        const auto range = m_temporaryInputDispatchTable.find(status, control);
+        if (!range.isEmpty()) {
+            return range;
+        }
+    }
+    m_inputDispatchTable.setScriptEngineGeneration(scriptEngineGeneration);
+    return m_inputDispatchTable.find(status, control);
 }
 
 void MidiController::receive(unsigned char status, unsigned char control,
@@ -237,28 +258,20 @@ void MidiController::receive(unsigned char status, unsigned char control,
     triggerActivity();
     if (isLearning()) {
         emit messageReceived(status, control, value);
-
-        auto it = m_temporaryInputMappings.constFind(mappingKey.key);
-        if (it != m_temporaryInputMappings.constEnd()) {
-            for (; it != m_temporaryInputMappings.constEnd() && it.key() == mappingKey.key; ++it) {
-                processInputMapping(it.value(), status, control, value, timestamp);
-            }
-            return;
-        }
     }
 
-    auto it = m_preset.getInputMappings().constFind(mappingKey.key);
-    for (; it != m_preset.getInputMappings().constEnd() && it.key() == mappingKey.key; ++it) {
-        processInputMapping(it.value(), status, control, value, timestamp);
+    for (auto& entry : findInputMappings(mappingKey.status, mappingKey.control)) {
+        processInputMapping(&entry, status, control, value, timestamp);
     }
 }
 
-void MidiController::processInputMapping(const MidiInputMapping& mapping,
+void MidiController::processInputMapping(MidiInputDispatchTable::Entry* pEntry,
                                          unsigned char status,
                                          unsigned char control,
                                          unsigned char value,
                                          mixxx::Duration timestamp) {
     Q_UNUSED(timestamp);
+    const MidiInputMapping& mapping = pEntry->mapping;
     unsigned char channel = MidiUtils::channelFromStatus(status);
     unsigned char opCode = MidiUtils::opCodeFromStatus(status);
 
@@ -268,14 +281,16 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
             return;
         }
 
-        QJSValue function = pEngine->wrapFunctionCode(mapping.control.item, 5);
+        if (pEntry->function.isUndefined()) {
+            pEntry->function = pEngine->wrapFunctionCode(mapping.control.item, 5);
+        }
         QJSValueList args;
         args << QJSValue(channel);
         args << QJSValue(control);
         args << QJSValue(value);
         args << QJSValue(status);
         args << QJSValue(mapping.control.group);
-        if (!pEngine->executeFunction(function, args)) {
+        if (!pEngine->executeFunction(pEntry->function, args)) {
             qDebug() << "MidiController: Invalid script function"
                      << mapping.control.item;
         }
@@ -283,7 +298,7 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
     }
 
     // Only pass values on to valid ControlObjects.
-    ControlObject* pCO = ControlObject::getControl(mapping.control);
+    ControlObject* pCO = pEntry->control();
     if (pCO == NULL) {
         return;
     }
@@ -495,33 +510,27 @@ void MidiController::receive(const QByteArray& data, mixxx::Duration timestamp)
     if (isLearning()) {
         // TODO(rryan): Fake a one value?
         emit messageReceived(mappingKey.status, mappingKey.control, 0x7F);
-
-        auto it = m_temporaryInputMappings.constFind(mappingKey.key);
-        if (it != m_temporaryInputMappings.constEnd()) {
-            for (; it != m_temporaryInputMappings.constEnd() && it.key() == mappingKey.key; ++it) {
-                processInputMapping(it.value(), data, timestamp);
-            }
-            return;
-        }
     }
 
-    auto it = m_preset.getInputMappings().constFind(mappingKey.key);
-    for (; it != m_preset.getInputMappings().constEnd() && it.key() == mappingKey.key; ++it) {
-        processInputMapping(it.value(), data, timestamp);
+    for (auto& entry : findInputMappings(mappingKey.status, mappingKey.control)) {
+        processInputMapping(&entry, data, timestamp);
     }
 }
 
-void MidiController::processInputMapping(const MidiInputMapping& mapping,
+void MidiController::processInputMapping(MidiInputDispatchTable::Entry* pEntry,
                                          const QByteArray& data,
                                          mixxx::Duration timestamp) {
+    const MidiInputMapping& mapping = pEntry->mapping;
     // Custom script handler
     if (mapping.options.script) {
         ControllerEngine* pEngine = getEngine();
         if (pEngine == NULL) {
             return;
         }
-        QJSValue function = pEngine->wrapFunctionCode(mapping.control.item, 2);
-        if (!pEngine->executeFunction(function, data)) {
+        if (pEntry->function.isUndefined()) {
+            pEntry->function = pEngine->wrapFunctionCode(mapping.control.item, 2);
+        }
+        if (!pEngine->executeFunction(pEntry->function, data)) {
             qDebug() << "MidiController: Invalid script function"
                      << mapping.control.item;
         }
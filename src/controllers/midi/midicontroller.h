@@ -16,6 +16,7 @@
 #include "controllers/controller.h"
 #include "controllers/midi/midicontrollerpreset.h"
 #include "controllers/midi/midicontrollerpresetfilehandler.h"
+#include "controllers/midi/midiinputdispatchtable.h"
 #include "controllers/midi/midimessage.h"
 #include "controllers/midi/midioutputhandler.h"
 #include "controllers/softtakeover.h"
@@ -89,14 +90,18 @@ class MidiController : public Controller {
     void commitTemporaryInputMappings();
 
   private:
-    void processInputMapping(const MidiInputMapping& mapping,
+    void processInputMapping(MidiInputDispatchTable::Entry* pEntry,
                              unsigned char status,
                              unsigned char control,
                              unsigned char value,
                              mixxx::Duration timestamp);
-    void processInputMapping(const MidiInputMapping& mapping,
+    void processInputMapping(MidiInputDispatchTable::Entry* pEntry,
                              const QByteArray& data,
                              mixxx::Duration timestamp);
+    /// Returns the mapped entries of the message from the temporary input
+    /// mappings while learning or otherwise from the preset.
+    MidiInputDispatchTable::Range findInputMappings(
+            unsigned char status, unsigned char control);
 
     double computeValue(MidiOptions options, double _prevmidivalue, double _newmidivalue);
     void createOutputHandlers();
@@ -110,6 +115,11 @@ class MidiController : public Controller {
     }
 
     QHash<uint16_t, MidiInputMapping> m_temporaryInputMappings;
+    // The input mappings of m_preset and m_temporaryInputMappings compiled
+    // for dispatching incoming messages. Must be recompiled whenever the
+    // mappings are modified.
+    MidiInputDispatchTable m_inputDispatchTable;
+    MidiInputDispatchTable m_temporaryInputDispatchTable;
     QList<MidiOutputHandler*> m_outputs;
     MidiControllerPreset m_preset;
     SoftTakeoverCtrl m_st;
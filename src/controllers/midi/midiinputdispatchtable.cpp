@@ -0,0 +1,85 @@
+#include "controllers/midi/midiinputdispatchtable.h"
+
+#include <QtDebug>
+#include <algorithm>
+
+#include "control/control.h"
+#include "control/controlobject.h"
+
+ControlObject* MidiInputDispatchTable::Entry::control() {
+    ControlObject* pControl = m_pControl ? m_pControl->getCreatorCO() : nullptr;
+    if (!pControl) {
+        m_pControl = ControlDoublePrivate::getControl(mapping.control);
+        pControl = m_pControl ? m_pControl->getCreatorCO() : nullptr;
+    }
+    return pControl;
+}
+
+MidiInputDispatchTable::MidiInputDispatchTable()
+        : m_scriptEngineGeneration(-1) {
+    m_pageIndices.fill(-1);
+}
+
+void MidiInputDispatchTable::clear() {
+    m_pageIndices.fill(-1);
+    m_pages.clear();
+    m_entries.clear();
+}
+
+void MidiInputDispatchTable::compile(
+        const QMultiHash<uint16_t, MidiInputMapping>& mappings) {
+    clear();
+    m_entries.reserve(mappings.size());
+
+    QList<uint16_t> keys = mappings.uniqueKeys();
+    std::sort(keys.begin(), keys.end());
+    for (const uint16_t key : qAsConst(keys)) {
+        MidiKey midiKey;
+        midiKey.key = key;
+        if (midiKey.status < kStatusCount) {
+            qWarning() << "MidiInputDispatchTable: Ignoring mapping with invalid status"
+                       << QString::number(midiKey.status, 16).toUpper();
+            continue;
+        }
+
+        int& pageIndex = m_pageIndices[midiKey.status - kStatusCount];
+        if (pageIndex < 0) {
+            pageIndex = static_cast<int>(m_pages.size());
+            m_pages.emplace_back();
+            m_pages.back().fill(Slot{0, 0});
+        }
+
+        Slot& slot = m_pages[pageIndex][midiKey.control];
+        slot.first = static_cast<int>(m_entries.size());
+        for (auto it = mappings.constFind(key);
+                it != mappings.constEnd() && it.key() == key;
+                ++it) {
+            m_entries.emplace_back(it.value());
+        }
+        slot.count = static_cast<int>(m_entries.size()) - slot.first;
+    }
+}
+
+MidiInputDispatchTable::Range MidiInputDispatchTable::find(
+        unsigned char status, unsigned char control) {
+    Entry* pEntries = m_entries.data();
+    if (status < kStatusCount) {
+        return Range(pEntries, pEntries);
+    }
+    const int pageIndex = m_pageIndices[status - kStatusCount];
+    if (pageIndex < 0) {
+        return Range(pEntries, pEntries);
+    }
+    const Slot& slot = m_pages[pageIndex][control];
+    return Range(pEntries + slot.first, pEntries + slot.first + slot.count);
+}
+
+void MidiInputDispatchTable::setScriptEngineGeneration(int generation) {
+    if (m_scriptEngineGeneration == generation) {
+        return;
+    }
+    m_scriptEngineGeneration = generation;
+    for (auto& entry : m_entries) {
+        entry.function = QJSValue();
+    }
+}
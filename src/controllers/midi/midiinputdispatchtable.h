@@ -0,0 +1,103 @@
+#pragma once
+/// @file midiinputdispatchtable.h
+/// @brief Precompiled lookup table for MIDI input mappings
+
+#include <QJSValue>
+#include <QMultiHash>
+#include <QSharedPointer>
+#include <array>
+#include <vector>
+
+#include "controllers/midi/midimessage.h"
+
+class ControlDoublePrivate;
+class ControlObject;
+
+/// The input mappings of a MIDI preset compiled into a flat table that is
+/// indexed by the status and control byte of incoming messages.
+///
+/// The table is rebuilt whenever the mappings change, so dispatching a
+/// message neither hashes its key nor looks up the wrapped script function
+/// or the mapped control by name. Script functions and controls are resolved
+/// on first use and kept in the table afterwards.
+class MidiInputDispatchTable {
+  public:
+    struct Entry {
+        explicit Entry(const MidiInputMapping& mapping)
+                : mapping(mapping) {
+        }
+
+        /// Returns the control of a direct mapping or nullptr if it does not
+        /// exist (yet). Controls that have been deleted meanwhile are looked
+        /// up again.
+        ControlObject* control();
+
+        MidiInputMapping mapping;
+        /// The wrapped function of a script mapping, undefined until used
+        QJSValue function;
+
+      private:
+        QSharedPointer<ControlDoublePrivate> m_pControl;
+    };
+
+    /// A range of entries that can be used in range-based for loops
+    class Range {
+      public:
+        Range(Entry* pBegin, Entry* pEnd)
+                : m_pBegin(pBegin),
+                  m_pEnd(pEnd) {
+        }
+
+        Entry* begin() const {
+            return m_pBegin;
+        }
+        Entry* end() const {
+            return m_pEnd;
+        }
+        bool isEmpty() const {
+            return m_pBegin == m_pEnd;
+        }
+
+      private:
+        Entry* m_pBegin;
+        Entry* m_pEnd;
+    };
+
+    MidiInputDispatchTable();
+
+    /// Rebuilds the table from the mappings. Multiple mappings for the same
+    /// message are dispatched in the same order as when iterating over
+    /// QMultiHash::constFind().
+    void compile(const QMultiHash<uint16_t, MidiInputMapping>& mappings);
+    void clear();
+
+    bool isEmpty() const {
+        return m_entries.empty();
+    }
+
+    /// Returns all entries that are mapped to the message
+    Range find(unsigned char status, unsigned char control);
+
+    /// Forgets all wrapped script functions if they have been wrapped by
+    /// a different generation of the script engine, i.e. before the
+    /// scripts have been reloaded.
+    void setScriptEngineGeneration(int generation);
+
+  private:
+    // Status bytes always have the most significant bit set
+    static constexpr int kStatusCount = 0x80;
+    static constexpr int kControlCount = 0x100;
+
+    struct Slot {
+        int first;
+        int count;
+    };
+    typedef std::array<Slot, kControlCount> Page;
+
+    // Pages are only allocated for status bytes that are actually mapped,
+    // most presets only use a few of them.
+    std::array<int, kStatusCount> m_pageIndices;
+    std::vector<Page> m_pages;
+    std::vector<Entry> m_entries;
+    int m_scriptEngineGeneration;
+};
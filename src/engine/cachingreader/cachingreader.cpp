@@ -24,24 +24,58 @@ const SINT kDefaultHintFrames = 1024;
 // With CachingReaderChunk::kFrames = 8192 each chunk consumes
 // 8192 frames * 2 channels/frame * 4-bytes per sample = 65 kB.
 //
-//     80 chunks ->  5120 KB =  5 MB
+//     16 chunks ->  1024 KB =  1 MB
 //
-// Each deck (including sample decks) will use their own CachingReader.
-// Consequently the total memory required for all allocated chunks depends
-// on the number of decks. The amount of memory reserved for a single
-// CachingReader must be multiplied by the number of decks to calculate
-// the total amount!
+// Each deck will use their own CachingReader that permanently owns
+// CachingReaderChunkPool::kMinChunksPerReader chunks. All additional
+// chunks are borrowed from the shared pool that is limited by a
+// configurable memory budget. The lightweight readers of samplers
+// borrow all of their chunks.
 //
 // NOTE(uklotzde, 2019-09-05): Reduce this number to just few chunks
 // (kNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
 // to verify that the MRU/LRU cache works as expected. Even though
 // massive drop outs are expected to occur Mixxx should run reliably!
-const SINT kNumberOfCachedChunksInMemory = 80;
+const SINT kNumberOfCachedChunksInMemory = CachingReaderChunkPool::kMinChunksPerReader;
+
+// Limit the number of in-flight requests to the worker.
+const SINT kMaxPendingReadRequests = 20;
+
+// The number of chunks a reader is allowed to hold for each chunk
+// that has been hinted during a single callback. Hints only cover
+// the chunks that are needed imminently, e.g. around the playhead,
+// the hotcues and the loop points. The additional headroom keeps the
+// recently played regions cached for jumping back and forth.
+const SINT kTargetChunksPerHintedChunk = 8;
+
+// The maximum number of surplus chunks that are returned to the
+// shared pool during a single callback.
+const SINT kMaxReturnedChunksPerCallback = 4;
+
+// Tracks up to this duration are decoded completely into memory, e.g.
+// one-shot samples. 30 s of stereo audio at 48 kHz occupy ~11 MB.
+const double kDefaultDecodedTrackMaxDurationSeconds = 30.0;
+
+// The total amount of memory for all tracks that have been decoded
+// completely into memory.
+const int kDefaultDecodedTrackMemoryBudgetMB = 256;
+
+// The worker sends a decoded track with every TRACK_LOADED status
+// update and the reader releases at most one decoded track per update.
+const SINT kMaxReleasedDecodedTracks = 4;
 
 } // anonymous namespace
 
+// static
+const ConfigKey CachingReader::kDecodedTrackMaxDurationConfigKey =
+        ConfigKey("[Master]", "CachingReaderDecodedTrackMaxDurationSeconds");
+// static
+const ConfigKey CachingReader::kDecodedTrackMemoryBudgetConfigKey =
+        ConfigKey("[Master]", "CachingReaderDecodedTrackMemoryBudgetMB");
+
 CachingReader::CachingReader(const QString& group,
-        UserSettingsPointer config)
+        UserSettingsPointer config,
+        bool lightweight)
         : m_pConfig(config),
           // Limit the number of in-flight requests to the worker. This should
           // prevent to overload the worker when it is not able to fetch those
@@ -52,21 +86,33 @@ CachingReader::CachingReader(const QString& group,
           // buffer, where new requests replace old requests when full. Those
           // old requests need to be returned immediately to the CachingReader
           // that must take ownership and free them!!!
-          m_chunkReadRequestFIFO(kNumberOfCachedChunksInMemory / 4),
-          // The capacity of the back channel must be equal to the number of
-          // allocated chunks, because the worker use writeBlocking(). Otherwise
-          // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          m_chunkReadRequestFIFO(kMaxPendingReadRequests),
+          // The capacity of the back channel must be equal to the maximum
+          // number of allocated chunks, because the worker use writeBlocking().
+          // Otherwise the worker could get stuck in a hot loop!!!
+          m_readerStatusUpdateFIFO(CachingReaderChunkPool::kMaxChunksPerReader),
+          m_releasedDecodedTrackFIFO(kMaxReleasedDecodedTracks),
           m_state(STATE_IDLE),
+          m_pChunkPool(CachingReaderChunkPool::instance(config)),
+          m_ownedChunks(lightweight ? 0 : kNumberOfCachedChunksInMemory),
+          // Raised when a track is loaded
+          m_targetChunks(m_ownedChunks),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
-          m_sampleBuffer(CachingReaderChunk::kSamples * kNumberOfCachedChunksInMemory),
-          m_worker(group, &m_chunkReadRequestFIFO, &m_readerStatusUpdateFIFO) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
+          m_sampleBuffer(CachingReaderChunk::kSamples * m_ownedChunks),
+          m_pDecodedTrack(nullptr),
+          m_worker(group,
+                  &m_chunkReadRequestFIFO,
+                  &m_readerStatusUpdateFIFO,
+                  &m_releasedDecodedTrackFIFO) {
+    m_allocatedCachingReaderChunks.reserve(CachingReaderChunkPool::kMaxChunksPerReader);
+    // Avoid memory allocations in the engine thread when borrowing chunks
+    m_borrowedChunks.reserve(
+            CachingReaderChunkPool::kMaxChunksPerReader - m_ownedChunks);
     // Divide up the allocated raw memory buffer into total_chunks
     // chunks. Initialize each chunk to hold nothing and add it to the free
     // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
+    for (SINT i = 0; i < m_ownedChunks; ++i) {
         CachingReaderChunkForOwner* c =
                 new CachingReaderChunkForOwner(
                         mixxx::SampleBuffer::WritableSlice(
@@ -77,6 +123,21 @@ CachingReader::CachingReader(const QString& group,
         m_freeChunks.push_back(c);
     }
 
+    double decodedTrackMaxDurationSeconds = kDefaultDecodedTrackMaxDurationSeconds;
+    int decodedTrackMemoryBudgetMB = kDefaultDecodedTrackMemoryBudgetMB;
+    if (m_pConfig) {
+        decodedTrackMaxDurationSeconds = m_pConfig->getValue(
+                kDecodedTrackMaxDurationConfigKey,
+                kDefaultDecodedTrackMaxDurationSeconds);
+        decodedTrackMemoryBudgetMB = m_pConfig->getValue(
+                kDecodedTrackMemoryBudgetConfigKey,
+                kDefaultDecodedTrackMemoryBudgetMB);
+    }
+    m_worker.setDecodedTrackLimits(
+            decodedTrackMaxDurationSeconds,
+            static_cast<SINT>(decodedTrackMemoryBudgetMB) * 1024 * 1024);
+    m_worker.setDiskCache(std::make_unique<CachingReaderDiskCache>(m_pConfig));
+
     // Forward signals from worker
     connect(&m_worker, &CachingReaderWorker::trackLoading,
             this, &CachingReader::trackLoading,
@@ -88,12 +149,74 @@ CachingReader::CachingReader(const QString& group,
             this, &CachingReader::trackLoadFailed,
             Qt::DirectConnection);
 
-    m_worker.start(QThread::HighPriority);
+    // Most samplers are never used, their workers are only started
+    // when the first track is loaded
+    if (!lightweight) {
+        m_worker.start(QThread::HighPriority);
+    }
 }
 
 CachingReader::~CachingReader() {
     m_worker.quitWait();
+    // The worker has been stopped and the engine is not running anymore.
+    // All borrowed chunks can safely be returned to the shared pool.
+    for (const auto& pChunk : qAsConst(m_borrowedChunks)) {
+        if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
+            pChunk->removeFromList(
+                    &m_mruCachingReaderChunk,
+                    &m_lruCachingReaderChunk);
+        }
+        if (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING) {
+            pChunk->takeFromWorker();
+        }
+        if (pChunk->getState() != CachingReaderChunkForOwner::FREE) {
+            pChunk->free();
+        }
+        pChunk->setBorrowedIndex(-1);
+        m_pChunkPool->returnChunk(pChunk);
+    }
     qDeleteAll(m_chunks);
+    // The worker has been stopped and will not delete any decoded
+    // tracks that are still pending.
+    CachingReaderDecodedTrack* pDecodedTrack = nullptr;
+    while (m_releasedDecodedTrackFIFO.read(&pDecodedTrack, 1) == 1) {
+        CachingReaderWorker::deleteDecodedTrack(pDecodedTrack);
+    }
+    CachingReaderWorker::deleteDecodedTrack(m_pDecodedTrack);
+}
+
+void CachingReader::releaseDecodedTrack() {
+    if (!m_pDecodedTrack) {
+        return;
+    }
+    // The worker drains this FIFO before processing any other
+    // request. It could only be full if the worker got stuck.
+    VERIFY_OR_DEBUG_ASSERT(m_releasedDecodedTrackFIFO.write(&m_pDecodedTrack, 1) == 1) {
+        kLogger.critical() << "Failed to release decoded track";
+    }
+    m_pDecodedTrack = nullptr;
+    m_worker.workReady();
+}
+
+bool CachingReader::isBorrowedChunk(const CachingReaderChunkForOwner* pChunk) const {
+    return pChunk->getBorrowedIndex() >= 0;
+}
+
+void CachingReader::returnBorrowedChunk(CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk->getState() == CachingReaderChunkForOwner::FREE);
+    // Constant time, invoked for every freed chunk in the engine thread
+    const int index = pChunk->getBorrowedIndex();
+    VERIFY_OR_DEBUG_ASSERT(index >= 0 && index < m_borrowedChunks.size() &&
+            m_borrowedChunks[index] == pChunk) {
+        return;
+    }
+    // Swap with the last element to avoid moving all following elements
+    CachingReaderChunkForOwner* pLastChunk = m_borrowedChunks.last();
+    m_borrowedChunks[index] = pLastChunk;
+    pLastChunk->setBorrowedIndex(index);
+    m_borrowedChunks.removeLast();
+    pChunk->setBorrowedIndex(-1);
+    m_pChunkPool->returnChunk(pChunk);
 }
 
 void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
@@ -101,7 +224,15 @@ void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
             &m_mruCachingReaderChunk,
             &m_lruCachingReaderChunk);
     pChunk->free();
-    m_freeChunks.push_back(pChunk);
+    if (isBorrowedChunk(pChunk)) {
+        if (numChunks() > m_targetChunks) {
+            returnBorrowedChunk(pChunk);
+        } else {
+            m_freeBorrowedChunks.push_back(pChunk);
+        }
+    } else {
+        m_freeChunks.push_back(pChunk);
+    }
 }
 
 void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
@@ -129,18 +260,53 @@ void CachingReader::freeAllChunks() {
             freeChunkFromList(pChunk);
         }
     }
+    // Iterate backwards, because freeChunkFromList() might remove
+    // the current and swap the last element into its position.
+    for (int i = m_borrowedChunks.size() - 1; i >= 0; --i) {
+        const auto pChunk = m_borrowedChunks[i];
+        if (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING) {
+            continue;
+        }
+        if (pChunk->getState() != CachingReaderChunkForOwner::FREE) {
+            freeChunkFromList(pChunk);
+        }
+    }
     DEBUG_ASSERT(!m_mruCachingReaderChunk);
     DEBUG_ASSERT(!m_lruCachingReaderChunk);
 
     m_allocatedCachingReaderChunks.clear();
 }
 
+CachingReaderChunkForOwner* CachingReader::takeFreeChunk() {
+    if (!m_freeChunks.empty()) {
+        CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
+        m_freeChunks.pop_front();
+        return pChunk;
+    }
+    if (!m_freeBorrowedChunks.empty()) {
+        CachingReaderChunkForOwner* pChunk = m_freeBorrowedChunks.front();
+        m_freeBorrowedChunks.pop_front();
+        return pChunk;
+    }
+    if (numChunks() >= m_targetChunks) {
+        // Recycle our own chunks instead of borrowing more
+        return nullptr;
+    }
+    CachingReaderChunkForOwner* pChunk = m_pChunkPool->borrowChunk();
+    if (pChunk) {
+        pChunk->setBorrowedIndex(m_borrowedChunks.size());
+        m_borrowedChunks.push_back(pChunk);
+    } else {
+        Counter("CachingReader::allocateChunk(): Shared chunk pool exhausted")++;
+    }
+    return pChunk;
+}
+
 CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
-    if (m_freeChunks.empty()) {
+    CachingReaderChunkForOwner* pChunk = takeFreeChunk();
+    if (!pChunk) {
         return nullptr;
     }
-    CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
-    m_freeChunks.pop_front();
 
     pChunk->init(chunkIndex);
 
@@ -151,12 +317,17 @@ CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
 
 CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkIndex) {
     auto pChunk = allocateChunk(chunkIndex);
-    if (!pChunk) {
+    // Freeing a borrowed LRU chunk might return it to the shared pool
+    // instead of making it available for allocation if this reader
+    // holds more chunks than its current target size. Continue until
+    // a chunk becomes available.
+    while (!pChunk) {
         if (m_lruCachingReaderChunk) {
             freeChunk(m_lruCachingReaderChunk);
             pChunk = allocateChunk(chunkIndex);
         } else {
             kLogger.warning() << "No cached LRU chunk available for freeing";
+            break;
         }
     }
     if (kLogger.traceEnabled()) {
@@ -165,6 +336,43 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
     return pChunk;
 }
 
+void CachingReader::updateTargetChunks(SINT hintedChunks) {
+    const SINT desiredChunks = math_clamp(
+            kNumberOfCachedChunksInMemory + hintedChunks * kTargetChunksPerHintedChunk,
+            kNumberOfCachedChunksInMemory,
+            CachingReaderChunkPool::kMaxChunksPerReader);
+    if (desiredChunks > m_targetChunks) {
+        // Grow immediately
+        m_targetChunks = desiredChunks;
+    } else if (desiredChunks < m_targetChunks) {
+        // Shrink slowly to avoid thrashing when the hint pressure
+        // fluctuates, e.g. while a loop is toggled on and off.
+        --m_targetChunks;
+    }
+    returnSurplusChunks();
+}
+
+void CachingReader::returnSurplusChunks() {
+    for (SINT i = 0;
+            (i < kMaxReturnedChunksPerCallback) && (numChunks() > m_targetChunks);
+            ++i) {
+        if (!m_freeBorrowedChunks.empty()) {
+            CachingReaderChunkForOwner* pChunk = m_freeBorrowedChunks.front();
+            m_freeBorrowedChunks.pop_front();
+            returnBorrowedChunk(pChunk);
+        } else if (m_lruCachingReaderChunk &&
+                isBorrowedChunk(m_lruCachingReaderChunk)) {
+            // Returned to the pool immediately when freed
+            freeChunk(m_lruCachingReaderChunk);
+        } else {
+            // The remaining borrowed chunks will be returned when
+            // they become the LRU chunk or when their read request
+            // has been finished.
+            break;
+        }
+    }
+}
+
 CachingReaderChunkForOwner* CachingReader::lookupChunk(SINT chunkIndex) {
     // Defaults to nullptr if it's not in the hash.
     auto pChunk = m_allocatedCachingReaderChunks.value(chunkIndex, nullptr);
@@ -218,7 +426,13 @@ void CachingReader::newTrack(TrackPointer pTrack) {
         kLogger.warning()
                 << "Loading a new track while loading a track may lead to inconsistent states";
     }
+    const bool startWorker = pTrack && !m_worker.isRunning();
     m_worker.newTrack(std::move(pTrack));
+    if (startWorker) {
+        // Only the UI thread loads tracks, i.e. the worker is started
+        // at most once
+        m_worker.start(QThread::HighPriority);
+    }
 }
 
 void CachingReader::process() {
@@ -271,15 +485,31 @@ void CachingReader::process() {
                     DEBUG_ASSERT(atomicLoadRelaxed(m_state) == STATE_TRACK_LOADING);
                     freeAllChunks();
                 }
+                // Lightweight readers start borrowing chunks now
+                m_targetChunks = math_max(m_targetChunks, kNumberOfCachedChunksInMemory);
                 // Reset the readable frame index range
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
+                // Replace the decoded track of the previous track (if any)
+                releaseDecodedTrack();
+                m_pDecodedTrack = update.takeDecodedTrack();
                 m_state.storeRelease(STATE_TRACK_LOADED);
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
                 // This message could be processed later when a new
                 // track is already loading! In this case the TRACK_LOADED will
                 // be the very next status update.
-                if (!m_state.testAndSetRelease(STATE_TRACK_UNLOADING, STATE_IDLE)) {
+                if (m_state.testAndSetRelease(STATE_TRACK_UNLOADING, STATE_IDLE)) {
+                    releaseDecodedTrack();
+                    // Hand back all borrowed chunks to the shared pool
+                    // while no track is loaded.
+                    m_targetChunks = m_ownedChunks;
+                    freeAllChunks();
+                    while (!m_freeBorrowedChunks.empty()) {
+                        CachingReaderChunkForOwner* pChunk = m_freeBorrowedChunks.front();
+                        m_freeBorrowedChunks.pop_front();
+                        returnBorrowedChunk(pChunk);
+                    }
+                } else {
                     DEBUG_ASSERT(atomicLoadRelaxed(m_state) == STATE_TRACK_LOADING);
                 }
             }
@@ -331,6 +561,11 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
     // the first chunk and to update m_readableFrameIndexRange
     process();
 
+    if (m_pDecodedTrack) {
+        // Fast path that doesn't involve any chunks
+        return readDecodedTrack(sample, numSamples, reverse, buffer);
+    }
+
     auto remainingFrameIndexRange =
             mixxx::IndexRange::forward(
                     CachingReaderChunk::samples2frames(sample),
@@ -504,16 +739,81 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
     return result;
 }
 
+CachingReader::ReadResult CachingReader::readDecodedTrack(
+        SINT startSample,
+        SINT numSamples,
+        bool reverse,
+        CSAMPLE* buffer) const {
+    DEBUG_ASSERT(m_pDecodedTrack);
+    const auto frameIndexRange =
+            mixxx::IndexRange::forward(
+                    CachingReaderChunk::samples2frames(startSample),
+                    CachingReaderChunk::samples2frames(numSamples));
+    const auto readableFrameIndexRange =
+            intersect(frameIndexRange, m_readableFrameIndexRange);
+    if (readableFrameIndexRange.empty()) {
+        SampleUtil::clear(buffer, numSamples);
+        return ReadResult::PARTIALLY_AVAILABLE;
+    }
+    DEBUG_ASSERT(readableFrameIndexRange.isSubrangeOf(
+            m_pDecodedTrack->frameIndexRange()));
+
+    // Silence before and after the readable frames
+    const SINT leadingSamples = CachingReaderChunk::frames2samples(
+            readableFrameIndexRange.start() - frameIndexRange.start());
+    const SINT readableSamples = CachingReaderChunk::frames2samples(
+            readableFrameIndexRange.length());
+    const SINT trailingSamples = numSamples - leadingSamples - readableSamples;
+    DEBUG_ASSERT(trailingSamples >= 0);
+
+    const CSAMPLE* pReadableData =
+            m_pDecodedTrack->readableData(readableFrameIndexRange.start());
+    if (reverse) {
+        // The last frame comes first
+        SampleUtil::clear(buffer, trailingSamples);
+        SampleUtil::copyReverse(
+                buffer + trailingSamples,
+                pReadableData,
+                readableSamples);
+        SampleUtil::clear(
+                buffer + trailingSamples + readableSamples,
+                leadingSamples);
+    } else {
+        SampleUtil::clear(buffer, leadingSamples);
+        SampleUtil::copy(
+                buffer + leadingSamples,
+                pReadableData,
+                readableSamples);
+        SampleUtil::clear(
+                buffer + leadingSamples + readableSamples,
+                trailingSamples);
+    }
+    if (leadingSamples > 0 || trailingSamples > 0) {
+        return ReadResult::PARTIALLY_AVAILABLE;
+    }
+    return ReadResult::AVAILABLE;
+}
+
 void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
     // If no file is loaded, skip.
     if (atomicLoadRelaxed(m_state) != STATE_TRACK_LOADED) {
         return;
     }
 
+    // A track that has been decoded completely into memory doesn't
+    // need any chunks. Return all borrowed chunks to the shared pool.
+    if (m_pDecodedTrack) {
+        updateTargetChunks(0);
+        return;
+    }
+
     // For every chunk that the hints indicated, check if it is in the cache. If
     // any are not, then wake.
     bool shouldWake = false;
 
+    // The number of chunks that are requested by all hints
+    SINT hintedChunks = 0;
+
     for (const auto& hint: hintList) {
         SINT hintFrame = hint.frame;
         SINT hintFrameCount = hint.frameCount;
@@ -544,6 +844,7 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
 
         const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
         const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
+        hintedChunks += lastChunkIndex - firstChunkIndex + 1;
         for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
             CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
             if (!pChunk) {
@@ -559,7 +860,7 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
                 // Do not insert the allocated chunk into the MRU/LRU list,
                 // because it will be handed over to the worker immediately
                 CachingReaderChunkReadRequest request;
-                request.giveToWorker(pChunk);
+                request.giveToWorker(pChunk, hint.priority);
                 if (kLogger.traceEnabled()) {
                     kLogger.trace()
                             << "Requesting read of chunk"
@@ -581,6 +882,9 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
         }
     }
 
+    // Adjust the size of the cache according to the hint pressure
+    updateTargetChunks(hintedChunks);
+
     // If there are chunks to be read, wake up.
     if (shouldWake) {
         m_worker.workReady();
@@ -8,8 +8,10 @@
 #include <QList>
 #include <QVarLengthArray>
 #include <QVector>
+#include <gtest/gtest_prod.h>
 #include <list>
 
+#include "engine/cachingreader/cachingreaderchunkpool.h"
 #include "engine/cachingreader/cachingreaderworker.h"
 #include "engine/engineworker.h"
 #include "preferences/usersettings.h"
@@ -26,17 +28,29 @@ typedef struct Hint {
     // If a range of frames should be present, use frameCount to indicate that the
     // range (frame, frame + frameCount) should be present in memory.
     SINT frameCount;
-    // Currently unused -- but in the future could be used to prioritize certain
-    // hints over others. A priority of 1 is the highest priority and should be
-    // used for samples that will be read imminently. Hints for samples that
-    // have the potential to be read (i.e. a cue point) should be issued with
-    // priority >10.
+    // Used by the worker to prioritize certain hints over others. A priority
+    // of 1 is the highest priority and should be used for samples that will
+    // be read imminently. Hints for samples that have the potential to be
+    // read (i.e. a cue point) should be issued with priority >= 10. Pending
+    // requests with kPriorityPlayPosition are dropped when the play position
+    // jumps elsewhere.
     int priority;
 
     // for the default frame count in forward direction
     static constexpr SINT kFrameCountForward = 0;
     static constexpr SINT kFrameCountBackward = -1;
 
+    // The samples at the play position that will be read imminently
+    static constexpr int kPriorityPlayPosition = 1;
+    // Loop boundaries of an active loop
+    static constexpr int kPriorityLoop = 2;
+    // The virtual play position in slip mode that is read when slip mode
+    // ends. Distinct from kPriorityPlayPosition, because both positions
+    // are usually far apart.
+    static constexpr int kPrioritySlipPosition = 3;
+    // Cue points, hotcues and inactive loops
+    static constexpr int kPriorityCue = 10;
+
 } Hint;
 
 // Note that we use a QVarLengthArray here instead of a QVector. Since this list
@@ -70,13 +84,31 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // least-recently-used list. When a chunk needs to be allocated and there are no
 // free chunks then the least recently used chunk is free'd (see
 // allocateChunkExpireLRU).
+//
+// Each CachingReader owns a small, fixed number of chunks. Additional chunks
+// are borrowed from a CachingReaderChunkPool that is shared by all readers.
+// The number of chunks a reader is allowed to hold is adjusted according to
+// the number of chunks that are requested by hintAndMaybeWake ("hint
+// pressure"). Decks that are actively used grow their cache while the
+// borrowed chunks of idle decks and samplers are returned to the pool.
+//
+// Short tracks are decoded completely into memory by the worker when loaded
+// (see CachingReaderDecodedTrack). In this case the cache is bypassed
+// entirely and all reads are served from a single contiguous buffer.
+//
+// Lightweight readers don't own any chunks and only borrow chunks while a
+// track is loaded. Their worker thread is started when the first track is
+// loaded. This keeps the memory and the threads of players that are rarely
+// used, i.e. most samplers, close to zero.
 class CachingReader : public QObject {
     Q_OBJECT
 
   public:
-    // Construct a CachingReader with the given group.
+    // Construct a CachingReader with the given group. Lightweight readers
+    // don't own any chunks and borrow all chunks from the shared pool.
     CachingReader(const QString& group,
-            UserSettingsPointer _config);
+            UserSettingsPointer _config,
+            bool lightweight = false);
     ~CachingReader() override;
 
     void process();
@@ -111,6 +143,9 @@ class CachingReader : public QObject {
         m_worker.setScheduler(pScheduler);
     }
 
+    static const ConfigKey kDecodedTrackMaxDurationConfigKey;
+    static const ConfigKey kDecodedTrackMemoryBudgetConfigKey;
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -124,6 +159,17 @@ class CachingReader : public QObject {
     // reader thread.
     FIFO<CachingReaderChunkReadRequest> m_chunkReadRequestFIFO;
     FIFO<ReaderStatusUpdate> m_readerStatusUpdateFIFO;
+    FIFO<CachingReaderDecodedTrack*> m_releasedDecodedTrackFIFO;
+
+    // Reads from the track that has been decoded completely into memory.
+    ReadResult readDecodedTrack(
+            SINT startSample,
+            SINT numSamples,
+            bool reverse,
+            CSAMPLE* buffer) const;
+
+    // Hands the decoded track back to the worker for deletion.
+    void releaseDecodedTrack();
 
     // Looks for the provided chunk number in the index of in-memory chunks and
     // returns it if it is present. If not, returns nullptr. If it is present then
@@ -150,6 +196,24 @@ class CachingReader : public QObject {
     // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none available.
     CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex);
 
+    bool isBorrowedChunk(const CachingReaderChunkForOwner* pChunk) const;
+
+    // Gets a chunk from the local free lists or borrows a new chunk from
+    // the shared pool if the target size has not been reached yet.
+    CachingReaderChunkForOwner* takeFreeChunk();
+
+    // Returns a free, borrowed chunk to the shared pool
+    void returnBorrowedChunk(CachingReaderChunkForOwner* pChunk);
+
+    // Adjusts the target number of chunks according to the number of
+    // hinted chunks and returns surplus chunks to the shared pool.
+    void updateTargetChunks(SINT hintedChunks);
+    void returnSurplusChunks();
+
+    SINT numChunks() const {
+        return m_chunks.size() + m_borrowedChunks.size();
+    }
+
     enum State {
         STATE_IDLE,
         STATE_TRACK_LOADING,
@@ -158,13 +222,28 @@ class CachingReader : public QObject {
     };
     QAtomicInt m_state;
 
+    const std::shared_ptr<CachingReaderChunkPool> m_pChunkPool;
+
+    // The number of chunks that are owned permanently by this reader
+    const SINT m_ownedChunks;
+
     // Keeps track of all CachingReaderChunks we've allocated.
     QVector<CachingReaderChunkForOwner*> m_chunks;
 
+    // Keeps track of all CachingReaderChunks we've borrowed from
+    // the shared pool.
+    QVector<CachingReaderChunkForOwner*> m_borrowedChunks;
+
+    // The number of chunks this reader is currently allowed to hold.
+    SINT m_targetChunks;
+
     // List of free chunks. Linked list so that we have constant time insertions
     // and deletions. Iteration is not necessary.
     std::list<CachingReaderChunkForOwner*> m_freeChunks;
 
+    // List of free chunks that have been borrowed from the shared pool.
+    std::list<CachingReaderChunkForOwner*> m_freeBorrowedChunks;
+
     // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
     // chunk number they are allocated to.
     QHash<int, CachingReaderChunkForOwner*> m_allocatedCachingReaderChunks;
@@ -179,5 +258,10 @@ class CachingReader : public QObject {
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // The current track if it has been decoded completely into memory.
+    CachingReaderDecodedTrack* m_pDecodedTrack;
+
     CachingReaderWorker m_worker;
+
+    FRIEND_TEST(LightweightSamplerTest, StartReaderOnFirstLoad);
 };
@@ -123,6 +123,7 @@ CachingReaderChunkForOwner::CachingReaderChunkForOwner(
         mixxx::SampleBuffer::WritableSlice sampleBuffer)
         : CachingReaderChunk(std::move(sampleBuffer)),
           m_state(FREE),
+          m_borrowedIndex(-1),
           m_pPrev(nullptr),
           m_pNext(nullptr) {
 }
@@ -136,9 +136,21 @@ public:
             CachingReaderChunkForOwner** ppHead,
             CachingReaderChunkForOwner** ppTail);
 
+    // The position in the list of chunks that the owning reader has
+    // borrowed from the shared pool, or -1 if the chunk is owned
+    // permanently by the reader or not borrowed at all.
+    int getBorrowedIndex() const {
+        return m_borrowedIndex;
+    }
+    void setBorrowedIndex(int borrowedIndex) {
+        m_borrowedIndex = borrowedIndex;
+    }
+
 private:
     State m_state;
 
+    int m_borrowedIndex;
+
     CachingReaderChunkForOwner* m_pPrev; // previous item in double-linked list
     CachingReaderChunkForOwner* m_pNext; // next item in double-linked list
 };
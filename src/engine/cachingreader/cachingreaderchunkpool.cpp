@@ -0,0 +1,124 @@
+#include "engine/cachingreader/cachingreaderchunkpool.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderChunkPool");
+
+// With CachingReaderChunk::kFrames = 8192 each chunk consumes
+// 8192 frames * 2 channels/frame * 4-bytes per sample = 64 KiB.
+//
+//    64 MB -> 1024 chunks
+const SINT kBytesPerChunk = CachingReaderChunk::kSamples * sizeof(CSAMPLE);
+
+QMutex s_instanceMutex;
+std::weak_ptr<CachingReaderChunkPool> s_pInstance;
+
+// The engine threads must not be suspended by a mutex. The lock is
+// only held for a few instructions and contention is rare.
+class ScopedSpinLock final {
+  public:
+    explicit ScopedSpinLock(std::atomic_flag* pFlag)
+            : m_pFlag(pFlag) {
+        while (m_pFlag->test_and_set(std::memory_order_acquire)) {
+        }
+    }
+    ~ScopedSpinLock() {
+        m_pFlag->clear(std::memory_order_release);
+    }
+
+  private:
+    std::atomic_flag* const m_pFlag;
+};
+
+} // anonymous namespace
+
+// static
+const ConfigKey CachingReaderChunkPool::kMemoryBudgetConfigKey =
+        ConfigKey("[Master]", "CachingReaderMemoryBudgetMB");
+
+// static
+SINT CachingReaderChunkPool::numChunksForMemoryBudget(int memoryBudgetMB) {
+    if (memoryBudgetMB <= 0) {
+        return 0;
+    }
+    return (static_cast<SINT>(memoryBudgetMB) * 1024 * 1024) / kBytesPerChunk;
+}
+
+// static
+std::shared_ptr<CachingReaderChunkPool> CachingReaderChunkPool::instance(
+        const UserSettingsPointer& pConfig) {
+    QMutexLocker locker(&s_instanceMutex);
+    auto pInstance = s_pInstance.lock();
+    if (!pInstance) {
+        int memoryBudgetMB = kDefaultMemoryBudgetMB;
+        if (pConfig) {
+            memoryBudgetMB = pConfig->getValue(
+                    kMemoryBudgetConfigKey, kDefaultMemoryBudgetMB);
+        }
+        kLogger.info()
+                << "Creating shared chunk pool with a memory budget of"
+                << memoryBudgetMB
+                << "MB";
+        pInstance = std::make_shared<CachingReaderChunkPool>(
+                numChunksForMemoryBudget(memoryBudgetMB));
+        s_pInstance = pInstance;
+    }
+    return pInstance;
+}
+
+CachingReaderChunkPool::CachingReaderChunkPool(SINT numChunks)
+        : m_sampleBuffer(CachingReaderChunk::kSamples * numChunks),
+          // The FIFO must be able to hold all chunks at once
+          m_freeChunks(math_max(numChunks, SINT(1))) {
+    DEBUG_ASSERT(numChunks >= 0);
+    m_chunks.reserve(numChunks);
+    for (SINT i = 0; i < numChunks; ++i) {
+        auto* pChunk =
+                new CachingReaderChunkForOwner(
+                        mixxx::SampleBuffer::WritableSlice(
+                                m_sampleBuffer,
+                                CachingReaderChunk::kSamples * i,
+                                CachingReaderChunk::kSamples));
+        m_chunks.push_back(pChunk);
+        m_freeChunks.writeBlocking(&pChunk, 1);
+    }
+}
+
+CachingReaderChunkPool::~CachingReaderChunkPool() {
+    // All borrowed chunks must have been returned by their readers
+    DEBUG_ASSERT(available() == size());
+    qDeleteAll(m_chunks);
+}
+
+CachingReaderChunkForOwner* CachingReaderChunkPool::borrowChunk() {
+    CachingReaderChunkForOwner* pChunk = nullptr;
+    {
+        ScopedSpinLock lock(&m_freeChunksLock);
+        if (m_freeChunks.read(&pChunk, 1) != 1) {
+            return nullptr;
+        }
+    }
+    DEBUG_ASSERT(pChunk);
+    DEBUG_ASSERT(pChunk->getState() == CachingReaderChunkForOwner::FREE);
+    return pChunk;
+}
+
+void CachingReaderChunkPool::returnChunk(CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk);
+    DEBUG_ASSERT(pChunk->getState() == CachingReaderChunkForOwner::FREE);
+    int written = 0;
+    {
+        ScopedSpinLock lock(&m_freeChunksLock);
+        // Never blocks, because the FIFO is able to hold all chunks
+        written = m_freeChunks.write(&pChunk, 1);
+    }
+    VERIFY_OR_DEBUG_ASSERT(written == 1) {
+        kLogger.critical() << "Failed to return chunk" << pChunk;
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "preferences/usersettings.h"
+#include "util/fifo.h"
+#include "util/samplebuffer.h"
+
+// A process-wide pool of CachingReaderChunks that is shared by all
+// CachingReader instances.
+//
+// Each CachingReader owns a small number of chunks that are guaranteed
+// to be available for playback. Beyond that readers borrow additional
+// chunks from this pool on demand and return them when they are no longer
+// needed, i.e. when the hint pressure of a deck decreases or when its
+// track is unloaded. This way busy decks are able to grow their cache
+// while idle samplers don't waste any memory.
+//
+// The total amount of memory that is reserved for the pool is configured
+// by the user as a memory budget in MB.
+//
+// Thread-safety: Chunks are borrowed and returned from the engine callback,
+// possibly from multiple threads that process channels in parallel. Access
+// to the underlying single-producer/single-consumer FIFO is serialized by
+// a spin lock that is only held for reading or writing a single pointer.
+// The destructor of CachingReader might also return chunks from a different
+// thread.
+class CachingReaderChunkPool final {
+  public:
+    // The minimum number of chunks that are owned by each CachingReader
+    // and that are not shared with other readers.
+    static constexpr SINT kMinChunksPerReader = 16;
+
+    // The maximum number of chunks that a single CachingReader might
+    // own, including the borrowed chunks. This limit is needed for
+    // dimensioning the FIFOs between the reader and its worker.
+    static constexpr SINT kMaxChunksPerReader = 512;
+
+    static const ConfigKey kMemoryBudgetConfigKey;
+    static constexpr int kDefaultMemoryBudgetMB = 64;
+
+    // Returns the shared instance. The pool is created on first use
+    // and destroyed when the last reference has been released. The
+    // memory budget is only read from the config when creating a new
+    // instance.
+    static std::shared_ptr<CachingReaderChunkPool> instance(
+            const UserSettingsPointer& pConfig);
+
+    explicit CachingReaderChunkPool(SINT numChunks);
+    ~CachingReaderChunkPool();
+
+    CachingReaderChunkPool(const CachingReaderChunkPool&) = delete;
+    CachingReaderChunkPool& operator=(const CachingReaderChunkPool&) = delete;
+
+    SINT size() const {
+        return m_chunks.size();
+    }
+
+    // The number of chunks that are currently available for borrowing.
+    SINT available() const {
+        return m_freeChunks.readAvailable();
+    }
+
+    // Borrow a free chunk. Returns nullptr if the pool is exhausted.
+    CachingReaderChunkForOwner* borrowChunk();
+
+    // Return a borrowed chunk that must be in state FREE.
+    void returnChunk(CachingReaderChunkForOwner* pChunk);
+
+  private:
+    static SINT numChunksForMemoryBudget(int memoryBudgetMB);
+
+    // The raw memory buffer which is divided up into chunks.
+    mixxx::SampleBuffer m_sampleBuffer;
+
+    // All chunks of this pool, regardless of who is borrowing them.
+    QVector<CachingReaderChunkForOwner*> m_chunks;
+
+    FIFO<CachingReaderChunkForOwner*> m_freeChunks;
+    std::atomic_flag m_freeChunksLock = ATOMIC_FLAG_INIT;
+};
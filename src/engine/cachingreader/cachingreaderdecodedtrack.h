@@ -0,0 +1,62 @@
+#pragma once
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "util/indexrange.h"
+#include "util/samplebuffer.h"
+
+// The stereo samples of a track that has been decoded completely into
+// a single contiguous buffer by the CachingReaderWorker.
+//
+// Ownership is passed from the worker to the CachingReader together
+// with the TRACK_LOADED status update. The CachingReader hands it back
+// to the worker when the track is unloaded, because the memory must
+// not be deallocated in the engine thread.
+class CachingReaderDecodedTrack final {
+  public:
+    explicit CachingReaderDecodedTrack(
+            const mixxx::IndexRange& frameIndexRange)
+            : m_frameIndexRange(frameIndexRange),
+              m_sampleBuffer(CachingReaderChunk::frames2samples(
+                      frameIndexRange.length())) {
+    }
+
+    CachingReaderDecodedTrack(const CachingReaderDecodedTrack&) = delete;
+    CachingReaderDecodedTrack& operator=(const CachingReaderDecodedTrack&) = delete;
+
+    // The range of frames that have been decoded successfully
+    const mixxx::IndexRange& frameIndexRange() const {
+        return m_frameIndexRange;
+    }
+    void shrinkFrameIndexRange(const mixxx::IndexRange& frameIndexRange) {
+        DEBUG_ASSERT(frameIndexRange.empty() ||
+                (frameIndexRange.start() == m_frameIndexRange.start() &&
+                        frameIndexRange.isSubrangeOf(m_frameIndexRange)));
+        m_frameIndexRange = frameIndexRange;
+    }
+
+    SINT sizeInBytes() const {
+        return m_sampleBuffer.size() * sizeof(CSAMPLE);
+    }
+
+    mixxx::SampleBuffer::WritableSlice writableSlice(
+            const mixxx::IndexRange& frameIndexRange) {
+        DEBUG_ASSERT(frameIndexRange.isSubrangeOf(m_frameIndexRange));
+        return mixxx::SampleBuffer::WritableSlice(
+                m_sampleBuffer,
+                CachingReaderChunk::frames2samples(
+                        frameIndexRange.start() - m_frameIndexRange.start()),
+                CachingReaderChunk::frames2samples(
+                        frameIndexRange.length()));
+    }
+
+    const CSAMPLE* readableData(SINT frameIndex) const {
+        DEBUG_ASSERT(m_frameIndexRange.containsIndex(frameIndex));
+        return m_sampleBuffer.data(
+                CachingReaderChunk::frames2samples(
+                        frameIndex - m_frameIndexRange.start()));
+    }
+
+  private:
+    mixxx::IndexRange m_frameIndexRange;
+    mixxx::SampleBuffer m_sampleBuffer;
+};
@@ -0,0 +1,458 @@
+#include "engine/cachingreader/cachingreaderdiskcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QUrl>
+#include <algorithm>
+#include <cstring>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "sources/audiosourcestereoproxy.h"
+#include "track/track.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderDiskCache");
+
+const QString kFileSuffix = QStringLiteral(".pcm");
+const QString kPartialFileSuffix = QStringLiteral(".pcm.part");
+
+// Partial entries are written continuously until committed. Those
+// that have not been modified for a long time have been left behind,
+// e.g. after a crash.
+constexpr qint64 kStalePartialFileAgeSecs = 60 * 60;
+
+constexpr char kMagic[8] = {'M', 'I', 'X', 'X', 'X', 'P', 'C', 'M'};
+constexpr quint32 kVersion = 1;
+
+// The header precedes the interleaved samples in native byte order.
+// Entries are not supposed to be shared between different machines.
+struct EntryHeader {
+    char magic[8];
+    quint32 version;
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 reserved;
+    qint64 frameIndexStart;
+    qint64 frameIndexEnd;
+};
+static_assert(sizeof(EntryHeader) % sizeof(CSAMPLE) == 0,
+        "samples following the header must be aligned");
+
+EntryHeader makeEntryHeader(
+        const mixxx::audio::SignalInfo& signalInfo,
+        const mixxx::IndexRange& frameIndexRange) {
+    EntryHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.channelCount = signalInfo.getChannelCount();
+    header.sampleRate = signalInfo.getSampleRate();
+    header.reserved = 0;
+    header.frameIndexStart = frameIndexRange.start();
+    header.frameIndexEnd = frameIndexRange.end();
+    return header;
+}
+
+void touchFile(QFile* pFile) {
+    // The modification time is used for evicting the least
+    // recently used entries
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    pFile->setFileTime(
+            QDateTime::currentDateTimeUtc(),
+            QFileDevice::FileModificationTime);
+#else
+    Q_UNUSED(pFile);
+#endif
+}
+
+// Offers the samples of a memory-mapped cache entry. Samples are copied
+// into the provided buffer, because the memory of the mapping must not
+// be accessed from the engine thread.
+class CachedAudioSource : public mixxx::AudioSource {
+  public:
+    explicit CachedAudioSource(const QString& filePath)
+            : AudioSource(QUrl::fromLocalFile(filePath)),
+              m_file(filePath),
+              m_pMappedData(nullptr),
+              m_pSamples(nullptr) {
+    }
+    ~CachedAudioSource() override {
+        close();
+    }
+
+    void close() override {
+        if (m_pMappedData) {
+            m_file.unmap(m_pMappedData);
+            m_pMappedData = nullptr;
+            m_pSamples = nullptr;
+        }
+        m_file.close();
+    }
+
+  protected:
+    OpenResult tryOpen(
+            OpenMode /*mode*/,
+            const OpenParams& /*params*/) override {
+        // Write access is only needed for updating the modification time
+        if (!m_file.open(QIODevice::ReadWrite) &&
+                !m_file.open(QIODevice::ReadOnly)) {
+            return OpenResult::Failed;
+        }
+        const qint64 fileSize = m_file.size();
+        if (fileSize < static_cast<qint64>(sizeof(EntryHeader))) {
+            return OpenResult::Failed;
+        }
+        m_pMappedData = m_file.map(0, fileSize);
+        if (!m_pMappedData) {
+            kLogger.warning()
+                    << "Failed to map file"
+                    << m_file.fileName()
+                    << m_file.errorString();
+            return OpenResult::Failed;
+        }
+        EntryHeader header;
+        std::memcpy(&header, m_pMappedData, sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+                header.version != kVersion) {
+            kLogger.warning()
+                    << "Invalid or outdated entry"
+                    << m_file.fileName();
+            return OpenResult::Failed;
+        }
+        const auto frameIndexRange =
+                mixxx::IndexRange::between(
+                        header.frameIndexStart,
+                        header.frameIndexEnd);
+        const qint64 expectedFileSize =
+                sizeof(EntryHeader) +
+                static_cast<qint64>(frameIndexRange.length()) *
+                        header.channelCount * sizeof(CSAMPLE);
+        if (!initChannelCountOnce(static_cast<SINT>(header.channelCount)) ||
+                !initSampleRateOnce(static_cast<SINT>(header.sampleRate)) ||
+                !initFrameIndexRangeOnce(frameIndexRange) ||
+                fileSize != expectedFileSize) {
+            kLogger.warning()
+                    << "Corrupt entry"
+                    << m_file.fileName();
+            return OpenResult::Failed;
+        }
+        m_pSamples = reinterpret_cast<const CSAMPLE*>(
+                m_pMappedData + sizeof(EntryHeader));
+        if (m_file.isWritable()) {
+            touchFile(&m_file);
+        }
+        return OpenResult::Succeeded;
+    }
+
+    mixxx::ReadableSampleFrames readSampleFramesClamped(
+            const mixxx::WritableSampleFrames& writableSampleFrames) override {
+        const auto frameIndexRange = writableSampleFrames.frameIndexRange();
+        DEBUG_ASSERT(frameIndexRange.isSubrangeOf(this->frameIndexRange()));
+        const SINT sampleCount =
+                getSignalInfo().frames2samples(frameIndexRange.length());
+        if (!writableSampleFrames.writableData() || sampleCount == 0) {
+            // Skip frames
+            return mixxx::ReadableSampleFrames(frameIndexRange);
+        }
+        const SINT sampleOffset =
+                getSignalInfo().frames2samples(
+                        frameIndexRange.start() - frameIndexMin());
+        SampleUtil::copy(
+                writableSampleFrames.writableData(),
+                m_pSamples + sampleOffset,
+                sampleCount);
+        return mixxx::ReadableSampleFrames(
+                frameIndexRange,
+                mixxx::SampleBuffer::ReadableSlice(
+                        writableSampleFrames.writableData(),
+                        sampleCount));
+    }
+
+  private:
+    QFile m_file;
+    uchar* m_pMappedData;
+    const CSAMPLE* m_pSamples;
+};
+
+} // anonymous namespace
+
+// static
+const ConfigKey CachingReaderDiskCache::kEnabledConfigKey =
+        ConfigKey("[Master]", "CachingReaderDiskCacheEnabled");
+// static
+const ConfigKey CachingReaderDiskCache::kQuotaConfigKey =
+        ConfigKey("[Master]", "CachingReaderDiskCacheQuotaMB");
+
+CachingReaderDiskCache::CachingReaderDiskCache(
+        const UserSettingsPointer& pConfig)
+        : m_enabled(pConfig &&
+                  pConfig->getValue(kEnabledConfigKey, false)),
+          m_quotaBytes(static_cast<qint64>(pConfig
+                                       ? pConfig->getValue(kQuotaConfigKey, kDefaultQuotaMB)
+                                       : kDefaultQuotaMB) *
+                  1024 * 1024),
+          m_directory(pConfig
+                          ? QDir(pConfig->getSettingsPath()).filePath(QStringLiteral("pcmcache"))
+                          : QString()) {
+    if (m_enabled && !QDir().mkpath(m_directory.absolutePath())) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << m_directory.absolutePath();
+    }
+}
+
+// static
+QString CachingReaderDiskCache::cacheKeyForTrack(
+        const TrackPointer& pTrack) {
+    if (!pTrack) {
+        return QString();
+    }
+    const QFileInfo fileInfo = pTrack->getFileInfo().asFileInfo();
+    if (!fileInfo.exists()) {
+        return QString();
+    }
+    // Hashing the file contents would be too expensive. Any modification
+    // of the file is supposed to update its size or modification time.
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(fileInfo.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(fileInfo.size()));
+    hash.addData(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString CachingReaderDiskCache::filePathForCacheKey(
+        const QString& cacheKey) const {
+    return m_directory.filePath(cacheKey + kFileSuffix);
+}
+
+mixxx::AudioSourcePointer CachingReaderDiskCache::openAudioSource(
+        const QString& cacheKey) const {
+    if (!m_enabled || cacheKey.isEmpty()) {
+        return nullptr;
+    }
+    const QString filePath = filePathForCacheKey(cacheKey);
+    if (!QFileInfo::exists(filePath)) {
+        return nullptr;
+    }
+    auto pAudioSource = std::make_shared<CachedAudioSource>(filePath);
+    if (pAudioSource->open(mixxx::AudioSource::OpenMode::Strict) !=
+            mixxx::AudioSource::OpenResult::Succeeded) {
+        pAudioSource.reset();
+        // Delete the unusable entry to write it again
+        QFile::remove(filePath);
+        return nullptr;
+    }
+    return pAudioSource;
+}
+
+std::unique_ptr<CachingReaderDiskCache::Writer> CachingReaderDiskCache::createWriter(
+        const QString& cacheKey,
+        mixxx::AudioSourcePointer pAudioSource) const {
+    if (!m_enabled || cacheKey.isEmpty() || !pAudioSource) {
+        return nullptr;
+    }
+    const qint64 sizeInBytes =
+            CachingReaderChunk::frames2samples(pAudioSource->frameLength()) *
+            static_cast<qint64>(sizeof(CSAMPLE));
+    if (sizeInBytes > m_quotaBytes) {
+        return nullptr;
+    }
+    return std::make_unique<Writer>(
+            filePathForCacheKey(cacheKey),
+            std::move(pAudioSource));
+}
+
+void CachingReaderDiskCache::evictLeastRecentlyUsed() const {
+    if (!m_enabled) {
+        return;
+    }
+    const QDateTime staleBefore =
+            QDateTime::currentDateTimeUtc().addSecs(-kStalePartialFileAgeSecs);
+    // Oldest files last
+    const QFileInfoList files = m_directory.entryInfoList(
+            QStringList{
+                    QStringLiteral("*") + kFileSuffix,
+                    QStringLiteral("*") + kPartialFileSuffix},
+            QDir::Files,
+            QDir::Time);
+    qint64 totalBytes = 0;
+    for (const auto& file : files) {
+        const bool partial = file.fileName().endsWith(kPartialFileSuffix);
+        if (partial && file.lastModified() < staleBefore) {
+            if (QFile::remove(file.absoluteFilePath())) {
+                kLogger.debug()
+                        << "Deleted stale partial entry"
+                        << file.fileName();
+                continue;
+            }
+        }
+        totalBytes += file.size();
+        if (totalBytes <= m_quotaBytes || partial) {
+            // Partial entries of running writers are never evicted
+            continue;
+        }
+        // Might fail on some platforms while still mapped by another
+        // worker. Those entries will be evicted later.
+        if (QFile::remove(file.absoluteFilePath())) {
+            totalBytes -= file.size();
+            kLogger.debug()
+                    << "Evicted"
+                    << file.fileName();
+        }
+    }
+}
+
+CachingReaderDiskCache::Writer::Writer(
+        const QString& filePath,
+        mixxx::AudioSourcePointer pAudioSource)
+        : m_filePath(filePath),
+          m_pAudioSource(std::move(pAudioSource)),
+          m_file(filePath.left(filePath.size() - kFileSuffix.size()) +
+                  QStringLiteral(".XXXXXX") + kPartialFileSuffix),
+          m_tempReadBuffer(m_pAudioSource->getSignalInfo().frames2samples(
+                  CachingReaderChunk::kFrames)),
+          m_writeBuffer(CachingReaderChunk::kSamples),
+          m_writtenFrameIndexRange(mixxx::IndexRange::forward(
+                  m_pAudioSource->frameIndexMin(), 0)),
+          m_committed(false) {
+    // The file is removed explicitly when aborting and must
+    // survive when being renamed on commit
+    m_file.setAutoRemove(false);
+    open();
+}
+
+CachingReaderDiskCache::Writer::~Writer() {
+    if (!m_committed) {
+        abort();
+    }
+}
+
+bool CachingReaderDiskCache::Writer::open() {
+    // Creates a new file with a unique name
+    if (!m_file.open()) {
+        kLogger.warning()
+                << "Failed to create file for writing"
+                << m_file.fileTemplate()
+                << m_file.errorString();
+        return false;
+    }
+    // Write the header of an empty entry that is finally
+    // replaced when committing all samples.
+    const auto header = makeEntryHeader(
+            mixxx::audio::SignalInfo(
+                    CachingReaderChunk::kChannels,
+                    m_pAudioSource->getSignalInfo().getSampleRate(),
+                    mixxx::AudioSource::kSampleLayout),
+            m_writtenFrameIndexRange);
+    if (m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) !=
+            sizeof(header)) {
+        abort();
+        return false;
+    }
+    return true;
+}
+
+bool CachingReaderDiskCache::Writer::writeNextFrames() {
+    if (!m_file.isOpen()) {
+        return false;
+    }
+    const auto remainingFrameIndexRange =
+            mixxx::IndexRange::between(
+                    m_writtenFrameIndexRange.end(),
+                    m_pAudioSource->frameIndexMax());
+    if (remainingFrameIndexRange.empty()) {
+        commit();
+        return false;
+    }
+    const auto nextFrameIndexRange =
+            mixxx::IndexRange::forward(
+                    remainingFrameIndexRange.start(),
+                    math_min(
+                            CachingReaderChunk::kFrames,
+                            remainingFrameIndexRange.length()));
+    mixxx::AudioSourceStereoProxy audioSourceProxy(
+            m_pAudioSource,
+            mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+    const auto readableSampleFrames =
+            audioSourceProxy.readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            nextFrameIndexRange,
+                            mixxx::SampleBuffer::WritableSlice(m_writeBuffer)));
+    if (readableSampleFrames.frameIndexRange() != nextFrameIndexRange) {
+        // Only complete tracks are cached
+        kLogger.warning()
+                << "Failed to decode samples:"
+                << "expected =" << nextFrameIndexRange
+                << ", actual =" << readableSampleFrames.frameIndexRange();
+        abort();
+        return false;
+    }
+    const qint64 bytes = readableSampleFrames.readableLength() * sizeof(CSAMPLE);
+    if (m_file.write(
+                reinterpret_cast<const char*>(readableSampleFrames.readableData()),
+                bytes) != bytes) {
+        kLogger.warning()
+                << "Failed to write file"
+                << m_file.fileName()
+                << m_file.errorString();
+        abort();
+        return false;
+    }
+    m_writtenFrameIndexRange.growBack(nextFrameIndexRange.length());
+    return true;
+}
+
+bool CachingReaderDiskCache::Writer::commit() {
+    DEBUG_ASSERT(m_file.isOpen());
+    const auto header = makeEntryHeader(
+            mixxx::audio::SignalInfo(
+                    CachingReaderChunk::kChannels,
+                    m_pAudioSource->getSignalInfo().getSampleRate(),
+                    mixxx::AudioSource::kSampleLayout),
+            m_writtenFrameIndexRange);
+    if (!m_file.seek(0) ||
+            m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) !=
+                    sizeof(header) ||
+            !m_file.flush()) {
+        abort();
+        return false;
+    }
+    // Never replaces an existing file, i.e. an entry that has been
+    // committed by another worker concurrently is kept unmodified.
+    if (!m_file.rename(m_filePath)) {
+        if (QFileInfo::exists(m_filePath)) {
+            kLogger.debug()
+                    << "Discarding duplicate entry"
+                    << m_file.fileName();
+        } else {
+            kLogger.warning()
+                    << "Failed to rename"
+                    << m_file.fileName()
+                    << "to"
+                    << m_filePath
+                    << m_file.errorString();
+        }
+        abort();
+        return false;
+    }
+    m_committed = true;
+    // Release the file handles of the decoder
+    m_pAudioSource.reset();
+    return true;
+}
+
+void CachingReaderDiskCache::Writer::abort() {
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    // The file name is only assigned after the file has been created
+    if (!m_file.fileName().isEmpty()) {
+        m_file.remove();
+    }
+    m_pAudioSource.reset();
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QDir>
+#include <QString>
+#include <QTemporaryFile>
+#include <memory>
+
+#include "preferences/usersettings.h"
+#include "sources/audiosource.h"
+#include "track/track_decl.h"
+#include "util/samplebuffer.h"
+
+// An optional, persistent cache of decoded PCM samples on disk.
+//
+// Each entry contains the complete stereo signal of a track as 32-bit
+// floats in native byte order, prefixed with a small header. Entries
+// are identified by a cache key that is derived from the track file's
+// location, size and modification time. Once available the entry is
+// memory-mapped and offered as an AudioSource, so reloading a track or
+// seeking within it doesn't require any decoding.
+//
+// Entries are written in the background by CachingReaderWorker when a
+// track is loaded that is not yet cached. The total size of all entries
+// is limited by a disk quota. Least recently used entries are evicted
+// first.
+//
+// The class itself is not thread-safe, each worker uses its own instance.
+// Multiple instances that share the same directory only coordinate through
+// the file system.
+class CachingReaderDiskCache final {
+  public:
+    static const ConfigKey kEnabledConfigKey;
+    static const ConfigKey kQuotaConfigKey;
+    static constexpr int kDefaultQuotaMB = 4096;
+
+    // Writes a single cache entry incrementally by decoding the audio
+    // source sequentially in small steps. Each writer writes into its
+    // own temporary file that is only renamed into place when complete.
+    // If another writer has already committed the same entry in the
+    // meantime the existing entry is kept and the own file discarded.
+    class Writer final {
+      public:
+        Writer(
+                const QString& filePath,
+                mixxx::AudioSourcePointer pAudioSource);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        // Decodes and writes the next portion of samples. Returns
+        // false when finished or after a failure.
+        bool writeNextFrames();
+
+        // Returns true if the entry has been written completely
+        // and is available for reading.
+        bool isCommitted() const {
+            return m_committed;
+        }
+
+      private:
+        bool open();
+        bool commit();
+        void abort();
+
+        const QString m_filePath;
+        mixxx::AudioSourcePointer m_pAudioSource;
+        QTemporaryFile m_file;
+        mixxx::SampleBuffer m_tempReadBuffer;
+        mixxx::SampleBuffer m_writeBuffer;
+        mixxx::IndexRange m_writtenFrameIndexRange;
+        bool m_committed;
+    };
+
+    explicit CachingReaderDiskCache(
+            const UserSettingsPointer& pConfig);
+
+    bool isEnabled() const {
+        return m_enabled;
+    }
+
+    // Derives the cache key from the file properties. Returns an
+    // empty string if the file is not accessible.
+    static QString cacheKeyForTrack(
+            const TrackPointer& pTrack);
+
+    // Opens a cached entry as an audio source with stereo samples.
+    // Returns nullptr on a cache miss.
+    mixxx::AudioSourcePointer openAudioSource(
+            const QString& cacheKey) const;
+
+    // Creates a writer for a new entry. The audio source must
+    // provide stereo samples and is used exclusively by the writer.
+    // Returns nullptr if the cache is disabled.
+    std::unique_ptr<Writer> createWriter(
+            const QString& cacheKey,
+            mixxx::AudioSourcePointer pAudioSource) const;
+
+    // Deletes least recently used entries until the total size
+    // of all entries fits into the quota. Partial entries of writers
+    // that are still running count against the quota. Stale partial
+    // entries that have been abandoned are deleted.
+    void evictLeastRecentlyUsed() const;
+
+  private:
+    QString filePathForCacheKey(const QString& cacheKey) const;
+
+    const bool m_enabled;
+    const qint64 m_quotaBytes;
+    const QDir m_directory;
+};
@@ -3,30 +3,190 @@
 #include <QFileInfo>
 #include <QMutexLocker>
 #include <QtDebug>
+#include <atomic>
+#include <cstdlib>
 
 #include "control/controlobject.h"
+#include "engine/cachingreader/cachingreader.h"
+#include "engine/cachingreader/cachingreaderchunkpool.h"
+#include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/compatibility.h"
 #include "util/event.h"
 #include "util/logger.h"
+#include "util/math.h"
 
 namespace {
 
 mixxx::Logger kLogger("CachingReaderWorker");
 
+// The total amount of memory occupied by decoded tracks of all workers
+std::atomic<SINT> s_decodedTrackBytes(0);
+
+// The hints for the play position only cover a few consecutive chunks.
+// Pending requests at the play position for chunks that are further
+// away from a new one belong to a position that has been left, e.g.
+// after a jump. Only requests for the audible play position are
+// compared, the virtual slip position is hinted independently.
+constexpr SINT kMaxPlayPositionChunkDistance = 2;
+
+bool isSupersededBy(
+        const CachingReaderChunkReadRequest& pendingRequest,
+        const CachingReaderChunkReadRequest& newRequest) {
+    return pendingRequest.priority == Hint::kPriorityPlayPosition &&
+            newRequest.priority == Hint::kPriorityPlayPosition &&
+            std::abs(pendingRequest.chunk->getIndex() -
+                    newRequest.chunk->getIndex()) > kMaxPlayPositionChunkDistance;
+}
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
         const QString& group,
         FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
-        FIFO<ReaderStatusUpdate>* pReaderStatusFIFO)
+        FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
+        FIFO<CachingReaderDecodedTrack*>* pReleasedDecodedTrackFIFO)
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
           m_pReaderStatusFIFO(pReaderStatusFIFO),
+          m_pReleasedDecodedTrackFIFO(pReleasedDecodedTrackFIFO),
           m_newTrackAvailable(false),
+          m_decodedTrackMaxDurationSeconds(0.0),
+          m_decodedTrackMemoryBudgetBytes(0),
           m_stop(0) {
+    // The reader limits the number of requests in flight
+    m_pendingReadRequests.reserve(
+            CachingReaderChunkPool::kMaxChunksPerReader);
+}
+
+// static
+void CachingReaderWorker::deleteDecodedTrack(
+        CachingReaderDecodedTrack* pDecodedTrack) {
+    if (!pDecodedTrack) {
+        return;
+    }
+    s_decodedTrackBytes.fetch_sub(pDecodedTrack->sizeInBytes());
+    delete pDecodedTrack;
+}
+
+// static
+SINT CachingReaderWorker::decodedTrackBytes() {
+    return s_decodedTrackBytes.load();
+}
+
+void CachingReaderWorker::deleteReleasedDecodedTracks() {
+    CachingReaderDecodedTrack* pDecodedTrack = nullptr;
+    while (m_pReleasedDecodedTrackFIFO->read(&pDecodedTrack, 1) == 1) {
+        deleteDecodedTrack(pDecodedTrack);
+    }
+}
+
+CachingReaderDecodedTrack* CachingReaderWorker::decodeTrack() {
+    DEBUG_ASSERT(m_pAudioSource);
+    if (m_decodedTrackMaxDurationSeconds <= 0 ||
+            m_decodedTrackMemoryBudgetBytes <= 0) {
+        return nullptr;
+    }
+    const auto frameIndexRange = m_pAudioSource->frameIndexRange();
+    const auto sampleRate = m_pAudioSource->getSignalInfo().getSampleRate();
+    if (frameIndexRange.length() >
+            m_decodedTrackMaxDurationSeconds * sampleRate) {
+        return nullptr;
+    }
+
+    // Reserve the memory before allocating it. Other workers might
+    // compete for the same budget concurrently.
+    const SINT sizeInBytes =
+            CachingReaderChunk::frames2samples(frameIndexRange.length()) *
+            sizeof(CSAMPLE);
+    if (s_decodedTrackBytes.fetch_add(sizeInBytes) + sizeInBytes >
+            m_decodedTrackMemoryBudgetBytes) {
+        s_decodedTrackBytes.fetch_sub(sizeInBytes);
+        kLogger.info()
+                << m_group
+                << "Memory budget for decoded tracks exhausted";
+        return nullptr;
+    }
+    auto* pDecodedTrack = new CachingReaderDecodedTrack(frameIndexRange);
+    DEBUG_ASSERT(pDecodedTrack->sizeInBytes() == sizeInBytes);
+
+    // Decode the track in pieces with the size of a chunk,
+    // because the temporary buffer is sized accordingly.
+    mixxx::AudioSourceStereoProxy audioSourceProxy(
+            m_pAudioSource,
+            mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+    auto decodedFrameIndexRange =
+            mixxx::IndexRange::forward(frameIndexRange.start(), 0);
+    while (decodedFrameIndexRange.end() < frameIndexRange.end()) {
+        if (atomicLoadAcquire(m_stop) || m_newTrackAvailable) {
+            // Abort decoding
+            deleteDecodedTrack(pDecodedTrack);
+            return nullptr;
+        }
+        const auto nextFrameIndexRange =
+                mixxx::IndexRange::forward(
+                        decodedFrameIndexRange.end(),
+                        math_min(
+                                CachingReaderChunk::kFrames,
+                                frameIndexRange.end() - decodedFrameIndexRange.end()));
+        const auto readableSampleFrames =
+                audioSourceProxy.readSampleFrames(
+                        mixxx::WritableSampleFrames(
+                                nextFrameIndexRange,
+                                pDecodedTrack->writableSlice(nextFrameIndexRange)));
+        if (readableSampleFrames.frameIndexRange() != nextFrameIndexRange) {
+            kLogger.warning()
+                    << m_group
+                    << "Failed to decode track completely:"
+                    << "expected =" << nextFrameIndexRange
+                    << ", actual =" << readableSampleFrames.frameIndexRange();
+            if (readableSampleFrames.frameIndexRange().start() ==
+                    nextFrameIndexRange.start()) {
+                decodedFrameIndexRange.growBack(
+                        readableSampleFrames.frameIndexRange().length());
+            }
+            break;
+        }
+        decodedFrameIndexRange.growBack(nextFrameIndexRange.length());
+    }
+    if (decodedFrameIndexRange.empty()) {
+        deleteDecodedTrack(pDecodedTrack);
+        return nullptr;
+    }
+    // The unused memory at the end is still accounted for and
+    // will be released together with the decoded track.
+    pDecodedTrack->shrinkFrameIndexRange(decodedFrameIndexRange);
+    return pDecodedTrack;
+}
+
+mixxx::AudioSourcePointer CachingReaderWorker::openAudioSource(
+        const TrackPointer& pTrack) {
+    DEBUG_ASSERT(!m_pDiskCacheWriter);
+    QString diskCacheKey;
+    if (m_pDiskCache && m_pDiskCache->isEnabled()) {
+        diskCacheKey = CachingReaderDiskCache::cacheKeyForTrack(pTrack);
+        auto pCachedAudioSource = m_pDiskCache->openAudioSource(diskCacheKey);
+        if (pCachedAudioSource) {
+            kLogger.debug()
+                    << m_group
+                    << "Loading decoded samples from disk cache";
+            return pCachedAudioSource;
+        }
+    }
+
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(CachingReaderChunk::kChannels);
+    auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    if (pAudioSource && !diskCacheKey.isEmpty()) {
+        // The writer needs its own audio source for decoding the
+        // track sequentially, independent of any chunk reads.
+        m_pDiskCacheWriter = m_pDiskCache->createWriter(
+                diskCacheKey,
+                SoundSourceProxy(pTrack).openAudioSource(config));
+    }
+    return pAudioSource;
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
@@ -74,6 +234,51 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
     return result;
 }
 
+void CachingReaderWorker::discardReadRequest(
+        const CachingReaderChunkReadRequest& request) {
+    const auto update = ReaderStatusUpdate::readDiscarded(request.chunk);
+    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+}
+
+void CachingReaderWorker::fetchReadRequests() {
+    CachingReaderChunkReadRequest request;
+    while (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+        // Requests with a lower priority, e.g. for cue points or the slip
+        // position, are kept.
+        // They never delay requests for the play position that are always
+        // processed first. The reader will request discarded chunks again
+        // if they are still needed.
+        auto i = m_pendingReadRequests.begin();
+        while (i != m_pendingReadRequests.end()) {
+            if (isSupersededBy(*i, request)) {
+                discardReadRequest(*i);
+                i = m_pendingReadRequests.erase(i);
+            } else {
+                ++i;
+            }
+        }
+        m_pendingReadRequests.push_back(request);
+    }
+}
+
+bool CachingReaderWorker::takeNextReadRequest(
+        CachingReaderChunkReadRequest* pRequest) {
+    fetchReadRequests();
+    if (m_pendingReadRequests.empty()) {
+        return false;
+    }
+    // Only few requests are pending, a linear search is sufficient
+    auto next = m_pendingReadRequests.begin();
+    for (auto i = next + 1; i != m_pendingReadRequests.end(); ++i) {
+        if (i->priority < next->priority) {
+            next = i;
+        }
+    }
+    *pRequest = *next;
+    m_pendingReadRequests.erase(next);
+    return true;
+}
+
 // WARNING: Always called from a different thread (GUI)
 void CachingReaderWorker::newTrack(TrackPointer pTrack) {
     {
@@ -90,8 +295,9 @@ void CachingReaderWorker::run() {
 
     Event::start(m_tag);
     while (!atomicLoadAcquire(m_stop)) {
-        // Request is initialized by reading from FIFO
+        // Request is initialized by takeNextReadRequest()
         CachingReaderChunkReadRequest request;
+        deleteReleasedDecodedTracks();
         if (m_newTrackAvailable) {
             TrackPointer pLoadTrack;
             { // locking scope
@@ -101,10 +307,21 @@ void CachingReaderWorker::run() {
                 m_newTrackAvailable = false;
             } // implicitly unlocks the mutex
             loadTrack(pLoadTrack);
-        } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+        } else if (takeNextReadRequest(&request)) {
             // Read the requested chunk and send the result
             const ReaderStatusUpdate update(processReadRequest(request));
             m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        } else if (m_pDiskCacheWriter) {
+            // Continue writing the disk cache entry while there is
+            // nothing else to do
+            if (!m_pDiskCacheWriter->writeNextFrames()) {
+                if (m_pDiskCacheWriter->isCommitted()) {
+                    m_pDiskCache->evictLeastRecentlyUsed();
+                }
+                m_pDiskCacheWriter.reset();
+            }
+            // Don't starve other threads, decoding is expensive
+            QThread::yieldCurrentThread();
         } else {
             Event::end(m_tag);
             m_semaRun.acquire();
@@ -115,14 +332,15 @@ void CachingReaderWorker::run() {
 
 void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
     // Discard all pending read requests
-    CachingReaderChunkReadRequest request;
-    while (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
-        const auto update = ReaderStatusUpdate::readDiscarded(request.chunk);
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+    fetchReadRequests();
+    for (const auto& request : m_pendingReadRequests) {
+        discardReadRequest(request);
     }
+    m_pendingReadRequests.clear();
 
     // Unload the track
     m_pAudioSource.reset(); // Close open file handles
+    m_pDiskCacheWriter.reset(); // Discard incomplete entries
 
     if (!pTrack) {
         // If no new track is available then we are done
@@ -148,9 +366,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         return;
     }
 
-    mixxx::AudioSource::OpenParams config;
-    config.setChannelCount(CachingReaderChunk::kChannels);
-    m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    m_pAudioSource = openAudioSource(pTrack);
     if (!m_pAudioSource) {
         kLogger.warning()
                 << m_group
@@ -189,6 +405,32 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
     }
 
+    const auto sampleRate = m_pAudioSource->getSignalInfo().getSampleRate();
+    const SINT frameLength = m_pAudioSource->frameLength();
+
+    // Short tracks are decoded completely into memory. The reader will
+    // then never need to request any chunks for this track.
+    CachingReaderDecodedTrack* pDecodedTrack = decodeTrack();
+    if (pDecodedTrack) {
+        kLogger.debug()
+                << m_group
+                << "Decoded track completely into memory"
+                << pDecodedTrack->frameIndexRange();
+        // The file is not needed anymore
+        const auto frameIndexRange = pDecodedTrack->frameIndexRange();
+        m_pAudioSource.reset(); // Close open file handles
+        const auto update =
+                ReaderStatusUpdate::trackLoaded(
+                        frameIndexRange,
+                        pDecodedTrack);
+        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        emit trackLoaded(
+                pTrack,
+                sampleRate,
+                CachingReaderChunk::frames2samples(frameLength));
+        return;
+    }
+
     const auto update =
             ReaderStatusUpdate::trackLoaded(
                     m_pAudioSource->frameIndexRange());
@@ -196,11 +438,10 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
 
     // Emit that the track is loaded.
     const SINT sampleCount =
-            CachingReaderChunk::frames2samples(
-                    m_pAudioSource->frameLength());
+            CachingReaderChunk::frames2samples(frameLength);
     emit trackLoaded(
             pTrack,
-            m_pAudioSource->getSignalInfo().getSampleRate(),
+            sampleRate,
             sampleCount);
 }
 
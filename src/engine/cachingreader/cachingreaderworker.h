@@ -6,8 +6,11 @@
 #include <QString>
 #include <QThread>
 #include <QtDebug>
+#include <vector>
 
 #include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreaderdecodedtrack.h"
+#include "engine/cachingreader/cachingreaderdiskcache.h"
 #include "engine/engineworker.h"
 #include "sources/audiosource.h"
 #include "track/track_decl.h"
@@ -16,10 +19,13 @@
 // POD with trivial ctor/dtor/copy for passing through FIFO
 typedef struct CachingReaderChunkReadRequest {
     CachingReaderChunk* chunk;
+    // The priority of the corresponding hint, see Hint::priority
+    int priority;
 
-    void giveToWorker(CachingReaderChunkForOwner* chunkForOwner) {
+    void giveToWorker(CachingReaderChunkForOwner* chunkForOwner, int priorityArg) {
         DEBUG_ASSERT(chunkForOwner);
         chunk = chunkForOwner;
+        priority = priorityArg;
         chunkForOwner->giveToWorker();
     }
 } CachingReaderChunkReadRequest;
@@ -37,6 +43,7 @@ enum ReaderStatus {
 typedef struct ReaderStatusUpdate {
   private:
     CachingReaderChunk* chunk;
+    CachingReaderDecodedTrack* decodedTrack;
     SINT readableFrameIndexRangeStart;
     SINT readableFrameIndexRangeEnd;
 
@@ -49,6 +56,7 @@ typedef struct ReaderStatusUpdate {
             const mixxx::IndexRange& readableFrameIndexRangeArg) {
         status = statusArg;
         chunk = chunkArg;
+        decodedTrack = nullptr;
         readableFrameIndexRangeStart = readableFrameIndexRangeArg.start();
         readableFrameIndexRangeEnd = readableFrameIndexRangeArg.end();
     }
@@ -60,11 +68,17 @@ typedef struct ReaderStatusUpdate {
         return update;
     }
 
+    // The optional decoded track is owned by the receiver of
+    // the status update.
     static ReaderStatusUpdate trackLoaded(
-            const mixxx::IndexRange& readableFrameIndexRange) {
+            const mixxx::IndexRange& readableFrameIndexRange,
+            CachingReaderDecodedTrack* pDecodedTrack = nullptr) {
         DEBUG_ASSERT(!readableFrameIndexRange.empty());
+        DEBUG_ASSERT(!pDecodedTrack ||
+                pDecodedTrack->frameIndexRange() == readableFrameIndexRange);
         ReaderStatusUpdate update;
         update.init(TRACK_LOADED, nullptr, readableFrameIndexRange);
+        update.decodedTrack = pDecodedTrack;
         return update;
     }
 
@@ -85,6 +99,12 @@ typedef struct ReaderStatusUpdate {
         return pChunk;
     }
 
+    CachingReaderDecodedTrack* takeDecodedTrack() {
+        CachingReaderDecodedTrack* pDecodedTrack = decodedTrack;
+        decodedTrack = nullptr;
+        return pDecodedTrack;
+    }
+
     mixxx::IndexRange readableFrameIndexRange() const {
         return mixxx::IndexRange::between(
                 readableFrameIndexRangeStart,
@@ -99,12 +119,39 @@ class CachingReaderWorker : public EngineWorker {
     // Construct a CachingReader with the given group.
     CachingReaderWorker(const QString& group,
             FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
-            FIFO<ReaderStatusUpdate>* pReaderStatusFIFO);
+            FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
+            FIFO<CachingReaderDecodedTrack*>* pReleasedDecodedTrackFIFO);
     ~CachingReaderWorker() override = default;
 
     // Request to load a new track. wake() must be called afterwards.
     void newTrack(TrackPointer pTrack);
 
+    // Configures which tracks are decoded completely into memory when
+    // loaded. Tracks up to the given duration qualify as long as the
+    // total memory occupied by all decoded tracks of all workers stays
+    // within the budget. Setting any of the limits to 0 disables this
+    // mode. Must be called before the worker thread is started.
+    void setDecodedTrackLimits(
+            double maxDurationSeconds,
+            SINT memoryBudgetBytes) {
+        m_decodedTrackMaxDurationSeconds = maxDurationSeconds;
+        m_decodedTrackMemoryBudgetBytes = memoryBudgetBytes;
+    }
+
+    // Enables the persistent cache of decoded samples. Must be called
+    // before the worker thread is started.
+    void setDiskCache(std::unique_ptr<CachingReaderDiskCache> pDiskCache) {
+        m_pDiskCache = std::move(pDiskCache);
+    }
+
+    // Deletes a decoded track. Must not be called from the engine thread,
+    // because it deallocates memory.
+    static void deleteDecodedTrack(CachingReaderDecodedTrack* pDecodedTrack);
+
+    // The total amount of memory that is currently occupied by the
+    // decoded tracks of all workers.
+    static SINT decodedTrackBytes();
+
     // Run upkeep operations like loading tracks and reading from file. Run by a
     // thread pool via the EngineWorkerScheduler.
     void run() override;
@@ -125,6 +172,7 @@ class CachingReaderWorker : public EngineWorker {
     // reader thread.
     FIFO<CachingReaderChunkReadRequest>* m_pChunkReadRequestFIFO;
     FIFO<ReaderStatusUpdate>* m_pReaderStatusFIFO;
+    FIFO<CachingReaderDecodedTrack*>* m_pReleasedDecodedTrackFIFO;
 
     // Queue of Tracks to load, and the corresponding lock. Must acquire the
     // lock to touch.
@@ -138,6 +186,38 @@ class CachingReaderWorker : public EngineWorker {
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
+    // Moves all requests from the FIFO into the pending requests and
+    // discards pending requests for a play position that has been left.
+    void fetchReadRequests();
+
+    // Takes the pending request with the highest priority. Requests with
+    // the same priority are processed in the order they have been received.
+    bool takeNextReadRequest(CachingReaderChunkReadRequest* pRequest);
+
+    // Discards a request and responds to the reader
+    void discardReadRequest(const CachingReaderChunkReadRequest& request);
+
+    // Requests that have been received, but not yet processed
+    std::vector<CachingReaderChunkReadRequest> m_pendingReadRequests;
+
+    // Decodes the whole track into memory if it qualifies. Returns
+    // nullptr if the track should be read chunk by chunk.
+    CachingReaderDecodedTrack* decodeTrack();
+
+    // Deletes all decoded tracks that have been released by the reader.
+    void deleteReleasedDecodedTracks();
+
+    // Opens the audio source of the track, preferably from the disk cache.
+    // Starts writing a new disk cache entry on a cache miss.
+    mixxx::AudioSourcePointer openAudioSource(const TrackPointer& pTrack);
+
+    std::unique_ptr<CachingReaderDiskCache> m_pDiskCache;
+    // Writes the disk cache entry of the current track while idle
+    std::unique_ptr<CachingReaderDiskCache::Writer> m_pDiskCacheWriter;
+
+    double m_decodedTrackMaxDurationSeconds;
+    SINT m_decodedTrackMemoryBudgetBytes;
+
     // The current audio source of the track loaded
     mixxx::AudioSourcePointer m_pAudioSource;
 
@@ -0,0 +1,190 @@
+#include "engine/channelmixer.h"
+
+#include <array>
+#include <utility>
+
+#include "util/sample.h"
+
+namespace {
+
+// The number of samples that are mixed at once when more than
+// kMaxChannelsPerPass channels are active. The output block and the
+// corresponding blocks of all buffers of a single pass must fit into
+// the L1 cache: (1 + 8) * 512 * 4 bytes = 18 KiB
+constexpr SINT kSamplesPerBlock = 512;
+
+// pOutput[i] (+)= pBuffer0[i] + pBuffer1[i] + ... + pBufferN[i]
+//
+// The buffers are passed as individual restricted pointers, allowing the
+// compiler to vectorize the loop without runtime alias checks. The left
+// fold preserves the summation order of the previously generated code.
+template<bool kAccumulate, typename... Samples>
+inline void sumBuffers(CSAMPLE* M_RESTRICT pOutput,
+        SINT numSamples,
+        const Samples* M_RESTRICT... pBuffers) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        const CSAMPLE sum = (... + pBuffers[i]);
+        if (kAccumulate) {
+            pOutput[i] += sum;
+        } else {
+            pOutput[i] = sum;
+        }
+    }
+}
+
+template<bool kAccumulate, std::size_t... Is>
+inline void sumBlock(CSAMPLE* pOutput,
+        const CSAMPLE* const* ppBuffers,
+        SINT offset,
+        SINT numSamples,
+        std::index_sequence<Is...>) {
+    sumBuffers<kAccumulate>(
+            pOutput + offset, numSamples, (ppBuffers[Is] + offset)...);
+}
+
+template<bool kAccumulate, std::size_t kNumBuffers>
+void sumBlockOf(CSAMPLE* pOutput,
+        const CSAMPLE* const* ppBuffers,
+        SINT offset,
+        SINT numSamples) {
+    sumBlock<kAccumulate>(pOutput,
+            ppBuffers,
+            offset,
+            numSamples,
+            std::make_index_sequence<kNumBuffers>());
+}
+
+typedef void (*SumBlockFunction)(CSAMPLE* pOutput,
+        const CSAMPLE* const* ppBuffers,
+        SINT offset,
+        SINT numSamples);
+
+// Dispatch table indexed by the number of buffers - 1
+template<bool kAccumulate, std::size_t... Is>
+constexpr std::array<SumBlockFunction, sizeof...(Is)> makeSumBlockFunctions(
+        std::index_sequence<Is...>) {
+    return {{&sumBlockOf<kAccumulate, Is + 1>...}};
+}
+
+constexpr auto kAssignSumFunctions = makeSumBlockFunctions<false>(
+        std::make_index_sequence<ChannelMixer::kMaxChannelsPerPass>());
+constexpr auto kAccumulateSumFunctions = makeSumBlockFunctions<true>(
+        std::make_index_sequence<ChannelMixer::kMaxChannelsPerPass>());
+
+// Returns the gain that should be reached at the end of this callback
+// and updates the cache for the next callback.
+inline CSAMPLE_GAIN updateGain(
+        const EngineMaster::GainCalculator& gainCalculator,
+        EngineMaster::ChannelInfo* pChannelInfo,
+        EngineMaster::GainCache* pGainCache) {
+    CSAMPLE_GAIN newGain;
+    if (pGainCache->m_fadeout) {
+        newGain = 0;
+        pGainCache->m_fadeout = false;
+    } else {
+        newGain = gainCalculator.getGain(pChannelInfo);
+    }
+    pGainCache->m_gain = newGain;
+    return newGain;
+}
+
+} // anonymous namespace
+
+// static
+void ChannelMixer::applyEffectsAndMixChannels(const EngineMaster::GainCalculator& gainCalculator,
+        QVarLengthArray<EngineMaster::ChannelInfo*, kPreallocatedChannels>* activeChannels,
+        QVarLengthArray<EngineMaster::GainCache, kPreallocatedChannels>* channelGainCache,
+        CSAMPLE* pOutput,
+        const ChannelHandle& outputHandle,
+        unsigned int iBufferSize,
+        unsigned int iSampleRate,
+        EngineEffectsManager* pEngineEffectsManager) {
+    // Signal flow overview:
+    // 1. Clear pOutput buffer
+    // 2. Calculate gains for each channel
+    // 3. Pass each channel's calculated gain and input buffer to pEngineEffectsManager, which then:
+    //     A) Copies each channel input buffer to a temporary buffer
+    //     B) Applies gain to the temporary buffer
+    //     C) Processes effects on the temporary buffer
+    //     D) Mixes the temporary buffer into pOutput
+    // The original channel input buffers are not modified.
+    SampleUtil::clear(pOutput, iBufferSize);
+    for (EngineMaster::ChannelInfo* pChannelInfo : *activeChannels) {
+        EngineMaster::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
+        const CSAMPLE_GAIN oldGain = gainCache.m_gain;
+        const CSAMPLE_GAIN newGain = updateGain(gainCalculator, pChannelInfo, &gainCache);
+        pEngineEffectsManager->processPostFaderAndMix(pChannelInfo->m_handle,
+                outputHandle,
+                pChannelInfo->m_pBuffer,
+                pOutput,
+                iBufferSize,
+                iSampleRate,
+                pChannelInfo->m_features,
+                oldGain,
+                newGain);
+    }
+}
+
+// static
+void ChannelMixer::applyEffectsInPlaceAndMixChannels(const EngineMaster::GainCalculator& gainCalculator,
+        QVarLengthArray<EngineMaster::ChannelInfo*, kPreallocatedChannels>* activeChannels,
+        QVarLengthArray<EngineMaster::GainCache, kPreallocatedChannels>* channelGainCache,
+        CSAMPLE* pOutput,
+        const ChannelHandle& outputHandle,
+        unsigned int iBufferSize,
+        unsigned int iSampleRate,
+        EngineEffectsManager* pEngineEffectsManager) {
+    // Signal flow overview:
+    // 1. Calculate gains for each channel
+    // 2. Pass each channel's calculated gain and input buffer to pEngineEffectsManager, which then:
+    //    A) Applies the calculated gain to the channel buffer, modifying the original input buffer
+    //    B) Applies effects to the buffer, modifying the original input buffer
+    // 3. Mix the channel buffers together to make pOutput, overwriting the pOutput buffer from the last engine callback
+    QVarLengthArray<const CSAMPLE*, kPreallocatedChannels> buffers;
+    for (EngineMaster::ChannelInfo* pChannelInfo : *activeChannels) {
+        EngineMaster::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
+        const CSAMPLE_GAIN oldGain = gainCache.m_gain;
+        const CSAMPLE_GAIN newGain = updateGain(gainCalculator, pChannelInfo, &gainCache);
+        pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
+                outputHandle,
+                pChannelInfo->m_pBuffer,
+                iBufferSize,
+                iSampleRate,
+                pChannelInfo->m_features,
+                oldGain,
+                newGain);
+        buffers.append(pChannelInfo->m_pBuffer);
+    }
+    mixChannelBuffers(pOutput, buffers.constData(), buffers.size(), iBufferSize);
+}
+
+// static
+void ChannelMixer::mixChannelBuffers(
+        CSAMPLE* pOutput,
+        const CSAMPLE* const* ppBuffers,
+        int numBuffers,
+        SINT numSamples) {
+    if (numBuffers <= 0) {
+        SampleUtil::clear(pOutput, numSamples);
+        return;
+    }
+    if (numBuffers <= kMaxChannelsPerPass) {
+        // Common case: A single pass over all samples
+        kAssignSumFunctions[numBuffers - 1](pOutput, ppBuffers, 0, numSamples);
+        return;
+    }
+    // Sum up kMaxChannelsPerPass buffers per pass and block by block. The
+    // output block stays in the cache between subsequent passes.
+    for (SINT offset = 0; offset < numSamples; offset += kSamplesPerBlock) {
+        const SINT blockSamples = math_min(kSamplesPerBlock, numSamples - offset);
+        kAssignSumFunctions[kMaxChannelsPerPass - 1](
+                pOutput, ppBuffers, offset, blockSamples);
+        for (int channel = kMaxChannelsPerPass; channel < numBuffers;
+                channel += kMaxChannelsPerPass) {
+            const int passBuffers = math_min(kMaxChannelsPerPass, numBuffers - channel);
+            kAccumulateSumFunctions[passBuffers - 1](
+                    pOutput, ppBuffers + channel, offset, blockSamples);
+        }
+    }
+}
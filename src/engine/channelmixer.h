@@ -29,6 +29,19 @@ class ChannelMixer {
         unsigned int iBufferSize,
         unsigned int iSampleRate,
         EngineEffectsManager* pEngineEffectsManager);
+
+    // Sums the buffers sample by sample and overwrites pOutput with the
+    // result. The summation is specialized at compile time for up to
+    // kMaxChannelsPerPass buffers. Larger counts are accumulated in
+    // blocks that stay in the cache, so that each cache line of pOutput
+    // is only written once.
+    static void mixChannelBuffers(
+        CSAMPLE* pOutput,
+        const CSAMPLE* const* ppBuffers,
+        int numBuffers,
+        SINT numSamples);
+
+    static constexpr int kMaxChannelsPerPass = 8;
 };
 
 #endif /* CHANNELMIXER_H */
@@ -0,0 +1,250 @@
+#include "engine/channelprocessingpool.h"
+
+#include <QtDebug>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/math.h"
+
+namespace {
+
+const mixxx::Logger kLogger("ChannelProcessingPool");
+
+constexpr int kNextTaskBits = 16;
+constexpr int kNumTasksBits = 16;
+constexpr std::uint64_t kTaskMask = (std::uint64_t(1) << kNextTaskBits) - 1;
+constexpr int kMaxTasks = static_cast<int>(kTaskMask);
+
+inline std::uint64_t packTaskState(
+        std::uint32_t generation, int numTasks, int nextTask) {
+    return (std::uint64_t(generation) << (kNumTasksBits + kNextTaskBits)) |
+            (std::uint64_t(numTasks) << kNextTaskBits) |
+            std::uint64_t(nextTask);
+}
+
+inline int nextTaskOf(std::uint64_t taskState) {
+    return static_cast<int>(taskState & kTaskMask);
+}
+
+inline int numTasksOf(std::uint64_t taskState) {
+    return static_cast<int>((taskState >> kNextTaskBits) & kTaskMask);
+}
+
+// Hint for the CPU that we are busy waiting, without giving up the
+// time slice of the real-time thread.
+inline void spinPause() {
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+void pinCurrentThreadToCpu(int cpu) {
+#if defined(__linux__)
+    const long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (numCpus <= 1) {
+        return;
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu % numCpus, &cpuSet);
+    const int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (result != 0) {
+        kLogger.warning() << "Failed to pin worker thread to CPU" << cpu << result;
+    }
+#elif defined(_WIN32)
+    DWORD_PTR processMask;
+    DWORD_PTR systemMask;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        return;
+    }
+    // Select the n-th CPU that is available for this process
+    int remaining = cpu;
+    for (int bit = 0; bit < static_cast<int>(sizeof(DWORD_PTR) * 8); ++bit) {
+        const DWORD_PTR mask = DWORD_PTR(1) << bit;
+        if ((processMask & mask) && remaining-- == 0) {
+            SetThreadAffinityMask(GetCurrentThread(), mask);
+            return;
+        }
+    }
+#else
+    // Pinning threads is not supported on macOS
+    Q_UNUSED(cpu);
+#endif
+}
+
+} // anonymous namespace
+
+// static
+const ConfigKey ChannelProcessingPool::kNumWorkerThreadsConfigKey =
+        ConfigKey("[Master]", "ChannelProcessingThreads");
+
+ChannelProcessingPool::ChannelProcessingPool(int numWorkerThreads)
+        : m_taskState(packTaskState(0, 0, 0)),
+          m_generation(0),
+          m_pJob(nullptr),
+          m_pendingTasks(0),
+          m_quit(false),
+          m_schedulingPolicyCaptured(false),
+          m_schedulingGeneration(0),
+          m_schedulingPolicy(0),
+          m_schedulingPriority(0),
+          m_engineThreadTimer("ChannelProcessingPool engine thread"),
+          m_waitTimer("ChannelProcessingPool wait for workers") {
+    numWorkerThreads = math_clamp(numWorkerThreads, 0, kMaxWorkerThreads);
+    kLogger.info() << "Starting" << numWorkerThreads << "worker threads";
+    m_workers.reserve(numWorkerThreads);
+    for (int i = 0; i < numWorkerThreads; ++i) {
+        Worker* pWorker = new Worker(this, i);
+        pWorker->start(QThread::TimeCriticalPriority);
+        m_workers.push_back(pWorker);
+    }
+}
+
+ChannelProcessingPool::~ChannelProcessingPool() {
+    m_quit.store(true);
+    m_semaWork.release(static_cast<int>(m_workers.size()));
+    for (Worker* pWorker : m_workers) {
+        pWorker->wait();
+        delete pWorker;
+    }
+}
+
+void ChannelProcessingPool::run(Job* pJob, int numTasks) {
+    VERIFY_OR_DEBUG_ASSERT(numTasks <= kMaxTasks) {
+        numTasks = kMaxTasks;
+    }
+    if (numTasks <= 0) {
+        return;
+    }
+    if (m_workers.empty() || numTasks == 1) {
+        // Waking up a worker would only add latency
+        for (int i = 0; i < numTasks; ++i) {
+            pJob->runTask(i);
+        }
+        return;
+    }
+    if (!m_schedulingPolicyCaptured) {
+        captureSchedulingPolicy();
+    }
+
+    m_pJob = pJob;
+    m_pendingTasks.store(numTasks, std::memory_order_relaxed);
+    // Publishes the job and the pending tasks to the workers
+    m_taskState.store(
+            packTaskState(++m_generation, numTasks, 0),
+            std::memory_order_release);
+    // The engine thread processes tasks as well. QSemaphore may acquire
+    // a mutex internally, but only for a short critical section that
+    // never waits for a worker.
+    m_semaWork.release(math_min(numTasks - 1, static_cast<int>(m_workers.size())));
+
+    m_engineThreadTimer.start();
+    if (runTasks() > 0) {
+        m_engineThreadTimer.elapsed(true);
+    }
+
+    // Barrier: Spin until all tasks that have been claimed by workers
+    // are finished. Only the workers that are busy with the last tasks
+    // are still running at this point.
+    m_waitTimer.start();
+    while (m_pendingTasks.load(std::memory_order_acquire) > 0) {
+        spinPause();
+    }
+    m_waitTimer.elapsed(true);
+}
+
+int ChannelProcessingPool::runTasks() {
+    int numTasksRun = 0;
+    std::uint64_t taskState = m_taskState.load(std::memory_order_acquire);
+    while (nextTaskOf(taskState) < numTasksOf(taskState)) {
+        // The generation in the upper bits guarantees that the exchange
+        // fails if the job has already been finished and replaced
+        if (m_taskState.compare_exchange_weak(taskState,
+                    taskState + 1,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire)) {
+            m_pJob->runTask(nextTaskOf(taskState));
+            ++numTasksRun;
+            m_pendingTasks.fetch_sub(1, std::memory_order_release);
+            taskState = m_taskState.load(std::memory_order_acquire);
+        }
+    }
+    return numTasksRun;
+}
+
+void ChannelProcessingPool::captureSchedulingPolicy() {
+    m_schedulingPolicyCaptured = true;
+#if defined(__linux__)
+    int policy;
+    struct sched_param param;
+    if (pthread_getschedparam(pthread_self(), &policy, &param) != 0) {
+        return;
+    }
+    if (policy != SCHED_FIFO && policy != SCHED_RR) {
+        // The workers keep their time critical Qt priority
+        return;
+    }
+    m_schedulingPolicy.store(policy, std::memory_order_relaxed);
+    m_schedulingPriority.store(param.sched_priority, std::memory_order_relaxed);
+    m_schedulingGeneration.fetch_add(1, std::memory_order_release);
+#endif
+}
+
+ChannelProcessingPool::Worker::Worker(ChannelProcessingPool* pPool, int index)
+        : m_pPool(pPool),
+          m_index(index),
+          m_timer(QString("ChannelProcessingPool worker %1").arg(index)),
+          m_schedulingGeneration(0) {
+}
+
+void ChannelProcessingPool::Worker::run() {
+    QThread::currentThread()->setObjectName(
+            QString("ChannelProcessingPool %1").arg(m_index));
+    // The engine thread usually runs on the first CPU
+    pinCurrentThreadToCpu(m_index + 1);
+
+    while (true) {
+        m_pPool->m_semaWork.acquire();
+        if (m_pPool->m_quit.load()) {
+            break;
+        }
+        if (m_schedulingGeneration !=
+                m_pPool->m_schedulingGeneration.load(std::memory_order_acquire)) {
+            adoptSchedulingPolicy();
+        }
+        m_timer.start();
+        if (m_pPool->runTasks() > 0) {
+            m_timer.elapsed(true);
+        }
+    }
+}
+
+void ChannelProcessingPool::Worker::adoptSchedulingPolicy() {
+    m_schedulingGeneration =
+            m_pPool->m_schedulingGeneration.load(std::memory_order_acquire);
+#if defined(__linux__)
+    struct sched_param param;
+    param.sched_priority =
+            m_pPool->m_schedulingPriority.load(std::memory_order_relaxed);
+    const int policy = m_pPool->m_schedulingPolicy.load(std::memory_order_relaxed);
+    const int result = pthread_setschedparam(pthread_self(), policy, &param);
+    if (result != 0) {
+        kLogger.warning() << "Failed to adopt the scheduling policy of the engine thread"
+                          << result;
+    }
+#endif
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "preferences/usersettings.h"
+#include "util/timer.h"
+
+// A pool of real-time worker threads that processes independent tasks
+// of the engine callback in parallel, e.g. the active channels in
+// EngineMaster::processChannels.
+//
+// The calling thread distributes the tasks of a job among the workers
+// and itself and returns when all tasks have been finished. Tasks are
+// claimed and completed through atomic counters, the calling thread
+// never blocks on a mutex while waiting for the workers. Idle workers
+// sleep on a semaphore until the next job is started.
+//
+// No memory is allocated while running jobs. The workers run with time
+// critical priority. On Linux each worker is pinned to a dedicated CPU
+// core and adopts the real-time scheduling policy of the audio callback
+// thread.
+//
+// The time each thread spends on processing tasks is reported to the
+// StatsManager.
+class ChannelProcessingPool final {
+  public:
+    // The work that is distributed among the threads. The tasks of a
+    // job must be independent of each other.
+    class Job {
+      public:
+        virtual ~Job() = default;
+        virtual void runTask(int taskIndex) = 0;
+    };
+
+    // The number of worker threads in addition to the engine thread.
+    // 0 disables parallel processing.
+    static const ConfigKey kNumWorkerThreadsConfigKey;
+    static constexpr int kMaxWorkerThreads = 15;
+
+    explicit ChannelProcessingPool(int numWorkerThreads);
+    ~ChannelProcessingPool();
+
+    ChannelProcessingPool(const ChannelProcessingPool&) = delete;
+    ChannelProcessingPool& operator=(const ChannelProcessingPool&) = delete;
+
+    int numWorkerThreads() const {
+        return static_cast<int>(m_workers.size());
+    }
+
+    // Runs all tasks of the job and returns when they are finished. Must
+    // only be called from a single thread, i.e. the engine thread.
+    void run(Job* pJob, int numTasks);
+
+  private:
+    class Worker final : public QThread {
+      public:
+        Worker(ChannelProcessingPool* pPool, int index);
+
+      protected:
+        void run() override;
+
+      private:
+        void adoptSchedulingPolicy();
+
+        ChannelProcessingPool* const m_pPool;
+        const int m_index;
+        Timer m_timer;
+        int m_schedulingGeneration;
+    };
+
+    // Claims and runs tasks of the current job until none are left.
+    // Returns the number of tasks that have been run.
+    int runTasks();
+
+    void captureSchedulingPolicy();
+
+    std::vector<Worker*> m_workers;
+
+    // Bit layout: generation (32 bits) | numTasks (16 bits) | nextTask (16 bits)
+    // The generation prevents that a worker that has been woken up late
+    // claims a task of a subsequent job with a stale state.
+    std::atomic<std::uint64_t> m_taskState;
+    std::uint32_t m_generation;
+    // Only modified before publishing m_taskState
+    Job* m_pJob;
+    std::atomic<int> m_pendingTasks;
+
+    QSemaphore m_semaWork;
+    std::atomic<bool> m_quit;
+
+    // Scheduling policy of the engine thread that is adopted by
+    // the workers
+    bool m_schedulingPolicyCaptured;
+    std::atomic<int> m_schedulingGeneration;
+    std::atomic<int> m_schedulingPolicy;
+    std::atomic<int> m_schedulingPriority;
+
+    Timer m_engineThreadTimer;
+    Timer m_waitTimer;
+};
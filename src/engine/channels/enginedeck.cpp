@@ -15,7 +15,8 @@ EngineDeck::EngineDeck(
         EngineMaster* pMixingEngine,
         EffectsManager* pEffectsManager,
         EngineChannel::ChannelOrientation defaultOrientation,
-        bool primaryDeck)
+        bool primaryDeck,
+        bool lightweight)
         : EngineChannel(handleGroup, defaultOrientation, pEffectsManager,
                   /*isTalkoverChannel*/ false,
                   primaryDeck),
@@ -38,7 +39,7 @@ EngineDeck::EngineDeck(
             Qt::DirectConnection);
 
     m_pPregain = new EnginePregain(getGroup());
-    m_pBuffer = new EngineBuffer(getGroup(), pConfig, this, pMixingEngine);
+    m_pBuffer = new EngineBuffer(getGroup(), pConfig, this, pMixingEngine, lightweight);
 }
 
 EngineDeck::~EngineDeck() {
@@ -28,7 +28,8 @@ class EngineDeck : public EngineChannel, public AudioDestination {
             EngineMaster* pMixingEngine,
             EffectsManager* pEffectsManager,
             EngineChannel::ChannelOrientation defaultOrientation,
-            bool primaryDeck);
+            bool primaryDeck,
+            bool lightweight = false);
     virtual ~EngineDeck();
 
     virtual void process(CSAMPLE* pOutput, const int iBufferSize);
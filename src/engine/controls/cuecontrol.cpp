@@ -1169,7 +1169,7 @@ void CueControl::hintReader(HintVector* pHintList) {
     if (cuePoint >= 0) {
         cue_hint.frame = SampleUtil::floorPlayPosToFrame(m_pCuePoint->get());
         cue_hint.frameCount = Hint::kFrameCountForward;
-        cue_hint.priority = 10;
+        cue_hint.priority = Hint::kPriorityCue;
         pHintList->append(cue_hint);
     }
 
@@ -1181,7 +1181,7 @@ void CueControl::hintReader(HintVector* pHintList) {
         if (position != Cue::kNoPosition) {
             cue_hint.frame = SampleUtil::floorPlayPosToFrame(position);
             cue_hint.frameCount = Hint::kFrameCountForward;
-            cue_hint.priority = 10;
+            cue_hint.priority = Hint::kPriorityCue;
             pHintList->append(cue_hint);
         }
     }
@@ -56,7 +56,8 @@ const SINT kSamplesPerFrame = 2; // Engine buffer uses Stereo frames only
 EngineBuffer::EngineBuffer(const QString& group,
         UserSettingsPointer pConfig,
         EngineChannel* pChannel,
-        EngineMaster* pMixingEngine)
+        EngineMaster* pMixingEngine,
+        bool lightweight)
         : m_group(group),
           m_pConfig(pConfig),
           m_pLoopingControl(nullptr),
@@ -83,6 +84,8 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_pRepeat(nullptr),
           m_startButton(nullptr),
           m_endButton(nullptr),
+          m_pScaleST(nullptr),
+          m_pScaleRB(nullptr),
           m_bScalerOverride(false),
           m_iSeekQueued(SEEK_NONE),
           m_iSeekPhaseQueued(0),
@@ -91,13 +94,10 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_iTrackLoading(0),
           m_bPlayAfterLoading(false),
           m_iSampleRate(0),
-          m_pCrossfadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
+          m_pCrossfadeBuffer(nullptr),
           m_bCrossfadeReady(false),
           m_iLastBufferSize(0) {
-    // zero out crossfade buffer
-    SampleUtil::clear(m_pCrossfadeBuffer, MAX_BUFFER_LEN);
-
-    m_pReader = new CachingReader(group, pConfig);
+    m_pReader = new CachingReader(group, pConfig, lightweight);
     connect(m_pReader, &CachingReader::trackLoading,
             this, &EngineBuffer::slotTrackLoading,
             Qt::DirectConnection);
@@ -254,12 +254,10 @@ EngineBuffer::EngineBuffer(const QString& group,
 
     // Construct scaling objects
     m_pScaleLinear = new EngineBufferScaleLinear(m_pReadAheadManager);
-    m_pScaleST = new EngineBufferScaleST(m_pReadAheadManager);
-    m_pScaleRB = new EngineBufferScaleRubberBand(m_pReadAheadManager);
-    if (m_pKeylockEngine->get() == SOUNDTOUCH) {
-        m_pScaleKeylock = m_pScaleST;
-    } else {
-        m_pScaleKeylock = m_pScaleRB;
+    // Replaced by the configured keylock scaler when allocated
+    m_pScaleKeylock = m_pScaleLinear;
+    if (!lightweight) {
+        allocateScalers();
     }
     m_pScaleVinyl = m_pScaleLinear;
     m_pScale = m_pScaleVinyl;
@@ -324,6 +322,33 @@ void EngineBuffer::bindWorkers(EngineWorkerScheduler* pWorkerScheduler) {
     m_pReader->setScheduler(pWorkerScheduler);
 }
 
+void EngineBuffer::allocateScalers() {
+    if (m_pScaleST) {
+        return;
+    }
+    // Allocate the buffers of the time stretchers without holding the
+    // pause lock, this takes a while.
+    auto pScaleST = new EngineBufferScaleST(m_pReadAheadManager);
+    auto pScaleRB = new EngineBufferScaleRubberBand(m_pReadAheadManager);
+    const auto sampleRate = mixxx::audio::SampleRate(
+            static_cast<int>(m_pSampleRate->get()));
+    if (sampleRate.isValid()) {
+        // Prevent re-allocations in the engine thread
+        pScaleST->setSampleRate(sampleRate);
+        pScaleRB->setSampleRate(sampleRate);
+    }
+    CSAMPLE* pCrossfadeBuffer = SampleUtil::alloc(MAX_BUFFER_LEN);
+    SampleUtil::clear(pCrossfadeBuffer, MAX_BUFFER_LEN);
+
+    m_pause.lock();
+    m_pScaleST = pScaleST;
+    m_pScaleRB = pScaleRB;
+    m_pCrossfadeBuffer = pCrossfadeBuffer;
+    m_pause.unlock();
+
+    slotKeylockEngineChanged(m_pKeylockEngine->get());
+}
+
 void EngineBuffer::enableIndependentPitchTempoScaling(bool bEnable,
                                                       const int iBufferSize) {
     // MUST ACQUIRE THE PAUSE MUTEX BEFORE CALLING THIS METHOD
@@ -442,7 +467,9 @@ void EngineBuffer::requestClonePosition(EngineChannel* pChannel) {
 }
 
 void EngineBuffer::readToCrossfadeBuffer(const int iBufferSize) {
-    if (!m_bCrossfadeReady) {
+    // Lightweight buffers allocate the crossfade buffer together with the
+    // first track. Before there is nothing to crossfade from.
+    if (!m_bCrossfadeReady && m_pCrossfadeBuffer) {
         // Read buffer, as if there where no parameter change
         // (Must be called only once per callback)
         m_pScale->scaleBuffer(m_pCrossfadeBuffer, iBufferSize);
@@ -516,6 +543,7 @@ void EngineBuffer::slotTrackLoading() {
 }
 
 void EngineBuffer::loadFakeTrack(TrackPointer pTrack, bool bPlay) {
+    allocateScalers();
     if (bPlay) {
         m_playButton->set((double)bPlay);
     }
@@ -759,7 +787,8 @@ void EngineBuffer::slotControlStop(double v)
 }
 
 void EngineBuffer::slotKeylockEngineChanged(double dIndex) {
-    if (m_bScalerOverride) {
+    if (m_bScalerOverride || !m_pScaleST) {
+        // The keylock scaler is selected when allocated
         return;
     }
     // static_cast<KeylockEngine>(dIndex); direct cast produces a "not used" warning with gcc
@@ -784,9 +813,6 @@ void EngineBuffer::processTrackLocked(
         baserate = m_trackSampleRateOld / sample_rate;
     }
 
-    // Sync requests can affect rate, so process those first.
-    processSyncRequests();
-
     // Note: play is also active during cue preview
     bool paused = !m_playButton->toBool();
     KeyControl::PitchTempoRatio pitchTempoRatio = m_pKeyControl->getPitchTempoRatio();
@@ -1103,11 +1129,15 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
     // We do this even if rubberband is not active.
     const auto sampleRate = mixxx::audio::SampleRate(m_iSampleRate);
     m_pScaleLinear->setSampleRate(sampleRate);
-    m_pScaleST->setSampleRate(sampleRate);
-    m_pScaleRB->setSampleRate(sampleRate);
 
     bool bTrackLoading = atomicLoadRelaxed(m_iTrackLoading) != 0;
     if (!bTrackLoading && m_pause.tryLock()) {
+        // Lightweight buffers allocate the keylock scalers together with
+        // the first track, so they always exist while a track is loaded.
+        if (m_pScaleST) {
+            m_pScaleST->setSampleRate(sampleRate);
+            m_pScaleRB->setSampleRate(sampleRate);
+        }
         processTrackLocked(pOutput, iBufferSize, m_iSampleRate);
         // release the pauselock
         m_pause.unlock();
@@ -1174,6 +1204,27 @@ void EngineBuffer::processSlip(int iBufferSize) {
     }
 }
 
+void EngineBuffer::processSharedRequests() {
+    // The requests are kept until a track has been loaded
+    bool bTrackLoading = atomicLoadRelaxed(m_iTrackLoading) != 0;
+    if (bTrackLoading || !m_pause.tryLock()) {
+        return;
+    }
+    // Sync requests can affect rate, so process those first.
+    processSyncRequests();
+    // Check if we are cloning another channel before doing any seeking.
+    // The seek is then processed together with all other seeks.
+    EngineChannel* pChannel = m_pChannelToCloneFrom.fetchAndStoreRelaxed(nullptr);
+    if (pChannel) {
+        seekCloneBuffer(pChannel->getEngineBuffer());
+    }
+    m_pause.unlock();
+}
+
+bool EngineBuffer::isSynchronized() const {
+    return m_pSyncControl->isSynchronized();
+}
+
 void EngineBuffer::processSyncRequests() {
     SyncRequestQueued enable_request =
             static_cast<SyncRequestQueued>(
@@ -1201,12 +1252,6 @@ void EngineBuffer::processSyncRequests() {
 }
 
 void EngineBuffer::processSeek(bool paused) {
-    // Check if we are cloning another channel before doing any seeking.
-    EngineChannel* pChannel = m_pChannelToCloneFrom.fetchAndStoreRelaxed(nullptr);
-    if (pChannel) {
-        seekCloneBuffer(pChannel->getEngineBuffer());
-    }
-
     // We need to read position just after reading seekType, to ensure that we
     // read the matching position to seek_typ or a position from a new (second)
     // seek just queued from another thread
@@ -1355,7 +1400,7 @@ void EngineBuffer::hintReader(const double dRate) {
     if (m_bSlipEnabledProcessing) {
         Hint hint;
         hint.frame = SampleUtil::floorPlayPosToFrame(m_dSlipPosition);
-        hint.priority = 1;
+        hint.priority = Hint::kPrioritySlipPosition;
         if (m_dSlipRate >= 0) {
             hint.frameCount = Hint::kFrameCountForward;
         } else {
@@ -1373,6 +1418,7 @@ void EngineBuffer::hintReader(const double dRate) {
 // WARNING: This method runs in the GUI thread
 void EngineBuffer::loadTrack(TrackPointer pTrack, bool play) {
     if (pTrack) {
+        allocateScalers();
         // Signal to the reader to load the track. The reader will respond with
         // trackLoading and then either with trackLoaded or trackLoadFailed signals.
         m_bPlayAfterLoading = play;
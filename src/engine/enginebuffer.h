@@ -111,8 +111,15 @@ class EngineBuffer : public EngineObject {
         KEYLOCK_ENGINE_COUNT,
     };
 
+    // Lightweight buffers, e.g. of samplers, allocate the time stretching
+    // scalers and the crossfade buffer when the first track is loaded and
+    // use a lightweight CachingReader that only starts its worker thread
+    // then. The EngineControls are created up front like for decks,
+    // because they own the controls of the group that skins and
+    // controller mappings bind to.
     EngineBuffer(const QString& group, UserSettingsPointer pConfig,
-                 EngineChannel* pChannel, EngineMaster* pMixingEngine);
+                 EngineChannel* pChannel, EngineMaster* pMixingEngine,
+                 bool lightweight = false);
     virtual ~EngineBuffer();
 
     void bindWorkers(EngineWorkerScheduler* pWorkerScheduler);
@@ -141,6 +148,16 @@ class EngineBuffer : public EngineObject {
     void requestClonePosition(EngineChannel* pChannel);
 
     // The process methods all run in the audio callback.
+
+    // Processes the queued requests that access the state of EngineSync
+    // or of other channels, i.e. for enabling sync, changing the sync mode
+    // and cloning the play position of another deck. Called by EngineMaster
+    // for all active channels before any channel is processed.
+    void processSharedRequests();
+    // Decks that take part in sync modify the shared state of EngineSync
+    // while being processed.
+    bool isSynchronized() const;
+
     void process(CSAMPLE* pOut, const int iBufferSize);
     void processSlip(int iBufferSize);
     void postProcess(const int iBufferSize);
@@ -220,6 +237,10 @@ class EngineBuffer : public EngineObject {
     void enableIndependentPitchTempoScaling(bool bEnable,
                                             const int iBufferSize);
 
+    // Allocates the keylock scalers and the crossfade buffer if this has
+    // not been done yet. Must not be called from the engine thread.
+    void allocateScalers();
+
     void updateIndicators(double rate, int iBufferSize);
 
     void hintReader(const double rate);
@@ -271,6 +292,7 @@ class EngineBuffer : public EngineObject {
     FRIEND_TEST(EngineSyncTest, UserTweakPreservedInSeek);
     FRIEND_TEST(EngineSyncTest, BeatMapQantizePlay);
     FRIEND_TEST(EngineBufferTest, ScalerNoTransport);
+    FRIEND_TEST(LightweightSamplerTest, StartReaderOnFirstLoad);
     EngineSync* m_pEngineSync;
     SyncControl* m_pSyncControl;
     VinylControlControl* m_pVinylControlControl;
@@ -387,7 +409,9 @@ class EngineBuffer : public EngineObject {
 
     // Object used for vinyl-style interpolation scaling of the audio
     EngineBufferScaleLinear* m_pScaleLinear;
-    // Objects used for pitch-indep time stretch (key lock) scaling of the audio
+    // Objects used for pitch-indep time stretch (key lock) scaling of the audio.
+    // Only accessed while holding m_pause, because they are allocated on
+    // demand by lightweight buffers.
     EngineBufferScaleST* m_pScaleST;
     EngineBufferScaleRubberBand* m_pScaleRB;
 
@@ -417,7 +441,8 @@ class EngineBuffer : public EngineObject {
 #endif
 
     // Certain operations like seeks and engine changes need to be crossfaded
-    // to eliminate clicks and pops.
+    // to eliminate clicks and pops. Null for lightweight buffers until the
+    // first track is loaded, only accessed while holding m_pause.
     CSAMPLE* m_pCrossfadeBuffer;
     bool m_bCrossfadeReady;
     int m_iLastBufferSize;
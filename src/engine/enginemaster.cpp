@@ -11,6 +11,7 @@
 #include "control/controlpushbutton.h"
 #include "effects/effectsmanager.h"
 #include "engine/channelmixer.h"
+#include "engine/channelprocessingpool.h"
 #include "engine/effects/engineeffectsmanager.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginebuffer.h"
@@ -28,6 +29,7 @@
 #include "util/sample.h"
 #include "util/timer.h"
 #include "util/trace.h"
+#include "util/tracing.h"
 
 EngineMaster::EngineMaster(
         UserSettingsPointer pConfig,
@@ -67,6 +69,13 @@ EngineMaster::EngineMaster(
     m_pWorkerScheduler = new EngineWorkerScheduler(this);
     m_pWorkerScheduler->start(QThread::HighPriority);
 
+    // Parallel processing of channels is disabled by default
+    const int numChannelProcessingThreads = pConfig->getValue(
+            ChannelProcessingPool::kNumWorkerThreadsConfigKey, 0);
+    m_pChannelProcessingPool = numChannelProcessingThreads > 0
+            ? new ChannelProcessingPool(numChannelProcessingThreads)
+            : nullptr;
+
     // Master sample rate
     m_pMasterSampleRate = new ControlObject(ConfigKey(group, "samplerate"), true, true);
     m_pMasterSampleRate->set(44100.);
@@ -243,6 +252,7 @@ EngineMaster::~EngineMaster() {
     }
 
     delete m_pWorkerScheduler;
+    delete m_pChannelProcessingPool;
 
     for (int i = 0; i < m_channels.size(); ++i) {
         ChannelInfo* pChannelInfo = m_channels[i];
@@ -270,7 +280,48 @@ const CSAMPLE* EngineMaster::getSidechainBuffer() const {
     return m_pSidechainMix;
 }
 
+namespace {
+
+void processChannel(EngineMaster::ChannelInfo* pChannelInfo,
+        int iBufferSize,
+        bool collectFeatures) {
+    EngineChannel* pChannel = pChannelInfo->m_pChannel;
+    pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
+
+    // Collect metadata for effects
+    if (collectFeatures) {
+        GroupFeatureState features;
+        pChannel->collectFeatures(&features);
+        pChannelInfo->m_features = features;
+    }
+}
+
+// Processes active channels on the threads of the
+// ChannelProcessingPool. Each task processes a single channel.
+class ProcessChannelsJob final : public ChannelProcessingPool::Job {
+  public:
+    ProcessChannelsJob(EngineMaster::ChannelInfo* const* ppChannels,
+            int iBufferSize,
+            bool collectFeatures)
+            : m_ppChannels(ppChannels),
+              m_iBufferSize(iBufferSize),
+              m_collectFeatures(collectFeatures) {
+    }
+
+    void runTask(int taskIndex) override {
+        processChannel(m_ppChannels[taskIndex], m_iBufferSize, m_collectFeatures);
+    }
+
+  private:
+    EngineMaster::ChannelInfo* const* const m_ppChannels;
+    const int m_iBufferSize;
+    const bool m_collectFeatures;
+};
+
+} // anonymous namespace
+
 void EngineMaster::processChannels(int iBufferSize) {
+    mixxx::ScopedTrace trace("EngineMaster::processChannels");
     // Update internal master sync rate.
     m_pMasterSync->onCallbackStart(m_iSampleRate, m_iBufferSize);
 
@@ -281,6 +332,20 @@ void EngineMaster::processChannels(int iBufferSize) {
     m_activeTalkoverChannels.clear();
     m_activeChannels.clear();
 
+    // Requests that access EngineSync or other channels are processed
+    // for all channels before any channel is processed. Those requests
+    // might also change the sync master.
+    for (int i = 0; i < m_channels.size(); ++i) {
+        EngineChannel* pChannel = m_channels[i]->m_pChannel;
+        if (!pChannel || !pChannel->isActive()) {
+            continue;
+        }
+        EngineBuffer* pBuffer = pChannel->getEngineBuffer();
+        if (pBuffer) {
+            pBuffer->processSharedRequests();
+        }
+    }
+
     //ScopedTimer timer("EngineMaster::processChannels");
     EngineChannel* pMasterChannel = m_pMasterSync->getMaster();
     // Reserve the first place for the master channel which
@@ -354,17 +419,33 @@ void EngineMaster::processChannels(int iBufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex;
-             i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        EngineChannel* pChannel = pChannelInfo->m_pChannel;
-        pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
-
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState features;
-            pChannel->collectFeatures(&features);
-            pChannelInfo->m_features = features;
+    const bool collectFeatures = m_pEngineEffectsManager != nullptr;
+    if (m_pChannelProcessingPool &&
+            m_activeChannels.size() - activeChannelsStartIndex > 1) {
+        // Decks that take part in sync modify the shared state of
+        // EngineSync and follow the sync master. They are processed
+        // serially in order, i.e. the sync master first. All other
+        // channels only share the chunk pool of the readers and the
+        // worker scheduler that are both thread-safe.
+        m_parallelChannels.clear();
+        for (int i = activeChannelsStartIndex;
+                 i < m_activeChannels.size(); ++i) {
+            ChannelInfo* pChannelInfo = m_activeChannels[i];
+            EngineBuffer* pBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
+            if (pBuffer && pBuffer->isSynchronized()) {
+                processChannel(pChannelInfo, iBufferSize, collectFeatures);
+            } else {
+                m_parallelChannels.append(pChannelInfo);
+            }
+        }
+        ProcessChannelsJob job(m_parallelChannels.constData(),
+                iBufferSize,
+                collectFeatures);
+        m_pChannelProcessingPool->run(&job, m_parallelChannels.size());
+    } else {
+        for (int i = activeChannelsStartIndex;
+                 i < m_activeChannels.size(); ++i) {
+            processChannel(m_activeChannels[i], iBufferSize, collectFeatures);
         }
     }
 
@@ -388,7 +469,7 @@ void EngineMaster::process(const int iBufferSize) {
         QThread::currentThread()->setObjectName("Engine");
         haveSetName = true;
     }
-    //Trace t("EngineMaster::process");
+    mixxx::ScopedTrace trace("EngineMaster::process", iBufferSize);
 
     bool masterEnabled = m_pMasterEnabled->toBool();
     bool boothEnabled = m_pBoothEnabled->toBool();
@@ -32,6 +32,7 @@
 #include "recording/recordingmanager.h"
 
 class EngineWorkerScheduler;
+class ChannelProcessingPool;
 class EngineBuffer;
 class EngineChannel;
 class EngineDeck;
@@ -270,7 +271,8 @@ class EngineMaster : public QObject, public AudioSource {
 
   private:
     // Processes active channels. The master sync channel (if any) is processed
-    // first and all others are processed after. Populates m_activeChannels,
+    // first and all others are processed after. Channels that don't take part
+    // in sync might be processed in parallel. Populates m_activeChannels,
     // m_activeBusChannels, m_activeHeadphoneChannels, and
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
@@ -297,6 +299,7 @@ class EngineMaster : public QObject, public AudioSource {
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeBusChannels[3];
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeHeadphoneChannels;
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeTalkoverChannels;
+    QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_parallelChannels;
 
     unsigned int m_iSampleRate;
     unsigned int m_iBufferSize;
@@ -310,6 +313,7 @@ class EngineMaster : public QObject, public AudioSource {
     CSAMPLE* m_pSidechainMix;
 
     EngineWorkerScheduler* m_pWorkerScheduler;
+    ChannelProcessingPool* m_pChannelProcessingPool;
     EngineSync* m_pMasterSync;
 
     ControlObject* m_pMasterGain;
@@ -4,6 +4,7 @@
 #include <QMutex>
 #include <QThreadPool>
 #include <QWaitCondition>
+#include <atomic>
 
 #include "util/fifo.h"
 
@@ -28,8 +29,9 @@ class EngineWorkerScheduler : public QThread {
 
   private:
     // Indicates whether workerReady has been called since the last time
-    // runWorkers was run. This should only be touched from the engine callback.
-    bool m_bWakeScheduler;
+    // runWorkers was run. Set from the engine callback, possibly from
+    // multiple threads that process channels in parallel.
+    std::atomic<bool> m_bWakeScheduler;
 
     std::vector<EngineWorker*> m_workers;
 
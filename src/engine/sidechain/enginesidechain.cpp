@@ -42,8 +42,7 @@ EngineSideChain::EngineSideChain(
         CSAMPLE* sidechainMix)
         : m_pConfig(pConfig),
           m_bStopThread(false),
-          m_sampleFifo(SIDECHAIN_BUFFER_SIZE),
-          m_pWorkBuffer(SampleUtil::alloc(SIDECHAIN_BUFFER_SIZE)),
+          m_sampleBuffer(SIDECHAIN_BUFFER_SIZE),
           m_pSidechainMix(sidechainMix) {
     // We use HighPriority to prevent starvation by lower-priority processes (Qt
     // main thread, analysis, etc.). This used to be LowPriority but that is not
@@ -65,18 +64,23 @@ EngineSideChain::~EngineSideChain() {
 
     MMutexLocker locker(&m_workerLock);
     while (!m_workers.empty()) {
-        SideChainWorker* pWorker = m_workers.takeLast();
-        pWorker->shutdown();
-        delete pWorker;
+        const Worker worker = m_workers.takeLast();
+        if (worker.reader >= 0) {
+            m_sampleBuffer.detachReader(worker.reader);
+        }
+        worker.pWorker->shutdown();
+        delete worker.pWorker;
     }
     locker.unlock();
-
-    SampleUtil::free(m_pWorkBuffer);
 }
 
 void EngineSideChain::addSideChainWorker(SideChainWorker* pWorker) {
     MMutexLocker locker(&m_workerLock);
-    m_workers.append(pWorker);
+    const int reader = m_sampleBuffer.attachReader();
+    VERIFY_OR_DEBUG_ASSERT(reader >= 0) {
+        qWarning() << "EngineSideChain: Too many workers, ignoring the new worker";
+    }
+    m_workers.append({pWorker, reader});
 }
 
 void EngineSideChain::receiveBuffer(const AudioInput& input,
@@ -96,13 +100,15 @@ void EngineSideChain::writeSamples(const CSAMPLE* pBuffer, int iFrames) {
     // TODO: remove assumption of stereo buffer
     const int kChannels = 2;
     const int iSamples = iFrames * kChannels;
-    int samples_written = m_sampleFifo.write(pBuffer, iSamples);
+    // The samples that don't fit are dropped and reported by the
+    // workers that are lagging behind
+    int samples_written = m_sampleBuffer.write(pBuffer, iSamples);
 
     if (samples_written != iSamples) {
         Counter("EngineSideChain::writeSamples buffer overrun").increment();
     }
 
-    if (m_sampleFifo.writeAvailable() < SIDECHAIN_BUFFER_SIZE / 5) {
+    if (m_sampleBuffer.writeAvailable() < SIDECHAIN_BUFFER_SIZE / 5) {
         // Signal to the sidechain that samples are available.
         Trace wakeup("EngineSideChain::writeSamples wake up");
         m_waitForSamples.wakeAll();
@@ -125,13 +131,37 @@ void EngineSideChain::run() {
         m_waitLock.unlock();
         Event::start(tag);
 
-        int samples_read;
-        while ((samples_read = m_sampleFifo.read(m_pWorkBuffer,
-                                                 SIDECHAIN_BUFFER_SIZE))) {
+        {
             Trace process("EngineSideChain::process");
             MMutexLocker locker(&m_workerLock);
-            foreach (SideChainWorker* pWorker, m_workers) {
-                pWorker->process(m_pWorkBuffer, samples_read);
+            for (const auto& worker : qAsConst(m_workers)) {
+                if (worker.reader < 0) {
+                    continue;
+                }
+                int samples_read;
+                while ((samples_read = m_sampleBuffer.readAvailable(worker.reader))) {
+                    const CSAMPLE* dataPtr1;
+                    int size1;
+                    const CSAMPLE* dataPtr2;
+                    int size2;
+                    // The workers process the samples in place
+                    m_sampleBuffer.acquireReadRegions(worker.reader,
+                            samples_read,
+                            &dataPtr1,
+                            &size1,
+                            &dataPtr2,
+                            &size2);
+                    worker.pWorker->process(dataPtr1, size1);
+                    if (size2 > 0) {
+                        worker.pWorker->process(dataPtr2, size2);
+                    }
+                    m_sampleBuffer.releaseReadRegions(worker.reader, samples_read);
+                }
+                const int overflowCount = m_sampleBuffer.takeOverflowCount(worker.reader);
+                if (overflowCount > 0) {
+                    Counter("EngineSideChain::process samples lost by a lagging worker") +=
+                            overflowCount;
+                }
             }
         }
 
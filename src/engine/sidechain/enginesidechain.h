@@ -25,8 +25,8 @@
 #include "preferences/usersettings.h"
 #include "engine/sidechain/sidechainworker.h"
 #include "soundio/soundmanagerutil.h"
-#include "util/fifo.h"
 #include "util/mutex.h"
+#include "util/spmcringbuffer.h"
 #include "util/types.h"
 
 class EngineSideChain : public QThread, public AudioDestination {
@@ -58,8 +58,8 @@ class EngineSideChain : public QThread, public AudioDestination {
     // Indicates that the thread should exit.
     volatile bool m_bStopThread;
 
-    FIFO<CSAMPLE> m_sampleFifo;
-    CSAMPLE* m_pWorkBuffer;
+    // Each worker reads the samples in place with its own read cursor
+    SpmcRingBuffer<CSAMPLE> m_sampleBuffer;
     CSAMPLE* m_pSidechainMix;
 
     // Provides thread safety around the wait condition below.
@@ -67,9 +67,15 @@ class EngineSideChain : public QThread, public AudioDestination {
     // Allows sleeping until we have samples to process.
     QWaitCondition m_waitForSamples;
 
+    struct Worker {
+        SideChainWorker* pWorker;
+        // The reader of m_sampleBuffer
+        int reader;
+    };
+
     // Sidechain workers registered with EngineSideChain.
     MMutex m_workerLock;
-    QList<SideChainWorker*> m_workers GUARDED_BY(m_workerLock);
+    QList<Worker> m_workers GUARDED_BY(m_workerLock);
 };
 
 #endif
@@ -0,0 +1,326 @@
+#include "engine/sidechain/sharedbroadcastencoder.h"
+
+#include <QMutexLocker>
+
+#include "recording/defs_recording.h"
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SharedBroadcastEncoder");
+
+// Same as the network cache of ShoutConnection: 10 s mp3 @ 192 kbit/s
+const int kMaxQueuedBytes = 491520;
+
+} // anonymous namespace
+
+SharedBroadcastEncoder::SharedBroadcastEncoder(
+        const QString& settingsKey,
+        StreamingCountPointer pStreamingCount)
+        : m_settingsKey(settingsKey),
+          m_pStreamingCount(std::move(pStreamingCount)) {
+}
+
+SharedBroadcastEncoder::~SharedBroadcastEncoder() {
+    DEBUG_ASSERT(m_subscribers.isEmpty());
+    // Destroying the encoder might flush pending packets into write()
+    m_pEncoder.reset();
+}
+
+SharedBroadcastEncoder::Subscriber* SharedBroadcastEncoder::findSubscriber(
+        EncoderCallback* pCallback) {
+    for (auto& subscriber : m_subscribers) {
+        if (subscriber.pCallback == pCallback) {
+            return &subscriber;
+        }
+    }
+    return nullptr;
+}
+
+void SharedBroadcastEncoder::setStreaming(EncoderCallback* pSubscriber, bool streaming) {
+    QMutexLocker locker(&m_mutex);
+    Subscriber* pEntry = findSubscriber(pSubscriber);
+    VERIFY_OR_DEBUG_ASSERT(pEntry) {
+        return;
+    }
+    if (pEntry->streaming != streaming) {
+        m_pStreamingCount->fetch_add(streaming ? 1 : -1);
+    }
+    pEntry->streaming = streaming;
+    pEntry->packets.clear();
+    pEntry->queuedBytes = 0;
+}
+
+void SharedBroadcastEncoder::encode(const CSAMPLE* pBuffer, int iBufferSize) {
+    {
+        QMutexLocker locker(&m_mutex);
+        bool streaming = false;
+        for (const auto& subscriber : qAsConst(m_subscribers)) {
+            if (subscriber.streaming) {
+                streaming = true;
+                break;
+            }
+        }
+        if (!streaming) {
+            return;
+        }
+    }
+    // The encoded packets are queued by write(). The subscribers must
+    // not wait for the encoder while writing their pending packets.
+    m_pEncoder->encodeBuffer(pBuffer, iBufferSize);
+}
+
+void SharedBroadcastEncoder::writePendingPackets(EncoderCallback* pSubscriber) {
+    QList<QByteArray> packets;
+    {
+        QMutexLocker locker(&m_mutex);
+        Subscriber* pEntry = findSubscriber(pSubscriber);
+        VERIFY_OR_DEBUG_ASSERT(pEntry) {
+            return;
+        }
+        packets.swap(pEntry->packets);
+        pEntry->queuedBytes = 0;
+    }
+    // Writing to the server might block and must not delay the
+    // other subscribers
+    for (const auto& packet : qAsConst(packets)) {
+        pSubscriber->write(nullptr,
+                reinterpret_cast<const unsigned char*>(packet.constData()),
+                0,
+                packet.size());
+    }
+}
+
+void SharedBroadcastEncoder::detach(EncoderCallback* pSubscriber) {
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < m_subscribers.size(); ++i) {
+        if (m_subscribers[i].pCallback == pSubscriber) {
+            if (m_subscribers[i].streaming) {
+                m_pStreamingCount->fetch_sub(1);
+            }
+            m_subscribers.removeAt(i);
+            return;
+        }
+    }
+    DEBUG_ASSERT(!"detach: unknown subscriber");
+}
+
+int SharedBroadcastEncoder::subscriberCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_subscribers.size();
+}
+
+void SharedBroadcastEncoder::write(
+        const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    // Only invoked by the encoder, either from encode() or when the
+    // last reference is released
+    QByteArray packet;
+    packet.reserve(headerLen + bodyLen);
+    if (headerLen > 0) {
+        packet.append(reinterpret_cast<const char*>(header), headerLen);
+    }
+    if (bodyLen > 0) {
+        packet.append(reinterpret_cast<const char*>(body), bodyLen);
+    }
+    if (packet.isEmpty()) {
+        return;
+    }
+    QMutexLocker locker(&m_mutex);
+    // The implicitly shared data is only copied once for all subscribers
+    for (auto& subscriber : m_subscribers) {
+        if (!subscriber.streaming) {
+            continue;
+        }
+        subscriber.packets.append(packet);
+        subscriber.queuedBytes += packet.size();
+        while (subscriber.queuedBytes > kMaxQueuedBytes) {
+            // The subscriber is not able to keep up with the stream
+            kLogger.warning() << "Dropping encoded packets of a stalled connection";
+            subscriber.queuedBytes -= subscriber.packets.takeFirst().size();
+        }
+    }
+}
+
+// These are not used for streaming, but the interface requires them
+int SharedBroadcastEncoder::tell() {
+    return -1;
+}
+
+// These are not used for streaming, but the interface requires them
+void SharedBroadcastEncoder::seek(int pos) {
+    Q_UNUSED(pos);
+}
+
+// These are not used for streaming, but the interface requires them
+int SharedBroadcastEncoder::filelen() {
+    return 0;
+}
+
+SharedBroadcastEncoderRegistry::SharedBroadcastEncoderRegistry()
+        : SharedBroadcastEncoderRegistry(
+                  [](EncoderSettingsPointer pSettings, EncoderCallback* pCallback) {
+                      return EncoderFactory::getFactory().createEncoder(
+                              pSettings, pCallback);
+                  }) {
+}
+
+SharedBroadcastEncoderRegistry::SharedBroadcastEncoderRegistry(
+        EncoderFactoryFunction encoderFactory)
+        : m_encoderFactory(std::move(encoderFactory)),
+          m_pStreamingCount(std::make_shared<std::atomic<int>>(0)),
+          m_threadWaiting(false),
+          m_bStopThread(false) {
+}
+
+SharedBroadcastEncoderRegistry::~SharedBroadcastEncoderRegistry() {
+    shutdown();
+    wait();
+}
+
+// static
+bool SharedBroadcastEncoderRegistry::isShareable(const EncoderSettings& settings) {
+    return settings.getFormat() == ENCODING_MP3;
+}
+
+// static
+QString SharedBroadcastEncoderRegistry::settingsKey(
+        const EncoderSettings& settings, int sampleRate) {
+    return QString("%1/%2/%3/%4")
+            .arg(settings.getFormat(),
+                    QString::number(settings.getQuality()),
+                    QString::number(static_cast<int>(settings.getChannelMode())),
+                    QString::number(sampleRate));
+}
+
+SharedBroadcastEncoderPtr SharedBroadcastEncoderRegistry::attach(
+        EncoderSettingsPointer pSettings,
+        int sampleRate,
+        EncoderCallback* pSubscriber,
+        QString* pErrorMessage) {
+    VERIFY_OR_DEBUG_ASSERT(pSettings && isShareable(*pSettings)) {
+        return SharedBroadcastEncoderPtr();
+    }
+    const QString key = settingsKey(*pSettings, sampleRate);
+
+    QMutexLocker locker(&m_mutex);
+    SharedBroadcastEncoderPtr pEncoder = m_encoders.value(key).toStrongRef();
+    if (!pEncoder) {
+        pEncoder = SharedBroadcastEncoderPtr(
+                new SharedBroadcastEncoder(key, m_pStreamingCount));
+        pEncoder->m_pEncoder = m_encoderFactory(pSettings, pEncoder.data());
+        QString errorMessage;
+        if (!pEncoder->m_pEncoder ||
+                pEncoder->m_pEncoder->initEncoder(sampleRate, errorMessage) < 0) {
+            if (pErrorMessage) {
+                *pErrorMessage = errorMessage;
+            }
+            return SharedBroadcastEncoderPtr();
+        }
+        // Forget the encoders of all settings that are no longer used
+        for (auto it = m_encoders.begin(); it != m_encoders.end();) {
+            if (it.value().isNull()) {
+                it = m_encoders.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_encoders.insert(key, pEncoder);
+        kLogger.debug() << "Created shared encoder" << key;
+    }
+
+    QMutexLocker encoderLocker(&pEncoder->m_mutex);
+    DEBUG_ASSERT(!pEncoder->findSubscriber(pSubscriber));
+    pEncoder->m_subscribers.append({pSubscriber, false, QList<QByteArray>(), 0});
+    return pEncoder;
+}
+
+void SharedBroadcastEncoderRegistry::process(
+        const CSAMPLE* pBuffer, const int iBufferSize) {
+    if (iBufferSize <= 0) {
+        return;
+    }
+    QList<SharedBroadcastEncoderPtr> encoders;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const auto& pWeakEncoder : qAsConst(m_encoders)) {
+            SharedBroadcastEncoderPtr pEncoder = pWeakEncoder.toStrongRef();
+            if (pEncoder) {
+                encoders.append(pEncoder);
+            }
+        }
+    }
+    // Encoding must not block attaching new connections
+    for (const auto& pEncoder : qAsConst(encoders)) {
+        pEncoder->encode(pBuffer, iBufferSize);
+    }
+}
+
+void SharedBroadcastEncoderRegistry::shutdown() {
+    m_bStopThread = true;
+    m_readSema.release();
+}
+
+void SharedBroadcastEncoderRegistry::outputAvailable() {
+    if (streamingSubscriberCount() > 0) {
+        m_readSema.release();
+    }
+}
+
+void SharedBroadcastEncoderRegistry::setOutputFifo(
+        QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) {
+    m_pOutputFifo = pOutputFifo;
+}
+
+QSharedPointer<FIFO<CSAMPLE>> SharedBroadcastEncoderRegistry::getOutputFifo() {
+    return m_pOutputFifo;
+}
+
+bool SharedBroadcastEncoderRegistry::threadWaiting() {
+    // The master mix is not needed while all connections are idle
+    return m_threadWaiting.load(std::memory_order_relaxed) &&
+            streamingSubscriberCount() > 0;
+}
+
+void SharedBroadcastEncoderRegistry::run() {
+    QThread::currentThread()->setObjectName(QStringLiteral("SharedBroadcastEncoder"));
+    VERIFY_OR_DEBUG_ASSERT(m_pOutputFifo) {
+        kLogger.warning() << "run: Broadcast FIFO handle is not available. Aborting";
+        return;
+    }
+    // Discard the samples that have been written before
+    m_pOutputFifo->flushReadData(m_pOutputFifo->readAvailable());
+    m_threadWaiting = true;
+
+    while (!m_bStopThread) {
+        if (!m_readSema.tryAcquire(1, 1000)) {
+            continue;
+        }
+        int readAvailable = m_pOutputFifo->readAvailable();
+        if (readAvailable && streamingSubscriberCount() == 0) {
+            // Samples that are left over after the last subscriber
+            // stopped streaming must not be encoded when the next
+            // one starts
+            m_pOutputFifo->flushReadData(readAvailable);
+        } else if (readAvailable) {
+            CSAMPLE* dataPtr1;
+            ring_buffer_size_t size1;
+            CSAMPLE* dataPtr2;
+            ring_buffer_size_t size2;
+            // We use size1 and size2, so we can ignore the return value
+            (void)m_pOutputFifo->aquireReadRegions(readAvailable, &dataPtr1, &size1,
+                    &dataPtr2, &size2);
+            process(dataPtr1, size1);
+            if (size2 > 0) {
+                process(dataPtr2, size2);
+            }
+            m_pOutputFifo->releaseReadRegions(readAvailable);
+        }
+    }
+
+    m_threadWaiting = false;
+    kLogger.debug() << "run: Thread stopped";
+}
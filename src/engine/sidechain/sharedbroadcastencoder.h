@@ -0,0 +1,164 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QString>
+#include <QThread>
+#include <QWeakPointer>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "engine/sidechain/networkoutputstreamworker.h"
+#include "util/fifo.h"
+#include "util/types.h"
+
+class SharedBroadcastEncoder;
+typedef QSharedPointer<SharedBroadcastEncoder> SharedBroadcastEncoderPtr;
+
+// Encodes the master mix only once for all broadcast connections that
+// use identical encoder settings and fans out the encoded packets to
+// each of them.
+//
+// The encoder is only fed by the SharedBroadcastEncoderRegistry from
+// its own thread. The packets are queued for all streaming subscribers
+// and each subscriber writes its pending packets to its own server from
+// its own thread by calling writePendingPackets(). A stalled connection
+// only loses its own packets once its queue is full.
+//
+// Only formats that can be joined at any packet boundary, i.e. MP3,
+// can be shared. Ogg streams start with header pages that a subscriber
+// joining later would have missed and carry the track metadata within
+// the stream.
+class SharedBroadcastEncoder : public EncoderCallback {
+  public:
+    ~SharedBroadcastEncoder() override;
+
+    const QString& settingsKey() const {
+        return m_settingsKey;
+    }
+
+    // Starts or stops queuing packets for the subscriber. Subscribers
+    // should only be streaming while they are connected.
+    void setStreaming(EncoderCallback* pSubscriber, bool streaming);
+
+    // Writes all pending packets of the subscriber by invoking its
+    // write() callback on the calling thread.
+    void writePendingPackets(EncoderCallback* pSubscriber);
+
+    // Removes the subscriber. The encoder is destroyed when the last
+    // reference is released.
+    void detach(EncoderCallback* pSubscriber);
+
+    int subscriberCount() const;
+
+    // EncoderCallback, only invoked by the encoder while encoding
+    void write(const unsigned char* header, const unsigned char* body, int headerLen, int bodyLen) override;
+    int tell() override;
+    void seek(int pos) override;
+    int filelen() override;
+
+  private:
+    friend class SharedBroadcastEncoderRegistry;
+
+    struct Subscriber {
+        EncoderCallback* pCallback;
+        bool streaming;
+        QList<QByteArray> packets;
+        int queuedBytes;
+    };
+
+    typedef std::shared_ptr<std::atomic<int>> StreamingCountPointer;
+
+    SharedBroadcastEncoder(
+            const QString& settingsKey,
+            StreamingCountPointer pStreamingCount);
+
+    Subscriber* findSubscriber(EncoderCallback* pCallback);
+
+    // Only invoked by the thread of the registry
+    void encode(const CSAMPLE* pBuffer, int iBufferSize);
+
+    const QString m_settingsKey;
+    // The number of streaming subscribers of all encoders of the
+    // registry, shared with the registry
+    const StreamingCountPointer m_pStreamingCount;
+    // Only accessed by the thread of the registry once attached
+    EncoderPointer m_pEncoder;
+
+    mutable QMutex m_mutex;
+    QList<Subscriber> m_subscribers;
+};
+
+// Groups the broadcast connections by their encoder settings. Owned by
+// BroadcastManager and shared by all of its connections.
+//
+// The registry is a network output worker on its own: It receives the
+// master mix once in its output FIFO and feeds all shared encoders from
+// its own thread, independent of the connections. The master mix is
+// only written into the FIFO while at least one subscriber is streaming.
+class SharedBroadcastEncoderRegistry
+        : public QThread, public NetworkOutputStreamWorker {
+  public:
+    typedef std::function<EncoderPointer(EncoderSettingsPointer, EncoderCallback*)>
+            EncoderFactoryFunction;
+
+    SharedBroadcastEncoderRegistry();
+    // For tests that don't want to depend on the available encoder libraries
+    explicit SharedBroadcastEncoderRegistry(EncoderFactoryFunction encoderFactory);
+    ~SharedBroadcastEncoderRegistry() override;
+
+    // Returns true if encoders with these settings can be shared
+    static bool isShareable(const EncoderSettings& settings);
+
+    // A key that is identical for equal encoder settings
+    static QString settingsKey(const EncoderSettings& settings, int sampleRate);
+
+    // Attaches the subscriber to the encoder for these settings. The
+    // encoder is created and initialized if no other connection with
+    // the same settings exists yet. Returns a null pointer if the
+    // encoder could not be initialized.
+    SharedBroadcastEncoderPtr attach(
+            EncoderSettingsPointer pSettings,
+            int sampleRate,
+            EncoderCallback* pSubscriber,
+            QString* pErrorMessage);
+
+    // The number of subscribers of all encoders that are streaming
+    int streamingSubscriberCount() const {
+        return m_pStreamingCount->load();
+    }
+
+    // NetworkOutputStreamWorker
+    // Encodes the samples once for each encoder with streaming subscribers
+    void process(const CSAMPLE* pBuffer, const int iBufferSize) override;
+    void shutdown() override;
+    void outputAvailable() override;
+    void setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) override;
+    QSharedPointer<FIFO<CSAMPLE>> getOutputFifo() override;
+    bool threadWaiting() override;
+
+  protected:
+    void run() override;
+
+  private:
+    const EncoderFactoryFunction m_encoderFactory;
+
+    QMutex m_mutex;
+    QHash<QString, QWeakPointer<SharedBroadcastEncoder>> m_encoders;
+
+    const SharedBroadcastEncoder::StreamingCountPointer m_pStreamingCount;
+
+    QSharedPointer<FIFO<CSAMPLE>> m_pOutputFifo;
+    QSemaphore m_readSema;
+    std::atomic<bool> m_threadWaiting;
+    std::atomic<bool> m_bStopThread;
+};
+
+typedef QSharedPointer<SharedBroadcastEncoderRegistry> SharedBroadcastEncoderRegistryPtr;
@@ -46,7 +46,8 @@ const mixxx::Logger kLogger("ShoutConnection");
 }
 
 ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
-        UserSettingsPointer pConfig)
+        UserSettingsPointer pConfig,
+        SharedBroadcastEncoderRegistryPtr pEncoderRegistry)
         : m_pTextCodec(nullptr),
           m_pMetaData(),
           m_pShout(nullptr),
@@ -57,6 +58,7 @@ ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
           m_pConfig(pConfig),
           m_pProfile(profile),
           m_encoder(nullptr),
+          m_pEncoderRegistry(pEncoderRegistry),
           m_pMasterSamplerate(new ControlProxy("[Master]", "samplerate", this)),
           m_pBroadcastEnabled(new ControlProxy(BROADCAST_PREF_KEY, "enabled", this)),
           m_custom_metadata(false),
@@ -126,6 +128,7 @@ ShoutConnection::~ShoutConnection() {
        qWarning() << "ShoutOutput::~ShoutOutput(): Thread didn't die.\
        Ignored but file a bug report if problems rise!";
     }
+    resetEncoder();
 }
 
 bool ShoutConnection::isConnected() {
@@ -188,7 +191,7 @@ void ShoutConnection::updateFromPreferences() {
     // Delete m_encoder if it has been initialized (with maybe) different bitrate.
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    resetEncoder();
 
     m_format_is_mp3 = false;
     m_format_is_ov = false;
@@ -444,12 +447,25 @@ void ShoutConnection::updateFromPreferences() {
     // Initialize m_encoder
     EncoderSettingsPointer pBroadcastSettings =
             std::make_shared<EncoderBroadcastSettings>(m_pProfile);
-    m_encoder = EncoderFactory::getFactory().createEncoder(
-                    pBroadcastSettings, this);
-
     QString errorMsg;
-    // TODO(XXX): Use mixxx::audio::SampleRate instead of int in initEncoder
-    if (m_encoder->initEncoder(static_cast<int>(masterSamplerate), errorMsg) < 0) {
+    bool encoderReady;
+    if (m_pEncoderRegistry &&
+            SharedBroadcastEncoderRegistry::isShareable(*pBroadcastSettings)) {
+        // Connections with identical settings encode the stream only once
+        m_pSharedEncoder = m_pEncoderRegistry->attach(
+                pBroadcastSettings,
+                static_cast<int>(masterSamplerate),
+                this,
+                &errorMsg);
+        encoderReady = !m_pSharedEncoder.isNull();
+    } else {
+        m_encoder = EncoderFactory::getFactory().createEncoder(
+                pBroadcastSettings, this);
+        // TODO(XXX): Use mixxx::audio::SampleRate instead of int in initEncoder
+        encoderReady = m_encoder->initEncoder(
+                               static_cast<int>(masterSamplerate), errorMsg) >= 0;
+    }
+    if (!encoderReady) {
         // e.g., if lame is not found
         // init m_encoder itself will display a message box
         kLogger.warning() << "**** Encoder init failed";
@@ -457,7 +473,7 @@ void ShoutConnection::updateFromPreferences() {
 
         // delete m_encoder calls write() make sure it will be exit early
         DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-        m_encoder.reset();
+        resetEncoder();
 
         setState(NETWORKSTREAMWORKER_STATE_ERROR);
         m_lastErrorStr = "Encoder error";
@@ -467,6 +483,14 @@ void ShoutConnection::updateFromPreferences() {
     setState(NETWORKSTREAMWORKER_STATE_READY);
 }
 
+void ShoutConnection::resetEncoder() {
+    m_encoder.reset();
+    if (m_pSharedEncoder) {
+        m_pSharedEncoder->detach(this);
+        m_pSharedEncoder.reset();
+    }
+}
+
 bool ShoutConnection::serverConnect() {
     if(!m_pProfile->getEnabled())
         return false;
@@ -482,7 +506,7 @@ bool ShoutConnection::processConnect() {
     // Make sure that we call updateFromPreferences always
     updateFromPreferences();
 
-    if (!m_encoder) {
+    if (!m_encoder && !m_pSharedEncoder) {
         // updateFromPreferences failed
         setStatus(BroadcastProfile::STATUS_FAILURE);
         kLogger.warning() << "ShoutOutput::processConnect() returning false";
@@ -579,6 +603,9 @@ bool ShoutConnection::processConnect() {
             	m_pOutputFifo->flushReadData(m_pOutputFifo->readAvailable());
             }
             m_threadWaiting = true;
+            if (m_pSharedEncoder) {
+                m_pSharedEncoder->setStreaming(this, true);
+            }
 
             setStatus(BroadcastProfile::STATUS_CONNECTED);
             emit broadcastConnected();
@@ -602,7 +629,7 @@ bool ShoutConnection::processConnect() {
     shout_close(m_pShout);
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    resetEncoder();
     if (m_pProfile->getEnabled()) {
         setStatus(BroadcastProfile::STATUS_FAILURE);
     } else {
@@ -627,7 +654,7 @@ bool ShoutConnection::processDisconnect() {
     }
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    resetEncoder();
     return disconnected;
 }
 
@@ -714,7 +741,14 @@ void ShoutConnection::process(const CSAMPLE* pBuffer, const int iBufferSize) {
         return;
 
     // If we are connected, encode the samples.
-    if (iBufferSize > 0 && m_encoder) {
+    if (m_pSharedEncoder) {
+        setFunctionCode(6);
+        // Keep the shared encoder alive if write() needs to reconnect
+        const SharedBroadcastEncoderPtr pSharedEncoder = m_pSharedEncoder;
+        // The samples have already been encoded by the registry. Only
+        // the encoded frames are passed to the write() callback.
+        pSharedEncoder->writePendingPackets(this);
+    } else if (iBufferSize > 0 && m_encoder) {
         setFunctionCode(6);
         m_encoder->encodeBuffer(pBuffer, iBufferSize);
         // the encoded frames are received by the write() callback.
@@ -20,6 +20,7 @@
 #include "control/controlproxy.h"
 #include "encoder/encoder.h"
 #include "encoder/encodercallback.h"
+#include "engine/sidechain/sharedbroadcastencoder.h"
 #include "errordialoghandler.h"
 #include "preferences/broadcastprofile.h"
 #include "preferences/usersettings.h"
@@ -37,7 +38,9 @@ class ShoutConnection
         : public QThread, public EncoderCallback, public NetworkOutputStreamWorker {
     Q_OBJECT
   public:
-    ShoutConnection(BroadcastProfilePtr profile, UserSettingsPointer pConfig);
+    ShoutConnection(BroadcastProfilePtr profile,
+            UserSettingsPointer pConfig,
+            SharedBroadcastEncoderRegistryPtr pEncoderRegistry);
     ~ShoutConnection() override;
 
     // This is called by the Engine implementation for each sample. Encode and
@@ -117,6 +120,9 @@ class ShoutConnection
     bool waitForRetry();
 
     void tryReconnect();
+    // Deletes or detaches from the encoder. Deleting the encoder might
+    // invoke write() to flush the stream.
+    void resetEncoder();
     void insertMetaData(const char *name, const char *value);
 
     QTextCodec* m_pTextCodec;
@@ -129,6 +135,9 @@ class ShoutConnection
     UserSettingsPointer m_pConfig;
     BroadcastProfilePtr m_pProfile;
     EncoderPointer m_encoder;
+    // Replaces m_encoder if the encoder can be shared with other connections
+    SharedBroadcastEncoderRegistryPtr m_pEncoderRegistry;
+    SharedBroadcastEncoderPtr m_pSharedEncoder;
     ControlProxy* m_pMasterSamplerate;
     ControlProxy* m_pBroadcastEnabled;
     // static metadata according to prefereneces
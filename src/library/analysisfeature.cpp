@@ -56,6 +56,7 @@ AnalysisFeature::AnalysisFeature(
         m_baseTitle(tr("Analyze")),
         m_icon(":/images/library/ic_library_prepare.svg"),
         m_pTrackAnalysisScheduler(TrackAnalysisScheduler::NullPointer()),
+        m_preempted(false),
         m_pAnalysisView(nullptr),
         m_title(m_baseTitle) {
 }
@@ -184,6 +185,10 @@ void AnalysisFeature::resumeAnalysis() {
     if (!m_pTrackAnalysisScheduler) {
         return; // inactive
     }
+    if (m_preempted) {
+        kLogger.info() << "Deferring analysis until loaded tracks have been analyzed";
+        return;
+    }
     kLogger.info() << "Resuming analysis";
     m_pTrackAnalysisScheduler->resume();
 }
@@ -196,6 +201,22 @@ void AnalysisFeature::stopAnalysis() {
     m_pTrackAnalysisScheduler->stop();
 }
 
+void AnalysisFeature::preemptAnalysis() {
+    if (m_preempted) {
+        return;
+    }
+    m_preempted = true;
+    suspendAnalysis();
+}
+
+void AnalysisFeature::releaseAnalysis() {
+    if (!m_preempted) {
+        return;
+    }
+    m_preempted = false;
+    resumeAnalysis();
+}
+
 void AnalysisFeature::onTrackAnalysisSchedulerProgress(
         AnalyzerProgress /*currentTrackProgress*/,
         int currentTrackNumber,
@@ -54,6 +54,12 @@ class AnalysisFeature : public LibraryFeature {
     void resumeAnalysis();
     void stopAnalysis();
 
+    // Tracks that have been loaded into players are analyzed with a
+    // higher priority. A batch analysis is preempted until all of them
+    // have been analyzed and does not resume in the meantime.
+    void preemptAnalysis();
+    void releaseAnalysis();
+
   private slots:
     void onTrackAnalysisSchedulerProgress(AnalyzerProgress currentTrackProgress, int currentTrackNumber, int totalTracksCount);
     void onTrackAnalysisSchedulerFinished();
@@ -73,6 +79,8 @@ class AnalysisFeature : public LibraryFeature {
 
     TrackAnalysisScheduler::Pointer m_pTrackAnalysisScheduler;
 
+    bool m_preempted;
+
     TreeItemModel m_childModel;
     DlgAnalysis* m_pAnalysisView;
 
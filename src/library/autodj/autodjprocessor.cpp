@@ -848,7 +848,7 @@ TrackPointer AutoDJProcessor::getNextTrackFromQueue() {
             ConfigKey("[Auto DJ]", "EnableRandomQueue"));
     int minAutoDJCrateTracks = m_pConfig->getValueString(
             ConfigKey(kConfigKey, "RandomQueueMinimumAllowed")).toInt();
-    int tracksToAdd = minAutoDJCrateTracks - m_pAutoDJTableModel->rowCount();
+    int tracksToAdd = minAutoDJCrateTracks - m_pAutoDJTableModel->totalRowCount();
     // In case we start off with < minimum tracks
     if (randomQueueEnabled && (tracksToAdd > 0)) {
         emit randomTrackRequested(tracksToAdd);
@@ -939,7 +939,7 @@ void AutoDJProcessor::maybeFillRandomTracks() {
     bool randomQueueEnabled = (((m_pConfig->getValueString(
             ConfigKey("[Auto DJ]", "EnableRandomQueue")).toInt())) == 1);
 
-    int tracksToAdd = minAutoDJCrateTracks - m_pAutoDJTableModel->rowCount();
+    int tracksToAdd = minAutoDJCrateTracks - m_pAutoDJTableModel->totalRowCount();
     if (randomQueueEnabled && (tracksToAdd > 0)) {
         qDebug() << "Randomly adding tracks";
         emit randomTrackRequested(tracksToAdd);
@@ -140,6 +140,7 @@ void BansheeFeature::appendTrackIdsFromRightClickIndex(QList<TrackId>* trackIds,
             BansheePlaylistModel* pPlaylistModelToAdd = new BansheePlaylistModel(this, m_pLibrary->trackCollections(), &m_connection);
             pPlaylistModelToAdd->setTableModel(playlistID);
             pPlaylistModelToAdd->select();
+            pPlaylistModelToAdd->fetchAll();
 
             // Copy Tracks
             int rows = pPlaylistModelToAdd->rowCount();
@@ -144,6 +144,7 @@ void BaseExternalLibraryFeature::appendTrackIdsFromRightClickIndex(
     pPlaylistModelToAdd->setSort(pPlaylistModelToAdd->fieldIndex(
             ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION), Qt::AscendingOrder);
     pPlaylistModelToAdd->select();
+    pPlaylistModelToAdd->fetchAll();
 
     // Copy Tracks
     int rows = pPlaylistModelToAdd->rowCount();
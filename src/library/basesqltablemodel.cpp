@@ -2,6 +2,7 @@
 
 #include "library/basesqltablemodel.h"
 
+#include <QTimer>
 #include <QUrl>
 #include <QtDebug>
 #include <algorithm>
@@ -32,6 +33,10 @@ const bool sDebug = false;
 const int kIdColumn = 0;
 const int kMaxSortColumns = 3;
 
+// The number of rows that are published at once by fetchMore(). Should
+// be sufficient to fill the visible area of a track table.
+const int kRowsPerFetch = 256;
+
 // Constant for getModelSetting(name)
 const QString COLUMNS_SORTING = QStringLiteral("ColumnsSorting");
 
@@ -44,10 +49,18 @@ BaseSqlTableModel::BaseSqlTableModel(
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
-          m_bInitialized(false) {
+          m_fetchedRowCount(0),
+          m_selectPending(false),
+          m_bInitialized(false),
+          m_tableRowsValid(false) {
+    connect(&m_searchWatcher,
+            &QFutureWatcher<bool>::finished,
+            this,
+            &BaseSqlTableModel::slotSearchFinished);
 }
 
 BaseSqlTableModel::~BaseSqlTableModel() {
+    cancelSearch();
 }
 
 void BaseSqlTableModel::initHeaderProperties() {
@@ -153,12 +166,16 @@ void BaseSqlTableModel::initSortColumnMapping() {
 void BaseSqlTableModel::clearRows() {
     DEBUG_ASSERT(m_rowInfo.empty() == m_trackIdToRows.empty());
     DEBUG_ASSERT(m_rowInfo.size() >= m_trackIdToRows.size());
-    if (!m_rowInfo.isEmpty()) {
-        beginRemoveRows(QModelIndex(), 0, m_rowInfo.size() - 1);
-        m_rowInfo.clear();
-        m_trackIdToRows.clear();
+    DEBUG_ASSERT(m_fetchedRowCount <= m_rowInfo.size());
+    if (m_fetchedRowCount > 0) {
+        beginRemoveRows(QModelIndex(), 0, m_fetchedRowCount - 1);
+        m_fetchedRowCount = 0;
         endRemoveRows();
     }
+    // Rows that have not been published or read yet are discarded silently
+    m_selectPending = false;
+    m_rowInfo.clear();
+    m_trackIdToRows.clear();
     DEBUG_ASSERT(m_rowInfo.isEmpty());
     DEBUG_ASSERT(m_trackIdToRows.isEmpty());
 }
@@ -175,16 +192,44 @@ void BaseSqlTableModel::replaceRows(
     // its container types in the future this code becomes even more efficient.
     DEBUG_ASSERT(rows.empty() == trackIdToRows.empty());
     DEBUG_ASSERT(rows.size() >= trackIdToRows.size());
-    if (rows.isEmpty()) {
-        clearRows();
-    } else {
-        beginInsertRows(QModelIndex(), 0, rows.size() - 1);
+    if (m_selectPending) {
+        m_selectPending = false;
+        if (startsWithPublishedRows(rows)) {
+            // Only append the remaining rows to the first page that has
+            // been published by select() without resetting the view
+            m_rowInfo = rows;
+            m_trackIdToRows = trackIdToRows;
+            if (m_fetchedRowCount > 0) {
+                emit dataChanged(index(0, 0),
+                        index(m_fetchedRowCount - 1, columnCount() - 1));
+            } else {
+                fetchMore();
+            }
+            return;
+        }
+    }
+    clearRows();
+    if (!rows.isEmpty()) {
         m_rowInfo = rows;
         m_trackIdToRows = trackIdToRows;
-        endInsertRows();
+        // Only publish the first page, the view will fetch more
+        // rows on demand while scrolling
+        fetchMore();
     }
 }
 
+bool BaseSqlTableModel::startsWithPublishedRows(const QVector<RowInfo>& rows) const {
+    if (rows.size() < m_fetchedRowCount) {
+        return false;
+    }
+    for (int i = 0; i < m_fetchedRowCount; ++i) {
+        if (rows[i].trackId != m_rowInfo[i].trackId) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void BaseSqlTableModel::select() {
     if (!m_bInitialized) {
         return;
@@ -207,37 +252,97 @@ void BaseSqlTableModel::select() {
     PerformanceTimer time;
     time.start();
 
+    // A pending search or selection would publish outdated rows
+    cancelSearch();
+    m_selectPending = false;
+    m_tableRowsValid = false;
+
+    // The track source only removes rows from the table if it doesn't
+    // sort them. Then the first page of the table is published before
+    // reading the remaining rows of large tables after returning to the
+    // event loop.
+    if (m_trackSourceOrderBy.isEmpty() &&
+            !m_tableOrderBy.contains("RANDOM()", Qt::CaseInsensitive)) {
+        QVector<RowInfo> rowInfos;
+        QSet<TrackId> trackIds;
+        if (!queryTableRows(kRowsPerFetch, &rowInfos, &trackIds)) {
+            return;
+        }
+        if (rowInfos.size() < kRowsPerFetch) {
+            // All rows of the table have been read
+            publishTableRows(std::move(rowInfos), std::move(trackIds));
+        } else {
+            filterAndSortRows(trackIds);
+            publishRows(std::move(rowInfos));
+            m_selectPending = true;
+            QTimer::singleShot(0, this, &BaseSqlTableModel::slotFinishSelect);
+        }
+    } else {
+        finishSelect();
+    }
+
+    qDebug() << this << "select() took" << time.elapsed().debugMillisWithUnit()
+             << m_rowInfo.size() << "published" << m_fetchedRowCount;
+}
+
+void BaseSqlTableModel::slotFinishSelect() {
+    if (!m_selectPending) {
+        // Superseded or already finished on demand
+        return;
+    }
+    PerformanceTimer time;
+    time.start();
+    finishSelect();
+    if (sDebug) {
+        qDebug() << this << "reading the remaining rows took"
+                 << time.elapsed().debugMillisWithUnit();
+    }
+}
+
+void BaseSqlTableModel::finishSelect() {
+    QVector<RowInfo> rowInfos;
+    QSet<TrackId> trackIds;
+    if (!queryTableRows(-1, &rowInfos, &trackIds)) {
+        m_selectPending = false;
+        return;
+    }
+    publishTableRows(std::move(rowInfos), std::move(trackIds));
+}
+
+bool BaseSqlTableModel::queryTableRows(
+        int limit,
+        QVector<RowInfo>* pRowInfos,
+        QSet<TrackId>* pTrackIds) {
     // Prepare query for id and all columns not in m_trackSource
     QString queryString = QString("SELECT %1 FROM %2 %3")
                                   .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+    if (limit >= 0) {
+        queryString.append(QString(" LIMIT %1").arg(limit));
+    }
 
     if (sDebug) {
         qDebug() << this << "select() executing:" << queryString;
     }
 
+    // The query must be executed on the connection of the GUI thread,
+    // because the tables of playlists and crates are temporary views
+    // that only exist for this connection.
     QSqlQuery query(m_database);
     // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
     // won't allocate a giant in-memory table that we won't use at all.
     query.setForwardOnly(true);
     if (!query.prepare(queryString)) {
         LOG_FAILED_QUERY(query);
-        return;
+        return false;
     }
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
-        return;
+        return false;
     }
 
-    // Remove all the rows from the table after(!) the query has been
-    // executed successfully. See Bug #1090888.
-    // TODO(rryan) we could edit the table in place instead of clearing it?
-    clearRows();
-
     // The size of the result set is not known in advance for a
     // forward-only query, so we cannot reserve memory for rows
     // in advance.
-    QVector<RowInfo> rowInfos;
-    QSet<TrackId> trackIds;
     int idColumn = -1;
     while (query.next()) {
         QSqlRecord sqlRecord = query.record();
@@ -249,30 +354,33 @@ void BaseSqlTableModel::select() {
             qCritical()
                     << "ID column not available in database query results:"
                     << m_idColumn;
-            return;
+            return false;
         }
         // TODO(XXX): Can we get rid of the hard-coded assumption that
         // the the first column always contains the id?
         DEBUG_ASSERT(idColumn == kIdColumn);
 
         TrackId trackId(sqlRecord.value(idColumn));
-        trackIds.insert(trackId);
+        pTrackIds->insert(trackId);
 
         RowInfo rowInfo;
         rowInfo.trackId = trackId;
         // current position defines the ordering
-        rowInfo.order = rowInfos.size();
+        rowInfo.order = pRowInfos->size();
         rowInfo.metadata.reserve(sqlRecord.count());
         for (int i = 0; i < m_tableColumns.size(); ++i) {
             rowInfo.metadata.push_back(sqlRecord.value(i));
         }
-        rowInfos.push_back(rowInfo);
+        pRowInfos->push_back(rowInfo);
     }
 
     if (sDebug) {
-        qDebug() << "Rows actually received:" << rowInfos.size();
+        qDebug() << "Rows actually received:" << pRowInfos->size();
     }
+    return true;
+}
 
+void BaseSqlTableModel::filterAndSortRows(const QSet<TrackId>& trackIds) {
     if (m_trackSource) {
         m_trackSource->filterAndSort(trackIds,
                 m_currentSearch,
@@ -281,7 +389,21 @@ void BaseSqlTableModel::select() {
                 m_sortColumns,
                 m_tableColumns.size() - 1, // exclude the 1st column with the id
                 &m_trackSortOrder);
+    }
+}
 
+void BaseSqlTableModel::publishTableRows(
+        QVector<RowInfo>&& rowInfos,
+        QSet<TrackId>&& trackIds) {
+    m_tableRows = rowInfos;
+    m_tableTrackIds = trackIds;
+    m_tableRowsValid = true;
+    filterAndSortRows(m_tableTrackIds);
+    publishRows(std::move(rowInfos));
+}
+
+void BaseSqlTableModel::publishRows(QVector<RowInfo> rowInfos) {
+    if (m_trackSource) {
         // Re-sort the track IDs since filterAndSort can change their order or mark
         // them for removal (by setting their row to -1).
         for (auto& rowInfo : rowInfos) {
@@ -322,14 +444,61 @@ void BaseSqlTableModel::select() {
     DEBUG_ASSERT(trackIdToRows.size() <= rowInfos.size());
 
     // We're done! Issue the update signals and replace the master maps.
+    // Removing the old and inserting the new rows happens at once without
+    // returning to the event loop.
     replaceRows(
             std::move(rowInfos),
             std::move(trackIdToRows));
     // Both rowInfo and trackIdToRows (might) have been moved and
     // must not be used afterwards!
+}
 
-    qDebug() << this << "select() took" << time.elapsed().debugMillisWithUnit()
-             << m_rowInfo.size();
+bool BaseSqlTableModel::startSearch() {
+    if (!m_bInitialized || !m_trackSource ||
+            !m_tableRowsValid || m_tableTrackIds.isEmpty()) {
+        return false;
+    }
+    TrackCacheSearchPointer pSearch = m_trackSource->prepareSearch(
+            m_tableTrackIds,
+            m_currentSearch,
+            m_currentSearchFilter,
+            m_trackSourceOrderBy,
+            m_sortColumns,
+            m_tableColumns.size() - 1); // exclude the 1st column with the id
+    if (!pSearch) {
+        return false;
+    }
+    // Typing in the search box supersedes the previous search
+    cancelSearch();
+    m_pSearch = pSearch;
+    m_searchWatcher.setFuture(m_trackSource->startSearch(std::move(pSearch)));
+    return true;
+}
+
+void BaseSqlTableModel::cancelSearch() {
+    if (m_pSearch) {
+        m_pSearch->cancel();
+        m_pSearch.reset();
+    }
+}
+
+void BaseSqlTableModel::slotSearchFinished() {
+    if (!m_pSearch || !m_searchWatcher.isFinished()) {
+        // Canceled or superseded by select()
+        return;
+    }
+    const TrackCacheSearchPointer pSearch = std::move(m_pSearch);
+    if (!m_searchWatcher.result()) {
+        return;
+    }
+    PerformanceTimer time;
+    time.start();
+    m_trackSource->finishSearch(pSearch.get(), &m_trackSortOrder);
+    publishRows(m_tableRows);
+    if (sDebug) {
+        qDebug() << this << "publishing search results took"
+                 << time.elapsed().debugMillisWithUnit();
+    }
 }
 
 void BaseSqlTableModel::setTable(const QString& tableName,
@@ -342,6 +511,11 @@ void BaseSqlTableModel::setTable(const QString& tableName,
     m_tableName = tableName;
     m_idColumn = idColumn;
     m_tableColumns = tableColumns;
+    cancelSearch();
+    m_selectPending = false;
+    m_tableRows.clear();
+    m_tableTrackIds.clear();
+    m_tableRowsValid = false;
 
     if (m_trackSource) {
         disconnect(m_trackSource.data(),
@@ -410,7 +584,12 @@ void BaseSqlTableModel::search(const QString& searchText, const QString& extraFi
         qDebug() << this << "search" << searchText;
     }
     setSearch(searchText, extraFilter);
-    select();
+    // Searching doesn't change the rows of the table and they only need
+    // to be filtered again. This is done concurrently to keep the GUI
+    // responsive while typing.
+    if (!startSearch()) {
+        select();
+    }
 }
 
 void BaseSqlTableModel::setSort(int column, Qt::SortOrder order) {
@@ -559,11 +738,56 @@ void BaseSqlTableModel::sort(int column, Qt::SortOrder order) {
 }
 
 int BaseSqlTableModel::rowCount(const QModelIndex& parent) const {
-    int count = parent.isValid() ? 0 : m_rowInfo.size();
+    int count = parent.isValid() ? 0 : m_fetchedRowCount;
     //qDebug() << "rowCount()" << parent << count;
     return count;
 }
 
+bool BaseSqlTableModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() &&
+            (m_selectPending || m_fetchedRowCount < m_rowInfo.size());
+}
+
+void BaseSqlTableModel::fetchMore(const QModelIndex& parent) {
+    if (!canFetchMore(parent)) {
+        return;
+    }
+    if (m_selectPending) {
+        finishSelect();
+        if (!canFetchMore(parent)) {
+            return;
+        }
+    }
+    const int numRows = std::min(
+            m_rowInfo.size() - m_fetchedRowCount,
+            kRowsPerFetch);
+    if (sDebug) {
+        qDebug() << this << "fetchMore()" << m_fetchedRowCount << numRows;
+    }
+    beginInsertRows(QModelIndex(), m_fetchedRowCount, m_fetchedRowCount + numRows - 1);
+    m_fetchedRowCount += numRows;
+    endInsertRows();
+}
+
+int BaseSqlTableModel::totalRowCount() {
+    if (m_selectPending) {
+        finishSelect();
+    }
+    return m_rowInfo.size();
+}
+
+void BaseSqlTableModel::fetchAll() {
+    if (m_selectPending) {
+        finishSelect();
+    }
+    if (!canFetchMore()) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), m_fetchedRowCount, m_rowInfo.size() - 1);
+    m_fetchedRowCount = m_rowInfo.size();
+    endInsertRows();
+}
+
 int BaseSqlTableModel::columnCount(const QModelIndex& parent) const {
     VERIFY_OR_DEBUG_ASSERT(!parent.isValid()) {
         return 0;
@@ -614,7 +838,7 @@ QVariant BaseSqlTableModel::rawValue(
 
     const int row = index.row();
     DEBUG_ASSERT(row >= 0);
-    if (row >= m_rowInfo.size()) {
+    if (row >= m_fetchedRowCount) {
         return QVariant();
     }
 
@@ -810,6 +1034,10 @@ void BaseSqlTableModel::tracksChanged(const QSet<TrackId>& trackIds) {
     for (const auto& trackId : trackIds) {
         const auto rows = getTrackRows(trackId);
         for (int row : rows) {
+            if (row >= m_fetchedRowCount) {
+                // Not published yet
+                continue;
+            }
             //qDebug() << "Row in this result set was updated. Signalling update. track:" << trackId << "row:" << row;
             QModelIndex topLeft = index(row, 0);
             QModelIndex bottomRight = index(row, numColumns);
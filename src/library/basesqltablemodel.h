@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QFutureWatcher>
 #include <QHash>
 #include <QtSql>
 
@@ -38,6 +39,21 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     int rowCount(const QModelIndex& parent = QModelIndex()) const final;
     int columnCount(const QModelIndex& parent = QModelIndex()) const final;
 
+    // The rows of a selection are published incrementally in pages, i.e.
+    // views only need to lay out and decode the rows that are actually
+    // scrolled into view. rowCount() only includes the published rows.
+    bool canFetchMore(const QModelIndex& parent = QModelIndex()) const final;
+    void fetchMore(const QModelIndex& parent = QModelIndex()) final;
+
+    // Publishes all remaining rows at once. Needs to be invoked before
+    // iterating over all rows of the model, e.g. for exporting them.
+    void fetchAll();
+
+    // The number of rows of the current selection, including those
+    // that have not been published yet. Reads the remaining rows of a
+    // pending select().
+    int totalRowCount();
+
     void sort(int column, Qt::SortOrder order) final;
 
     ///////////////////////////////////////////////////////////////////////////
@@ -51,6 +67,9 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     CoverInfo getCoverInfo(const QModelIndex& index) const override;
 
+    // Might also return rows that have not been published yet, see
+    // fetchMore(). Only includes the first page while select() is
+    // pending.
     const QVector<int> getTrackRows(TrackId trackId) const override {
         return m_trackIdToRows.value(trackId);
     }
@@ -103,6 +122,8 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
   private slots:
     void tracksChanged(const QSet<TrackId>& trackIds);
+    void slotSearchFinished();
+    void slotFinishSelect();
 
   private:
     void setTrackValueForColumn(
@@ -131,12 +152,41 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     typedef QHash<TrackId, QVector<int>> TrackId2Rows;
 
+    // Reads all rows of the table into m_tableRows and publishes them
+    void finishSelect();
+    // Reads the rows of the table, all rows if limit is negative
+    bool queryTableRows(
+            int limit,
+            QVector<RowInfo>* pRowInfos,
+            QSet<TrackId>* pTrackIds);
+    // Filters and sorts the tracks of the table into m_trackSortOrder
+    void filterAndSortRows(const QSet<TrackId>& trackIds);
+    void publishTableRows(
+            QVector<RowInfo>&& rowInfos,
+            QSet<TrackId>&& trackIds);
+    bool startsWithPublishedRows(const QVector<RowInfo>& rows) const;
+
     void clearRows();
     void replaceRows(
             QVector<RowInfo>&& rows,
             TrackId2Rows&& trackIdToRows);
-
+    // Orders the rows of the table according to m_trackSortOrder and
+    // replaces the current rows
+    void publishRows(QVector<RowInfo> rowInfos);
+
+    // Filters the rows of the table from the last select() again on the
+    // search thread of the track source. Returns false if the search
+    // needs to be performed synchronously by select().
+    bool startSearch();
+    void cancelSearch();
+
+    // All rows of the current selection, only the first
+    // m_fetchedRowCount rows have been published
     QVector<RowInfo> m_rowInfo;
+    int m_fetchedRowCount;
+    // Only the first page of the table has been read by select(), the
+    // remaining rows are read after returning to the event loop
+    bool m_selectPending;
 
     QString m_tableName;
     QString m_idColumn;
@@ -151,5 +201,14 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     QVector<QHash<int, QVariant> > m_headerInfo;
     QString m_trackSourceOrderBy;
 
+    // The unfiltered rows of the table from the last select() that
+    // are reused when only the search changes
+    QVector<RowInfo> m_tableRows;
+    QSet<TrackId> m_tableTrackIds;
+    bool m_tableRowsValid;
+
+    TrackCacheSearchPointer m_pSearch;
+    QFutureWatcher<bool> m_searchWatcher;
+
     DISALLOW_COPY_AND_ASSIGN(BaseSqlTableModel);
 };
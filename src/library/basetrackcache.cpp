@@ -3,6 +3,8 @@
 
 #include "library/basetrackcache.h"
 
+#include <QtConcurrentRun>
+
 #include "library/queryutil.h"
 #include "library/searchqueryparser.h"
 #include "library/trackcollection.h"
@@ -16,8 +18,95 @@ namespace {
 
 constexpr bool sDebug = false;
 
+ColumnarTrackIndex::ColumnType indexColumnType(
+        const ColumnCache& columnCache, int column) {
+    const ColumnCache::Column numberColumns[] = {
+            ColumnCache::COLUMN_LIBRARYTABLE_ID,
+            ColumnCache::COLUMN_LIBRARYTABLE_DURATION,
+            ColumnCache::COLUMN_LIBRARYTABLE_BITRATE,
+            ColumnCache::COLUMN_LIBRARYTABLE_BPM,
+            ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN,
+            ColumnCache::COLUMN_LIBRARYTABLE_CUEPOINT,
+            ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE,
+            ColumnCache::COLUMN_LIBRARYTABLE_CHANNELS,
+            ColumnCache::COLUMN_LIBRARYTABLE_MIXXXDELETED,
+            ColumnCache::COLUMN_LIBRARYTABLE_HEADERPARSED,
+            ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED,
+            ColumnCache::COLUMN_LIBRARYTABLE_PLAYED,
+            ColumnCache::COLUMN_LIBRARYTABLE_RATING,
+            ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID,
+            ColumnCache::COLUMN_LIBRARYTABLE_BPM_LOCK,
+            ColumnCache::COLUMN_LIBRARYTABLE_COLOR,
+            ColumnCache::COLUMN_LIBRARYTABLE_COVERART_SOURCE,
+            ColumnCache::COLUMN_LIBRARYTABLE_COVERART_TYPE,
+            ColumnCache::COLUMN_LIBRARYTABLE_COVERART_COLOR,
+            ColumnCache::COLUMN_LIBRARYTABLE_COVERART_HASH,
+            ColumnCache::COLUMN_TRACKLOCATIONSTABLE_FSDELETED,
+            ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_TRACKID,
+            ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION,
+            ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_PLAYLISTID,
+    };
+    const ColumnCache::Column stringColumns[] = {
+            ColumnCache::COLUMN_LIBRARYTABLE_ARTIST,
+            ColumnCache::COLUMN_LIBRARYTABLE_TITLE,
+            ColumnCache::COLUMN_LIBRARYTABLE_ALBUM,
+            ColumnCache::COLUMN_LIBRARYTABLE_ALBUMARTIST,
+            ColumnCache::COLUMN_LIBRARYTABLE_YEAR,
+            ColumnCache::COLUMN_LIBRARYTABLE_GENRE,
+            ColumnCache::COLUMN_LIBRARYTABLE_COMPOSER,
+            ColumnCache::COLUMN_LIBRARYTABLE_GROUPING,
+            ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER,
+            ColumnCache::COLUMN_LIBRARYTABLE_FILETYPE,
+            ColumnCache::COLUMN_LIBRARYTABLE_NATIVELOCATION,
+            ColumnCache::COLUMN_LIBRARYTABLE_COMMENT,
+            ColumnCache::COLUMN_LIBRARYTABLE_URL,
+            ColumnCache::COLUMN_LIBRARYTABLE_DATETIMEADDED,
+            ColumnCache::COLUMN_LIBRARYTABLE_KEY,
+            ColumnCache::COLUMN_LIBRARYTABLE_COVERART_LOCATION,
+            ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_LOCATION,
+            ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_ARTIST,
+            ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_TITLE,
+            ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_DATETIMEADDED,
+            ColumnCache::COLUMN_REKORDBOX_ANALYZE_PATH,
+    };
+    for (const auto numberColumn : numberColumns) {
+        if (columnCache.fieldIndex(numberColumn) == column) {
+            return ColumnarTrackIndex::ColumnType::Number;
+        }
+    }
+    for (const auto stringColumn : stringColumns) {
+        if (columnCache.fieldIndex(stringColumn) == column) {
+            return ColumnarTrackIndex::ColumnType::String;
+        }
+    }
+    // Binary data (e.g. digests) and unknown columns of external
+    // libraries are stored unmodified
+    return ColumnarTrackIndex::ColumnType::Variant;
+}
+
+QVector<ColumnarTrackIndex::ColumnType> indexColumnTypes(
+        const ColumnCache& columnCache, int numColumns) {
+    QVector<ColumnarTrackIndex::ColumnType> columnTypes;
+    columnTypes.reserve(numColumns);
+    for (int i = 0; i < numColumns; ++i) {
+        columnTypes.append(indexColumnType(columnCache, i));
+    }
+    return columnTypes;
+}
+
 }  // namespace
 
+TrackCacheSearch::TrackCacheSearch()
+        : m_columnOffset(0),
+          m_keyNotation(KeyUtils::KeyNotation::Invalid),
+          m_canceled(false) {
+}
+
+TrackCacheSearch::~TrackCacheSearch() {
+    // Required to allow forward declarations of (managed pointer) members
+    // in header file
+}
+
 BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
                                const QString& tableName,
                                const QString& idColumn,
@@ -31,6 +120,7 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
           m_pQueryParser(new SearchQueryParser(pTrackCollection)),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
+          m_trackIndex(columns, indexColumnTypes(m_columnCache, columns.size())),
           m_database(pTrackCollection->database()) {
     m_searchColumns << "artist"
                     << "album"
@@ -48,11 +138,15 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
     for (int i = 0; i < m_searchColumns.size(); ++i) {
         m_searchColumnIndices[i] = m_columnCache.fieldIndex(m_searchColumns[i]);
     }
+
+    // A single thread is sufficient, because all searches need
+    // exclusive access to the index
+    m_searchThreadPool.setMaxThreadCount(1);
 }
 
 BaseTrackCache::~BaseTrackCache() {
-    // Required to allow forward declarations of (managed pointer) members
-    // in header file
+    // Pending searches access the index
+    m_searchThreadPool.waitForDone();
 }
 
 int BaseTrackCache::columnCount() const {
@@ -94,7 +188,10 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
         qDebug() << this << "slotTracksRemoved" << trackIds.size();
     }
     for (const auto& trackId : qAsConst(trackIds)) {
-        m_trackInfo.remove(trackId);
+        {
+            const QMutexLocker locker(&m_trackIndexMutex);
+            m_trackIndex.removeRow(trackId);
+        }
         m_dirtyTracks.remove(trackId);
     }
 }
@@ -116,7 +213,7 @@ void BaseTrackCache::slotTrackClean(TrackId trackId) {
 }
 
 bool BaseTrackCache::isCached(TrackId trackId) const {
-    return m_trackInfo.contains(trackId);
+    return m_trackIndex.contains(trackId);
 }
 
 void BaseTrackCache::ensureCached(TrackId trackId) {
@@ -221,14 +318,12 @@ bool BaseTrackCache::updateTrackInIndex(
 
     TrackId trackId = pTrack->getId();
     if (trackId.isValid()) {
-        // m_trackInfo[id] will insert a QVector<QVariant> into the
-        // m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
         // preallocate memory for all columns at once
-        record.resize(numColumns);
+        QVector<QVariant> record(numColumns);
         for (int i = 0; i < numColumns; ++i) {
             getTrackValueForColumn(pTrack, i, record[i]);
         }
+        setTrackIndexRow(trackId, record);
         if (m_bIsCaching) {
             replaceRecentTrack(std::move(trackId), std::move(pTrack));
         }
@@ -266,14 +361,10 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
     int numColumns = columnCount();
     int idColumn = query.record().indexOf(m_idColumn);
 
+    QVector<QVariant> record(numColumns);
     while (query.next()) {
         TrackId trackId(query.value(idColumn));
 
-        //m_trackInfo[id] will insert a QVector<QVariant> into the
-        //m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        record.resize(numColumns);
-
         for (int i = 0; i < numColumns; ++i) {
             if (fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_NATIVELOCATION) == i) {
                 // Database stores all locations with Qt separators: "/"
@@ -285,6 +376,7 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
                 record[i] = query.value(i);
             }
         }
+        setTrackIndexRow(trackId, record);
     }
 
     qDebug() << this << "updateIndexWithQuery took" << timer.elapsed().debugMillisWithUnit();
@@ -306,7 +398,10 @@ void BaseTrackCache::buildIndex() {
     // TODO(rryan) for very large tables, it probably makes more sense to NOT
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
-    m_trackInfo.clear();
+    {
+        const QMutexLocker locker(&m_trackIndexMutex);
+        m_trackIndex.clear();
+    }
 
     if (!updateIndexWithQuery(queryString)) {
         qDebug() << "buildIndex failed!";
@@ -315,6 +410,12 @@ void BaseTrackCache::buildIndex() {
     m_bIndexBuilt = true;
 }
 
+void BaseTrackCache::setTrackIndexRow(
+        TrackId trackId, const QVector<QVariant>& record) {
+    const QMutexLocker locker(&m_trackIndexMutex);
+    m_trackIndex.setRow(trackId, record);
+}
+
 void BaseTrackCache::updateTrackInIndex(TrackId trackId) {
     QSet<TrackId> trackIds;
     trackIds.insert(trackId);
@@ -448,10 +549,9 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     // metadata. Currently the upper-levels will not delegate row-specific
     // columns to this method, but there should still be a check here I think.
     if (!result.isValid()) {
-        auto it = m_trackInfo.constFind(trackId);
-        if (it != m_trackInfo.constEnd()) {
-            const QVector<QVariant>& fields = it.value();
-            result = fields.value(column, result);
+        const int row = m_trackIndex.findRow(trackId);
+        if (row >= 0 && column >= 0 && column < m_trackIndex.columnCount()) {
+            result = m_trackIndex.value(row, column);
         }
     }
     return result;
@@ -473,74 +573,195 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         buildIndex();
     }
 
+    const auto pSearch = prepareSearch(trackIds,
+            searchQuery,
+            extraFilter,
+            orderByClause,
+            sortColumns,
+            columnOffset);
+    if (pSearch) {
+        runSearch(pSearch.get());
+        finishSearch(pSearch.get(), trackToIndex);
+        return;
+    }
+
+    PerformanceTimer timer;
+    timer.start();
+
     QStringList idStrings;
-    // TODO(rryan) consider making this the data passed in and a separate
-    // QVector for output
-    QSet<TrackId> dirtyTracks;
-    for (const auto& trackId: trackIds) {
+    idStrings.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
         idStrings << trackId.toString();
-        if (m_dirtyTracks.contains(trackId)) {
-            dirtyTracks.insert(trackId);
-        }
     }
 
     QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
-    }
+    queryFragments << QString("(%1)").arg(extraFilter);
+    queryFragments << QString("%1 in (%2)")
+            .arg(m_idColumn, idStrings.join(","));
 
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    m_searchColumns,
-                    queryFragments.join(" AND "));
+    std::unique_ptr<QueryNode> pQuery = m_pQueryParser->parseQuery(
+            searchQuery,
+            m_searchColumns,
+            queryFragments.join(" AND "));
 
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
+    QVector<TrackId> trackOrder = selectTracksWithSql(*pQuery, orderByClause);
 
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+    trackToIndex->clear();
+    trackToIndex->reserve(trackOrder.size());
+    for (int i = 0; i < trackOrder.size(); ++i) {
+        (*trackToIndex)[trackOrder[i]] = i;
+    }
 
     if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
+        qDebug() << this << "filterAndSort selected" << trackOrder.size()
+                 << "tracks with SQL in" << timer.elapsed().debugMillisWithUnit();
     }
 
-    QSqlQuery query(m_database);
-    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
-    // won't allocate a giant in-memory table that we won't use at all.
-    query.setForwardOnly(true);
-    query.prepare(queryString);
+    updateDirtyTracksInResult(dirtyTracks(trackIds),
+            searchQuery.isEmpty() ? nullptr : pQuery.get(),
+            sortColumns,
+            columnOffset,
+            &trackOrder,
+            trackToIndex);
+}
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+TrackCacheSearchPointer BaseTrackCache::prepareSearch(
+        const QSet<TrackId>& trackIds,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QString& orderByClause,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset) {
+    // Additional SQL filters and a random order can only be handled
+    // by the database
+    if (!extraFilter.isEmpty() ||
+            orderByClause.contains("RANDOM()", Qt::CaseInsensitive)) {
+        return TrackCacheSearchPointer();
     }
 
-    int idColumn = query.record().indexOf(m_idColumn);
-    int rows = query.size();
+    if (!m_bIndexBuilt) {
+        buildIndex();
+    }
+
+    auto pSearch = TrackCacheSearchPointer(new TrackCacheSearch());
+    pSearch->m_trackIds = trackIds;
+    if (!searchQuery.isEmpty()) {
+        pSearch->m_pQuery = m_pQueryParser->parseQuery(
+                searchQuery,
+                m_searchColumns,
+                QString());
+        // The database must not be accessed on the search thread
+        pSearch->m_pQuery->prepareMatch();
+    }
+    pSearch->m_sortColumns = sortColumns;
+    pSearch->m_columnOffset = columnOffset;
+    // The model only uses our order if there is an ORDER BY clause
+    if (!orderByClause.isEmpty()) {
+        pSearch->m_sortKeys = sortKeys(sortColumns, columnOffset);
+    }
+    pSearch->m_keyNotation = m_columnCache.keyNotation();
+    return pSearch;
+}
+
+QFuture<bool> BaseTrackCache::startSearch(TrackCacheSearchPointer pSearch) {
+    DEBUG_ASSERT(pSearch);
+    return QtConcurrent::run(&m_searchThreadPool, [this, pSearch] {
+        return runSearch(pSearch.get());
+    });
+}
+
+bool BaseTrackCache::runSearch(TrackCacheSearch* pSearch) const {
+    PerformanceTimer timer;
+    timer.start();
+
+    {
+        const QMutexLocker locker(&m_trackIndexMutex);
+        pSearch->m_trackOrder = m_trackIndex.select(
+                pSearch->m_trackIds,
+                pSearch->m_pQuery.get(),
+                pSearch->m_sortKeys,
+                pSearch->m_keyNotation,
+                &pSearch->m_canceled);
+    }
+    if (pSearch->isCanceled()) {
+        if (sDebug) {
+            qDebug() << this << "search canceled after"
+                     << timer.elapsed().debugMillisWithUnit();
+        }
+        return false;
+    }
 
     if (sDebug) {
-        qDebug() << "Rows returned:" << rows;
+        qDebug() << this << "search selected" << pSearch->m_trackOrder.size()
+                 << "tracks from the index in" << timer.elapsed().debugMillisWithUnit();
     }
+    return true;
+}
 
-    m_trackOrder.resize(0); // keeps allocated memory
+void BaseTrackCache::finishSearch(
+        TrackCacheSearch* pSearch,
+        QHash<TrackId, int>* trackToIndex) {
+    DEBUG_ASSERT(!pSearch->isCanceled());
     trackToIndex->clear();
-    if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
+    trackToIndex->reserve(pSearch->m_trackOrder.size());
+    for (int i = 0; i < pSearch->m_trackOrder.size(); ++i) {
+        (*trackToIndex)[pSearch->m_trackOrder[i]] = i;
+    }
+
+    // Tracks might have become dirty while searching
+    updateDirtyTracksInResult(dirtyTracks(pSearch->m_trackIds),
+            pSearch->m_pQuery.get(),
+            pSearch->m_sortColumns,
+            pSearch->m_columnOffset,
+            &pSearch->m_trackOrder,
+            trackToIndex);
+}
+
+QVector<ColumnarTrackIndex::SortKey> BaseTrackCache::sortKeys(
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset) const {
+    QVector<ColumnarTrackIndex::SortKey> sortKeys;
+    for (const auto& sc : sortColumns) {
+        int column;
+        if (sc.m_column <= columnOffset) {
+            // Columns of the table model are not contained in
+            // the track source. Only the id is mapped to the
+            // 1st column like in BaseSqlTableModel::setSort().
+            if (sc.m_column != 0) {
+                continue;
+            }
+            column = 0;
+        } else {
+            column = sc.m_column - columnOffset;
+        }
+        if (column >= columnCount()) {
+            continue;
+        }
+        sortKeys.append(ColumnarTrackIndex::SortKey{
+                column,
+                sortModeForColumn(column),
+                sc.m_order});
     }
+    return sortKeys;
+}
 
-    while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+QSet<TrackId> BaseTrackCache::dirtyTracks(const QSet<TrackId>& trackIds) const {
+    QSet<TrackId> dirtyTracks;
+    for (const auto& trackId : qAsConst(m_dirtyTracks)) {
+        if (trackIds.contains(trackId)) {
+            dirtyTracks.insert(trackId);
+        }
     }
+    return dirtyTracks;
+}
 
+void BaseTrackCache::updateDirtyTracksInResult(
+        const QSet<TrackId>& dirtyTracks,
+        const QueryNode* pQuery,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QVector<TrackId>* pTrackOrder,
+        QHash<TrackId, int>* trackToIndex) {
     // At this point, the original set of tracks have been divided into two
     // pieces: those that should be in the result set and those that should
     // not. Unfortunately, due to TrackDAO caching, there may be tracks in
@@ -565,8 +786,7 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
 
         // The track should be in the result set if the search is empty or the
         // track matches the search.
-        bool shouldBeInResultSet = searchQuery.isEmpty() ||
-                pQuery->match(pTrack);
+        bool shouldBeInResultSet = !pQuery || pQuery->match(pTrack);
 
         // If the track is in this result set.
         bool isInResultSet = trackToIndex->contains(trackId);
@@ -578,14 +798,14 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
             // will sort wrong).
             if (isInResultSet) {
                 int index = (*trackToIndex)[trackId];
-                m_trackOrder.remove(index);
+                pTrackOrder->remove(index);
                 // Don't update trackToIndex, since we do it below.
             }
 
             // Figure out where it is supposed to sort. The table is sorted by
             // the sort column, so we can binary search.
             int insertRow = findSortInsertionPoint(
-                    pTrack, sortColumns, columnOffset, m_trackOrder);
+                    pTrack, sortColumns, columnOffset, *pTrackOrder);
 
             if (sDebug) {
                 qDebug() << this
@@ -594,28 +814,84 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
             }
 
             // The track should sort at insertRow
-            m_trackOrder.insert(insertRow, trackId);
+            pTrackOrder->insert(insertRow, trackId);
 
             trackToIndex->clear();
             // Fix the index. TODO(rryan) find a non-stupid way to do this.
-            for (int i = 0; i < m_trackOrder.size(); ++i) {
-                (*trackToIndex)[m_trackOrder[i]] = i;
+            for (int i = 0; i < pTrackOrder->size(); ++i) {
+                (*trackToIndex)[pTrackOrder->at(i)] = i;
             }
         } else if (isInResultSet) {
             // Track should not be in this result set, but it is. We need to
             // remove it.
             int index = (*trackToIndex)[trackId];
-            m_trackOrder.remove(index);
+            pTrackOrder->remove(index);
 
             trackToIndex->clear();
             // Fix the index. TODO(rryan) find a non-stupid way to do this.
-            for (int i = 0; i < m_trackOrder.size(); ++i) {
-                (*trackToIndex)[m_trackOrder[i]] = i;
+            for (int i = 0; i < pTrackOrder->size(); ++i) {
+                (*trackToIndex)[pTrackOrder->at(i)] = i;
             }
         }
     }
 }
 
+QVector<TrackId> BaseTrackCache::selectTracksWithSql(
+        const QueryNode& query,
+        const QString& orderByClause) const {
+    QString filter = query.toSql();
+    if (!filter.isEmpty()) {
+        filter.prepend("WHERE ");
+    }
+
+    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn, m_tableName, filter, orderByClause);
+
+    if (sDebug) {
+        qDebug() << this << "select() executing:" << queryString;
+    }
+
+    QSqlQuery sqlQuery(m_database);
+    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+    // won't allocate a giant in-memory table that we won't use at all.
+    sqlQuery.setForwardOnly(true);
+    sqlQuery.prepare(queryString);
+
+    if (!sqlQuery.exec()) {
+        LOG_FAILED_QUERY(sqlQuery);
+    }
+
+    QVector<TrackId> trackOrder;
+    int idColumn = sqlQuery.record().indexOf(m_idColumn);
+    while (sqlQuery.next()) {
+        trackOrder.append(TrackId(sqlQuery.value(idColumn)));
+    }
+
+    if (sDebug) {
+        qDebug() << "Rows returned:" << trackOrder.size();
+    }
+    return trackOrder;
+}
+
+ColumnarTrackIndex::SortMode BaseTrackCache::sortModeForColumn(int column) const {
+    if (column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_YEAR) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_DURATION) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BITRATE) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BPM) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_CHANNELS) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED) ||
+            column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_RATING) ||
+            column == fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION)) {
+        return ColumnarTrackIndex::SortMode::Numeric;
+    } else if (column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY)) {
+        return ColumnarTrackIndex::SortMode::Key;
+    }
+    return ColumnarTrackIndex::SortMode::Collated;
+}
+
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         const QList<SortColumn>& sortColumns,
         const int columnOffset,
@@ -646,7 +922,7 @@ int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
 
         // This should not happen, but it's a recoverable error so we should
         // only log it.
-        if (!m_trackInfo.contains(otherTrackId)) {
+        if (!m_trackIndex.contains(otherTrackId)) {
             qDebug() << "WARNING: track" << otherTrackId << "was not in index";
             //updateTrackInIndex(otherTrackId);
         }
@@ -687,18 +963,8 @@ int BaseTrackCache::compareColumnValues(int sortColumn,
         const QVariant& val2) const {
     int result = 0;
 
-    if (sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_YEAR) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_DURATION) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BITRATE) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_BPM) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_CHANNELS) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_RATING) ||
-            sortColumn == fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION)
-    ) {
+    switch (sortModeForColumn(sortColumn)) {
+    case ColumnarTrackIndex::SortMode::Numeric: {
         // Sort as floats.
         double delta = val1.toDouble() - val2.toDouble();
 
@@ -708,7 +974,9 @@ int BaseTrackCache::compareColumnValues(int sortColumn,
             result = 1;
         else
             result = -1;
-    } else if (sortColumn == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY)) {
+        break;
+    }
+    case ColumnarTrackIndex::SortMode::Key: {
         KeyUtils::KeyNotation keyNotation = m_columnCache.keyNotation();
 
         int key1 = KeyUtils::keyToCircleOfFifthsOrder(
@@ -722,8 +990,11 @@ int BaseTrackCache::compareColumnValues(int sortColumn,
         } else if (key1 == key2) {
             result = 0;
         }
-    } else {
+        break;
+    }
+    case ColumnarTrackIndex::SortMode::Collated:
         result = m_collator.compare(val1.toString(), val2.toString());
+        break;
     }
 
     // If we're in descending order, flip the comparison.
@@ -1,21 +1,27 @@
 #pragma once
 
+#include <QFuture>
 #include <QHash>
 #include <QList>
+#include <QMutex>
 #include <QObject>
 #include <QSet>
 #include <QSqlDatabase>
 #include <QString>
 #include <QStringList>
+#include <QThreadPool>
 #include <QVector>
+#include <atomic>
 #include <memory>
 
+#include "library/columnartrackindex.h"
 #include "library/columncache.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
 
@@ -29,12 +35,51 @@ class SortColumn {
     Qt::SortOrder m_order;
 };
 
+// A search that has been prepared by BaseTrackCache::prepareSearch()
+// for executing it concurrently on the search thread of the cache.
+class TrackCacheSearch final {
+  public:
+    ~TrackCacheSearch();
+
+    // Aborts the search if it is still pending or running. The
+    // result of a canceled search must not be used.
+    void cancel() {
+        m_canceled.store(true);
+    }
+    bool isCanceled() const {
+        return m_canceled.load();
+    }
+
+  private:
+    friend class BaseTrackCache;
+    TrackCacheSearch();
+
+    QSet<TrackId> m_trackIds;
+    std::unique_ptr<QueryNode> m_pQuery;
+    QList<SortColumn> m_sortColumns;
+    int m_columnOffset;
+    QVector<ColumnarTrackIndex::SortKey> m_sortKeys;
+    KeyUtils::KeyNotation m_keyNotation;
+    std::atomic<bool> m_canceled;
+
+    QVector<TrackId> m_trackOrder;
+
+    DISALLOW_COPY_AND_ASSIGN(TrackCacheSearch);
+};
+
+typedef std::shared_ptr<TrackCacheSearch> TrackCacheSearchPointer;
+
 // BaseTrackCache is a cache of all of the values in certain table. It supports
 // searching and sorting of tracks by values within the table. The reasoning for
 // this is that previously there was a per-table-model cache which was largely a
 // waste of memory because all the table-models were caching the same data
 // (track properties). Furthermore, the base SQL tables of these table-models
 // involve complicated joins, which are very slow.
+//
+// Searching and sorting is performed on a columnar in-memory index without
+// querying the database unless an additional SQL filter is given. Those
+// searches can also be executed concurrently on a dedicated search thread
+// to keep the GUI responsive while typing.
 class BaseTrackCache : public QObject {
     Q_OBJECT
   public:
@@ -70,6 +115,26 @@ class BaseTrackCache : public QObject {
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
                                QHash<TrackId, int>* trackToIndex);
+
+    // Prepares the same search as filterAndSort() for executing it
+    // concurrently with startSearch(). Returns nullptr if the search
+    // requires the database and can only be performed synchronously
+    // by filterAndSort().
+    TrackCacheSearchPointer prepareSearch(const QSet<TrackId>& trackIds,
+            const QString& query,
+            const QString& extraFilter,
+            const QString& orderByClause,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset);
+    // Executes a prepared search on the search thread. Searches are
+    // executed one after another in the order they have been started.
+    // The future returns false if the search has been canceled.
+    QFuture<bool> startSearch(TrackCacheSearchPointer pSearch);
+    // Stores the result of a search like filterAndSort() after it has
+    // finished on the search thread.
+    void finishSearch(TrackCacheSearch* pSearch,
+            QHash<TrackId, int>* trackToIndex);
+
     virtual bool isCached(TrackId trackId) const;
     virtual void ensureCached(TrackId trackId);
     virtual void ensureCached(const QSet<TrackId>& trackIds);
@@ -99,6 +164,32 @@ class BaseTrackCache : public QObject {
     void getTrackValueForColumn(TrackPointer pTrack, int column,
                                 QVariant& trackValue) const;
 
+    // Selects the tracks of a prepared search from the index. Might be
+    // invoked on any thread.
+    bool runSearch(TrackCacheSearch* pSearch) const;
+    QVector<ColumnarTrackIndex::SortKey> sortKeys(
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset) const;
+    void setTrackIndexRow(TrackId trackId, const QVector<QVariant>& record);
+
+    QSet<TrackId> dirtyTracks(const QSet<TrackId>& trackIds) const;
+    // Fixes the membership and position of dirty tracks in the result,
+    // because their properties in the index might be outdated.
+    void updateDirtyTracksInResult(const QSet<TrackId>& dirtyTracks,
+            const QueryNode* pQuery,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            QVector<TrackId>* pTrackOrder,
+            QHash<TrackId, int>* trackToIndex);
+
+    // Selects the matching tracks from the table in SQL order. Only
+    // needed if the query contains SQL filters that cannot be evaluated
+    // on the index.
+    QVector<TrackId> selectTracksWithSql(
+            const QueryNode& query,
+            const QString& orderByClause) const;
+    ColumnarTrackIndex::SortMode sortModeForColumn(int column) const;
+
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
@@ -129,10 +220,6 @@ class BaseTrackCache : public QObject {
     QStringList m_searchColumns;
     QVector<int> m_searchColumnIndices;
 
-    // Temporary storage for filterAndSort()
-
-    QVector<TrackId> m_trackOrder;
-
     // Remember key and value of the most recent cache lookup to avoid querying
     // the global track cache again and again while populating the columns
     // of a single row. These members serve as a single-valued private cache.
@@ -147,7 +234,12 @@ class BaseTrackCache : public QObject {
 
     bool m_bIndexBuilt;
     bool m_bIsCaching;
-    QHash<TrackId, QVector<QVariant> > m_trackInfo;
+    ColumnarTrackIndex m_trackIndex;
+    // Synchronizes modifications of the index with searches on the
+    // search thread. Reading the index on the GUI thread doesn't require
+    // locking, because it is only modified on this thread.
+    mutable QMutex m_trackIndexMutex;
+    QThreadPool m_searchThreadPool;
     QSqlDatabase m_database;
     ControlProxy* m_pKeyNotationCP;
 
@@ -0,0 +1,378 @@
+#include "library/columnartrackindex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "library/searchquery.h"
+#include "util/assert.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+constexpr double kNullSortValue = -std::numeric_limits<double>::infinity();
+
+// The SQLite driver returns NULL values as null strings
+const QVariant kNullValue = QVariant(QVariant::String);
+
+// The number of rows between two checks if a selection has been canceled
+constexpr int kRowsPerCancellationCheck = 4096;
+
+bool isCanceled(const std::atomic<bool>* pCanceled) {
+    return pCanceled && pCanceled->load(std::memory_order_relaxed);
+}
+
+} // anonymous namespace
+
+ColumnarTrackIndex::ColumnarTrackIndex(
+        const QStringList& columnNames,
+        const QVector<ColumnType>& columnTypes)
+        : m_sortedRowsValid(false),
+          m_sortedRowsKeyNotation(KeyUtils::KeyNotation::Invalid) {
+    DEBUG_ASSERT(columnNames.size() == columnTypes.size());
+    m_columns.resize(columnTypes.size());
+    for (int i = 0; i < columnTypes.size(); ++i) {
+        m_columns[i].type = columnTypes[i];
+        m_columnIndexByName.insert(columnNames.value(i), i);
+    }
+}
+
+void ColumnarTrackIndex::clear() {
+    for (auto& column : m_columns) {
+        const ColumnType type = column.type;
+        column = Column();
+        column.type = type;
+    }
+    m_trackIds.clear();
+    m_rowsByTrackId.clear();
+    invalidateSortedRows();
+}
+
+void ColumnarTrackIndex::setRow(TrackId trackId, const QVector<QVariant>& values) {
+    VERIFY_OR_DEBUG_ASSERT(trackId.isValid()) {
+        return;
+    }
+    DEBUG_ASSERT(values.size() == columnCount());
+    int row = findRow(trackId);
+    if (row < 0) {
+        row = rowCount();
+        m_trackIds.push_back(trackId);
+        m_rowsByTrackId.insert(trackId, row);
+        for (auto& column : m_columns) {
+            switch (column.type) {
+            case ColumnType::Number:
+                column.numbers.push_back(std::numeric_limits<double>::quiet_NaN());
+                break;
+            case ColumnType::String:
+                column.stringIds.push_back(-1);
+                break;
+            case ColumnType::Variant:
+                column.variants.append(QVariant());
+                break;
+            }
+        }
+    }
+    for (int i = 0; i < columnCount(); ++i) {
+        setValue(row, i, values.value(i));
+    }
+    invalidateSortedRows();
+}
+
+void ColumnarTrackIndex::removeRow(TrackId trackId) {
+    const auto it = m_rowsByTrackId.find(trackId);
+    if (it == m_rowsByTrackId.end()) {
+        return;
+    }
+    // The row remains in the sort order, but will not be selected
+    // anymore
+    m_trackIds[it.value()] = TrackId();
+    m_rowsByTrackId.erase(it);
+}
+
+void ColumnarTrackIndex::setValue(int row, int column, const QVariant& value) {
+    Column* pColumn = &m_columns[column];
+    if (!value.isNull() && pColumn->valueType == QVariant::Invalid) {
+        pColumn->valueType = value.type();
+    }
+    switch (pColumn->type) {
+    case ColumnType::Number:
+        pColumn->numbers[row] = value.isNull()
+                ? std::numeric_limits<double>::quiet_NaN()
+                : value.toDouble();
+        break;
+    case ColumnType::String:
+        pColumn->stringIds[row] = value.isNull()
+                ? -1
+                : internString(pColumn, value.toString());
+        break;
+    case ColumnType::Variant:
+        pColumn->variants[row] = value;
+        break;
+    }
+}
+
+int ColumnarTrackIndex::internString(Column* pColumn, const QString& value) {
+    const auto it = pColumn->stringIdsByValue.constFind(value);
+    if (it != pColumn->stringIdsByValue.constEnd()) {
+        return it.value();
+    }
+    PooledString pooledString;
+    pooledString.value = value;
+    pooledString.folded = value;
+    mixxx::DbConnection::makeStringLatinLow(&pooledString.folded);
+    pooledString.number = value.toDouble();
+    const int stringId = pColumn->strings.size();
+    pColumn->foldedStringTrigrams.insert(stringId, pooledString.folded);
+    pColumn->strings.append(std::move(pooledString));
+    pColumn->stringIdsByValue.insert(value, stringId);
+    return stringId;
+}
+
+bool ColumnarTrackIndex::findStrings(
+        int column,
+        const QString& foldedSubstring,
+        std::vector<int>* pStringIds) const {
+    const Column& col = m_columns[column];
+    DEBUG_ASSERT(col.type == ColumnType::String);
+    if (!col.foldedStringTrigrams.findCandidates(foldedSubstring, pStringIds)) {
+        return false;
+    }
+    pStringIds->erase(
+            std::remove_if(pStringIds->begin(),
+                    pStringIds->end(),
+                    [&col, &foldedSubstring](int stringId) {
+                        return !col.strings[stringId].folded.contains(foldedSubstring);
+                    }),
+            pStringIds->end());
+    return true;
+}
+
+QVariant ColumnarTrackIndex::value(int row, int column) const {
+    const Column& col = m_columns[column];
+    switch (col.type) {
+    case ColumnType::Number: {
+        const double number = col.numbers[row];
+        if (std::isnan(number)) {
+            return kNullValue;
+        }
+        QVariant result(number);
+        if (col.valueType != QVariant::Invalid) {
+            result.convert(col.valueType);
+        }
+        return result;
+    }
+    case ColumnType::String: {
+        const int stringId = col.stringIds[row];
+        if (stringId < 0) {
+            return kNullValue;
+        }
+        return col.strings[stringId].value;
+    }
+    case ColumnType::Variant:
+        return col.variants[row];
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return QVariant();
+}
+
+bool ColumnarTrackIndex::isNull(int row, int column) const {
+    const Column& col = m_columns[column];
+    switch (col.type) {
+    case ColumnType::Number:
+        return std::isnan(col.numbers[row]);
+    case ColumnType::String:
+        return col.stringIds[row] < 0;
+    case ColumnType::Variant:
+        return col.variants[row].isNull();
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return true;
+}
+
+double ColumnarTrackIndex::number(int row, int column) const {
+    const Column& col = m_columns[column];
+    switch (col.type) {
+    case ColumnType::Number:
+        return col.numbers[row];
+    case ColumnType::String: {
+        const int stringId = col.stringIds[row];
+        if (stringId < 0) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return col.strings[stringId].number;
+    }
+    case ColumnType::Variant: {
+        const QVariant& value = col.variants[row];
+        if (value.isNull()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return value.toDouble();
+    }
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+QVector<TrackId> ColumnarTrackIndex::select(
+        const QSet<TrackId>& trackIds,
+        const QueryNode* pQuery,
+        const QVector<SortKey>& sortKeys,
+        KeyUtils::KeyNotation keyNotation,
+        const std::atomic<bool>* pCanceled) const {
+    std::vector<bool> selectedRows(m_trackIds.size(), false);
+    for (const auto& trackId : trackIds) {
+        const int row = findRow(trackId);
+        if (row >= 0) {
+            selectedRows[row] = true;
+        }
+    }
+
+    QVector<TrackId> result;
+    if (isCanceled(pCanceled)) {
+        return result;
+    }
+    result.reserve(trackIds.size());
+    int rowsUntilCancellationCheck = kRowsPerCancellationCheck;
+    // Returns false if the selection has been canceled
+    const auto selectRow = [&](int row) {
+        if (selectedRows[row] && (!pQuery || pQuery->match(*this, row))) {
+            result.append(m_trackIds[row]);
+        }
+        if (--rowsUntilCancellationCheck > 0) {
+            return true;
+        }
+        rowsUntilCancellationCheck = kRowsPerCancellationCheck;
+        return !isCanceled(pCanceled);
+    };
+    if (sortKeys.isEmpty()) {
+        for (int row = 0; row < rowCount(); ++row) {
+            if (!selectRow(row)) {
+                return QVector<TrackId>();
+            }
+        }
+    } else {
+        for (const int row : sortedRows(sortKeys, keyNotation)) {
+            if (!selectRow(row)) {
+                return QVector<TrackId>();
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<double> ColumnarTrackIndex::sortValues(
+        const SortKey& sortKey,
+        KeyUtils::KeyNotation keyNotation) const {
+    const Column& column = m_columns[sortKey.column];
+    std::vector<double> values(m_trackIds.size());
+    if (sortKey.mode == SortMode::Numeric || column.type == ColumnType::Number) {
+        for (int row = 0; row < rowCount(); ++row) {
+            const double number = this->number(row, sortKey.column);
+            values[row] = std::isnan(number) ? kNullSortValue : number;
+        }
+    } else if (column.type == ColumnType::String) {
+        // Compute the sort value once per distinct string
+        std::vector<int> ranks;
+        if (sortKey.mode == SortMode::Key) {
+            ranks.resize(column.strings.size());
+            for (int i = 0; i < column.strings.size(); ++i) {
+                ranks[i] = KeyUtils::keyToCircleOfFifthsOrder(
+                        KeyUtils::guessKeyFromText(column.strings[i].value),
+                        keyNotation);
+            }
+        } else {
+            if (column.collationRanks.size() != static_cast<std::size_t>(column.strings.size())) {
+                std::vector<int> stringIds(column.strings.size());
+                std::iota(stringIds.begin(), stringIds.end(), 0);
+                std::sort(stringIds.begin(), stringIds.end(), [&](int lhs, int rhs) {
+                    return m_collator.compare(
+                                   column.strings[lhs].value,
+                                   column.strings[rhs].value) < 0;
+                });
+                column.collationRanks.resize(stringIds.size());
+                for (std::size_t i = 0; i < stringIds.size(); ++i) {
+                    // Strings that collate equally get the same rank
+                    column.collationRanks[stringIds[i]] =
+                            (i > 0 &&
+                                    m_collator.compare(
+                                            column.strings[stringIds[i - 1]].value,
+                                            column.strings[stringIds[i]].value) == 0)
+                            ? column.collationRanks[stringIds[i - 1]]
+                            : static_cast<int>(i);
+                }
+            }
+            ranks = column.collationRanks;
+        }
+        const double nullValue = sortKey.mode == SortMode::Key
+                ? KeyUtils::keyToCircleOfFifthsOrder(
+                          mixxx::track::io::key::INVALID, keyNotation)
+                : kNullSortValue;
+        for (int row = 0; row < rowCount(); ++row) {
+            const int stringId = column.stringIds[row];
+            values[row] = stringId < 0 ? nullValue : ranks[stringId];
+        }
+    } else {
+        // Variant columns are rarely sorted, rank all rows
+        std::vector<int> rows(m_trackIds.size());
+        std::iota(rows.begin(), rows.end(), 0);
+        if (sortKey.mode == SortMode::Key) {
+            for (const int row : rows) {
+                values[row] = KeyUtils::keyToCircleOfFifthsOrder(
+                        KeyUtils::guessKeyFromText(column.variants[row].toString()),
+                        keyNotation);
+            }
+        } else {
+            std::stable_sort(rows.begin(), rows.end(), [&](int lhs, int rhs) {
+                return m_collator.compare(
+                               column.variants[lhs].toString(),
+                               column.variants[rhs].toString()) < 0;
+            });
+            for (std::size_t i = 0; i < rows.size(); ++i) {
+                values[rows[i]] = static_cast<double>(i);
+            }
+        }
+    }
+    if (sortKey.order == Qt::DescendingOrder) {
+        for (auto& value : values) {
+            value = -value;
+        }
+    }
+    return values;
+}
+
+const std::vector<int>& ColumnarTrackIndex::sortedRows(
+        const QVector<SortKey>& sortKeys,
+        KeyUtils::KeyNotation keyNotation) const {
+    if (m_sortedRowsValid &&
+            m_sortedRowsKeys == sortKeys &&
+            m_sortedRowsKeyNotation == keyNotation) {
+        return m_sortedRows;
+    }
+    std::vector<std::vector<double>> values;
+    values.reserve(sortKeys.size());
+    for (const auto& sortKey : sortKeys) {
+        values.push_back(sortValues(sortKey, keyNotation));
+    }
+    m_sortedRows.resize(m_trackIds.size());
+    std::iota(m_sortedRows.begin(), m_sortedRows.end(), 0);
+    std::stable_sort(m_sortedRows.begin(), m_sortedRows.end(), [&values](int lhs, int rhs) {
+        for (const auto& keyValues : values) {
+            if (keyValues[lhs] < keyValues[rhs]) {
+                return true;
+            }
+            if (keyValues[rhs] < keyValues[lhs]) {
+                return false;
+            }
+        }
+        return false;
+    });
+    m_sortedRowsKeys = sortKeys;
+    m_sortedRowsKeyNotation = keyNotation;
+    m_sortedRowsValid = true;
+    return m_sortedRows;
+}
+
+void ColumnarTrackIndex::invalidateSortedRows() {
+    m_sortedRowsValid = false;
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <atomic>
+#include <vector>
+
+#include "library/trigramindex.h"
+#include "track/keyutils.h"
+#include "track/trackid.h"
+#include "util/string.h"
+
+class QueryNode;
+
+// An in-memory index of the track properties of a BaseTrackCache that
+// can be searched and sorted without querying the database.
+//
+// Each column is stored in a contiguous array. Numeric columns store
+// plain doubles, text columns store references into a per-column pool
+// of interned strings. Most text columns only contain few distinct
+// values (artist, album, genre, ...), so searching and sorting works
+// on the pool instead of the rows: Search terms are matched once per
+// distinct string and sorting compares precomputed ranks. The strings
+// of each pool are indexed by their trigrams to find those that contain
+// a search term without scanning the whole pool. The sort
+// permutation of all rows is cached until the index is modified,
+// i.e. refining a search doesn't need to sort again.
+//
+// Rows of removed tracks are not reused until the index is rebuilt
+// and neither are strings that are no longer referenced.
+class ColumnarTrackIndex {
+  public:
+    enum class ColumnType {
+        // Stored as double, NaN represents NULL
+        Number,
+        // Interned strings that can be searched and collated
+        String,
+        // Stored as QVariant, e.g. for binary data or unknown columns
+        Variant,
+    };
+
+    enum class SortMode {
+        Collated,
+        Numeric,
+        // Text keys sorted by their position on the circle of fifths
+        Key,
+    };
+
+    struct SortKey {
+        int column;
+        SortMode mode;
+        Qt::SortOrder order;
+
+        friend bool operator==(const SortKey& lhs, const SortKey& rhs) {
+            return lhs.column == rhs.column &&
+                    lhs.mode == rhs.mode &&
+                    lhs.order == rhs.order;
+        }
+    };
+
+    ColumnarTrackIndex(
+            const QStringList& columnNames,
+            const QVector<ColumnType>& columnTypes);
+
+    int columnCount() const {
+        return m_columns.size();
+    }
+    // Returns the column with the given (SQL) name or -1
+    int columnIndex(const QString& columnName) const {
+        return m_columnIndexByName.value(columnName, -1);
+    }
+    ColumnType columnType(int column) const {
+        return m_columns[column].type;
+    }
+
+    // The number of rows including those of removed tracks
+    int rowCount() const {
+        return static_cast<int>(m_trackIds.size());
+    }
+    // Returns the row of the track or -1
+    int findRow(TrackId trackId) const {
+        return m_rowsByTrackId.value(trackId, -1);
+    }
+    bool contains(TrackId trackId) const {
+        return m_rowsByTrackId.contains(trackId);
+    }
+    // Returns an invalid id for rows of removed tracks
+    TrackId trackId(int row) const {
+        return m_trackIds[row];
+    }
+
+    void clear();
+    // Inserts or replaces the row of the track. The number and order of
+    // the values must match the columns.
+    void setRow(TrackId trackId, const QVector<QVariant>& values);
+    void removeRow(TrackId trackId);
+
+    QVariant value(int row, int column) const;
+    bool isNull(int row, int column) const;
+    // Returns the numeric value of the field, NaN if it is NULL. Text
+    // is converted like QVariant::toDouble().
+    double number(int row, int column) const;
+
+    // Access to the interned strings of a String column. Each distinct
+    // string has an id, -1 represents NULL.
+    int stringId(int row, int column) const {
+        return m_columns[column].stringIds[row];
+    }
+    int stringCount(int column) const {
+        return m_columns[column].strings.size();
+    }
+    const QString& string(int column, int stringId) const {
+        return m_columns[column].strings[stringId].value;
+    }
+    // The string converted with DbConnection::makeStringLatinLow()
+    // for case insensitive searching
+    const QString& foldedString(int column, int stringId) const {
+        return m_columns[column].strings[stringId].folded;
+    }
+    // Stores the ids of all strings of the column whose folded string
+    // contains the folded substring. Returns false if the substring is
+    // too short to be looked up and all strings need to be searched.
+    bool findStrings(
+            int column,
+            const QString& foldedSubstring,
+            std::vector<int>* pStringIds) const;
+
+    // Returns the ids of the tracks in trackIds that match the query
+    // in the order of the sort keys. Tracks with equal keys and all
+    // tracks if no sort keys are given are returned in the order in
+    // which they have been added to the index.
+    //
+    // The selection is aborted with an empty result as soon as the
+    // optional flag pCanceled is set by a different thread.
+    //
+    // Not reentrant, concurrent invocations need to be synchronized by
+    // the caller.
+    QVector<TrackId> select(
+            const QSet<TrackId>& trackIds,
+            const QueryNode* pQuery,
+            const QVector<SortKey>& sortKeys,
+            KeyUtils::KeyNotation keyNotation,
+            const std::atomic<bool>* pCanceled = nullptr) const;
+
+  private:
+    struct PooledString {
+        QString value;
+        QString folded;
+        double number;
+    };
+
+    struct Column {
+        ColumnType type;
+        // The type of the non-NULL values returned by value()
+        QVariant::Type valueType = QVariant::Invalid;
+
+        std::vector<double> numbers;
+
+        std::vector<int> stringIds;
+        QVector<PooledString> strings;
+        QHash<QString, int> stringIdsByValue;
+        TrigramIndex foldedStringTrigrams;
+        // The rank of each string in collation order. The pool only
+        // grows and is valid as long as the size matches.
+        mutable std::vector<int> collationRanks;
+
+        QVector<QVariant> variants;
+    };
+
+    void setValue(int row, int column, const QVariant& value);
+    int internString(Column* pColumn, const QString& value);
+
+    // Returns the values of all rows that are compared when sorting
+    // by the key. NULL sorts first in ascending order.
+    std::vector<double> sortValues(
+            const SortKey& sortKey,
+            KeyUtils::KeyNotation keyNotation) const;
+    const std::vector<int>& sortedRows(
+            const QVector<SortKey>& sortKeys,
+            KeyUtils::KeyNotation keyNotation) const;
+    void invalidateSortedRows();
+
+    QHash<QString, int> m_columnIndexByName;
+    QVector<Column> m_columns;
+
+    std::vector<TrackId> m_trackIds;
+    QHash<TrackId, int> m_rowsByTrackId;
+
+    const mixxx::StringCollator m_collator;
+
+    // The cached permutation of all rows for the most recent sort keys
+    mutable bool m_sortedRowsValid;
+    mutable QVector<SortKey> m_sortedRowsKeys;
+    mutable KeyUtils::KeyNotation m_sortedRowsKeyNotation;
+    mutable std::vector<int> m_sortedRows;
+};
@@ -11,6 +11,7 @@
 #include "preferences/usersettings.h"
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
+#include "sources/soundsourceproxy.h"
 #include "track/globaltrackcache.h"
 #include "util/class.h"
 #include "util/memory.h"
@@ -119,9 +120,12 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackId addTracksAddTrack(
             const TrackPointer& pTrack,
             bool unremove);
+    // The optional metadata that has been parsed in advance is used
+    // instead of parsing the file again if the track is new.
     TrackPointer addTracksAddFile(
             const TrackFile& trackFile,
-            bool unremove);
+            bool unremove,
+            const SoundSourceProxy::PreparsedMetadata* pPreparsedMetadata = nullptr);
     void addTracksFinish(bool rollback = false);
 
     bool updateTrack(Track* pTrack) const;
@@ -126,7 +126,7 @@ Library::Library(
             m_pAnalysisFeature,
             &AnalysisFeature::analyzeTracks);
     addFeature(m_pAnalysisFeature);
-    // Suspend a batch analysis while an ad-hoc analysis of
+    // Preempt a batch analysis while an ad-hoc analysis of
     // loaded tracks is in progress and resume it afterwards.
     connect(pPlayerManager,
             &PlayerManager::trackAnalyzerProgress,
@@ -395,13 +395,13 @@ void Library::addFeature(LibraryFeature* feature) {
 void Library::onPlayerManagerTrackAnalyzerProgress(
         TrackId /*trackId*/, AnalyzerProgress /*analyzerProgress*/) {
     if (m_pAnalysisFeature) {
-        m_pAnalysisFeature->suspendAnalysis();
+        m_pAnalysisFeature->preemptAnalysis();
     }
 }
 
 void Library::onPlayerManagerTrackAnalyzerIdle() {
     if (m_pAnalysisFeature) {
-        m_pAnalysisFeature->resumeAnalysis();
+        m_pAnalysisFeature->releaseAnalysis();
     }
 }
 
@@ -162,6 +162,7 @@ bool ParserCsv::writeCSVFile(const QString &file_str, BaseSqlTableModel* pPlayli
     out << "\r\n"; // CRLF according to rfc4180
 
 
+    pPlaylistTableModel->fetchAll();
     int rows = pPlaylistTableModel->rowCount();
     for (int j = 0; j < rows; j++) {
         // writing fields section
@@ -210,6 +211,7 @@ bool ParserCsv::writeReadableTextFile(const QString &file_str, BaseSqlTableModel
 
     int msecsFromStartToMidnight = 0;
     int i; // fieldIndex
+    pPlaylistTableModel->fetchAll();
     int rows = pPlaylistTableModel->rowCount();
     for (int j = 0; j < rows; j++) {
         // writing fields section
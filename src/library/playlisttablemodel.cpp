@@ -177,6 +177,7 @@ int PlaylistTableModel::addTracks(const QModelIndex& index,
 
     // Handle weird cases like a drag and drop to an invalid index
     if (position <= 0) {
+        fetchAll();
         position = rowCount() + 1;
     }
 
@@ -256,6 +257,9 @@ bool PlaylistTableModel::isLocked() {
 }
 
 void PlaylistTableModel::shuffleTracks(const QModelIndexList& shuffle, const QModelIndex& exclude) {
+    // All tracks are needed for reassigning the positions. Appending
+    // the remaining rows doesn't affect the given indices.
+    fetchAll();
     QList<int> positions;
     QHash<int, TrackId> allIds;
     const int positionColumn = fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION);
@@ -1,6 +1,7 @@
 #include "library/scanner/importfilestask.h"
 
 #include "library/scanner/libraryscanner.h"
+#include "sources/soundsourceproxy.h"
 #include "track/trackfile.h"
 #include "util/timer.h"
 
@@ -50,7 +51,11 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
-            emit addNewTrack(trackLocation);
+            // Parse the metadata in this worker thread, only adding the
+            // track to the database is done by the scanner thread
+            m_pScanner->queueParsedTrack(*m_scannerGlobal,
+                    trackLocation,
+                    SoundSourceProxy::preparseMetadata(TrackFile(fileInfo)));
         }
     }
     // Insert or update the hash in the database.
@@ -13,14 +13,20 @@
 #include "util/db/fwdsqlquery.h"
 #include "util/file.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/performancetimer.h"
 #include "util/timer.h"
 #include "util/trace.h"
 
 namespace {
 
-// TODO(rryan) make configurable
-const int kScannerThreadPoolSize = 1;
+// The number of worker threads that walk the directories and parse the
+// metadata of new files in parallel. Defaults to the number of cores.
+const ConfigKey kScannerThreadsConfigKey("[Library]", "ScannerThreads");
+
+// Limits the memory that is occupied by parsed metadata and cover images
+// if the workers are faster than adding the tracks to the database
+const int kMaxPendingParsedTracks = 256;
 
 mixxx::Logger kLogger("LibraryScanner");
 
@@ -57,7 +63,10 @@ LibraryScanner::LibraryScanner(
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
-    m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    const int numThreads = pConfig->getValue(
+            kScannerThreadsConfigKey, QThread::idealThreadCount());
+    m_pool.setMaxThreadCount(math_max(1, numThreads));
+    kLogger.debug() << "Using" << m_pool.maxThreadCount() << "worker threads";
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
@@ -183,6 +192,12 @@ void LibraryScanner::slotStartScan() {
 
     m_scannerGlobal->startTimer();
 
+    {
+        // Discard leftovers of a canceled scan
+        QMutexLocker locker(&m_parsedTracksMutex);
+        m_parsedTracks.clear();
+    }
+
     emit scanStarted();
 
     // First, we're going to mark all the directories that we've previously
@@ -373,6 +388,9 @@ void LibraryScanner::slotFinishUnhashedScan() {
         kLogger.debug() << "Recursive scanning interrupted by the user";
     }
 
+    // Add the remaining tracks that have been parsed by the workers
+    slotAddParsedTracks();
+
     // Finish adding the tracks -- rollback the transaction if the scan did not
     // finish cleanly and the user did not cancel the transaction.
     m_trackDao.addTracksFinish(!m_scannerGlobal->shouldCancel() &&
@@ -476,10 +494,6 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             &ScannerTask::trackExists,
             this,
             &LibraryScanner::slotTrackExists);
-    connect(pTask,
-            &ScannerTask::addNewTrack,
-            this,
-            &LibraryScanner::slotAddNewTrack);
 
     // Progress signals.
     // Pass directly to the main thread
@@ -532,11 +546,51 @@ void LibraryScanner::slotTrackExists(const QString& trackPath) {
     }
 }
 
-void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
-    //kLogger.debug() << "slotAddNewTrack" << trackPath;
+void LibraryScanner::queueParsedTrack(
+        const ScannerGlobal& scannerGlobal,
+        const QString& trackPath,
+        SoundSourceProxy::PreparsedMetadata preparsedMetadata) {
+    QMutexLocker locker(&m_parsedTracksMutex);
+    while (m_parsedTracks.size() >= kMaxPendingParsedTracks) {
+        // Wait for the database writer, but don't block canceling
+        if (scannerGlobal.shouldCancel()) {
+            return;
+        }
+        m_parsedTracksNotFull.wait(&m_parsedTracksMutex, 100);
+    }
+    if (m_parsedTracks.isEmpty()) {
+        // Tracks are added in batches, one invocation is pending
+        // until the queue has been drained
+        QMetaObject::invokeMethod(
+                this, &LibraryScanner::slotAddParsedTracks, Qt::QueuedConnection);
+    }
+    m_parsedTracks.append(ParsedTrack{trackPath, std::move(preparsedMetadata)});
+}
+
+void LibraryScanner::slotAddParsedTracks() {
+    QList<ParsedTrack> parsedTracks;
+    {
+        QMutexLocker locker(&m_parsedTracksMutex);
+        parsedTracks.swap(m_parsedTracks);
+        m_parsedTracksNotFull.wakeAll();
+    }
+    ScopedTimer timer("LibraryScanner::slotAddParsedTracks");
+    for (const auto& parsedTrack : qAsConst(parsedTracks)) {
+        if (m_scannerGlobal.isNull() || m_scannerGlobal->shouldCancel()) {
+            return;
+        }
+        addNewTrack(parsedTrack.trackPath, &parsedTrack.preparsedMetadata);
+    }
+}
+
+void LibraryScanner::addNewTrack(
+        const QString& trackPath,
+        const SoundSourceProxy::PreparsedMetadata* pPreparsedMetadata) {
+    //kLogger.debug() << "addNewTrack" << trackPath;
     ScopedTimer timer("LibraryScanner::addNewTrack");
     // For statistics tracking and to detect moved tracks
-    TrackPointer pTrack(m_trackDao.addTracksAddFile(trackPath, false));
+    TrackPointer pTrack(m_trackDao.addTracksAddFile(
+            trackPath, false, pPreparsedMetadata));
     if (pTrack) {
         DEBUG_ASSERT(!pTrack->isDirty());
         // The track's actual location might differ from the
@@ -3,12 +3,14 @@
 
 #include <gtest/gtest.h>
 
+#include <QMutex>
 #include <QScopedPointer>
 #include <QSemaphore>
 #include <QString>
 #include <QStringList>
 #include <QThread>
 #include <QThreadPool>
+#include <QWaitCondition>
 
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
@@ -17,6 +19,7 @@
 #include "library/dao/playlistdao.h"
 #include "library/dao/trackdao.h"
 #include "library/scanner/scannerglobal.h"
+#include "sources/soundsourceproxy.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/db/dbconnectionpool.h"
@@ -58,6 +61,14 @@ class LibraryScanner : public QThread {
   protected:
     void run() override;
 
+    // Invoked by the workers after parsing the metadata of a new track.
+    // Blocks while too many parsed tracks are pending. The tracks are
+    // added to the database in batches by the scanner thread.
+    void queueParsedTrack(
+            const ScannerGlobal& scannerGlobal,
+            const QString& trackPath,
+            SoundSourceProxy::PreparsedMetadata preparsedMetadata);
+
   public slots:
     void queueTask(ScannerTask* pTask);
 
@@ -71,7 +82,7 @@ class LibraryScanner : public QThread {
                                    bool newDirectory, mixxx::cache_key_t hash);
     void slotDirectoryUnchanged(const QString& directoryPath);
     void slotTrackExists(const QString& trackPath);
-    void slotAddNewTrack(const QString& trackPath);
+    void slotAddParsedTracks();
 
   private:
     enum ScannerState {
@@ -97,11 +108,23 @@ class LibraryScanner : public QThread {
 
     void cleanUpScan();
 
+    void addNewTrack(
+            const QString& trackPath,
+            const SoundSourceProxy::PreparsedMetadata* pPreparsedMetadata);
+
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
 
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
 
+    struct ParsedTrack {
+        QString trackPath;
+        SoundSourceProxy::PreparsedMetadata preparsedMetadata;
+    };
+    QMutex m_parsedTracksMutex;
+    QWaitCondition m_parsedTracksNotFull;
+    QList<ParsedTrack> m_parsedTracks;
+
     // The library scanner thread's DAOs.
     LibraryHashDAO m_libraryHashDao;
     CueDAO m_cueDao;
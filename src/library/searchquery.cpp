@@ -2,6 +2,7 @@
 
 #include <QtDebug>
 
+#include "library/columnartrackindex.h"
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
 #include "library/trackset/crate/crateschema.h"
@@ -60,6 +61,20 @@ QVariant getTrackValueForColumn(const TrackPointer& pTrack, const QString& colum
     return QVariant();
 }
 
+bool IndexColumnBinding::bind(
+        const ColumnarTrackIndex& index, const QStringList& sqlColumns) const {
+    if (m_pIndex == &index) {
+        return false;
+    }
+    m_pIndex = &index;
+    m_columns.clear();
+    m_columns.reserve(sqlColumns.size());
+    for (const auto& sqlColumn : sqlColumns) {
+        m_columns.push_back(index.columnIndex(sqlColumn));
+    }
+    return true;
+}
+
 //static
 QString QueryNode::concatSqlClauses(
         const QStringList& sqlClauses, const QString& sqlConcatOp) {
@@ -87,6 +102,15 @@ bool AndNode::match(const TrackPointer& pTrack) const {
     return true;
 }
 
+bool AndNode::match(const ColumnarTrackIndex& index, int row) const {
+    for (const auto& pNode : m_nodes) {
+        if (!pNode->match(index, row)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 QString AndNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(static_cast<int>(m_nodes.size()));
@@ -116,6 +140,18 @@ bool OrNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool OrNode::match(const ColumnarTrackIndex& index, int row) const {
+    VERIFY_OR_DEBUG_ASSERT(!m_nodes.empty()) {
+        return true;
+    }
+    for (const auto& pNode : m_nodes) {
+        if (pNode->match(index, row)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 QString OrNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(static_cast<int>(m_nodes.size()));
@@ -132,6 +168,10 @@ bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
 
+bool NotNode::match(const ColumnarTrackIndex& index, int row) const {
+    return !m_pNode->match(index, row);
+}
+
 QString NotNode::toSql() const {
     QString sql(m_pNode->toSql());
     if (sql.isEmpty()) {
@@ -169,6 +209,57 @@ bool TextFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool TextFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    if (m_indexColumns.bind(index, m_sqlColumns)) {
+        m_indexStringMatches.assign(m_sqlColumns.size(), std::vector<signed char>());
+        // Look up the matching strings in the trigram index in advance
+        // instead of searching all strings lazily
+        std::vector<int> stringIds;
+        for (std::size_t i = 0; i < m_indexColumns.columns().size(); ++i) {
+            const int column = m_indexColumns.columns()[i];
+            if (column < 0 ||
+                    index.columnType(column) != ColumnarTrackIndex::ColumnType::String ||
+                    !index.findStrings(column, m_argument, &stringIds)) {
+                continue;
+            }
+            std::vector<signed char>& stringMatches = m_indexStringMatches[i];
+            stringMatches.assign(index.stringCount(column), -1);
+            for (const int stringId : stringIds) {
+                stringMatches[stringId] = 1;
+            }
+        }
+    }
+    const std::vector<int>& columns = m_indexColumns.columns();
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        const int column = columns[i];
+        if (column < 0 || index.isNull(row, column)) {
+            continue;
+        }
+        if (index.columnType(column) != ColumnarTrackIndex::ColumnType::String) {
+            QString strValue = index.value(row, column).toString();
+            mixxx::DbConnection::makeStringLatinLow(&strValue);
+            if (strValue.contains(m_argument)) {
+                return true;
+            }
+            continue;
+        }
+        // Each distinct string is only searched once
+        const int stringId = index.stringId(row, column);
+        std::vector<signed char>& stringMatches = m_indexStringMatches[i];
+        if (static_cast<std::size_t>(stringId) >= stringMatches.size()) {
+            stringMatches.resize(index.stringCount(column), 0);
+        }
+        if (stringMatches[stringId] == 0) {
+            stringMatches[stringId] =
+                    index.foldedString(column, stringId).contains(m_argument) ? 1 : -1;
+        }
+        if (stringMatches[stringId] > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 QString TextFilterNode::toSql() const {
     FieldEscaper escaper(m_database);
     QString argument = m_argument;
@@ -200,6 +291,22 @@ bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool NullOrEmptyTextFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    if (!m_sqlColumns.isEmpty()) {
+        // only use the major column
+        m_indexColumns.bind(index, m_sqlColumns);
+        const int column = m_indexColumns.columns().front();
+        if (column < 0 || index.isNull(row, column)) {
+            return true;
+        }
+        if (index.columnType(column) == ColumnarTrackIndex::ColumnType::String) {
+            return index.string(column, index.stringId(row, column)).isEmpty();
+        }
+        return index.value(row, column).toString().isEmpty();
+    }
+    return false;
+}
+
 QString NullOrEmptyTextFilterNode::toSql() const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -216,6 +323,14 @@ CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
 }
 
 bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+    return matchTrackId(pTrack->getId());
+}
+
+bool CrateFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    return matchTrackId(index.trackId(row));
+}
+
+void CrateFilterNode::prepareMatch() const {
     if (!m_matchInitialized) {
         CrateTrackSelectResult crateTracks(
                 m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
@@ -226,8 +341,11 @@ bool CrateFilterNode::match(const TrackPointer& pTrack) const {
 
         m_matchInitialized = true;
     }
+}
 
-    return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+bool CrateFilterNode::matchTrackId(TrackId trackId) const {
+    prepareMatch();
+    return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), trackId);
 }
 
 QString CrateFilterNode::toSql() const {
@@ -242,6 +360,14 @@ NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
 }
 
 bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+    return matchTrackId(pTrack->getId());
+}
+
+bool NoCrateFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    return matchTrackId(index.trackId(row));
+}
+
+void NoCrateFilterNode::prepareMatch() const {
     if (!m_matchInitialized) {
         TrackSelectResult tracks(
                 m_pCrateStorage->selectAllTracksSorted());
@@ -252,8 +378,11 @@ bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
 
         m_matchInitialized = true;
     }
+}
 
-    return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+bool NoCrateFilterNode::matchTrackId(TrackId trackId) const {
+    prepareMatch();
+    return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), trackId);
 }
 
 QString NoCrateFilterNode::toSql() const {
@@ -325,23 +454,41 @@ bool NumericFilterNode::match(const TrackPointer& pTrack) const {
             continue;
         }
 
-        double dValue = value.toDouble();
-        if (m_bOperatorQuery) {
-            if ((m_operator == "=" && dValue == m_dOperatorArgument) ||
-                    (m_operator == "<" && dValue < m_dOperatorArgument) ||
-                    (m_operator == ">" && dValue > m_dOperatorArgument) ||
-                    (m_operator == "<=" && dValue <= m_dOperatorArgument) ||
-                    (m_operator == ">=" && dValue >= m_dOperatorArgument)) {
+        if (matchValue(value.toDouble())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NumericFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    m_indexColumns.bind(index, m_sqlColumns);
+    for (const int column : m_indexColumns.columns()) {
+        if (column < 0 || index.isNull(row, column)) {
+            if (m_bNullQuery) {
                 return true;
             }
-        } else if (m_bRangeQuery && dValue >= m_dRangeLow &&
-                dValue <= m_dRangeHigh) {
+            continue;
+        }
+        if (matchValue(index.number(row, column))) {
             return true;
         }
     }
     return false;
 }
 
+bool NumericFilterNode::matchValue(double dValue) const {
+    if (m_bOperatorQuery) {
+        return (m_operator == "=" && dValue == m_dOperatorArgument) ||
+                (m_operator == "<" && dValue < m_dOperatorArgument) ||
+                (m_operator == ">" && dValue > m_dOperatorArgument) ||
+                (m_operator == "<=" && dValue <= m_dOperatorArgument) ||
+                (m_operator == ">=" && dValue >= m_dOperatorArgument);
+    }
+    return m_bRangeQuery && dValue >= m_dRangeLow &&
+            dValue <= m_dRangeHigh;
+}
+
 QString NumericFilterNode::toSql() const {
     if (m_bNullQuery) {
         for (const auto& sqlColumn : m_sqlColumns) {
@@ -392,6 +539,16 @@ bool NullNumericFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool NullNumericFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    if (!m_sqlColumns.isEmpty()) {
+        // only use the major column
+        m_indexColumns.bind(index, m_sqlColumns);
+        const int column = m_indexColumns.columns().front();
+        return column < 0 || index.isNull(row, column);
+    }
+    return false;
+}
+
 QString NullNumericFilterNode::toSql() const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -451,6 +608,17 @@ bool KeyFilterNode::match(const TrackPointer& pTrack) const {
     return m_matchKeys.contains(pTrack->getKey());
 }
 
+bool KeyFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    static const QStringList kKeyIdColumns{LIBRARYTABLE_KEY_ID};
+    m_indexColumns.bind(index, kKeyIdColumns);
+    const int column = m_indexColumns.columns().front();
+    if (column < 0 || index.isNull(row, column)) {
+        return false;
+    }
+    return m_matchKeys.contains(static_cast<mixxx::track::io::key::ChromaticKey>(
+            static_cast<int>(index.number(row, column))));
+}
+
 QString KeyFilterNode::toSql() const {
     QStringList searchClauses;
     for (const auto& matchKey : m_matchKeys) {
@@ -15,18 +15,53 @@
 #include "util/assert.h"
 #include "util/memory.h"
 
+class ColumnarTrackIndex;
+
 const QString kMissingFieldSearchTerm = "\"\""; // "" searches for an empty string
 
 QVariant getTrackValueForColumn(const TrackPointer& pTrack, const QString& column);
 
+// Resolves the SQL column names of a node to the columns of the index
+// that it is matched against. Nodes are matched against many rows of
+// the same index, so the result is cached.
+class IndexColumnBinding {
+  public:
+    IndexColumnBinding()
+            : m_pIndex(nullptr) {
+    }
+
+    // Returns true if the columns have been resolved for a different
+    // index than before.
+    bool bind(const ColumnarTrackIndex& index, const QStringList& sqlColumns) const;
+
+    // The column of each SQL column name, -1 if the index doesn't
+    // contain it
+    const std::vector<int>& columns() const {
+        return m_columns;
+    }
+
+  private:
+    mutable const ColumnarTrackIndex* m_pIndex;
+    mutable std::vector<int> m_columns;
+};
+
 class QueryNode {
   public:
     QueryNode(const QueryNode&) = delete; // prevent copying
     virtual ~QueryNode() = default;
 
     virtual bool match(const TrackPointer& pTrack) const = 0;
+    // Evaluates the node for a row of the index without accessing
+    // the track object or the database.
+    virtual bool match(const ColumnarTrackIndex& index, int row) const = 0;
     virtual QString toSql() const = 0;
 
+    // Loads all data from the database that is needed for matching.
+    // Must be invoked on the thread that owns the database connection
+    // before the node is matched on a different thread.
+    virtual void prepareMatch() const {
+    }
+
   protected:
     QueryNode() = default;
 
@@ -40,6 +75,12 @@ class GroupNode : public QueryNode {
         m_nodes.push_back(std::move(pNode));
     }
 
+    void prepareMatch() const override {
+        for (const auto& pNode : m_nodes) {
+            pNode->prepareMatch();
+        }
+    }
+
   protected:
     // NOTE(uklotzde): std::vector is more suitable (efficiency)
     // than a QList for a private member. And QList from Qt 4
@@ -50,12 +91,14 @@ class GroupNode : public QueryNode {
 class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 };
 
@@ -67,8 +110,13 @@ class NotNode : public QueryNode {
     }
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
+    void prepareMatch() const override {
+        m_pNode->prepareMatch();
+    }
+
   private:
     std::unique_ptr<QueryNode> m_pNode;
 };
@@ -80,12 +128,18 @@ class TextFilterNode : public QueryNode {
             const QString& argument);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
   private:
     QSqlDatabase m_database;
     QStringList m_sqlColumns;
     QString m_argument;
+
+    IndexColumnBinding m_indexColumns;
+    // Memoizes the result for each distinct string of the index
+    // columns: 0 = unknown, 1 = match, -1 = no match
+    mutable std::vector<std::vector<signed char>> m_indexStringMatches;
 };
 
 class NullOrEmptyTextFilterNode : public QueryNode {
@@ -97,11 +151,13 @@ class NullOrEmptyTextFilterNode : public QueryNode {
     }
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
   private:
     QSqlDatabase m_database;
     QStringList m_sqlColumns;
+    IndexColumnBinding m_indexColumns;
 };
 
 class CrateFilterNode : public QueryNode {
@@ -110,9 +166,14 @@ class CrateFilterNode : public QueryNode {
             const QString& crateNameLike);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
+    void prepareMatch() const override;
+
   private:
+    bool matchTrackId(TrackId trackId) const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -124,9 +185,14 @@ class NoCrateFilterNode : public QueryNode {
     explicit NoCrateFilterNode(const CrateStorage* pCrateStorage);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
+    void prepareMatch() const override;
+
   private:
+    bool matchTrackId(TrackId trackId) const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -138,6 +204,7 @@ class NumericFilterNode : public QueryNode {
     NumericFilterNode(const QStringList& sqlColumns, const QString& argument);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
   protected:
@@ -153,7 +220,10 @@ class NumericFilterNode : public QueryNode {
   private:
     virtual double parse(const QString& arg, bool* ok);
 
+    bool matchValue(double value) const;
+
     QStringList m_sqlColumns;
+    IndexColumnBinding m_indexColumns;
     bool m_bOperatorQuery;
     bool m_bNullQuery;
     QString m_operator;
@@ -168,9 +238,13 @@ class NullNumericFilterNode : public QueryNode {
     explicit NullNumericFilterNode(const QStringList& sqlColumns);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
     QStringList m_sqlColumns;
+
+  private:
+    IndexColumnBinding m_indexColumns;
 };
 
 class DurationFilterNode : public NumericFilterNode {
@@ -186,10 +260,12 @@ class KeyFilterNode : public QueryNode {
     KeyFilterNode(mixxx::track::io::key::ChromaticKey key, bool fuzzy);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
   private:
     QList<mixxx::track::io::key::ChromaticKey> m_matchKeys;
+    IndexColumnBinding m_indexColumns;
 };
 
 class SqlNode : public QueryNode {
@@ -208,6 +284,12 @@ class SqlNode : public QueryNode {
         return true;
     }
 
+    bool match(const ColumnarTrackIndex& index, int row) const override {
+        Q_UNUSED(index);
+        Q_UNUSED(row);
+        return true;
+    }
+
     QString toSql() const override {
         return m_sql;
     }
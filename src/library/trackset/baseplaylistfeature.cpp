@@ -513,6 +513,7 @@ void BasePlaylistFeature::slotExportPlaylist() {
     } else {
         // Create and populate a list of files of the playlist
         QList<QString> playlist_items;
+        pPlaylistTableModel->fetchAll();
         int rows = pPlaylistTableModel->rowCount();
         for (int i = 0; i < rows; ++i) {
             QModelIndex index = pPlaylistTableModel->index(i, 0);
@@ -534,6 +535,7 @@ void BasePlaylistFeature::slotExportTrackFiles() {
                                          ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION),
             Qt::AscendingOrder);
     pPlaylistTableModel->select();
+    pPlaylistTableModel->fetchAll();
 
     int rows = pPlaylistTableModel->rowCount();
     TrackPointerList tracks;
@@ -714,10 +714,11 @@ void CrateFeature::slotExportPlaylist() {
     } else {
         // populate a list of files of the crate
         QList<QString> playlist_items;
+        pCrateTableModel->fetchAll();
         int rows = pCrateTableModel->rowCount();
         for (int i = 0; i < rows; ++i) {
-            QModelIndex index = m_crateTableModel.index(i, 0);
-            playlist_items << m_crateTableModel.getTrackLocation(index);
+            QModelIndex index = pCrateTableModel->index(i, 0);
+            playlist_items << pCrateTableModel->getTrackLocation(index);
         }
         exportPlaylistItemsIntoFile(
                 file_location,
@@ -732,12 +733,13 @@ void CrateFeature::slotExportTrackFiles() {
             new CrateTableModel(this, m_pLibrary->trackCollections()));
     pCrateTableModel->selectCrate(m_crateTableModel.selectedCrate());
     pCrateTableModel->select();
+    pCrateTableModel->fetchAll();
 
     int rows = pCrateTableModel->rowCount();
     TrackPointerList trackpointers;
     for (int i = 0; i < rows; ++i) {
-        QModelIndex index = m_crateTableModel.index(i, 0);
-        trackpointers.push_back(m_crateTableModel.getTrack(index));
+        QModelIndex index = pCrateTableModel->index(i, 0);
+        trackpointers.push_back(pCrateTableModel->getTrack(index));
     }
 
     TrackExportWizard track_export(nullptr, m_pConfig, trackpointers);
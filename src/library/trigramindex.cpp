@@ -0,0 +1,116 @@
+#include "library/trigramindex.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "util/assert.h"
+
+namespace {
+
+// Intersecting further lists doesn't pay off if only a few candidates
+// are left that need to be verified anyway
+constexpr std::size_t kMinCandidatesForIntersection = 32;
+
+} // anonymous namespace
+
+void TrigramIndex::clear() {
+    m_postingLists.clear();
+}
+
+// static
+void TrigramIndex::appendTrigrams(const QString& string, std::vector<quint64>* pTrigrams) {
+    const QChar* chars = string.constData();
+    for (int i = 0; i + kTrigramLength <= string.size(); ++i) {
+        pTrigrams->push_back(
+                (static_cast<quint64>(chars[i].unicode()) << 32) |
+                (static_cast<quint64>(chars[i + 1].unicode()) << 16) |
+                static_cast<quint64>(chars[i + 2].unicode()));
+    }
+    std::sort(pTrigrams->begin(), pTrigrams->end());
+    pTrigrams->erase(
+            std::unique(pTrigrams->begin(), pTrigrams->end()),
+            pTrigrams->end());
+}
+
+void TrigramIndex::insert(int id, const QString& string) {
+    std::vector<quint64> trigrams;
+    appendTrigrams(string, &trigrams);
+    for (const auto trigram : trigrams) {
+        PostingList& postingList = m_postingLists[trigram];
+        VERIFY_OR_DEBUG_ASSERT(id > postingList.lastId) {
+            continue;
+        }
+        quint32 delta = static_cast<quint32>(id - postingList.lastId);
+        while (delta >= 0x80) {
+            postingList.deltas.append(static_cast<char>((delta & 0x7F) | 0x80));
+            delta >>= 7;
+        }
+        postingList.deltas.append(static_cast<char>(delta));
+        postingList.lastId = id;
+        ++postingList.size;
+    }
+}
+
+// static
+void TrigramIndex::decode(const PostingList& postingList, std::vector<int>* pIds) {
+    pIds->clear();
+    pIds->reserve(postingList.size);
+    const char* data = postingList.deltas.constData();
+    const char* const end = data + postingList.deltas.size();
+    int id = -1;
+    while (data < end) {
+        quint32 delta = 0;
+        int shift = 0;
+        quint8 byte;
+        do {
+            byte = static_cast<quint8>(*data++);
+            delta |= static_cast<quint32>(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        id += static_cast<int>(delta);
+        pIds->push_back(id);
+    }
+}
+
+bool TrigramIndex::findCandidates(const QString& substring, std::vector<int>* pIds) const {
+    if (substring.size() < kTrigramLength) {
+        return false;
+    }
+    std::vector<quint64> trigrams;
+    appendTrigrams(substring, &trigrams);
+
+    std::vector<const PostingList*> postingLists;
+    postingLists.reserve(trigrams.size());
+    for (const auto trigram : trigrams) {
+        const auto it = m_postingLists.constFind(trigram);
+        if (it == m_postingLists.constEnd()) {
+            // No string contains this trigram
+            pIds->clear();
+            return true;
+        }
+        postingLists.push_back(&it.value());
+    }
+    // Start with the most selective trigrams
+    std::sort(postingLists.begin(), postingLists.end(), [](const PostingList* lhs, const PostingList* rhs) {
+        return lhs->size < rhs->size;
+    });
+
+    decode(*postingLists.front(), pIds);
+    std::vector<int> ids;
+    std::vector<int> intersection;
+    for (std::size_t i = 1; i < postingLists.size(); ++i) {
+        if (pIds->size() < kMinCandidatesForIntersection) {
+            break;
+        }
+        decode(*postingLists[i], &ids);
+        intersection.clear();
+        std::set_intersection(
+                pIds->begin(),
+                pIds->end(),
+                ids.begin(),
+                ids.end(),
+                std::back_inserter(intersection));
+        pIds->swap(intersection);
+    }
+    return true;
+}
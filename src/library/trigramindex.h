@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+// An inverted index from trigrams, i.e. sequences of 3 consecutive
+// characters, to the ids of the strings that contain them.
+//
+// A substring of at least 3 characters can only be contained in strings
+// that contain all of its trigrams. Intersecting the (sorted) id lists
+// of these trigrams yields a small set of candidates that needs to be
+// verified instead of scanning all strings.
+//
+// The id lists are delta encoded as variable length integers, most
+// deltas of frequent trigrams fit into a single byte.
+class TrigramIndex {
+  public:
+    static constexpr int kTrigramLength = 3;
+
+    void clear();
+
+    // Adds a string to the index. The ids of all strings must be added
+    // in ascending order.
+    void insert(int id, const QString& string);
+
+    // Stores the ids of all strings that might contain the substring in
+    // ascending order. The candidates must be verified by the caller.
+    // Returns false if the substring is too short to be looked up.
+    bool findCandidates(const QString& substring, std::vector<int>* pIds) const;
+
+  private:
+    struct PostingList {
+        QByteArray deltas;
+        int lastId = -1;
+        int size = 0;
+    };
+
+    static void appendTrigrams(const QString& string, std::vector<quint64>* pTrigrams);
+    static void decode(const PostingList& postingList, std::vector<int>* pIds);
+
+    QHash<quint64, PostingList> m_postingLists;
+};
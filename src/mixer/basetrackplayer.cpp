@@ -44,7 +44,8 @@ BaseTrackPlayerImpl::BaseTrackPlayerImpl(
         const ChannelHandleAndGroup& handleGroup,
         bool defaultMaster,
         bool defaultHeadphones,
-        bool primaryDeck)
+        bool primaryDeck,
+        bool lightweight)
         : BaseTrackPlayer(pParent, handleGroup.name()),
           m_pConfig(pConfig),
           m_pEngineMaster(pMixingEngine),
@@ -56,7 +57,8 @@ BaseTrackPlayerImpl::BaseTrackPlayerImpl(
             pMixingEngine,
             pEffectsManager,
             defaultOrientation,
-            primaryDeck);
+            primaryDeck,
+            lightweight);
 
     m_pInputConfigured = make_parented<ControlProxy>(getGroup(), "input_configured", this);
 #ifdef __VINYLCONTROL__
@@ -63,7 +63,8 @@ class BaseTrackPlayerImpl : public BaseTrackPlayer {
             const ChannelHandleAndGroup& handleGroup,
             bool defaultMaster,
             bool defaultHeadphones,
-            bool primaryDeck);
+            bool primaryDeck,
+            bool lightweight);
     ~BaseTrackPlayerImpl() override;
 
     TrackPointer getLoadedTrack() const final;
@@ -16,5 +16,6 @@ Deck::Deck(QObject* pParent,
                   handleGroup,
                   /*defaultMaster*/ true,
                   /*defaultHeadphones*/ false,
-                  /*primaryDeck*/ true) {
+                  /*primaryDeck*/ true,
+                  /*lightweight*/ false) {
 }
@@ -710,13 +710,13 @@ void PlayerManager::slotAnalyzeTrack(TrackPointer track) {
     VERIFY_OR_DEBUG_ASSERT(track) {
         return;
     }
-    if (m_pTrackAnalysisScheduler) {
-        if (m_pTrackAnalysisScheduler->scheduleTrackById(track->getId())) {
-            m_pTrackAnalysisScheduler->resume();
-        }
+    if (m_pTrackAnalysisScheduler &&
+            m_pTrackAnalysisScheduler->scheduleTrackById(track->getId())) {
+        m_pTrackAnalysisScheduler->resume();
         // The first progress signal will suspend a running batch analysis
         // until all loaded tracks have been analyzed. Emit it once just now
-        // before any signals from the analyzer queue arrive.
+        // before any signals from the analyzer queue arrive. Only scheduled
+        // tracks will finish with trackAnalyzerIdle() that resumes it.
         emit trackAnalyzerProgress(track->getId(), kAnalyzerProgressUnknown);
     }
 }
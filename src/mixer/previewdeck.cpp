@@ -16,5 +16,6 @@ PreviewDeck::PreviewDeck(QObject* pParent,
                   handleGroup,
                   /*defaultMaster*/ false,
                   /*defaultHeadphones*/ true,
-                  /*primaryDeck*/ false) {
+                  /*primaryDeck*/ false,
+                  /*lightweight*/ false) {
 }
@@ -18,5 +18,6 @@ Sampler::Sampler(QObject* pParent,
                   handleGroup,
                   /*defaultMaster*/ true,
                   /*defaultHeadphones*/ false,
-                  /*primaryDeck*/ false) {
+                  /*primaryDeck*/ false,
+                  /*lightweight*/ true) {
 }
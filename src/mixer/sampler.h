@@ -2,6 +2,10 @@
 
 #include "mixer/basetrackplayer.h"
 
+// Samplers mostly play short one-shots and most of them stay empty. Their
+// engine channels allocate the resources that are needed for playback
+// only when a track is loaded. All controls of the [SamplerN] groups are
+// the same as for decks.
 class Sampler : public BaseTrackPlayerImpl {
     Q_OBJECT
   public:
@@ -40,6 +40,7 @@
 #include "skin/legacyskinparser.h"
 #include "skin/skinloader.h"
 #include "soundio/soundmanager.h"
+#include "sources/mp3seekindexcache.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/db/dbconnectionpooled.h"
@@ -53,6 +54,7 @@
 #include "util/statsmanager.h"
 #include "util/time.h"
 #include "util/timer.h"
+#include "util/tracing.h"
 #include "util/translations.h"
 #include "util/version.h"
 #include "util/widgethelper.h"
@@ -150,6 +152,7 @@ MixxxMainWindow::MixxxMainWindow(QApplication* pApp, const CmdlineArgs& args)
           m_pTouchShift(nullptr) {
     m_runtime_timer.start();
     mixxx::Time::start();
+    mixxx::Tracing::setEnabled(m_cmdLineArgs.getTimelineEnabled());
 
     Version::logBuildDetails();
 
@@ -205,6 +208,10 @@ void MixxxMainWindow::initialize(QApplication* pApp, const CmdlineArgs& args) {
 
     Sandbox::initialize(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
 
+    // The seek indices are stored next to the other analysis results
+    mixxx::Mp3SeekIndexCache::configure(
+            QDir(pConfig->getSettingsPath()).filePath("analysis/mp3seekindex"));
+
     QString resourcePath = pConfig->getResourcePath();
 
     FontUtils::initializeFonts(resourcePath); // takes a long time
@@ -818,6 +825,11 @@ void MixxxMainWindow::finalize() {
     if (m_cmdLineArgs.getDeveloper()) {
         StatsManager::destroy();
     }
+
+    if (m_cmdLineArgs.getTimelineEnabled()) {
+        mixxx::Tracing::setEnabled(false);
+        mixxx::Tracing::writeChromeTrace(m_cmdLineArgs.getTimelinePath());
+    }
 }
 
 bool MixxxMainWindow::initializeDatabase() {
@@ -0,0 +1,290 @@
+#include "sources/mp3seekindexcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("Mp3SeekIndexCache");
+
+const quint32 kMagic = 0x4D503353; // "MP3S"
+const quint32 kVersion = 1;
+
+const QString kFileSuffix = QStringLiteral(".seekindex");
+
+// Scanning the headers of fewer MP3 frames (~4 minutes at 44.1 kHz)
+// takes less time than reading and validating the cached index
+constexpr std::size_t kMinFrameCount = 10000;
+
+// The digest covers the beginning and the end of the file to detect
+// modifications that have preserved both the size and the modification
+// time, e.g. when copying files. MP3 frames are not covered, but most
+// tag editors rewrite the ID3v2 tag at the beginning or the ID3v1 tag
+// at the end of the file.
+constexpr quint64 kDigestBytes = 64 * 1024;
+
+QByteArray fileDigest(const unsigned char* pFileData, quint64 fileSize) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const quint64 headSize = qMin(fileSize, kDigestBytes);
+    hash.addData(reinterpret_cast<const char*>(pFileData), static_cast<int>(headSize));
+    const quint64 tailSize = qMin(fileSize - headSize, kDigestBytes);
+    hash.addData(
+            reinterpret_cast<const char*>(pFileData + fileSize - tailSize),
+            static_cast<int>(tailSize));
+    return hash.result();
+}
+
+qint64 lastModifiedMillis(const QFileInfo& fileInfo) {
+    return fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
+void touchFile(QFile* pFile) {
+    // The modification time of the cache file is used for evicting
+    // the least recently used files
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    pFile->setFileTime(
+            QDateTime::currentDateTimeUtc(),
+            QFileDevice::FileModificationTime);
+#else
+    Q_UNUSED(pFile);
+#endif
+}
+
+// Both the frame indices and the byte offsets are strictly increasing.
+// Their deltas are encoded as variable length integers that mostly fit
+// into 2 bytes.
+void appendVarint(QByteArray* pBytes, quint64 value) {
+    while (value >= 0x80) {
+        pBytes->append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    pBytes->append(static_cast<char>(value));
+}
+
+bool readVarint(const char** ppData, const char* const end, quint64* pValue) {
+    quint64 value = 0;
+    int shift = 0;
+    quint8 byte;
+    do {
+        if (*ppData >= end || shift > 63) {
+            return false;
+        }
+        byte = static_cast<quint8>(*(*ppData)++);
+        value |= static_cast<quint64>(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    *pValue = value;
+    return true;
+}
+
+QByteArray encodeFrames(const std::vector<Mp3SeekIndex::Frame>& frames) {
+    QByteArray bytes;
+    bytes.reserve(static_cast<int>(frames.size()) * 4);
+    SINT frameIndex = 0;
+    quint64 byteOffset = 0;
+    for (const auto& frame : frames) {
+        appendVarint(&bytes, frame.frameIndex - frameIndex);
+        appendVarint(&bytes, frame.byteOffset - byteOffset);
+        frameIndex = frame.frameIndex;
+        byteOffset = frame.byteOffset;
+    }
+    return bytes;
+}
+
+bool decodeFrames(
+        const QByteArray& bytes,
+        quint32 frameCount,
+        std::vector<Mp3SeekIndex::Frame>* pFrames) {
+    pFrames->clear();
+    pFrames->reserve(frameCount);
+    const char* data = bytes.constData();
+    const char* const end = data + bytes.size();
+    Mp3SeekIndex::Frame frame{0, 0};
+    for (quint32 i = 0; i < frameCount; ++i) {
+        quint64 frameIndexDelta;
+        quint64 byteOffsetDelta;
+        if (!readVarint(&data, end, &frameIndexDelta) ||
+                !readVarint(&data, end, &byteOffsetDelta)) {
+            return false;
+        }
+        // Only the first frame starts at frame index 0
+        if (i > 0 && (frameIndexDelta == 0 || byteOffsetDelta == 0)) {
+            return false;
+        }
+        frame.frameIndex += static_cast<SINT>(frameIndexDelta);
+        frame.byteOffset += byteOffsetDelta;
+        pFrames->push_back(frame);
+    }
+    return data == end;
+}
+
+} // anonymous namespace
+
+// static
+QString Mp3SeekIndexCache::s_directory;
+
+// static
+qint64 Mp3SeekIndexCache::s_quotaBytes = Mp3SeekIndexCache::kDefaultQuotaBytes;
+
+// static
+void Mp3SeekIndexCache::configure(const QString& directory, qint64 quotaBytes) {
+    s_directory = directory;
+    s_quotaBytes = quotaBytes;
+    if (!s_directory.isEmpty() && !QDir().mkpath(s_directory)) {
+        kLogger.warning() << "Failed to create directory" << s_directory;
+    }
+}
+
+// static
+QString Mp3SeekIndexCache::cacheFilePath(const QFileInfo& fileInfo) {
+    QString filePath = fileInfo.canonicalFilePath();
+    if (filePath.isEmpty()) {
+        filePath = fileInfo.absoluteFilePath();
+    }
+    const QByteArray pathHash = QCryptographicHash::hash(
+            filePath.toUtf8(), QCryptographicHash::Sha1);
+    return QDir(s_directory).filePath(QString::fromLatin1(pathHash.toHex()) + kFileSuffix);
+}
+
+// static
+bool Mp3SeekIndexCache::load(
+        const QFileInfo& fileInfo,
+        const unsigned char* pFileData,
+        quint64 fileSize,
+        Mp3SeekIndex* pSeekIndex) {
+    DEBUG_ASSERT(pSeekIndex);
+    if (s_directory.isEmpty() || !pFileData) {
+        return false;
+    }
+    QFile file(cacheFilePath(fileInfo));
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Not cached yet
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic;
+    quint32 version;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion) {
+        return false;
+    }
+    quint64 cachedFileSize;
+    qint64 cachedLastModified;
+    QByteArray cachedDigest;
+    in >> cachedFileSize >> cachedLastModified >> cachedDigest;
+    if (in.status() != QDataStream::Ok ||
+            cachedFileSize != fileSize ||
+            cachedLastModified != lastModifiedMillis(fileInfo) ||
+            cachedDigest != fileDigest(pFileData, fileSize)) {
+        // The file has been modified since the index has been cached
+        return false;
+    }
+
+    qint32 channelCount;
+    qint32 sampleRate;
+    qint32 bitrate;
+    qint64 frameLength;
+    quint32 frameCount;
+    QByteArray compressedFrames;
+    in >> channelCount >> sampleRate >> bitrate >> frameLength >> frameCount >> compressedFrames;
+    if (in.status() != QDataStream::Ok) {
+        kLogger.warning() << "Corrupt cache file" << file.fileName();
+        return false;
+    }
+
+    Mp3SeekIndex seekIndex;
+    seekIndex.channelCount = audio::ChannelCount(channelCount);
+    seekIndex.sampleRate = audio::SampleRate(sampleRate);
+    seekIndex.bitrate = audio::Bitrate(bitrate);
+    seekIndex.frameLength = static_cast<SINT>(frameLength);
+    if (!seekIndex.channelCount.isValid() ||
+            !seekIndex.sampleRate.isValid() ||
+            frameCount == 0 ||
+            !decodeFrames(qUncompress(compressedFrames), frameCount, &seekIndex.frames) ||
+            seekIndex.frames.front().frameIndex != 0 ||
+            seekIndex.frames.back().frameIndex >= seekIndex.frameLength ||
+            seekIndex.frames.back().byteOffset >= fileSize) {
+        kLogger.warning() << "Corrupt cache file" << file.fileName();
+        return false;
+    }
+    *pSeekIndex = std::move(seekIndex);
+    touchFile(&file);
+    return true;
+}
+
+// static
+bool Mp3SeekIndexCache::save(
+        const QFileInfo& fileInfo,
+        const unsigned char* pFileData,
+        quint64 fileSize,
+        const Mp3SeekIndex& seekIndex) {
+    if (s_directory.isEmpty() || !pFileData) {
+        return false;
+    }
+    VERIFY_OR_DEBUG_ASSERT(!seekIndex.frames.empty()) {
+        return false;
+    }
+    if (seekIndex.frames.size() < kMinFrameCount) {
+        return false;
+    }
+    // Written atomically to never leave a truncated file behind
+    QSaveFile file(cacheFilePath(fileInfo));
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to create cache file" << file.fileName();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << kMagic << kVersion
+        << fileSize << lastModifiedMillis(fileInfo) << fileDigest(pFileData, fileSize)
+        << static_cast<qint32>(seekIndex.channelCount)
+        << static_cast<qint32>(seekIndex.sampleRate)
+        << static_cast<qint32>(seekIndex.bitrate)
+        << static_cast<qint64>(seekIndex.frameLength)
+        << static_cast<quint32>(seekIndex.frames.size())
+        << qCompress(encodeFrames(seekIndex.frames));
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        kLogger.warning() << "Failed to write cache file" << file.fileName();
+        return false;
+    }
+    evictLeastRecentlyUsed();
+    return true;
+}
+
+// static
+void Mp3SeekIndexCache::evictLeastRecentlyUsed() {
+    if (s_directory.isEmpty()) {
+        return;
+    }
+    // Oldest files last
+    const QFileInfoList files = QDir(s_directory).entryInfoList(
+            QStringList{QStringLiteral("*") + kFileSuffix},
+            QDir::Files,
+            QDir::Time);
+    qint64 totalBytes = 0;
+    for (const auto& file : files) {
+        totalBytes += file.size();
+        if (totalBytes <= s_quotaBytes) {
+            continue;
+        }
+        if (QFile::remove(file.absoluteFilePath())) {
+            totalBytes -= file.size();
+            kLogger.debug()
+                    << "Evicted"
+                    << file.fileName();
+        }
+    }
+}
+
+} // namespace mixxx
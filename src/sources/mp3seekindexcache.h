@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QFileInfo>
+#include <QString>
+#include <vector>
+
+#include "audio/types.h"
+#include "util/types.h"
+
+namespace mixxx {
+
+// The positions of all MP3 frames in a file as collected by
+// SoundSourceMp3 while scanning the frame headers together with
+// the audio properties that have been derived from them.
+struct Mp3SeekIndex {
+    struct Frame {
+        SINT frameIndex;
+        quint64 byteOffset;
+    };
+
+    audio::ChannelCount channelCount;
+    audio::SampleRate sampleRate;
+    audio::Bitrate bitrate;
+    // The number of sample frames, i.e. the end of the last MP3 frame
+    SINT frameLength = 0;
+    // Ordered by both frameIndex and byteOffset
+    std::vector<Frame> frames;
+};
+
+// Persists the seek index of MP3 files to avoid scanning all frame
+// headers again each time a file is opened.
+//
+// Each file is identified by its canonical path. A cached index is only
+// used if the size, the modification time, and a digest of the first and
+// last bytes of the file are unchanged. Otherwise it is simply rebuilt
+// and overwritten.
+//
+// Only the indices of long files are stored, scanning the headers of
+// shorter files is fast enough. The total size of all cache files is
+// limited by a quota. Least recently used files are evicted first.
+class Mp3SeekIndexCache {
+  public:
+    static constexpr qint64 kDefaultQuotaBytes = 32 * 1024 * 1024;
+
+    // Sets the directory where the cache files are stored. The cache is
+    // disabled while the directory is empty.
+    static void configure(
+            const QString& directory,
+            qint64 quotaBytes = kDefaultQuotaBytes);
+
+    static bool load(
+            const QFileInfo& fileInfo,
+            const unsigned char* pFileData,
+            quint64 fileSize,
+            Mp3SeekIndex* pSeekIndex);
+    // Returns false without storing the index if the file is too short
+    // or the cache is disabled.
+    static bool save(
+            const QFileInfo& fileInfo,
+            const unsigned char* pFileData,
+            quint64 fileSize,
+            const Mp3SeekIndex& seekIndex);
+
+    // Deletes least recently used cache files until the total size of
+    // all files fits into the quota.
+    static void evictLeastRecentlyUsed();
+
+  private:
+    static QString cacheFilePath(const QFileInfo& fileInfo);
+
+    static QString s_directory;
+    static qint64 s_quotaBytes;
+};
+
+} // namespace mixxx
@@ -1,9 +1,12 @@
 #include "sources/soundsourcemp3.h"
 #include "sources/mp3decoding.h"
+#include "sources/mp3seekindexcache.h"
 
 #include "util/logger.h"
 #include "util/math.h"
 
+#include <QFileInfo>
+
 #include <id3tag.h>
 
 namespace mixxx {
@@ -225,6 +228,31 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     DEBUG_ASSERT(m_seekFrameList.empty());
     m_avgSeekFrameCount = 0;
     m_curFrameIndex = 0;
+    if (!restoreSeekFrames()) {
+        const OpenResult result = scanSeekFrames();
+        if (result != OpenResult::Succeeded) {
+            return result;
+        }
+        storeSeekFrames();
+    }
+
+    // Terminate m_seekFrameList
+    addSeekFrame(m_curFrameIndex, 0);
+    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
+
+    // Restart decoding at the beginning of the audio stream
+    restartDecoding(m_seekFrameList.front());
+
+    if (m_curFrameIndex != frameIndexMin()) {
+        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
+        // Abort
+        return OpenResult::Failed;
+    }
+
+    return OpenResult::Succeeded;
+}
+
+SoundSource::OpenResult SoundSourceMp3::scanSeekFrames() {
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
         headerPerSampleRate[i] = 0;
@@ -397,20 +425,45 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         kLogger.warning() << "Bitrate cannot be calculated from headers";
     }
 
-    // Terminate m_seekFrameList
-    addSeekFrame(m_curFrameIndex, 0);
-    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
-
-    // Restart decoding at the beginning of the audio stream
-    restartDecoding(m_seekFrameList.front());
+    return OpenResult::Succeeded;
+}
 
-    if (m_curFrameIndex != frameIndexMin()) {
-        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
-        // Abort
-        return OpenResult::Failed;
+bool SoundSourceMp3::restoreSeekFrames() {
+    Mp3SeekIndex seekIndex;
+    if (!Mp3SeekIndexCache::load(QFileInfo(m_file), m_pFileData, m_fileSize, &seekIndex)) {
+        return false;
+    }
+    if (seekIndex.channelCount > kChannelCountMax ||
+            getIndexBySampleRate(seekIndex.sampleRate) >= kSampleRateCount) {
+        kLogger.warning() << "Ignoring invalid seek index of" << m_file.fileName();
+        return false;
+    }
+    for (const auto& frame : seekIndex.frames) {
+        addSeekFrame(frame.frameIndex, m_pFileData + frame.byteOffset);
+    }
+    m_curFrameIndex = seekIndex.frameLength;
+    initChannelCountOnce(seekIndex.channelCount);
+    initSampleRateOnce(seekIndex.sampleRate);
+    initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
+    m_avgSeekFrameCount = frameLength() / m_seekFrameList.size();
+    if (seekIndex.bitrate.isValid()) {
+        initBitrateOnce(seekIndex.bitrate);
     }
+    return true;
+}
 
-    return OpenResult::Succeeded;
+void SoundSourceMp3::storeSeekFrames() const {
+    Mp3SeekIndex seekIndex;
+    seekIndex.channelCount = getSignalInfo().getChannelCount();
+    seekIndex.sampleRate = getSignalInfo().getSampleRate();
+    seekIndex.bitrate = getBitrate();
+    seekIndex.frameLength = frameLength();
+    seekIndex.frames.reserve(m_seekFrameList.size());
+    for (const auto& seekFrame : m_seekFrameList) {
+        seekIndex.frames.push_back({seekFrame.frameIndex,
+                static_cast<quint64>(seekFrame.pInputData - m_pFileData)});
+    }
+    Mp3SeekIndexCache::save(QFileInfo(m_file), m_pFileData, m_fileSize, seekIndex);
 }
 
 void SoundSourceMp3::close() {
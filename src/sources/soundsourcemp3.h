@@ -32,6 +32,14 @@ class SoundSourceMp3 final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    // Collects the seek frames by decoding all frame headers
+    OpenResult scanSeekFrames();
+
+    // Restores the seek frames from or stores them in the
+    // Mp3SeekIndexCache to speed up opening the file again
+    bool restoreSeekFrames();
+    void storeSeekFrames() const;
+
     QFile m_file;
     quint64 m_fileSize;
     unsigned char* m_pFileData;
@@ -481,8 +481,26 @@ void SoundSourceProxy::initSoundSource(
     }
 }
 
+//static
+SoundSourceProxy::PreparsedMetadata SoundSourceProxy::preparseMetadata(
+        const TrackFile& trackFile) {
+    PreparsedMetadata preparsedMetadata;
+    const SoundSourceProxy proxy(trackFile.toUrl());
+    if (!proxy.m_pSoundSource) {
+        return preparsedMetadata;
+    }
+    const auto metadataImported =
+            proxy.m_pSoundSource->importTrackMetadataAndCoverImage(
+                    &preparsedMetadata.trackMetadata,
+                    &preparsedMetadata.coverImage);
+    preparsedMetadata.importResult = metadataImported.first;
+    preparsedMetadata.sourceSynchronizedAt = metadataImported.second;
+    return preparsedMetadata;
+}
+
 void SoundSourceProxy::updateTrackFromSource(
-        ImportTrackMetadataMode importTrackMetadataMode) {
+        ImportTrackMetadataMode importTrackMetadataMode,
+        const PreparsedMetadata* pPreparsedMetadata) {
     DEBUG_ASSERT(m_pTrack);
 
     if (getUrl().isEmpty()) {
@@ -540,10 +558,22 @@ void SoundSourceProxy::updateTrackFromSource(
         }
     }
 
-    // Parse the tags stored in the audio file
-    auto metadataImported =
-            m_pSoundSource->importTrackMetadataAndCoverImage(
-                    &trackMetadata, pCoverImg);
+    std::pair<mixxx::MetadataSource::ImportResult, QDateTime> metadataImported;
+    if (pPreparsedMetadata && !metadataSynchronized && pCoverImg) {
+        // The track object has never been populated from the file
+        // before, i.e. the preparsed metadata is exactly what would
+        // have been imported now
+        trackMetadata = pPreparsedMetadata->trackMetadata;
+        coverImg = pPreparsedMetadata->coverImage;
+        metadataImported = std::make_pair(
+                pPreparsedMetadata->importResult,
+                pPreparsedMetadata->sourceSynchronizedAt);
+    } else {
+        // Parse the tags stored in the audio file
+        metadataImported =
+                m_pSoundSource->importTrackMetadataAndCoverImage(
+                        &trackMetadata, pCoverImg);
+    }
     if (metadataImported.first == mixxx::MetadataSource::ImportResult::Failed) {
         kLogger.warning()
                 << "Failed to import track metadata"
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "sources/metadatasource.h"
 #include "sources/soundsourceproviderregistry.h"
 #include "track/track_decl.h"
 #include "track/trackfile.h"
@@ -51,6 +52,26 @@ class SoundSourceProxy {
             TrackFile trackFile,
             SecurityTokenPointer pSecurityToken = SecurityTokenPointer());
 
+    /// Metadata and embedded cover image of a file that have been parsed
+    /// in advance without a track object.
+    struct PreparsedMetadata {
+        mixxx::MetadataSource::ImportResult importResult =
+                mixxx::MetadataSource::ImportResult::Unavailable;
+        QDateTime sourceSynchronizedAt;
+        mixxx::TrackMetadata trackMetadata;
+        QImage coverImage;
+    };
+
+    /// Parses the metadata and embedded cover image of a file that is
+    /// not yet referenced by any track object, e.g. when scanning for
+    /// new files. Can be invoked concurrently from multiple threads.
+    ///
+    /// Unlike importTemporaryTrack() this function does not lock the
+    /// global track cache and does not protect the file from being
+    /// written while reading it!
+    static PreparsedMetadata preparseMetadata(
+            const TrackFile& trackFile);
+
     explicit SoundSourceProxy(
             TrackPointer pTrack,
             const mixxx::SoundSourceProviderPointer& pProvider = nullptr);
@@ -113,8 +134,13 @@ class SoundSourceProxy {
     /// too many possible reasons for failure to consider that cannot be handled
     /// properly. The application log will contain warning messages for a detailed
     /// analysis in case unexpected behavior has been reported.
+    ///
+    /// Metadata that has been parsed in advance by preparseMetadata()
+    /// is only used for track objects that have never been populated from
+    /// the file before. The file is parsed again otherwise.
     void updateTrackFromSource(
-            ImportTrackMetadataMode importTrackMetadataMode = ImportTrackMetadataMode::Default);
+            ImportTrackMetadataMode importTrackMetadataMode = ImportTrackMetadataMode::Default,
+            const PreparsedMetadata* pPreparsedMetadata = nullptr);
 
     /// Parse only the metadata from the file without modifying
     /// the referenced track.
@@ -84,4 +84,32 @@ TEST_F(AnalyzerWaveformTest, canary) {
     }
 }
 
+// The stored levels of both waveforms match the analyzed data
+TEST_F(AnalyzerWaveformTest, storeLevels) {
+    for (int i = 0; i < BIGBUF_SIZE; i++) {
+        bigbuf[i] = static_cast<CSAMPLE>((i * 37) % 101) / 100.0f;
+    }
+    aw.initialize(tio, tio->getSampleRate(), BIGBUF_SIZE);
+    aw.processSamples(bigbuf, BIGBUF_SIZE);
+    aw.storeResults(tio);
+    aw.cleanup();
+
+    for (const auto& pWaveform : {tio->getWaveform(), tio->getWaveformSummary()}) {
+        ASSERT_TRUE(pWaveform);
+        const Waveform stored(pWaveform->toByteArray());
+        Waveform recomputed(pWaveform->toByteArray());
+        recomputed.updateLevels(0, recomputed.getDataSize());
+        ASSERT_LT(0, stored.getLevelCount());
+        ASSERT_EQ(recomputed.getLevelCount(), stored.getLevelCount());
+        for (int level = 0; level < stored.getLevelCount(); ++level) {
+            ASSERT_EQ(recomputed.getLevelDataSize(level), stored.getLevelDataSize(level));
+            for (int i = 0; i < stored.getLevelDataSize(level); ++i) {
+                ASSERT_EQ(recomputed.levelData(level)[i].m_i,
+                        stored.levelData(level)[i].m_i)
+                        << "level " << level << " index " << i;
+            }
+        }
+    }
+}
+
 } // namespace
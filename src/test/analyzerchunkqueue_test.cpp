@@ -0,0 +1,107 @@
+#include "analyzer/analyzerchunkqueue.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kCapacity = 4;
+constexpr SINT kChunkSize = 16;
+
+class AnalyzerChunkQueueTest : public testing::Test {
+  protected:
+    // Writes chunks that are filled with their index
+    static void writeChunks(AnalyzerChunkQueue* pQueue, int chunkCount) {
+        for (int i = 0; i < chunkCount; ++i) {
+            const auto chunk = pQueue->beginWrite();
+            ASSERT_FALSE(chunk.empty());
+            // Vary the length of the chunks
+            const SINT length = kChunkSize - (i % 2);
+            for (SINT j = 0; j < length; ++j) {
+                chunk[j] = static_cast<CSAMPLE>(i);
+            }
+            pQueue->endWrite(length);
+        }
+    }
+
+    // Returns the index of each chunk that has been read
+    static std::vector<int> readChunks(AnalyzerChunkQueue* pQueue, int consumer) {
+        std::vector<int> chunkIndices;
+        while (true) {
+            const auto chunk = pQueue->beginRead(consumer);
+            if (chunk.empty()) {
+                return chunkIndices;
+            }
+            const int chunkIndex = static_cast<int>(chunk[0]);
+            EXPECT_EQ(kChunkSize - (chunkIndex % 2), chunk.length());
+            EXPECT_EQ(static_cast<CSAMPLE>(chunkIndex), chunk[chunk.length() - 1]);
+            chunkIndices.push_back(chunkIndex);
+            pQueue->endRead(consumer);
+        }
+    }
+};
+
+TEST_F(AnalyzerChunkQueueTest, singleConsumer) {
+    AnalyzerChunkQueue queue(kCapacity, kChunkSize, 1);
+    // Fill the queue completely without blocking
+    writeChunks(&queue, kCapacity);
+    queue.finish();
+
+    const std::vector<int> chunkIndices = readChunks(&queue, 0);
+    ASSERT_EQ(static_cast<std::size_t>(kCapacity), chunkIndices.size());
+    for (int i = 0; i < kCapacity; ++i) {
+        EXPECT_EQ(i, chunkIndices[i]);
+    }
+}
+
+TEST_F(AnalyzerChunkQueueTest, multipleConsumers) {
+    constexpr int kConsumerCount = 3;
+    constexpr int kChunkCount = 100 * kCapacity + 1;
+    AnalyzerChunkQueue queue(kCapacity, kChunkSize, kConsumerCount);
+
+    std::vector<std::vector<int>> chunkIndices(kConsumerCount);
+    std::vector<std::thread> consumers;
+    for (int consumer = 0; consumer < kConsumerCount; ++consumer) {
+        consumers.emplace_back([&queue, &chunkIndices, consumer] {
+            chunkIndices[consumer] = readChunks(&queue, consumer);
+        });
+    }
+    writeChunks(&queue, kChunkCount);
+    queue.finish();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    for (int consumer = 0; consumer < kConsumerCount; ++consumer) {
+        ASSERT_EQ(static_cast<std::size_t>(kChunkCount), chunkIndices[consumer].size());
+        for (int i = 0; i < kChunkCount; ++i) {
+            EXPECT_EQ(i, chunkIndices[consumer][i]);
+        }
+    }
+}
+
+TEST_F(AnalyzerChunkQueueTest, abortUnblocksProducerAndConsumers) {
+    AnalyzerChunkQueue queue(kCapacity, kChunkSize, 2);
+    writeChunks(&queue, kCapacity);
+
+    // The first consumer has caught up and waits for the next chunk
+    std::thread consumer([&queue] {
+        while (!queue.beginRead(0).empty()) {
+            queue.endRead(0);
+        }
+    });
+    // The second consumer never reads, so the queue remains full
+    // and the producer blocks
+    std::thread producer([&queue] {
+        EXPECT_TRUE(queue.beginWrite().empty());
+    });
+
+    queue.abort();
+    producer.join();
+    consumer.join();
+    EXPECT_TRUE(queue.beginRead(1).empty());
+}
+
+} // namespace
@@ -0,0 +1,163 @@
+#include "analyzer/plugins/analyzerqueenmarybeats.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QVector>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "analyzer/constants.h"
+#include "analyzer/plugins/buffering_utils.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr double kSignalSeconds = 20.0;
+
+// A synthetic four-on-the-floor pattern: a kick with a noisy attack on
+// every beat, a snare on every other beat and a quiet pad in the
+// background.
+std::vector<CSAMPLE> generateBeats(int sampleRate, double bpm) {
+    const SINT frames = static_cast<SINT>(sampleRate * kSignalSeconds);
+    std::vector<CSAMPLE> samples(frames * mixxx::kAnalysisChannels);
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+    const double beatLength = 60.0 / bpm;
+    for (SINT i = 0; i < frames; ++i) {
+        const double time = static_cast<double>(i) / sampleRate;
+        const auto beat = static_cast<int>(time / beatLength);
+        const double beatTime = time - beat * beatLength;
+        double value = 0.7 * std::exp(-beatTime * 25) * std::sin(2 * M_PI * 50 * beatTime) +
+                0.3 * std::exp(-beatTime * 400) * noise(generator);
+        if (beat % 2 == 1) {
+            value += 0.25 * std::exp(-beatTime * 40) * noise(generator);
+        }
+        value += 0.05 * std::sin(2 * M_PI * 220 * time) +
+                0.05 * std::sin(2 * M_PI * 277.2 * time);
+        samples[i * 2] = static_cast<CSAMPLE>(value);
+        samples[i * 2 + 1] = static_cast<CSAMPLE>(value);
+    }
+    return samples;
+}
+
+QVector<double> detectBeats(
+        const std::vector<CSAMPLE>& samples,
+        int sampleRate,
+        bool reducedSampleRate) {
+    mixxx::AnalyzerQueenMaryBeats analyzer(reducedSampleRate);
+    EXPECT_TRUE(analyzer.initialize(sampleRate));
+    for (size_t i = 0; i < samples.size(); i += mixxx::kAnalysisSamplesPerChunk) {
+        const auto length = math_min<size_t>(
+                mixxx::kAnalysisSamplesPerChunk, samples.size() - i);
+        EXPECT_TRUE(analyzer.processSamples(&samples[i], static_cast<int>(length)));
+    }
+    EXPECT_TRUE(analyzer.finalize());
+    return analyzer.getBeats();
+}
+
+double averageBpm(const QVector<double>& beats, int sampleRate) {
+    return 60.0 * sampleRate * (beats.size() - 1) / (beats.last() - beats.first());
+}
+
+double sinePeak(int decimationFactor, double frequency) {
+    constexpr size_t kBlockSize = 1024;
+    constexpr int kBlockCount = 32;
+    mixxx::DecimationFilter filter(decimationFactor, kBlockSize);
+    std::vector<double> input(kBlockSize);
+    std::vector<double> output(kBlockSize / decimationFactor);
+    double peak = 0.0;
+    for (int block = 0; block < kBlockCount; ++block) {
+        for (size_t i = 0; i < kBlockSize; ++i) {
+            input[i] = std::sin(2 * M_PI * frequency * (block * kBlockSize + i));
+        }
+        filter.process(input.data(), output.data());
+        // Skip the transient response of the filter
+        if (block >= kBlockCount / 2) {
+            for (const double value : output) {
+                peak = math_max(peak, std::fabs(value));
+            }
+        }
+    }
+    return peak;
+}
+
+class AnalyzerQueenMaryBeatsTest : public testing::TestWithParam<int> {
+};
+
+TEST(DecimationFilterTest, passbandAndStopband) {
+    for (const int decimationFactor : {2, 4, 8}) {
+        // Frequencies relative to the input sample rate
+        const double nyquist = 0.5 / decimationFactor;
+        EXPECT_NEAR(1.0, sinePeak(decimationFactor, 0.1 * nyquist), 0.01);
+        EXPECT_NEAR(1.0, sinePeak(decimationFactor, 0.7 * nyquist), 0.01);
+        // Aliasing is attenuated by at least 50 dB
+        EXPECT_GT(0.003, sinePeak(decimationFactor, 1.1 * nyquist));
+        EXPECT_GT(0.003, sinePeak(decimationFactor, 1.8 * nyquist));
+    }
+}
+
+TEST(DecimationFilterTest, decimationFactorForSampleRate) {
+    EXPECT_EQ(1, mixxx::DownmixAndOverlapHelper::decimationFactorForSampleRate(22050));
+    EXPECT_EQ(1, mixxx::DownmixAndOverlapHelper::decimationFactorForSampleRate(32000));
+    EXPECT_EQ(2, mixxx::DownmixAndOverlapHelper::decimationFactorForSampleRate(44100));
+    EXPECT_EQ(2, mixxx::DownmixAndOverlapHelper::decimationFactorForSampleRate(48000));
+    EXPECT_EQ(4, mixxx::DownmixAndOverlapHelper::decimationFactorForSampleRate(96000));
+    EXPECT_EQ(8, mixxx::DownmixAndOverlapHelper::decimationFactorForSampleRate(192000));
+}
+
+// The beats that are detected at the reduced sample rate must match
+// the beats that are detected at the sample rate of the track
+TEST_P(AnalyzerQueenMaryBeatsTest, reducedSampleRate) {
+    const int sampleRate = GetParam();
+    // Allow a deviation of a single detection step of ~12 ms
+    const double maxDeviationFrames = 0.015 * sampleRate;
+    for (const double bpm : {87.5, 124.0, 140.0}) {
+        const auto samples = generateBeats(sampleRate, bpm);
+        const QVector<double> beats = detectBeats(samples, sampleRate, false);
+        const QVector<double> reducedBeats = detectBeats(samples, sampleRate, true);
+        ASSERT_LE(2, beats.size());
+        ASSERT_LE(2, reducedBeats.size());
+
+        EXPECT_NEAR(bpm, averageBpm(beats, sampleRate), 0.15);
+        EXPECT_NEAR(averageBpm(beats, sampleRate),
+                averageBpm(reducedBeats, sampleRate),
+                0.15);
+
+        int matchingBeats = 0;
+        for (const double reducedBeat : reducedBeats) {
+            for (const double beat : beats) {
+                if (std::fabs(reducedBeat - beat) <= maxDeviationFrames) {
+                    ++matchingBeats;
+                    break;
+                }
+            }
+        }
+        EXPECT_LE(reducedBeats.size() - 1, matchingBeats)
+                << "bpm: " << bpm;
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(SampleRates,
+        AnalyzerQueenMaryBeatsTest,
+        testing::Values(44100, 48000, 96000));
+
+// Compares the analysis at the sample rate of the track (second arg = 0)
+// with the analysis at the reduced sample rate (second arg = 1)
+static void BM_QueenMaryBeats(benchmark::State& state) {
+    const auto sampleRate = static_cast<int>(state.range(0));
+    const bool reducedSampleRate = state.range(1) != 0;
+    const auto samples = generateBeats(sampleRate, 124.0);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(detectBeats(samples, sampleRate, reducedSampleRate));
+    }
+}
+BENCHMARK(BM_QueenMaryBeats)
+        ->Args({44100, 0})
+        ->Args({44100, 1})
+        ->Args({96000, 0})
+        ->Args({96000, 1})
+        ->Unit(benchmark::kMillisecond);
+
+} // namespace
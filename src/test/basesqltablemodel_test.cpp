@@ -0,0 +1,112 @@
+#include "library/basesqltablemodel.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QDir>
+
+#include "library/dao/playlistdao.h"
+#include "library/playlisttablemodel.h"
+#include "test/librarytest.h"
+#include "widget/wlibrarytableview.h"
+
+namespace {
+
+const QString kTrackLocationTest(QDir::currentPath() %
+        "/src/test/id3-test-data/cover-test-png.mp3");
+
+// More than a single page of rows that are published at once
+const int kPlaylistLength = 600;
+
+class TestLibraryTableView : public WLibraryTableView {
+  public:
+    explicit TestLibraryTableView(UserSettingsPointer pConfig)
+            : WLibraryTableView(nullptr,
+                      pConfig,
+                      ConfigKey("[Library]", "TestVScrollBarPos")) {
+    }
+
+    void onShow() override {
+    }
+    bool hasFocus() const override {
+        return QWidget::hasFocus();
+    }
+};
+
+class BaseSqlTableModelTest : public LibraryTest {
+  protected:
+    BaseSqlTableModelTest()
+            : m_pTableModel(std::make_unique<PlaylistTableModel>(
+                      nullptr, trackCollections(), "mixxx.db.model.test")) {
+        TrackPointer pTrack = getOrAddTrackByLocation(kTrackLocationTest);
+        EXPECT_TRUE(pTrack);
+
+        PlaylistDAO& playlistDao = internalCollection()->getPlaylistDAO();
+        const int playlistId = playlistDao.createPlaylist(
+                QStringLiteral("BaseSqlTableModelTest"));
+        EXPECT_LE(0, playlistId);
+        // Playlists may contain the same track multiple times
+        QList<TrackId> trackIds;
+        for (int i = 0; i < kPlaylistLength; ++i) {
+            trackIds.append(pTrack->getId());
+        }
+        EXPECT_TRUE(playlistDao.appendTracksToPlaylist(trackIds, playlistId));
+
+        m_pTableModel->setTableModel(playlistId);
+        m_pTableModel->select();
+    }
+
+    const std::unique_ptr<PlaylistTableModel> m_pTableModel;
+};
+
+TEST_F(BaseSqlTableModelTest, publishRowsOnDemand) {
+    // Only the first page is published after select()
+    EXPECT_LT(0, m_pTableModel->rowCount());
+    EXPECT_GT(kPlaylistLength, m_pTableModel->rowCount());
+    EXPECT_EQ(kPlaylistLength, m_pTableModel->totalRowCount());
+    ASSERT_TRUE(m_pTableModel->canFetchMore());
+
+    const int publishedRows = m_pTableModel->rowCount();
+    m_pTableModel->fetchMore();
+    EXPECT_LT(publishedRows, m_pTableModel->rowCount());
+    EXPECT_EQ(kPlaylistLength, m_pTableModel->totalRowCount());
+
+    m_pTableModel->fetchAll();
+    EXPECT_FALSE(m_pTableModel->canFetchMore());
+    EXPECT_EQ(kPlaylistLength, m_pTableModel->rowCount());
+    EXPECT_EQ(kPlaylistLength, m_pTableModel->totalRowCount());
+    EXPECT_TRUE(m_pTableModel->getTrackId(
+            m_pTableModel->index(kPlaylistLength - 1, 0)).isValid());
+}
+
+TEST_F(BaseSqlTableModelTest, readRemainingRowsAfterFirstPage) {
+    const int publishedRows = m_pTableModel->rowCount();
+    ASSERT_LT(0, publishedRows);
+    int removedRows = 0;
+    QObject::connect(m_pTableModel.get(),
+            &QAbstractItemModel::rowsRemoved,
+            [&removedRows](const QModelIndex&, int first, int last) {
+                removedRows += last - first + 1;
+            });
+
+    // The remaining rows are appended to the published first page
+    // after returning to the event loop
+    QCoreApplication::processEvents();
+    EXPECT_EQ(0, removedRows);
+    EXPECT_EQ(publishedRows, m_pTableModel->rowCount());
+    EXPECT_TRUE(m_pTableModel->canFetchMore());
+    EXPECT_EQ(kPlaylistLength, m_pTableModel->totalRowCount());
+}
+
+TEST_F(BaseSqlTableModelTest, selectAllIncludesUnpublishedRows) {
+    TestLibraryTableView view(config());
+    view.setModel(m_pTableModel.get());
+    ASSERT_GT(kPlaylistLength, m_pTableModel->rowCount());
+
+    view.selectAll();
+    EXPECT_EQ(kPlaylistLength, m_pTableModel->rowCount());
+    EXPECT_EQ(kPlaylistLength,
+            view.selectionModel()->selectedRows().size());
+}
+
+} // namespace
@@ -0,0 +1,96 @@
+#include "engine/cachingreader/cachingreaderchunkpool.h"
+
+#include <gtest/gtest.h>
+
+#include <QVector>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class CachingReaderChunkPoolTest : public testing::Test {
+};
+
+TEST_F(CachingReaderChunkPoolTest, BorrowAndReturn) {
+    CachingReaderChunkPool pool(3);
+    EXPECT_EQ(3, pool.size());
+    EXPECT_EQ(3, pool.available());
+
+    QVector<CachingReaderChunkForOwner*> borrowedChunks;
+    for (int i = 0; i < 3; ++i) {
+        auto* pChunk = pool.borrowChunk();
+        ASSERT_NE(nullptr, pChunk);
+        EXPECT_EQ(CachingReaderChunkForOwner::FREE, pChunk->getState());
+        EXPECT_FALSE(borrowedChunks.contains(pChunk));
+        borrowedChunks.push_back(pChunk);
+    }
+    EXPECT_EQ(0, pool.available());
+
+    // Exhausted
+    EXPECT_EQ(nullptr, pool.borrowChunk());
+
+    for (auto* pChunk : borrowedChunks) {
+        pool.returnChunk(pChunk);
+    }
+    EXPECT_EQ(3, pool.available());
+}
+
+TEST_F(CachingReaderChunkPoolTest, EmptyPool) {
+    CachingReaderChunkPool pool(0);
+    EXPECT_EQ(0, pool.size());
+    EXPECT_EQ(0, pool.available());
+    EXPECT_EQ(nullptr, pool.borrowChunk());
+}
+
+TEST_F(CachingReaderChunkPoolTest, BorrowAndReturnConcurrently) {
+    // Channels that are processed in parallel share the pool
+    const int kThreadCount = 4;
+    const int kChunksPerThread = 8;
+    const int kIterations = 10000;
+    CachingReaderChunkPool pool(kThreadCount * kChunksPerThread);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreadCount; ++i) {
+        threads.emplace_back([&pool] {
+            QVector<CachingReaderChunkForOwner*> borrowedChunks;
+            for (int j = 0; j < kIterations; ++j) {
+                for (int k = 0; k < kChunksPerThread; ++k) {
+                    auto* pChunk = pool.borrowChunk();
+                    EXPECT_NE(nullptr, pChunk);
+                    if (pChunk) {
+                        borrowedChunks.push_back(pChunk);
+                    }
+                }
+                for (auto* pChunk : borrowedChunks) {
+                    pool.returnChunk(pChunk);
+                }
+                borrowedChunks.clear();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // No chunk has been lost or duplicated
+    EXPECT_EQ(pool.size(), pool.available());
+    QVector<CachingReaderChunkForOwner*> borrowedChunks;
+    for (SINT i = 0; i < pool.size(); ++i) {
+        auto* pChunk = pool.borrowChunk();
+        ASSERT_NE(nullptr, pChunk);
+        EXPECT_FALSE(borrowedChunks.contains(pChunk));
+        borrowedChunks.push_back(pChunk);
+    }
+    for (auto* pChunk : borrowedChunks) {
+        pool.returnChunk(pChunk);
+    }
+}
+
+TEST_F(CachingReaderChunkPoolTest, SharedInstance) {
+    auto pInstance = CachingReaderChunkPool::instance(UserSettingsPointer());
+    ASSERT_NE(nullptr, pInstance);
+    EXPECT_EQ(pInstance, CachingReaderChunkPool::instance(UserSettingsPointer()));
+    EXPECT_GT(pInstance->size(), 0);
+}
+
+} // namespace
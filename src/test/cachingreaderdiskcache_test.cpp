@@ -0,0 +1,232 @@
+#include "engine/cachingreader/cachingreaderdiskcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+TrackPointer newTestTrack() {
+    return Track::newTemporary(
+            QDir::currentPath() + "/src/test/sine-30.wav",
+            SecurityTokenPointer());
+}
+
+mixxx::AudioSourcePointer openStereoAudioSource(const TrackPointer& pTrack) {
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(CachingReaderChunk::kChannels);
+    return SoundSourceProxy(pTrack).openAudioSource(config);
+}
+
+class CachingReaderDiskCacheTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        config()->setValue(CachingReaderDiskCache::kEnabledConfigKey, true);
+        m_cacheDir = QDir(config()->getSettingsPath())
+                             .filePath(QStringLiteral("pcmcache"));
+        m_pTrack = newTestTrack();
+        m_cacheKey = CachingReaderDiskCache::cacheKeyForTrack(m_pTrack);
+        ASSERT_FALSE(m_cacheKey.isEmpty());
+    }
+
+    std::unique_ptr<CachingReaderDiskCache> newDiskCache() const {
+        return std::make_unique<CachingReaderDiskCache>(config());
+    }
+
+    std::unique_ptr<CachingReaderDiskCache::Writer> newWriter(
+            const CachingReaderDiskCache& diskCache) const {
+        return diskCache.createWriter(
+                m_cacheKey,
+                openStereoAudioSource(m_pTrack));
+    }
+
+    QString entryFilePath() const {
+        return m_cacheDir.filePath(m_cacheKey + QStringLiteral(".pcm"));
+    }
+
+    QStringList partialFileNames() const {
+        return m_cacheDir.entryList(
+                QStringList{QStringLiteral("*.part")},
+                QDir::Files);
+    }
+
+    void writeEntry(const CachingReaderDiskCache& diskCache) const {
+        auto pWriter = newWriter(diskCache);
+        ASSERT_NE(nullptr, pWriter);
+        while (pWriter->writeNextFrames()) {
+        }
+        ASSERT_TRUE(pWriter->isCommitted());
+    }
+
+    static void createFile(
+            const QString& filePath,
+            qint64 size,
+            const QDateTime& lastModified) {
+        QFile file(filePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        ASSERT_TRUE(file.resize(size));
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+        ASSERT_TRUE(file.setFileTime(
+                lastModified,
+                QFileDevice::FileModificationTime));
+#else
+        Q_UNUSED(lastModified);
+#endif
+    }
+
+    QDir m_cacheDir;
+    TrackPointer m_pTrack;
+    QString m_cacheKey;
+};
+
+TEST_F(CachingReaderDiskCacheTest, disabledByDefault) {
+    config()->setValue(CachingReaderDiskCache::kEnabledConfigKey, false);
+    const auto pDiskCache = newDiskCache();
+    EXPECT_FALSE(pDiskCache->isEnabled());
+    EXPECT_EQ(nullptr, newWriter(*pDiskCache));
+    EXPECT_EQ(nullptr, pDiskCache->openAudioSource(m_cacheKey));
+}
+
+TEST_F(CachingReaderDiskCacheTest, writeAndReadEntry) {
+    const auto pDiskCache = newDiskCache();
+    EXPECT_EQ(nullptr, pDiskCache->openAudioSource(m_cacheKey));
+
+    writeEntry(*pDiskCache);
+    EXPECT_TRUE(QFile::exists(entryFilePath()));
+    EXPECT_TRUE(partialFileNames().isEmpty());
+
+    const auto pCachedSource = pDiskCache->openAudioSource(m_cacheKey);
+    ASSERT_NE(nullptr, pCachedSource);
+    const auto pDecodedSource = openStereoAudioSource(m_pTrack);
+    ASSERT_NE(nullptr, pDecodedSource);
+    EXPECT_EQ(pDecodedSource->getSignalInfo().getChannelCount(),
+            pCachedSource->getSignalInfo().getChannelCount());
+    EXPECT_EQ(pDecodedSource->getSignalInfo().getSampleRate(),
+            pCachedSource->getSignalInfo().getSampleRate());
+    EXPECT_EQ(pDecodedSource->frameIndexRange(),
+            pCachedSource->frameIndexRange());
+
+    // The cached samples are identical to the decoded samples
+    const auto frameIndexRange = mixxx::IndexRange::forward(
+            pDecodedSource->frameIndexMin() + 10000,
+            CachingReaderChunk::kFrames);
+    mixxx::SampleBuffer decodedSamples(CachingReaderChunk::kSamples);
+    mixxx::SampleBuffer cachedSamples(CachingReaderChunk::kSamples);
+    ASSERT_EQ(frameIndexRange,
+            pDecodedSource
+                    ->readSampleFrames(mixxx::WritableSampleFrames(
+                            frameIndexRange,
+                            mixxx::SampleBuffer::WritableSlice(decodedSamples)))
+                    .frameIndexRange());
+    ASSERT_EQ(frameIndexRange,
+            pCachedSource
+                    ->readSampleFrames(mixxx::WritableSampleFrames(
+                            frameIndexRange,
+                            mixxx::SampleBuffer::WritableSlice(cachedSamples)))
+                    .frameIndexRange());
+    for (SINT i = 0; i < CachingReaderChunk::kSamples; ++i) {
+        ASSERT_EQ(decodedSamples[i], cachedSamples[i]);
+    }
+}
+
+TEST_F(CachingReaderDiskCacheTest, abortedWriterLeavesNoFiles) {
+    const auto pDiskCache = newDiskCache();
+    auto pWriter = newWriter(*pDiskCache);
+    ASSERT_NE(nullptr, pWriter);
+    ASSERT_TRUE(pWriter->writeNextFrames());
+    EXPECT_EQ(1, partialFileNames().size());
+
+    pWriter.reset();
+    EXPECT_TRUE(partialFileNames().isEmpty());
+    EXPECT_FALSE(QFile::exists(entryFilePath()));
+}
+
+TEST_F(CachingReaderDiskCacheTest, concurrentWritersOfSameEntry) {
+    const auto pDiskCache = newDiskCache();
+    auto pWriter1 = newWriter(*pDiskCache);
+    auto pWriter2 = newWriter(*pDiskCache);
+    ASSERT_NE(nullptr, pWriter1);
+    ASSERT_NE(nullptr, pWriter2);
+
+    // Both writers use their own file
+    ASSERT_TRUE(pWriter1->writeNextFrames());
+    ASSERT_TRUE(pWriter2->writeNextFrames());
+    EXPECT_EQ(2, partialFileNames().size());
+
+    while (pWriter1->writeNextFrames()) {
+        pWriter2->writeNextFrames();
+    }
+    EXPECT_TRUE(pWriter1->isCommitted());
+    const QDateTime committed = QFileInfo(entryFilePath()).lastModified();
+
+    // The second writer must not replace the committed entry
+    while (pWriter2->writeNextFrames()) {
+    }
+    EXPECT_FALSE(pWriter2->isCommitted());
+    EXPECT_EQ(committed, QFileInfo(entryFilePath()).lastModified());
+    EXPECT_TRUE(partialFileNames().isEmpty());
+
+    EXPECT_NE(nullptr, pDiskCache->openAudioSource(m_cacheKey));
+}
+
+TEST_F(CachingReaderDiskCacheTest, deleteTruncatedEntry) {
+    const auto pDiskCache = newDiskCache();
+    writeEntry(*pDiskCache);
+    ASSERT_TRUE(QFile::resize(
+            entryFilePath(),
+            QFileInfo(entryFilePath()).size() - sizeof(CSAMPLE)));
+
+    EXPECT_EQ(nullptr, pDiskCache->openAudioSource(m_cacheKey));
+    // Deleted to be written again
+    EXPECT_FALSE(QFile::exists(entryFilePath()));
+}
+
+TEST_F(CachingReaderDiskCacheTest, deleteInvalidEntry) {
+    const auto pDiskCache = newDiskCache();
+    {
+        QFile file(entryFilePath());
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        const QByteArray garbage(4096, 'x');
+        ASSERT_EQ(garbage.size(), file.write(garbage));
+    }
+
+    EXPECT_EQ(nullptr, pDiskCache->openAudioSource(m_cacheKey));
+    EXPECT_FALSE(QFile::exists(entryFilePath()));
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+TEST_F(CachingReaderDiskCacheTest, evictLeastRecentlyUsed) {
+    config()->setValue(CachingReaderDiskCache::kQuotaConfigKey, 1);
+    const auto pDiskCache = newDiskCache();
+    const qint64 kSize = 256 * 1024;
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+
+    const QString runningPartialFile = m_cacheDir.filePath("a.abcdef.pcm.part");
+    createFile(runningPartialFile, kSize, now);
+    const QString stalePartialFile = m_cacheDir.filePath("b.abcdef.pcm.part");
+    createFile(stalePartialFile, kSize, now.addSecs(-2 * 60 * 60));
+    const QString newEntry = m_cacheDir.filePath("c.pcm");
+    createFile(newEntry, 2 * kSize, now.addSecs(-10));
+    const QString oldEntry = m_cacheDir.filePath("d.pcm");
+    createFile(oldEntry, 2 * kSize, now.addSecs(-20));
+
+    pDiskCache->evictLeastRecentlyUsed();
+
+    // The partial entry of the running writer counts against the quota
+    EXPECT_TRUE(QFile::exists(runningPartialFile));
+    EXPECT_FALSE(QFile::exists(stalePartialFile));
+    EXPECT_TRUE(QFile::exists(newEntry));
+    EXPECT_FALSE(QFile::exists(oldEntry));
+}
+#endif
+
+} // namespace
@@ -0,0 +1,350 @@
+#include "engine/cachingreader/cachingreaderworker.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThread>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "engine/cachingreader/cachingreader.h"
+#include "engine/cachingreader/cachingreaderchunkpool.h"
+#include "engine/engineworkerscheduler.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const QString kGroup = QStringLiteral("[Channel1]");
+
+// The test file contains 30 s of a mono signal at 44.1 kHz that
+// is decoded into stereo samples.
+const SINT kTestTrackFrames = 30 * 44100;
+const SINT kTestTrackBytes =
+        CachingReaderChunk::frames2samples(kTestTrackFrames) * sizeof(CSAMPLE);
+
+const qint64 kTimeoutMillis = 10000;
+
+TrackPointer newTestTrack() {
+    return Track::newTemporary(
+            QDir::currentPath() + "/src/test/sine-30.wav",
+            SecurityTokenPointer());
+}
+
+// Runs a worker in its own thread. The test acts as the reader and
+// as the engine thread that wakes the worker.
+class WorkerHarness {
+  public:
+    WorkerHarness(double maxDurationSeconds, SINT memoryBudgetBytes)
+            : m_chunkReadRequestFIFO(20),
+              m_readerStatusUpdateFIFO(CachingReaderChunkPool::kMaxChunksPerReader),
+              m_releasedDecodedTrackFIFO(4),
+              m_worker(kGroup,
+                      &m_chunkReadRequestFIFO,
+                      &m_readerStatusUpdateFIFO,
+                      &m_releasedDecodedTrackFIFO) {
+        m_worker.setDecodedTrackLimits(maxDurationSeconds, memoryBudgetBytes);
+        m_worker.setScheduler(&m_scheduler);
+        m_worker.start();
+    }
+
+    ~WorkerHarness() {
+        m_worker.quitWait();
+        CachingReaderDecodedTrack* pDecodedTrack = nullptr;
+        while (m_releasedDecodedTrackFIFO.read(&pDecodedTrack, 1) == 1) {
+            CachingReaderWorker::deleteDecodedTrack(pDecodedTrack);
+        }
+    }
+
+    // Loads the track and returns the decoded track (if any) that is
+    // then owned by the caller. Fails if the track has not been loaded.
+    CachingReaderDecodedTrack* loadTrack(TrackPointer pTrack) {
+        m_worker.newTrack(std::move(pTrack));
+        ReaderStatusUpdate update;
+        EXPECT_TRUE(waitForStatusUpdate(&update));
+        EXPECT_EQ(TRACK_LOADED, update.status);
+        return update.takeDecodedTrack();
+    }
+
+    void unloadTrack() {
+        m_worker.newTrack(TrackPointer());
+        ReaderStatusUpdate update;
+        EXPECT_TRUE(waitForStatusUpdate(&update));
+        EXPECT_EQ(TRACK_UNLOADED, update.status);
+    }
+
+    // Submits all requests at once, i.e. the worker receives them
+    // together before processing any of them
+    void requestChunks(
+            const std::vector<CachingReaderChunkReadRequest>& requests) {
+        ASSERT_EQ(static_cast<int>(requests.size()),
+                m_chunkReadRequestFIFO.write(
+                        requests.data(), static_cast<int>(requests.size())));
+        m_worker.workReady();
+    }
+
+    // Returns the index and status of the chunks in the order
+    // in which they have been answered by the worker
+    std::vector<std::pair<SINT, ReaderStatus>> waitForChunks(int count) {
+        std::vector<std::pair<SINT, ReaderStatus>> chunks;
+        ReaderStatusUpdate update;
+        while (static_cast<int>(chunks.size()) < count &&
+                waitForStatusUpdate(&update)) {
+            CachingReaderChunkForOwner* pChunk = update.takeFromWorker();
+            EXPECT_NE(nullptr, pChunk);
+            if (pChunk) {
+                chunks.emplace_back(pChunk->getIndex(), update.status);
+            }
+        }
+        return chunks;
+    }
+
+    // Hands the decoded track back to the worker for deletion
+    void releaseDecodedTrack(CachingReaderDecodedTrack* pDecodedTrack) {
+        ASSERT_EQ(1, m_releasedDecodedTrackFIFO.write(&pDecodedTrack, 1));
+        m_worker.workReady();
+    }
+
+    bool waitForStatusUpdate(ReaderStatusUpdate* pUpdate) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!timer.hasExpired(kTimeoutMillis)) {
+            m_worker.wakeIfReady();
+            if (m_readerStatusUpdateFIFO.read(pUpdate, 1) == 1) {
+                return true;
+            }
+            QThread::msleep(1);
+        }
+        return false;
+    }
+
+    bool waitForDecodedTrackBytes(SINT expectedBytes) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!timer.hasExpired(kTimeoutMillis)) {
+            m_worker.wakeIfReady();
+            if (CachingReaderWorker::decodedTrackBytes() == expectedBytes) {
+                return true;
+            }
+            QThread::msleep(1);
+        }
+        return false;
+    }
+
+  private:
+    // Only needed for collecting the ready notifications of the
+    // worker and never started
+    EngineWorkerScheduler m_scheduler;
+    FIFO<CachingReaderChunkReadRequest> m_chunkReadRequestFIFO;
+    FIFO<ReaderStatusUpdate> m_readerStatusUpdateFIFO;
+    FIFO<CachingReaderDecodedTrack*> m_releasedDecodedTrackFIFO;
+    CachingReaderWorker m_worker;
+};
+
+// Chunks that are owned by the test acting as the reader
+class TestChunks {
+  public:
+    explicit TestChunks(int count)
+            : m_sampleBuffer(count * CachingReaderChunk::kSamples) {
+        for (int i = 0; i < count; ++i) {
+            m_chunks.push_back(std::make_unique<CachingReaderChunkForOwner>(
+                    mixxx::SampleBuffer::WritableSlice(
+                            m_sampleBuffer,
+                            i * CachingReaderChunk::kSamples,
+                            CachingReaderChunk::kSamples)));
+        }
+    }
+
+    CachingReaderChunkReadRequest request(
+            int chunk, SINT chunkIndex, int priority) {
+        m_chunks[chunk]->init(chunkIndex);
+        CachingReaderChunkReadRequest request;
+        request.giveToWorker(m_chunks[chunk].get(), priority);
+        return request;
+    }
+
+  private:
+    mixxx::SampleBuffer m_sampleBuffer;
+    std::vector<std::unique_ptr<CachingReaderChunkForOwner>> m_chunks;
+};
+
+class CachingReaderWorkerTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        // Decoded tracks of other tests might still be alive
+        m_baseBytes = CachingReaderWorker::decodedTrackBytes();
+    }
+
+    SINT m_baseBytes;
+};
+
+TEST_F(CachingReaderWorkerTest, decodeShortTrack) {
+    WorkerHarness harness(60.0, m_baseBytes + 64 * 1024 * 1024);
+
+    CachingReaderDecodedTrack* pDecodedTrack = harness.loadTrack(newTestTrack());
+    ASSERT_NE(nullptr, pDecodedTrack);
+    EXPECT_EQ(mixxx::IndexRange::forward(0, kTestTrackFrames),
+            pDecodedTrack->frameIndexRange());
+    EXPECT_EQ(kTestTrackBytes, pDecodedTrack->sizeInBytes());
+    EXPECT_EQ(m_baseBytes + kTestTrackBytes,
+            CachingReaderWorker::decodedTrackBytes());
+
+    harness.releaseDecodedTrack(pDecodedTrack);
+    EXPECT_TRUE(harness.waitForDecodedTrackBytes(m_baseBytes));
+}
+
+TEST_F(CachingReaderWorkerTest, readChunksOfLongTrack) {
+    WorkerHarness harness(10.0, m_baseBytes + 64 * 1024 * 1024);
+
+    EXPECT_EQ(nullptr, harness.loadTrack(newTestTrack()));
+    EXPECT_EQ(m_baseBytes, CachingReaderWorker::decodedTrackBytes());
+}
+
+TEST_F(CachingReaderWorkerTest, readChunksWhenOverBudget) {
+    WorkerHarness harness(60.0, m_baseBytes + kTestTrackBytes - 1);
+
+    EXPECT_EQ(nullptr, harness.loadTrack(newTestTrack()));
+    // The reservation has been rolled back
+    EXPECT_EQ(m_baseBytes, CachingReaderWorker::decodedTrackBytes());
+}
+
+TEST_F(CachingReaderWorkerTest, shareBudgetBetweenWorkers) {
+    // Sufficient for only a single decoded track
+    const SINT memoryBudgetBytes = m_baseBytes + kTestTrackBytes * 3 / 2;
+    WorkerHarness harness1(60.0, memoryBudgetBytes);
+    WorkerHarness harness2(60.0, memoryBudgetBytes);
+
+    CachingReaderDecodedTrack* pDecodedTrack1 = harness1.loadTrack(newTestTrack());
+    ASSERT_NE(nullptr, pDecodedTrack1);
+    EXPECT_EQ(nullptr, harness2.loadTrack(newTestTrack()));
+    EXPECT_EQ(m_baseBytes + kTestTrackBytes,
+            CachingReaderWorker::decodedTrackBytes());
+
+    // The budget becomes available again after the decoded
+    // track has been released by the first reader
+    harness1.unloadTrack();
+    harness1.releaseDecodedTrack(pDecodedTrack1);
+    ASSERT_TRUE(harness1.waitForDecodedTrackBytes(m_baseBytes));
+
+    CachingReaderDecodedTrack* pDecodedTrack2 = harness2.loadTrack(newTestTrack());
+    ASSERT_NE(nullptr, pDecodedTrack2);
+    EXPECT_EQ(m_baseBytes + kTestTrackBytes,
+            CachingReaderWorker::decodedTrackBytes());
+    harness2.releaseDecodedTrack(pDecodedTrack2);
+    EXPECT_TRUE(harness2.waitForDecodedTrackBytes(m_baseBytes));
+}
+
+TEST_F(CachingReaderWorkerTest, processRequestsByPriority) {
+    // Must outlive the worker that fills them
+    TestChunks chunks(4);
+    WorkerHarness harness(10.0, m_baseBytes);
+    ASSERT_EQ(nullptr, harness.loadTrack(newTestTrack()));
+
+    harness.requestChunks({
+            chunks.request(0, 10, Hint::kPriorityCue),
+            chunks.request(1, 20, Hint::kPriorityLoop),
+            chunks.request(2, 0, Hint::kPriorityPlayPosition),
+            chunks.request(3, 1, Hint::kPriorityPlayPosition),
+    });
+
+    const std::vector<std::pair<SINT, ReaderStatus>> expected = {
+            {0, CHUNK_READ_SUCCESS},
+            {1, CHUNK_READ_SUCCESS},
+            {20, CHUNK_READ_SUCCESS},
+            {10, CHUNK_READ_SUCCESS},
+    };
+    EXPECT_EQ(expected, harness.waitForChunks(4));
+}
+
+TEST_F(CachingReaderWorkerTest, discardPlayPositionRequestsAfterJump) {
+    TestChunks chunks(5);
+    WorkerHarness harness(10.0, m_baseBytes);
+    ASSERT_EQ(nullptr, harness.loadTrack(newTestTrack()));
+
+    // Requests for cue points are kept, they are not superseded
+    // by the new play position
+    harness.requestChunks({
+            chunks.request(0, 0, Hint::kPriorityPlayPosition),
+            chunks.request(1, 1, Hint::kPriorityPlayPosition),
+            chunks.request(2, 50, Hint::kPriorityCue),
+            chunks.request(3, 100, Hint::kPriorityPlayPosition),
+            chunks.request(4, 101, Hint::kPriorityPlayPosition),
+    });
+
+    const std::vector<std::pair<SINT, ReaderStatus>> expected = {
+            {0, CHUNK_READ_DISCARDED},
+            {1, CHUNK_READ_DISCARDED},
+            {100, CHUNK_READ_SUCCESS},
+            {101, CHUNK_READ_SUCCESS},
+            {50, CHUNK_READ_SUCCESS},
+    };
+    EXPECT_EQ(expected, harness.waitForChunks(5));
+}
+
+TEST_F(CachingReaderWorkerTest, keepPlayPositionRequestsWhileSlipping) {
+    TestChunks chunks(4);
+    WorkerHarness harness(10.0, m_baseBytes);
+    ASSERT_EQ(nullptr, harness.loadTrack(newTestTrack()));
+
+    // The virtual play position in slip mode is usually far away from
+    // the audible play position and must not supersede its requests
+    harness.requestChunks({
+            chunks.request(0, 0, Hint::kPriorityPlayPosition),
+            chunks.request(1, 100, Hint::kPrioritySlipPosition),
+            chunks.request(2, 1, Hint::kPriorityPlayPosition),
+            chunks.request(3, 101, Hint::kPrioritySlipPosition),
+    });
+
+    const std::vector<std::pair<SINT, ReaderStatus>> expected = {
+            {0, CHUNK_READ_SUCCESS},
+            {1, CHUNK_READ_SUCCESS},
+            {100, CHUNK_READ_SUCCESS},
+            {101, CHUNK_READ_SUCCESS},
+    };
+    EXPECT_EQ(expected, harness.waitForChunks(4));
+}
+
+TEST_F(CachingReaderWorkerTest, readerReleasesDecodedTrackOnUnload) {
+    config()->setValue(CachingReader::kDecodedTrackMaxDurationConfigKey, 60.0);
+    EngineWorkerScheduler scheduler;
+    scheduler.start();
+    auto pReader = std::make_unique<CachingReader>(kGroup, config());
+    pReader->setScheduler(&scheduler);
+
+    // Acts as the engine thread that drives the reader and wakes
+    // the worker through the scheduler.
+    const auto processUntil = [&](const auto& condition) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!timer.hasExpired(kTimeoutMillis)) {
+            pReader->process();
+            if (condition()) {
+                return true;
+            }
+            scheduler.workerReady();
+            scheduler.runWorkers();
+            QThread::msleep(1);
+        }
+        return false;
+    };
+
+    pReader->newTrack(newTestTrack());
+    CSAMPLE buffer[2048];
+    ASSERT_TRUE(processUntil([&] {
+        return pReader->read(0, 2048, false, buffer) ==
+                CachingReader::ReadResult::AVAILABLE;
+    }));
+    EXPECT_EQ(m_baseBytes + kTestTrackBytes,
+            CachingReaderWorker::decodedTrackBytes());
+
+    pReader->newTrack(TrackPointer());
+    EXPECT_TRUE(processUntil([&] {
+        return CachingReaderWorker::decodedTrackBytes() == m_baseBytes;
+    }));
+    pReader.reset();
+}
+
+} // namespace
@@ -0,0 +1,97 @@
+#include "engine/channelmixer.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "util/sample.h"
+
+namespace {
+
+class ChannelMixerTest : public testing::Test {
+  protected:
+    static std::vector<std::vector<CSAMPLE>> createBuffers(
+            int numBuffers, SINT numSamples) {
+        std::vector<std::vector<CSAMPLE>> buffers(numBuffers);
+        for (int channel = 0; channel < numBuffers; ++channel) {
+            buffers[channel].resize(numSamples);
+            for (SINT i = 0; i < numSamples; ++i) {
+                buffers[channel][i] = 0.01f * channel - 0.001f * (i % 100);
+            }
+        }
+        return buffers;
+    }
+
+    static std::vector<const CSAMPLE*> bufferPointers(
+            const std::vector<std::vector<CSAMPLE>>& buffers) {
+        std::vector<const CSAMPLE*> pointers;
+        for (const auto& buffer : buffers) {
+            pointers.push_back(buffer.data());
+        }
+        return pointers;
+    }
+};
+
+TEST_F(ChannelMixerTest, mixChannelBuffers) {
+    // Covers the single pass, the blocked multi-pass accumulation with
+    // partial passes and partial blocks at the end of the buffer
+    for (int numBuffers = 0; numBuffers <= 4 * ChannelMixer::kMaxChannelsPerPass + 1;
+            ++numBuffers) {
+        for (const SINT numSamples : {0, 2, 7, 1024, 2050}) {
+            const auto buffers = createBuffers(numBuffers, numSamples);
+            const auto pointers = bufferPointers(buffers);
+            // One additional sample to detect overflows
+            std::vector<CSAMPLE> output(numSamples + 1, 1.0f);
+            ChannelMixer::mixChannelBuffers(
+                    output.data(), pointers.data(), numBuffers, numSamples);
+            for (SINT i = 0; i < numSamples; ++i) {
+                CSAMPLE expected = CSAMPLE_ZERO;
+                for (const auto& buffer : buffers) {
+                    expected += buffer[i];
+                }
+                EXPECT_NEAR(expected, output[i], 1e-5f)
+                        << numBuffers << " buffers, sample " << i;
+            }
+            EXPECT_EQ(1.0f, output[numSamples]);
+        }
+    }
+}
+
+// The mixing loop that was used for more than the number of channels
+// with generated code
+static void BM_MixChannelBuffersPerChannel(benchmark::State& state) {
+    const int numBuffers = static_cast<int>(state.range(0));
+    const SINT numSamples = 2048;
+    std::vector<std::vector<CSAMPLE>> buffers(
+            numBuffers, std::vector<CSAMPLE>(numSamples, 0.1f));
+    std::vector<CSAMPLE> output(numSamples);
+    for (auto _ : state) {
+        SampleUtil::clear(output.data(), numSamples);
+        for (const auto& buffer : buffers) {
+            SampleUtil::add(output.data(), buffer.data(), numSamples);
+        }
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_MixChannelBuffersPerChannel)->DenseRange(1, 16)->Arg(24)->Arg(32)->Arg(64);
+
+static void BM_MixChannelBuffers(benchmark::State& state) {
+    const int numBuffers = static_cast<int>(state.range(0));
+    const SINT numSamples = 2048;
+    std::vector<std::vector<CSAMPLE>> buffers(
+            numBuffers, std::vector<CSAMPLE>(numSamples, 0.1f));
+    std::vector<const CSAMPLE*> pointers;
+    for (const auto& buffer : buffers) {
+        pointers.push_back(buffer.data());
+    }
+    std::vector<CSAMPLE> output(numSamples);
+    for (auto _ : state) {
+        ChannelMixer::mixChannelBuffers(
+                output.data(), pointers.data(), numBuffers, numSamples);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_MixChannelBuffers)->DenseRange(1, 16)->Arg(24)->Arg(32)->Arg(64);
+
+} // namespace
@@ -0,0 +1,67 @@
+#include "engine/channelprocessingpool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+namespace {
+
+class CountingJob : public ChannelProcessingPool::Job {
+  public:
+    explicit CountingJob(int numTasks)
+            : m_runCounts(numTasks) {
+        for (auto& runCount : m_runCounts) {
+            runCount = 0;
+        }
+    }
+
+    void runTask(int taskIndex) override {
+        m_runCounts[taskIndex].fetch_add(1);
+    }
+
+    int runCount(int taskIndex) const {
+        return m_runCounts[taskIndex].load();
+    }
+
+  private:
+    std::vector<std::atomic<int>> m_runCounts;
+};
+
+class ChannelProcessingPoolTest : public testing::Test {
+  protected:
+    static void runAndVerify(ChannelProcessingPool* pPool, int numTasks) {
+        CountingJob job(numTasks);
+        pPool->run(&job, numTasks);
+        for (int i = 0; i < numTasks; ++i) {
+            // All tasks must have been run exactly once when run() returns
+            EXPECT_EQ(1, job.runCount(i)) << "task " << i << " of " << numTasks;
+        }
+    }
+};
+
+TEST_F(ChannelProcessingPoolTest, noWorkers) {
+    ChannelProcessingPool pool(0);
+    EXPECT_EQ(0, pool.numWorkerThreads());
+    for (int numTasks = 0; numTasks <= 8; ++numTasks) {
+        runAndVerify(&pool, numTasks);
+    }
+}
+
+TEST_F(ChannelProcessingPoolTest, runAllTasksOnce) {
+    ChannelProcessingPool pool(3);
+    EXPECT_EQ(3, pool.numWorkerThreads());
+    // Many subsequent jobs with varying numbers of tasks, i.e. more or
+    // less tasks than threads
+    for (int i = 0; i < 1000; ++i) {
+        runAndVerify(&pool, i % 13);
+    }
+}
+
+TEST_F(ChannelProcessingPoolTest, clampNumWorkerThreads) {
+    ChannelProcessingPool pool(ChannelProcessingPool::kMaxWorkerThreads + 1);
+    EXPECT_EQ(ChannelProcessingPool::kMaxWorkerThreads, pool.numWorkerThreads());
+    runAndVerify(&pool, 64);
+}
+
+} // namespace
@@ -0,0 +1,264 @@
+#include "library/columnartrackindex.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QSqlDatabase>
+#include <atomic>
+#include <memory>
+#include <random>
+
+#include "library/searchquery.h"
+
+namespace {
+
+enum Column {
+    kIdColumn,
+    kArtistColumn,
+    kTitleColumn,
+    kGenreColumn,
+    kLocationColumn,
+    kBpmColumn,
+    kNumColumns,
+};
+
+ColumnarTrackIndex newIndex() {
+    const QStringList columnNames = {
+            "id",
+            "artist",
+            "title",
+            "genre",
+            "location",
+            "bpm",
+    };
+    const QVector<ColumnarTrackIndex::ColumnType> columnTypes = {
+            ColumnarTrackIndex::ColumnType::Number,
+            ColumnarTrackIndex::ColumnType::String,
+            ColumnarTrackIndex::ColumnType::String,
+            ColumnarTrackIndex::ColumnType::String,
+            ColumnarTrackIndex::ColumnType::String,
+            ColumnarTrackIndex::ColumnType::Number,
+    };
+    return ColumnarTrackIndex(columnNames, columnTypes);
+}
+
+void setRow(ColumnarTrackIndex* pIndex,
+        int id,
+        const QString& artist,
+        const QString& title,
+        const QString& genre,
+        const QVariant& bpm) {
+    QVector<QVariant> values(kNumColumns);
+    values[kIdColumn] = id;
+    values[kArtistColumn] = artist;
+    values[kTitleColumn] = title;
+    values[kGenreColumn] = genre;
+    values[kLocationColumn] = QString("/music/%1 - %2.mp3").arg(artist, title);
+    values[kBpmColumn] = bpm;
+    pIndex->setRow(TrackId(id), values);
+}
+
+std::unique_ptr<QueryNode> newTextFilter(const QString& argument) {
+    return std::make_unique<TextFilterNode>(
+            QSqlDatabase(),
+            QStringList{"artist", "title", "genre", "location"},
+            argument);
+}
+
+QSet<TrackId> allTrackIds(const ColumnarTrackIndex& index) {
+    QSet<TrackId> trackIds;
+    for (int row = 0; row < index.rowCount(); ++row) {
+        if (index.trackId(row).isValid()) {
+            trackIds.insert(index.trackId(row));
+        }
+    }
+    return trackIds;
+}
+
+class ColumnarTrackIndexTest : public testing::Test {
+  protected:
+    ColumnarTrackIndexTest()
+            : m_index(newIndex()) {
+        setRow(&m_index, 1, "Daft Punk", "Around the World", "House", 121.0);
+        setRow(&m_index, 2, "Aphex Twin", "Windowlicker", "IDM", 126.0);
+        setRow(&m_index, 3, "Daft Punk", "One More Time", "House", 123.0);
+        setRow(&m_index, 4, "Björk", "Army of Me", "Pop", QVariant());
+    }
+
+    QList<int> select(
+            const QueryNode* pQuery,
+            const QVector<ColumnarTrackIndex::SortKey>& sortKeys) const {
+        QList<int> ids;
+        const auto trackIds = m_index.select(
+                allTrackIds(m_index),
+                pQuery,
+                sortKeys,
+                KeyUtils::KeyNotation::OpenKey);
+        for (const auto& trackId : trackIds) {
+            ids.append(trackId.toVariant().toInt());
+        }
+        return ids;
+    }
+
+    ColumnarTrackIndex m_index;
+};
+
+TEST_F(ColumnarTrackIndexTest, values) {
+    const int row = m_index.findRow(TrackId(4));
+    ASSERT_LE(0, row);
+    EXPECT_EQ(QVariant("Björk"), m_index.value(row, kArtistColumn));
+    EXPECT_TRUE(m_index.isNull(row, kBpmColumn));
+    EXPECT_TRUE(m_index.value(row, kBpmColumn).isNull());
+    EXPECT_EQ(QVariant(126.0), m_index.value(m_index.findRow(TrackId(2)), kBpmColumn));
+    // Equal strings are only stored once
+    EXPECT_EQ(m_index.stringId(m_index.findRow(TrackId(1)), kArtistColumn),
+            m_index.stringId(m_index.findRow(TrackId(3)), kArtistColumn));
+}
+
+TEST_F(ColumnarTrackIndexTest, search) {
+    auto pQuery = newTextFilter("daft");
+    EXPECT_EQ(QList<int>({1, 3}), select(pQuery.get(), {}));
+
+    // Too short for the trigram index
+    pQuery = newTextFilter("da");
+    EXPECT_EQ(QList<int>({1, 3}), select(pQuery.get(), {}));
+
+    // Case and diacritics are ignored like in the SQL query
+    pQuery = newTextFilter("bjork");
+    EXPECT_EQ(QList<int>({4}), select(pQuery.get(), {}));
+
+    auto pAndNode = std::make_unique<AndNode>();
+    pAndNode->addNode(newTextFilter("punk"));
+    pAndNode->addNode(std::make_unique<NotNode>(newTextFilter("world")));
+    EXPECT_EQ(QList<int>({3}), select(pAndNode.get(), {}));
+
+    auto pNumericNode = std::make_unique<NumericFilterNode>(QStringList{"bpm"}, ">122");
+    EXPECT_EQ(QList<int>({2, 3}), select(pNumericNode.get(), {}));
+
+    auto pNullNode = std::make_unique<NullNumericFilterNode>(QStringList{"bpm"});
+    EXPECT_EQ(QList<int>({4}), select(pNullNode.get(), {}));
+}
+
+TEST_F(ColumnarTrackIndexTest, sort) {
+    const ColumnarTrackIndex::SortKey artistAscending{
+            kArtistColumn,
+            ColumnarTrackIndex::SortMode::Collated,
+            Qt::AscendingOrder};
+    const ColumnarTrackIndex::SortKey bpmDescending{
+            kBpmColumn,
+            ColumnarTrackIndex::SortMode::Numeric,
+            Qt::DescendingOrder};
+    EXPECT_EQ(QList<int>({2, 4, 3, 1}), select(nullptr, {artistAscending, bpmDescending}));
+    // NULL sorts last in descending order
+    EXPECT_EQ(QList<int>({2, 3, 1, 4}), select(nullptr, {bpmDescending}));
+
+    // The cached order is updated when the index is modified
+    setRow(&m_index, 1, "Daft Punk", "Around the World", "House", 130.0);
+    EXPECT_EQ(QList<int>({1, 2, 3, 4}), select(nullptr, {bpmDescending}));
+
+    m_index.removeRow(TrackId(2));
+    EXPECT_EQ(QList<int>({1, 3, 4}), select(nullptr, {bpmDescending}));
+    EXPECT_FALSE(m_index.contains(TrackId(2)));
+}
+
+TEST_F(ColumnarTrackIndexTest, canceled) {
+    std::atomic<bool> canceled(false);
+    EXPECT_EQ(4,
+            m_index.select(allTrackIds(m_index),
+                           nullptr,
+                           {},
+                           KeyUtils::KeyNotation::OpenKey,
+                           &canceled)
+                    .size());
+    canceled.store(true);
+    EXPECT_TRUE(m_index.select(allTrackIds(m_index),
+                               nullptr,
+                               {},
+                               KeyUtils::KeyNotation::OpenKey,
+                               &canceled)
+                        .isEmpty());
+}
+
+// A library with 250k tracks, see below
+class LargeLibrary {
+  public:
+    LargeLibrary()
+            : m_index(newIndex()) {
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<int> artistDistribution(1, 20000);
+        std::uniform_int_distribution<int> genreDistribution(1, 50);
+        std::uniform_int_distribution<int> wordDistribution(0, 999);
+        std::uniform_int_distribution<int> bpmDistribution(70, 180);
+        for (int id = 1; id <= 250000; ++id) {
+            const QString title = QString("Track %1 %2")
+                                          .arg(wordDistribution(generator))
+                                          .arg(wordDistribution(generator));
+            setRow(&m_index,
+                    id,
+                    QString("Artist %1").arg(artistDistribution(generator)),
+                    title,
+                    QString("Genre %1").arg(genreDistribution(generator)),
+                    bpmDistribution(generator));
+        }
+        m_trackIds = allTrackIds(m_index);
+    }
+
+    const ColumnarTrackIndex& index() const {
+        return m_index;
+    }
+    const QSet<TrackId>& trackIds() const {
+        return m_trackIds;
+    }
+
+  private:
+    ColumnarTrackIndex m_index;
+    QSet<TrackId> m_trackIds;
+};
+
+// Search-as-you-type in a library with 250k tracks sorted by artist.
+// Each keystroke creates a new query like BaseTrackCache::filterAndSort().
+static void BM_SearchAsYouType(benchmark::State& state) {
+    const LargeLibrary library;
+    const QVector<ColumnarTrackIndex::SortKey> sortKeys = {
+            {kArtistColumn, ColumnarTrackIndex::SortMode::Collated, Qt::AscendingOrder},
+            {kTitleColumn, ColumnarTrackIndex::SortMode::Collated, Qt::AscendingOrder},
+    };
+    const QString input = "artist 1234";
+    // Sort once in advance, the order is cached until the index changes
+    library.index().select(library.trackIds(), nullptr, sortKeys, KeyUtils::KeyNotation::OpenKey);
+    int keystroke = 0;
+    for (auto _ : state) {
+        const auto pQuery = newTextFilter(input.left(keystroke % input.size() + 1));
+        benchmark::DoNotOptimize(library.index().select(
+                library.trackIds(),
+                pQuery.get(),
+                sortKeys,
+                KeyUtils::KeyNotation::OpenKey));
+        ++keystroke;
+    }
+    state.SetItemsProcessed(state.iterations() * library.trackIds().size());
+}
+BENCHMARK(BM_SearchAsYouType)->Unit(benchmark::kMillisecond);
+
+// Sorting all tracks after the index has been modified
+static void BM_SortByArtist(benchmark::State& state) {
+    const LargeLibrary library;
+    const QVector<ColumnarTrackIndex::SortKey> sortKeys = {
+            {kArtistColumn, ColumnarTrackIndex::SortMode::Collated, Qt::AscendingOrder},
+    };
+    auto bpmDescending = sortKeys;
+    bpmDescending[0] = {kBpmColumn, ColumnarTrackIndex::SortMode::Numeric, Qt::DescendingOrder};
+    int iteration = 0;
+    for (auto _ : state) {
+        // Alternate the sort keys to invalidate the cached order
+        benchmark::DoNotOptimize(library.index().select(
+                library.trackIds(),
+                nullptr,
+                iteration++ % 2 ? sortKeys : bpmDescending,
+                KeyUtils::KeyNotation::OpenKey));
+    }
+    state.SetItemsProcessed(state.iterations() * library.trackIds().size());
+}
+BENCHMARK(BM_SortByArtist)->Unit(benchmark::kMillisecond);
+
+} // namespace
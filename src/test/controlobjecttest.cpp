@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include <QtDebug>
 
+#include "control/controlchangebatcher.h"
 #include "control/controlobject.h"
+#include "control/controlproxy.h"
 #include "util/memory.h"
 #include "test/mixxxtest.h"
 
@@ -85,4 +87,55 @@ TEST_F(ControlObjectTest, Persistence_ValidValue) {
     EXPECT_DOUBLE_EQ(5.0, co.get());
 }
 
+TEST_F(ControlObjectTest, CoalescedValueChanged) {
+    QObject receiver;
+    ControlProxy proxy(ck1);
+    QList<double> values;
+    ASSERT_TRUE(proxy.connectValueChangedCoalesced(
+            &receiver, [&values](double value) { values.append(value); }));
+
+    // Subsequent changes are only delivered once per tick with the
+    // latest value
+    co1->set(1.0);
+    co1->set(2.0);
+    co1->set(3.0);
+    EXPECT_TRUE(values.isEmpty());
+    ControlChangeBatcher::notifySubscribers();
+    EXPECT_EQ(QList<double>{3.0}, values);
+
+    // Nothing has changed
+    ControlChangeBatcher::notifySubscribers();
+    EXPECT_EQ(QList<double>{3.0}, values);
+
+    // Changes that cancel each other out are not delivered
+    co1->set(4.0);
+    co1->set(3.0);
+    ControlChangeBatcher::notifySubscribers();
+    EXPECT_EQ(QList<double>{3.0}, values);
+}
+
+TEST_F(ControlObjectTest, CoalescedValueChangedMultipleProxies) {
+    QObject receiver;
+    QList<double> values1;
+    QList<double> values2;
+    auto pProxy1 = std::make_unique<ControlProxy>(ck1);
+    ControlProxy proxy2(ck1);
+    pProxy1->connectValueChangedCoalesced(
+            &receiver, [&values1](double value) { values1.append(value); });
+    proxy2.connectValueChangedCoalesced(
+            &receiver, [&values2](double value) { values2.append(value); });
+
+    co1->set(1.0);
+    ControlChangeBatcher::notifySubscribers();
+    EXPECT_EQ(QList<double>{1.0}, values1);
+    EXPECT_EQ(QList<double>{1.0}, values2);
+
+    // The remaining subscriber is still notified
+    pProxy1.reset();
+    co1->set(2.0);
+    ControlChangeBatcher::notifySubscribers();
+    EXPECT_EQ(QList<double>{1.0}, values1);
+    EXPECT_EQ((QList<double>{1.0, 2.0}), values2);
+}
+
 }
@@ -0,0 +1,168 @@
+#include "control/controlregistry.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+// Approximates the set of controls that exist after startup with
+// 4 decks, 4 samplers, 4 effect units and the master section
+std::vector<ConfigKey> startupControlKeys() {
+    std::vector<ConfigKey> keys;
+    QStringList groups;
+    for (int i = 1; i <= 4; ++i) {
+        groups << QString("[Channel%1]").arg(i);
+        groups << QString("[Sampler%1]").arg(i);
+        groups << QString("[EqualizerRack1_[Channel%1]_Effect1]").arg(i);
+        groups << QString("[QuickEffectRack1_[Channel%1]]").arg(i);
+        for (int j = 1; j <= 3; ++j) {
+            groups << QString("[EffectRack1_EffectUnit%1_Effect%2]").arg(i).arg(j);
+        }
+    }
+    groups << "[Master]"
+           << "[Library]"
+           << "[Playlist]";
+    for (const auto& group : groups) {
+        for (int i = 0; i < 150; ++i) {
+            keys.emplace_back(group, QString("control_%1").arg(i));
+        }
+    }
+    return keys;
+}
+
+class ControlRegistryTest : public MixxxTest {
+};
+
+TEST_F(ControlRegistryTest, resolveAndExpire) {
+    const ConfigKey key("[ControlRegistryTest]", "control");
+    auto pControl = std::make_unique<ControlObject>(key);
+    ControlProxy proxy(key);
+    EXPECT_TRUE(proxy.valid());
+    EXPECT_EQ(pControl.get(), ControlObject::getControl(key));
+
+    pControl.reset();
+    EXPECT_EQ(nullptr, ControlObject::getControl(key, ControlFlag::NoAssertIfMissing));
+
+    // The key can be reused by a new control
+    pControl = std::make_unique<ControlObject>(key);
+    EXPECT_EQ(pControl.get(), ControlObject::getControl(key));
+}
+
+TEST_F(ControlRegistryTest, removeAliasesOfExpiredControl) {
+    const ConfigKey key("[ControlRegistryTest]", "control");
+    const ConfigKey alias("[ControlRegistryTest]", "alias");
+    auto pControl = std::make_unique<ControlObject>(key);
+    ControlDoublePrivate::insertAlias(alias, key);
+    EXPECT_EQ(pControl.get(), ControlObject::getControl(alias));
+    EXPECT_TRUE(ControlDoublePrivate::getControlAliases().contains(key));
+
+    pControl.reset();
+    EXPECT_EQ(nullptr, ControlObject::getControl(alias, ControlFlag::NoAssertIfMissing));
+    EXPECT_FALSE(ControlDoublePrivate::getControlAliases().contains(key));
+
+    // The alias can be reused as the key of a new control
+    pControl = std::make_unique<ControlObject>(alias);
+    EXPECT_EQ(pControl.get(), ControlObject::getControl(alias));
+}
+
+TEST_F(ControlRegistryTest, concurrentLookups) {
+    const auto keys = startupControlKeys();
+    std::vector<std::unique_ptr<ControlObject>> controls;
+    for (const auto& key : keys) {
+        controls.push_back(std::make_unique<ControlObject>(key));
+    }
+
+    // Readers resolve existing controls while a writer adds and removes
+    // other controls concurrently
+    std::atomic<bool> stop(false);
+    std::atomic<int> failures(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&keys, &stop, &failures] {
+            while (!stop.load()) {
+                for (const auto& key : keys) {
+                    if (!ControlDoublePrivate::getControl(key)) {
+                        failures.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 200; ++i) {
+        ControlObject temporary(ConfigKey("[ControlRegistryTest]", QString::number(i)));
+        EXPECT_NE(nullptr, ControlObject::getControl(temporary.getKey()));
+    }
+    stop.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(0, failures.load());
+}
+
+class ControlRegistryBenchmark {
+  public:
+    ControlRegistryBenchmark()
+            : m_keys(startupControlKeys()) {
+        for (const auto& key : m_keys) {
+            m_controls.push_back(std::make_unique<ControlObject>(key));
+        }
+    }
+
+    const std::vector<ConfigKey>& keys() const {
+        return m_keys;
+    }
+
+  private:
+    const std::vector<ConfigKey> m_keys;
+    std::vector<std::unique_ptr<ControlObject>> m_controls;
+};
+
+// Resolves the full set of startup controls, like a skin or a controller
+// mapping does when it is loaded
+static void BM_ResolveStartupControls(benchmark::State& state) {
+    static ControlRegistryBenchmark* s_pFixture = nullptr;
+    if (state.thread_index == 0) {
+        s_pFixture = new ControlRegistryBenchmark();
+    }
+    // The benchmark loop starts and ends synchronized among all threads,
+    // i.e. after the fixture has been created and before it is deleted
+    std::size_t numKeys = 0;
+    for (auto _ : state) {
+        const auto& keys = s_pFixture->keys();
+        for (const auto& key : keys) {
+            benchmark::DoNotOptimize(ControlDoublePrivate::getControl(key));
+        }
+        numKeys = keys.size();
+    }
+    state.SetItemsProcessed(state.iterations() * numKeys);
+    if (state.thread_index == 0) {
+        delete s_pFixture;
+        s_pFixture = nullptr;
+    }
+}
+BENCHMARK(BM_ResolveStartupControls)->ThreadRange(1, 8)->UseRealTime();
+
+// The costs for creating the controls at startup, i.e. the write path
+static void BM_CreateStartupControls(benchmark::State& state) {
+    const auto keys = startupControlKeys();
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<ControlObject>> controls;
+        controls.reserve(keys.size());
+        for (const auto& key : keys) {
+            controls.push_back(std::make_unique<ControlObject>(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_CreateStartupControls);
+
+} // namespace
@@ -526,3 +526,82 @@ TEST_F(EngineBufferTest, RatePermTest) {
     ControlObject::set(ConfigKey(m_sGroup1, "rate_perm_up_small"), 0);
     EXPECT_EQ(1.06, m_pChannel1->getEngineBuffer()->m_speed_old);
 }
+
+// Samplers construct their EngineBuffer in lightweight mode, i.e. without
+// keylock scalers and crossfade buffer until the first track is loaded.
+class LightweightSamplerTest : public BaseSignalPathTest {
+  protected:
+    LightweightSamplerTest()
+            : m_pSampler(std::make_unique<Sampler>(nullptr,
+                      m_pConfig,
+                      m_pEngineMaster,
+                      m_pEffectsManager,
+                      m_pVisualsManager,
+                      EngineChannel::CENTER,
+                      m_pEngineMaster->registerChannelGroup(m_sSamplerGroup))) {
+    }
+
+    EngineBuffer* getEngineBuffer() const {
+        return m_pSampler->getEngineDeck()->getEngineBuffer();
+    }
+
+    void loadSamplerTrack() {
+        const QString kTrackLocationTest = QDir::currentPath() + "/src/test/sine-30.wav";
+        m_pSampler->slotLoadTrack(Track::newTemporary(kTrackLocationTest), false);
+        ProcessBuffer();
+        while (!getEngineBuffer()->isTrackLoaded()) {
+            QTest::qSleep(1); // millis
+        }
+    }
+
+    bool masterBufferIsSilent() {
+        CSAMPLE absLeft = 0;
+        CSAMPLE absRight = 0;
+        SampleUtil::sumAbsPerChannel(&absLeft,
+                &absRight,
+                m_pEngineMaster->masterBuffer(),
+                kProcessBufferSize);
+        return absLeft == 0 && absRight == 0;
+    }
+
+    std::unique_ptr<Sampler> m_pSampler;
+};
+
+TEST_F(LightweightSamplerTest, ChangeParametersBeforeLoad) {
+    // Seeking and switching the scaler would crossfade, but there is
+    // no crossfade buffer yet
+    ControlObject::set(ConfigKey(m_sSamplerGroup, "keylock"), 1.0);
+    ControlObject::set(ConfigKey(m_sSamplerGroup, "playposition"), 0.5);
+    ControlObject::set(ConfigKey(m_sSamplerGroup, "play"), 1.0);
+    ProcessBuffer();
+    ProcessBuffer();
+    EXPECT_FALSE(getEngineBuffer()->isTrackLoaded());
+    EXPECT_TRUE(masterBufferIsSilent());
+}
+
+TEST_F(LightweightSamplerTest, StartReaderOnFirstLoad) {
+    const CachingReader* pReader = getEngineBuffer()->m_pReader;
+    EXPECT_FALSE(pReader->m_worker.isRunning());
+    loadSamplerTrack();
+    EXPECT_TRUE(pReader->m_worker.isRunning());
+}
+
+TEST_F(LightweightSamplerTest, LoadAndPlay) {
+    loadSamplerTrack();
+    ControlObject::set(ConfigKey(m_sSamplerGroup, "play"), 1.0);
+    ProcessBuffer();
+    const double playPos = getEngineBuffer()->getExactPlayPos();
+    for (int i = 0; i < 10; ++i) {
+        ProcessBuffer();
+    }
+    EXPECT_LT(playPos, getEngineBuffer()->getExactPlayPos());
+    EXPECT_FALSE(masterBufferIsSilent());
+
+    // Crossfades into the keylock scaler and to the new position
+    ControlObject::set(ConfigKey(m_sSamplerGroup, "keylock"), 1.0);
+    ProcessBuffer();
+    ControlObject::set(ConfigKey(m_sSamplerGroup, "playposition"), 0.5);
+    ProcessBuffer();
+    ProcessBuffer();
+    EXPECT_FALSE(masterBufferIsSilent());
+}
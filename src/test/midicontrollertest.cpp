@@ -523,3 +523,60 @@ TEST_F(MidiControllerTest, ReceiveMessage_PotMeterCO_14BitPitchBend) {
     receive(MIDI_PITCH_BEND | channel, 0x01, 0x40);
     EXPECT_LT(kMiddleValue, potmeter.get());
 }
+
+TEST_F(MidiControllerTest, ReceiveMessage_ControlCreatedAfterPresetLoaded) {
+    ConfigKey key("[Channel1]", "hotcue_1_activate");
+
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+
+    addMapping(MidiInputMapping(MidiKey(MIDI_NOTE_ON | channel, control),
+                                MidiOptions(), key));
+    loadPreset(m_preset);
+
+    {
+        // Created after the mappings have been compiled
+        ControlPushButton cpb(key);
+        receive(MIDI_NOTE_ON | channel, control, 0x7F);
+        EXPECT_DOUBLE_EQ(1.0, cpb.get());
+    }
+
+    // The mapping must not keep using the deleted control.
+    ControlPushButton cpb(key);
+    EXPECT_DOUBLE_EQ(0.0, cpb.get());
+    receive(MIDI_NOTE_ON | channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(1.0, cpb.get());
+}
+
+TEST_F(MidiControllerTest, ReceiveMessage_MultipleMappingsForMessage) {
+    ConfigKey key1("[Channel1]", "hotcue_1_activate");
+    ConfigKey key2("[Channel2]", "hotcue_1_activate");
+    ControlPushButton cpb1(key1);
+    ControlPushButton cpb2(key2);
+
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+
+    addMapping(MidiInputMapping(MidiKey(MIDI_NOTE_ON | channel, control),
+                                MidiOptions(), key1));
+    addMapping(MidiInputMapping(MidiKey(MIDI_NOTE_ON | channel, control),
+                                MidiOptions(), key2));
+    // Mapped to a different control byte of the same status
+    addMapping(MidiInputMapping(MidiKey(MIDI_NOTE_ON | channel, control + 1),
+                                MidiOptions(), key2));
+    loadPreset(m_preset);
+
+    receive(MIDI_NOTE_ON | channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(1.0, cpb1.get());
+    EXPECT_DOUBLE_EQ(1.0, cpb2.get());
+
+    receive(MIDI_NOTE_ON | channel, control, 0x00);
+    EXPECT_DOUBLE_EQ(0.0, cpb1.get());
+    EXPECT_DOUBLE_EQ(0.0, cpb2.get());
+
+    // Unmapped messages are ignored
+    receive(MIDI_NOTE_ON | channel, control + 2, 0x7F);
+    receive(MIDI_CC | channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(0.0, cpb1.get());
+    EXPECT_DOUBLE_EQ(0.0, cpb2.get());
+}
@@ -0,0 +1,122 @@
+#include "sources/mp3seekindexcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+class Mp3SeekIndexCacheTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        mixxx::Mp3SeekIndexCache::configure(m_tempDir.filePath("cache"));
+
+        // The contents of the file are only used for the digest
+        m_fileData = QByteArray(200 * 1024, 'x');
+        m_filePath = m_tempDir.filePath("test.mp3");
+        QFile file(m_filePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        ASSERT_EQ(m_fileData.size(), file.write(m_fileData));
+    }
+
+    void TearDown() override {
+        mixxx::Mp3SeekIndexCache::configure(QString());
+    }
+
+    const unsigned char* fileData() const {
+        return reinterpret_cast<const unsigned char*>(m_fileData.constData());
+    }
+
+    // The indices of short files are not cached
+    static mixxx::Mp3SeekIndex newSeekIndex(SINT mp3FrameCount = 12000) {
+        mixxx::Mp3SeekIndex seekIndex;
+        seekIndex.channelCount = mixxx::audio::ChannelCount(2);
+        seekIndex.sampleRate = mixxx::audio::SampleRate(44100);
+        seekIndex.bitrate = mixxx::audio::Bitrate(192);
+        // 1152 sample frames per MP3 frame
+        for (SINT i = 0; i < mp3FrameCount; ++i) {
+            seekIndex.frames.push_back({i * 1152, 1024 + static_cast<quint64>(i) * 16});
+        }
+        seekIndex.frameLength = mp3FrameCount * 1152;
+        return seekIndex;
+    }
+
+    QString cacheFilePath() const {
+        const QFileInfoList files = QDir(m_tempDir.filePath("cache")).entryInfoList(QDir::Files);
+        return files.size() == 1 ? files.front().absoluteFilePath() : QString();
+    }
+
+    QTemporaryDir m_tempDir;
+    QByteArray m_fileData;
+    QString m_filePath;
+};
+
+TEST_F(Mp3SeekIndexCacheTest, saveAndLoad) {
+    const QFileInfo fileInfo(m_filePath);
+    const auto seekIndex = newSeekIndex();
+    mixxx::Mp3SeekIndex loaded;
+    EXPECT_FALSE(mixxx::Mp3SeekIndexCache::load(
+            fileInfo, fileData(), m_fileData.size(), &loaded));
+
+    ASSERT_TRUE(mixxx::Mp3SeekIndexCache::save(
+            fileInfo, fileData(), m_fileData.size(), seekIndex));
+    ASSERT_TRUE(mixxx::Mp3SeekIndexCache::load(
+            fileInfo, fileData(), m_fileData.size(), &loaded));
+    EXPECT_EQ(seekIndex.channelCount, loaded.channelCount);
+    EXPECT_EQ(seekIndex.sampleRate, loaded.sampleRate);
+    EXPECT_EQ(seekIndex.bitrate, loaded.bitrate);
+    EXPECT_EQ(seekIndex.frameLength, loaded.frameLength);
+    ASSERT_EQ(seekIndex.frames.size(), loaded.frames.size());
+    for (std::size_t i = 0; i < seekIndex.frames.size(); ++i) {
+        EXPECT_EQ(seekIndex.frames[i].frameIndex, loaded.frames[i].frameIndex);
+        EXPECT_EQ(seekIndex.frames[i].byteOffset, loaded.frames[i].byteOffset);
+    }
+}
+
+TEST_F(Mp3SeekIndexCacheTest, modifiedFile) {
+    const QFileInfo fileInfo(m_filePath);
+    ASSERT_TRUE(mixxx::Mp3SeekIndexCache::save(
+            fileInfo, fileData(), m_fileData.size(), newSeekIndex()));
+
+    mixxx::Mp3SeekIndex loaded;
+    // Different size
+    EXPECT_FALSE(mixxx::Mp3SeekIndexCache::load(
+            fileInfo, fileData(), m_fileData.size() - 1, &loaded));
+    // Same size, but modified tag at the end of the file
+    m_fileData[m_fileData.size() - 1] = 'y';
+    EXPECT_FALSE(mixxx::Mp3SeekIndexCache::load(
+            fileInfo, fileData(), m_fileData.size(), &loaded));
+}
+
+TEST_F(Mp3SeekIndexCacheTest, shortFile) {
+    const QFileInfo fileInfo(m_filePath);
+    EXPECT_FALSE(mixxx::Mp3SeekIndexCache::save(
+            fileInfo, fileData(), m_fileData.size(), newSeekIndex(1000)));
+    EXPECT_TRUE(cacheFilePath().isEmpty());
+}
+
+TEST_F(Mp3SeekIndexCacheTest, evictLeastRecentlyUsed) {
+    const QFileInfo fileInfo(m_filePath);
+    ASSERT_TRUE(mixxx::Mp3SeekIndexCache::save(
+            fileInfo, fileData(), m_fileData.size(), newSeekIndex()));
+    const QString filePath = cacheFilePath();
+    ASSERT_FALSE(filePath.isEmpty());
+
+    // Files that exceed the quota are deleted
+    mixxx::Mp3SeekIndexCache::configure(m_tempDir.filePath("cache"),
+            QFileInfo(filePath).size() - 1);
+    mixxx::Mp3SeekIndexCache::evictLeastRecentlyUsed();
+    EXPECT_FALSE(QFile::exists(filePath));
+}
+
+TEST_F(Mp3SeekIndexCacheTest, disabled) {
+    mixxx::Mp3SeekIndexCache::configure(QString());
+    const QFileInfo fileInfo(m_filePath);
+    EXPECT_FALSE(mixxx::Mp3SeekIndexCache::save(
+            fileInfo, fileData(), m_fileData.size(), newSeekIndex()));
+}
+
+} // namespace
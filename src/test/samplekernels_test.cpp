@@ -0,0 +1,317 @@
+#include "util/samplekernels.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QtDebug>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// Odd sizes and sizes that are not a multiple of the vector width
+// exercise the scalar tails of the vectorized kernels.
+const std::vector<SINT> kSizes = {0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 33, 1024, 1027};
+
+// Allows for different rounding caused by fused multiply-add
+// instructions and a different order of summation.
+constexpr CSAMPLE kTolerance = 1e-5f;
+
+class SampleUtilKernelsTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        m_src1 = randomBuffer(kMaxSize * 2, 1.2f);
+        m_src2 = randomBuffer(kMaxSize * 2, 1.0f);
+    }
+
+    static std::vector<CSAMPLE> randomBuffer(SINT size, CSAMPLE peak) {
+        std::vector<CSAMPLE> buffer(size);
+        for (auto& sample : buffer) {
+            sample = (static_cast<CSAMPLE>(std::rand()) / RAND_MAX) * 2 * peak - peak;
+        }
+        return buffer;
+    }
+
+    static void expectEqualBuffers(const std::vector<CSAMPLE>& expected,
+            const std::vector<CSAMPLE>& actual,
+            const char* kernelName,
+            SINT size) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_NEAR(expected[i], actual[i], kTolerance)
+                    << kernelName << ", size " << size << ", index " << i;
+        }
+    }
+
+    template<typename F>
+    void compareRampingGain(F kernel) {
+        const auto& scalar = SampleUtilKernels::scalar();
+        for (const auto* pKernels : SampleUtilKernels::available()) {
+            for (const SINT size : kSizes) {
+                // Ramping and constant gain
+                for (const auto newGain : {0.8f, 0.3f}) {
+                    // The samples after the end must remain untouched
+                    std::vector<CSAMPLE> expected(m_src2.begin(), m_src2.begin() + size + 4);
+                    std::vector<CSAMPLE> actual = expected;
+                    kernel(scalar, expected.data(), m_src1.data(), 0.3f, newGain, size);
+                    kernel(*pKernels, actual.data(), m_src1.data(), 0.3f, newGain, size);
+                    expectEqualBuffers(expected, actual, pKernels->name, size);
+                }
+            }
+        }
+    }
+
+    static constexpr SINT kMaxSize = 1027;
+
+    std::vector<CSAMPLE> m_src1;
+    std::vector<CSAMPLE> m_src2;
+};
+
+TEST_F(SampleUtilKernelsTest, ScalarIsAvailable) {
+    const auto kernels = SampleUtilKernels::available();
+    ASSERT_FALSE(kernels.empty());
+    EXPECT_EQ(&SampleUtilKernels::scalar(), kernels.front());
+    qInfo() << "Active SampleUtil kernels:" << SampleUtilKernels::active().name;
+}
+
+TEST_F(SampleUtilKernelsTest, applyRampingGain) {
+    compareRampingGain([](const SampleUtilKernels& kernels,
+                               CSAMPLE* pDest,
+                               const CSAMPLE*,
+                               CSAMPLE_GAIN oldGain,
+                               CSAMPLE_GAIN newGain,
+                               SINT size) {
+        kernels.applyRampingGain(pDest, oldGain, newGain, size);
+    });
+}
+
+TEST_F(SampleUtilKernelsTest, addWithRampingGain) {
+    compareRampingGain([](const SampleUtilKernels& kernels,
+                               CSAMPLE* pDest,
+                               const CSAMPLE* pSrc,
+                               CSAMPLE_GAIN oldGain,
+                               CSAMPLE_GAIN newGain,
+                               SINT size) {
+        kernels.addWithRampingGain(pDest, pSrc, oldGain, newGain, size);
+    });
+}
+
+TEST_F(SampleUtilKernelsTest, copyWithRampingGain) {
+    compareRampingGain([](const SampleUtilKernels& kernels,
+                               CSAMPLE* pDest,
+                               const CSAMPLE* pSrc,
+                               CSAMPLE_GAIN oldGain,
+                               CSAMPLE_GAIN newGain,
+                               SINT size) {
+        kernels.copyWithRampingGain(pDest, pSrc, oldGain, newGain, size);
+    });
+}
+
+TEST_F(SampleUtilKernelsTest, sumAbsPerChannel) {
+    const auto& scalar = SampleUtilKernels::scalar();
+    for (const auto* pKernels : SampleUtilKernels::available()) {
+        for (const SINT size : kSizes) {
+            for (const auto* pBuffer : {m_src1.data(), m_src2.data()}) {
+                CSAMPLE expectedL, expectedR;
+                const auto expectedClipping = scalar.sumAbsPerChannel(
+                        &expectedL, &expectedR, pBuffer, size);
+                CSAMPLE actualL, actualR;
+                const auto actualClipping = pKernels->sumAbsPerChannel(
+                        &actualL, &actualR, pBuffer, size);
+                EXPECT_EQ(expectedClipping, actualClipping)
+                        << pKernels->name << ", size " << size;
+                // Relative tolerance for the sums
+                EXPECT_NEAR(expectedL, actualL, kTolerance * (1 + size))
+                        << pKernels->name << ", size " << size;
+                EXPECT_NEAR(expectedR, actualR, kTolerance * (1 + size))
+                        << pKernels->name << ", size " << size;
+            }
+        }
+    }
+}
+
+TEST_F(SampleUtilKernelsTest, copyClampBuffer) {
+    const auto& scalar = SampleUtilKernels::scalar();
+    for (const auto* pKernels : SampleUtilKernels::available()) {
+        for (const SINT size : kSizes) {
+            std::vector<CSAMPLE> expected(size);
+            std::vector<CSAMPLE> actual(size);
+            scalar.copyClampBuffer(expected.data(), m_src1.data(), size);
+            pKernels->copyClampBuffer(actual.data(), m_src1.data(), size);
+            expectEqualBuffers(expected, actual, pKernels->name, size);
+        }
+    }
+}
+
+TEST_F(SampleUtilKernelsTest, convertFloat32ToS16) {
+    const auto& scalar = SampleUtilKernels::scalar();
+    for (const auto* pKernels : SampleUtilKernels::available()) {
+        for (const SINT size : kSizes) {
+            // Only in range samples, the scalar kernel doesn't saturate
+            std::vector<SAMPLE> expected(size);
+            std::vector<SAMPLE> actual(size);
+            scalar.convertFloat32ToS16(expected.data(), m_src2.data(), size);
+            pKernels->convertFloat32ToS16(actual.data(), m_src2.data(), size);
+            EXPECT_EQ(expected, actual) << pKernels->name << ", size " << size;
+        }
+    }
+}
+
+TEST_F(SampleUtilKernelsTest, convertFloat32ToS16Saturates) {
+    const std::vector<CSAMPLE> input = {
+            1.0f, -1.0f, 2.0f, -2.0f, 1e10f, -1e10f, 0.5f, -0.5f, 1.0f};
+    const std::vector<SAMPLE> expected = {
+            SAMPLE_MAX, SAMPLE_MIN, SAMPLE_MAX, SAMPLE_MIN, SAMPLE_MAX, SAMPLE_MIN, 16384, -16384, SAMPLE_MAX};
+    for (const auto* pKernels : SampleUtilKernels::available()) {
+        if (pKernels == &SampleUtilKernels::scalar()) {
+            continue;
+        }
+        std::vector<SAMPLE> actual(input.size());
+        pKernels->convertFloat32ToS16(actual.data(), input.data(), input.size());
+        EXPECT_EQ(expected, actual) << pKernels->name;
+    }
+}
+
+TEST_F(SampleUtilKernelsTest, interleaveBuffer) {
+    const auto& scalar = SampleUtilKernels::scalar();
+    for (const auto* pKernels : SampleUtilKernels::available()) {
+        for (const SINT size : kSizes) {
+            std::vector<CSAMPLE> expected(size * 2);
+            std::vector<CSAMPLE> actual(size * 2);
+            scalar.interleaveBuffer(expected.data(), m_src1.data(), m_src2.data(), size);
+            pKernels->interleaveBuffer(actual.data(), m_src1.data(), m_src2.data(), size);
+            expectEqualBuffers(expected, actual, pKernels->name, size);
+        }
+    }
+}
+
+// Benchmarks comparing each variant against the scalar reference.
+// Variants that are not supported by the CPU are skipped.
+
+typedef const SampleUtilKernels* (*KernelsGetter)();
+
+const SampleUtilKernels* scalarKernels() {
+    return &SampleUtilKernels::scalar();
+}
+
+const SampleUtilKernels* getKernelsOrSkip(
+        benchmark::State& state, KernelsGetter getKernels) {
+    const auto* pKernels = getKernels();
+    if (!pKernels) {
+        state.SkipWithError("Not supported on this CPU");
+    }
+    return pKernels;
+}
+
+#define BENCHMARK_SAMPLEUTIL_KERNELS(func)                                \
+    BENCHMARK_CAPTURE(func, scalar, scalarKernels)->Range(64, 4096);      \
+    BENCHMARK_CAPTURE(func, sse2, SampleUtilKernels::sse2)->Range(64, 4096); \
+    BENCHMARK_CAPTURE(func, avx2, SampleUtilKernels::avx2)->Range(64, 4096); \
+    BENCHMARK_CAPTURE(func, neon, SampleUtilKernels::neon)->Range(64, 4096)
+
+static void BM_KernelApplyRampingGain(benchmark::State& state, KernelsGetter getKernels) {
+    const auto* pKernels = getKernelsOrSkip(state, getKernels);
+    if (!pKernels) {
+        return;
+    }
+    const SINT size = static_cast<SINT>(state.range(0));
+    std::vector<CSAMPLE> buffer(size, 0.5f);
+    for (auto _ : state) {
+        pKernels->applyRampingGain(buffer.data(), 1.0f, 0.999f, size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_SAMPLEUTIL_KERNELS(BM_KernelApplyRampingGain);
+
+static void BM_KernelAddWithRampingGain(benchmark::State& state, KernelsGetter getKernels) {
+    const auto* pKernels = getKernelsOrSkip(state, getKernels);
+    if (!pKernels) {
+        return;
+    }
+    const SINT size = static_cast<SINT>(state.range(0));
+    std::vector<CSAMPLE> dest(size, 0.0f);
+    std::vector<CSAMPLE> src(size, 0.5f);
+    for (auto _ : state) {
+        pKernels->addWithRampingGain(dest.data(), src.data(), 0.0f, 0.001f, size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_SAMPLEUTIL_KERNELS(BM_KernelAddWithRampingGain);
+
+static void BM_KernelCopyWithRampingGain(benchmark::State& state, KernelsGetter getKernels) {
+    const auto* pKernels = getKernelsOrSkip(state, getKernels);
+    if (!pKernels) {
+        return;
+    }
+    const SINT size = static_cast<SINT>(state.range(0));
+    std::vector<CSAMPLE> dest(size, 0.0f);
+    std::vector<CSAMPLE> src(size, 0.5f);
+    for (auto _ : state) {
+        pKernels->copyWithRampingGain(dest.data(), src.data(), 0.2f, 0.8f, size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_SAMPLEUTIL_KERNELS(BM_KernelCopyWithRampingGain);
+
+static void BM_KernelSumAbsPerChannel(benchmark::State& state, KernelsGetter getKernels) {
+    const auto* pKernels = getKernelsOrSkip(state, getKernels);
+    if (!pKernels) {
+        return;
+    }
+    const SINT size = static_cast<SINT>(state.range(0));
+    std::vector<CSAMPLE> buffer(size, -0.5f);
+    CSAMPLE sumL, sumR;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pKernels->sumAbsPerChannel(
+                &sumL, &sumR, buffer.data(), size));
+    }
+}
+BENCHMARK_SAMPLEUTIL_KERNELS(BM_KernelSumAbsPerChannel);
+
+static void BM_KernelCopyClampBuffer(benchmark::State& state, KernelsGetter getKernels) {
+    const auto* pKernels = getKernelsOrSkip(state, getKernels);
+    if (!pKernels) {
+        return;
+    }
+    const SINT size = static_cast<SINT>(state.range(0));
+    std::vector<CSAMPLE> dest(size, 0.0f);
+    std::vector<CSAMPLE> src(size, 1.5f);
+    for (auto _ : state) {
+        pKernels->copyClampBuffer(dest.data(), src.data(), size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_SAMPLEUTIL_KERNELS(BM_KernelCopyClampBuffer);
+
+static void BM_KernelConvertFloat32ToS16(benchmark::State& state, KernelsGetter getKernels) {
+    const auto* pKernels = getKernelsOrSkip(state, getKernels);
+    if (!pKernels) {
+        return;
+    }
+    const SINT size = static_cast<SINT>(state.range(0));
+    std::vector<SAMPLE> dest(size, 0);
+    std::vector<CSAMPLE> src(size, 0.5f);
+    for (auto _ : state) {
+        pKernels->convertFloat32ToS16(dest.data(), src.data(), size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_SAMPLEUTIL_KERNELS(BM_KernelConvertFloat32ToS16);
+
+static void BM_KernelInterleaveBuffer(benchmark::State& state, KernelsGetter getKernels) {
+    const auto* pKernels = getKernelsOrSkip(state, getKernels);
+    if (!pKernels) {
+        return;
+    }
+    const SINT size = static_cast<SINT>(state.range(0));
+    std::vector<CSAMPLE> dest(size * 2, 0.0f);
+    std::vector<CSAMPLE> src1(size, 0.5f);
+    std::vector<CSAMPLE> src2(size, -0.5f);
+    for (auto _ : state) {
+        pKernels->interleaveBuffer(dest.data(), src1.data(), src2.data(), size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_SAMPLEUTIL_KERNELS(BM_KernelInterleaveBuffer);
+
+} // namespace
@@ -0,0 +1,259 @@
+#include "engine/sidechain/sharedbroadcastencoder.h"
+
+#include <gtest/gtest.h>
+
+#include <QVector>
+
+#include "recording/defs_recording.h"
+
+namespace {
+
+class Mp3Settings : public EncoderSettings {
+  public:
+    explicit Mp3Settings(int bitrate)
+            : m_bitrate(bitrate) {
+    }
+
+    int getQuality() const override {
+        return m_bitrate;
+    }
+    QString getFormat() const override {
+        return ENCODING_MP3;
+    }
+
+  private:
+    const int m_bitrate;
+};
+
+// Emits one packet per encoded buffer that contains the samples
+class FakeEncoder : public Encoder {
+  public:
+    FakeEncoder(EncoderCallback* pCallback, int* pEncodeCount)
+            : m_pCallback(pCallback),
+              m_pEncodeCount(pEncodeCount) {
+    }
+
+    int initEncoder(int samplerate, QString& errorMessage) override {
+        Q_UNUSED(samplerate);
+        Q_UNUSED(errorMessage);
+        return 0;
+    }
+    void encodeBuffer(const CSAMPLE* samples, const int size) override {
+        ++*m_pEncodeCount;
+        m_pCallback->write(nullptr,
+                reinterpret_cast<const unsigned char*>(samples),
+                0,
+                size * static_cast<int>(sizeof(CSAMPLE)));
+    }
+    void updateMetaData(const QString&, const QString&, const QString&) override {
+    }
+    void flush() override {
+    }
+    void setEncoderSettings(const EncoderSettings&) override {
+    }
+
+  private:
+    EncoderCallback* const m_pCallback;
+    int* const m_pEncodeCount;
+};
+
+// Stands in for an Icecast server that receives the encoded stream
+class FakeServer : public EncoderCallback {
+  public:
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override {
+        received.append(reinterpret_cast<const char*>(header), headerLen);
+        received.append(reinterpret_cast<const char*>(body), bodyLen);
+    }
+    int tell() override {
+        return -1;
+    }
+    void seek(int) override {
+    }
+    int filelen() override {
+        return 0;
+    }
+
+    QByteArray received;
+};
+
+class SharedBroadcastEncoderTest : public testing::Test {
+  protected:
+    SharedBroadcastEncoderTest()
+            : m_encodeCount(0),
+              m_registry([this](EncoderSettingsPointer, EncoderCallback* pCallback) {
+                  return std::make_shared<FakeEncoder>(pCallback, &m_encodeCount);
+              }) {
+    }
+
+    SharedBroadcastEncoderPtr attach(int bitrate, FakeServer* pServer) {
+        QString errorMessage;
+        auto pEncoder = m_registry.attach(
+                std::make_shared<Mp3Settings>(bitrate), 44100, pServer, &errorMessage);
+        EXPECT_FALSE(pEncoder.isNull());
+        pEncoder->setStreaming(pServer, true);
+        return pEncoder;
+    }
+
+    // The registry receives the master mix once and each connection
+    // writes its pending packets afterwards
+    void processAll(const QVector<std::pair<SharedBroadcastEncoderPtr, FakeServer*>>& connections,
+            const CSAMPLE* pBuffer,
+            int size) {
+        m_registry.process(pBuffer, size);
+        for (const auto& connection : connections) {
+            connection.first->writePendingPackets(connection.second);
+        }
+    }
+
+    int m_encodeCount;
+    SharedBroadcastEncoderRegistry m_registry;
+};
+
+TEST_F(SharedBroadcastEncoderTest, encodeOnceForIdenticalSettings) {
+    FakeServer server1;
+    FakeServer server2;
+    FakeServer server3;
+    auto pEncoder1 = attach(128, &server1);
+    auto pEncoder2 = attach(128, &server2);
+    auto pEncoder3 = attach(192, &server3);
+    EXPECT_EQ(pEncoder1, pEncoder2);
+    EXPECT_NE(pEncoder1, pEncoder3);
+    EXPECT_EQ(2, pEncoder1->subscriberCount());
+
+    const CSAMPLE samples[] = {0.1f, 0.2f, 0.3f, 0.4f};
+    processAll({{pEncoder1, &server1}, {pEncoder2, &server2}, {pEncoder3, &server3}},
+            samples,
+            4);
+    // Once for each distinct setting
+    EXPECT_EQ(2, m_encodeCount);
+    const QByteArray expected(reinterpret_cast<const char*>(samples), sizeof(samples));
+    EXPECT_EQ(expected, server1.received);
+    EXPECT_EQ(expected, server2.received);
+    EXPECT_EQ(expected, server3.received);
+
+    pEncoder1->detach(&server1);
+    pEncoder3->detach(&server3);
+    pEncoder2->detach(&server2);
+}
+
+TEST_F(SharedBroadcastEncoderTest, encodingMovesOnWhenDetached) {
+    FakeServer server1;
+    FakeServer server2;
+    auto pEncoder1 = attach(128, &server1);
+    auto pEncoder2 = attach(128, &server2);
+
+    const CSAMPLE samples[] = {0.1f, 0.2f};
+    pEncoder1->detach(&server1);
+    pEncoder1.clear();
+    processAll({{pEncoder2, &server2}}, samples, 2);
+    EXPECT_EQ(1, m_encodeCount);
+    EXPECT_EQ(QByteArray(reinterpret_cast<const char*>(samples), sizeof(samples)),
+            server2.received);
+    pEncoder2->detach(&server2);
+}
+
+TEST_F(SharedBroadcastEncoderTest, stalledSubscriberDoesNotBlockOthers) {
+    FakeServer server1;
+    FakeServer server2;
+    auto pEncoder1 = attach(128, &server1);
+    auto pEncoder2 = attach(128, &server2);
+
+    // The first connection doesn't write its packets, e.g. because its
+    // server doesn't respond
+    const CSAMPLE samples1[] = {0.1f, 0.2f};
+    const CSAMPLE samples2[] = {0.3f, 0.4f};
+    m_registry.process(samples1, 2);
+    m_registry.process(samples2, 2);
+    pEncoder2->writePendingPackets(&server2);
+    EXPECT_EQ(2, m_encodeCount);
+    EXPECT_TRUE(server1.received.isEmpty());
+    QByteArray expected(reinterpret_cast<const char*>(samples1), sizeof(samples1));
+    expected.append(reinterpret_cast<const char*>(samples2), sizeof(samples2));
+    EXPECT_EQ(expected, server2.received);
+
+    // No packets are lost when it recovers
+    pEncoder1->writePendingPackets(&server1);
+    EXPECT_EQ(expected, server1.received);
+
+    pEncoder1->detach(&server1);
+    pEncoder2->detach(&server2);
+}
+
+TEST_F(SharedBroadcastEncoderTest, continuousStreamWhenFirstSubscriberDetaches) {
+    FakeServer server1;
+    FakeServer server2;
+    auto pEncoder1 = attach(128, &server1);
+    auto pEncoder2 = attach(128, &server2);
+
+    const CSAMPLE samples1[] = {0.1f, 0.2f};
+    const CSAMPLE samples2[] = {0.3f, 0.4f};
+    processAll({{pEncoder1, &server1}, {pEncoder2, &server2}}, samples1, 2);
+    pEncoder1->detach(&server1);
+    pEncoder1.clear();
+    processAll({{pEncoder2, &server2}}, samples2, 2);
+
+    EXPECT_EQ(2, m_encodeCount);
+    QByteArray expected(reinterpret_cast<const char*>(samples1), sizeof(samples1));
+    expected.append(reinterpret_cast<const char*>(samples2), sizeof(samples2));
+    EXPECT_EQ(expected, server2.received);
+    pEncoder2->detach(&server2);
+}
+
+TEST_F(SharedBroadcastEncoderTest, onlyStreamingSubscribersReceivePackets) {
+    FakeServer server1;
+    FakeServer server2;
+    auto pEncoder1 = attach(128, &server1);
+    // Still connecting
+    QString errorMessage;
+    auto pEncoder2 = m_registry.attach(
+            std::make_shared<Mp3Settings>(128), 44100, &server2, &errorMessage);
+
+    const CSAMPLE samples[] = {0.1f, 0.2f};
+    processAll({{pEncoder1, &server1}, {pEncoder2, &server2}}, samples, 2);
+    EXPECT_EQ(1, m_encodeCount);
+    EXPECT_FALSE(server1.received.isEmpty());
+    EXPECT_TRUE(server2.received.isEmpty());
+
+    pEncoder1->detach(&server1);
+    pEncoder2->detach(&server2);
+}
+
+TEST_F(SharedBroadcastEncoderTest, countStreamingSubscribers) {
+    FakeServer server1;
+    FakeServer server2;
+    // Not streaming while still connecting
+    QString errorMessage;
+    auto pEncoder1 = m_registry.attach(
+            std::make_shared<Mp3Settings>(128), 44100, &server1, &errorMessage);
+    EXPECT_EQ(0, m_registry.streamingSubscriberCount());
+    EXPECT_FALSE(m_registry.threadWaiting());
+
+    pEncoder1->setStreaming(&server1, true);
+    pEncoder1->setStreaming(&server1, true);
+    auto pEncoder2 = attach(192, &server2);
+    EXPECT_EQ(2, m_registry.streamingSubscriberCount());
+
+    pEncoder1->setStreaming(&server1, false);
+    EXPECT_EQ(1, m_registry.streamingSubscriberCount());
+    pEncoder2->detach(&server2);
+    EXPECT_EQ(0, m_registry.streamingSubscriberCount());
+    pEncoder1->detach(&server1);
+}
+
+TEST_F(SharedBroadcastEncoderTest, recreatedAfterLastSubscriberDetached) {
+    FakeServer server;
+    auto pEncoder = attach(128, &server);
+    const QString key = pEncoder->settingsKey();
+    pEncoder->detach(&server);
+    pEncoder.clear();
+
+    pEncoder = attach(128, &server);
+    EXPECT_EQ(key, pEncoder->settingsKey());
+    EXPECT_EQ(1, pEncoder->subscriberCount());
+    pEncoder->detach(&server);
+}
+
+} // namespace
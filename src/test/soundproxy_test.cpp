@@ -231,6 +231,31 @@ TEST_F(SoundSourceProxyTest, TOAL_TPE2) {
     EXPECT_TRUE(trackMetadata.getTrackInfo().getComment().isNull());
 }
 
+TEST_F(SoundSourceProxyTest, updateTrackFromPreparsedMetadata) {
+    const TrackFile trackFile(kTestDir, "cover-test-png.mp3");
+    const auto preparsedMetadata = SoundSourceProxy::preparseMetadata(trackFile);
+    EXPECT_EQ(mixxx::MetadataSource::ImportResult::Succeeded,
+            preparsedMetadata.importResult);
+    EXPECT_FALSE(preparsedMetadata.coverImage.isNull());
+
+    // Populating a new track from the preparsed metadata must
+    // yield the same result as parsing the file
+    auto pParsedTrack = Track::newTemporary(trackFile);
+    SoundSourceProxy(pParsedTrack).updateTrackFromSource();
+    auto pPreparsedTrack = Track::newTemporary(trackFile);
+    SoundSourceProxy(pPreparsedTrack).updateTrackFromSource(
+            SoundSourceProxy::ImportTrackMetadataMode::Default,
+            &preparsedMetadata);
+
+    mixxx::TrackMetadata parsedTrackMetadata;
+    pParsedTrack->readTrackMetadata(&parsedTrackMetadata);
+    mixxx::TrackMetadata preparsedTrackMetadata;
+    pPreparsedTrack->readTrackMetadata(&preparsedTrackMetadata);
+    EXPECT_EQ(parsedTrackMetadata, preparsedTrackMetadata);
+    EXPECT_EQ(pParsedTrack->getCoverInfo(), pPreparsedTrack->getCoverInfo());
+    EXPECT_TRUE(pPreparsedTrack->isMetadataSynchronized());
+}
+
 TEST_F(SoundSourceProxyTest, seekForwardBackward) {
     const SINT kReadFrameCount = 10000;
 
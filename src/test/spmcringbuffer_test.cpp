@@ -0,0 +1,87 @@
+#include "util/spmcringbuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+std::vector<int> readAll(SpmcRingBuffer<int>* pBuffer, int reader) {
+    std::vector<int> values;
+    const int* dataPtr1;
+    int size1;
+    const int* dataPtr2;
+    int size2;
+    const int count = pBuffer->acquireReadRegions(reader,
+            pBuffer->readAvailable(reader),
+            &dataPtr1,
+            &size1,
+            &dataPtr2,
+            &size2);
+    values.insert(values.end(), dataPtr1, dataPtr1 + size1);
+    values.insert(values.end(), dataPtr2, dataPtr2 + size2);
+    pBuffer->releaseReadRegions(reader, count);
+    return values;
+}
+
+TEST(SpmcRingBufferTest, independentReaders) {
+    SpmcRingBuffer<int> buffer(8);
+    const int reader1 = buffer.attachReader();
+    const int reader2 = buffer.attachReader();
+    ASSERT_LE(0, reader1);
+    ASSERT_LE(0, reader2);
+
+    const int values[] = {1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(4, buffer.write(values, 4));
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4}), readAll(&buffer, reader1));
+    // Reader 2 still holds the data
+    EXPECT_EQ(4, buffer.writeAvailable());
+
+    // Wraps around the end of the buffer
+    EXPECT_EQ(2, buffer.write(values + 4, 2));
+    EXPECT_EQ(std::vector<int>({5, 6}), readAll(&buffer, reader1));
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4, 5, 6}), readAll(&buffer, reader2));
+    EXPECT_EQ(8, buffer.writeAvailable());
+
+    EXPECT_EQ(6, buffer.write(values, 6));
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4, 5, 6}), readAll(&buffer, reader1));
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4, 5, 6}), readAll(&buffer, reader2));
+}
+
+TEST(SpmcRingBufferTest, laggingReader) {
+    SpmcRingBuffer<int> buffer(8);
+    const int fastReader = buffer.attachReader();
+    const int slowReader = buffer.attachReader();
+
+    const int values[] = {1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(6, buffer.write(values, 6));
+    readAll(&buffer, fastReader);
+    // Only 2 more values fit until the slow reader catches up
+    EXPECT_EQ(2, buffer.write(values, 6));
+    EXPECT_EQ(0, buffer.takeOverflowCount(fastReader));
+    EXPECT_EQ(4, buffer.takeOverflowCount(slowReader));
+    EXPECT_EQ(0, buffer.takeOverflowCount(slowReader));
+
+    // The data that has been written is not lost
+    EXPECT_EQ(std::vector<int>({1, 2}), readAll(&buffer, fastReader));
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4, 5, 6, 1, 2}), readAll(&buffer, slowReader));
+}
+
+TEST(SpmcRingBufferTest, attachAndDetach) {
+    SpmcRingBuffer<int> buffer(8);
+    const int values[] = {1, 2, 3, 4};
+    // Without readers nothing blocks the writer
+    EXPECT_EQ(4, buffer.write(values, 4));
+    EXPECT_EQ(8, buffer.writeAvailable());
+
+    // New readers start at the current write position
+    const int reader = buffer.attachReader();
+    EXPECT_EQ(0, buffer.readAvailable(reader));
+    EXPECT_EQ(4, buffer.write(values, 4));
+    EXPECT_EQ(4, buffer.writeAvailable());
+
+    buffer.detachReader(reader);
+    EXPECT_EQ(8, buffer.writeAvailable());
+}
+
+} // namespace
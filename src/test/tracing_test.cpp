@@ -0,0 +1,104 @@
+#include "util/tracing.h"
+
+#include <gtest/gtest.h>
+
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <thread>
+
+namespace {
+
+class TracingTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        mixxx::Tracing::clear();
+        mixxx::Tracing::setEnabled(true);
+    }
+
+    void TearDown() override {
+        mixxx::Tracing::setEnabled(false);
+        mixxx::Tracing::clear();
+    }
+
+    // Returns all events except the thread names
+    QJsonArray writeEvents() {
+        QBuffer buffer;
+        EXPECT_TRUE(buffer.open(QIODevice::WriteOnly));
+        EXPECT_TRUE(mixxx::Tracing::writeChromeTrace(&buffer));
+        const QJsonDocument trace = QJsonDocument::fromJson(buffer.data());
+        EXPECT_TRUE(trace.isObject());
+        QJsonArray events;
+        for (const auto& event : trace.object().value("traceEvents").toArray()) {
+            if (event.toObject().value("ph").toString() != "M") {
+                events.append(event);
+            }
+        }
+        return events;
+    }
+};
+
+TEST_F(TracingTest, scopedTrace) {
+    {
+        mixxx::ScopedTrace trace("scope", 42);
+    }
+    mixxx::Tracing::instant("instant");
+    mixxx::Tracing::counter("counter", 7);
+
+    const QJsonArray events = writeEvents();
+    ASSERT_EQ(3, events.size());
+
+    const QJsonObject scope = events[0].toObject();
+    EXPECT_EQ("scope", scope.value("name").toString());
+    EXPECT_EQ("X", scope.value("ph").toString());
+    EXPECT_TRUE(scope.contains("ts"));
+    EXPECT_LE(0.0, scope.value("dur").toDouble(-1.0));
+    EXPECT_EQ(42, scope.value("args").toObject().value("arg").toInt());
+
+    const QJsonObject instant = events[1].toObject();
+    EXPECT_EQ("instant", instant.value("name").toString());
+    EXPECT_EQ("i", instant.value("ph").toString());
+    EXPECT_FALSE(instant.contains("args"));
+
+    const QJsonObject counter = events[2].toObject();
+    EXPECT_EQ("counter", counter.value("name").toString());
+    EXPECT_EQ("C", counter.value("ph").toString());
+    EXPECT_EQ(7, counter.value("args").toObject().value("value").toInt());
+}
+
+TEST_F(TracingTest, disabled) {
+    mixxx::Tracing::setEnabled(false);
+    {
+        mixxx::ScopedTrace trace("scope");
+    }
+    mixxx::Tracing::instant("instant");
+    EXPECT_TRUE(writeEvents().isEmpty());
+}
+
+TEST_F(TracingTest, keepMostRecentEvents) {
+    const int count = mixxx::Tracing::kEventsPerThread + 100;
+    for (int i = 0; i < count; ++i) {
+        mixxx::Tracing::instant("instant", i);
+    }
+
+    const QJsonArray events = writeEvents();
+    ASSERT_EQ(mixxx::Tracing::kEventsPerThread, events.size());
+    EXPECT_EQ(100, events.first().toObject().value("args").toObject().value("arg").toInt());
+    EXPECT_EQ(count - 1, events.last().toObject().value("args").toObject().value("arg").toInt());
+}
+
+TEST_F(TracingTest, separateThreads) {
+    mixxx::Tracing::instant("main");
+    std::thread thread([] {
+        mixxx::Tracing::instant("worker");
+    });
+    thread.join();
+
+    const QJsonArray events = writeEvents();
+    ASSERT_EQ(2, events.size());
+    EXPECT_NE(events[0].toObject().value("tid").toInt(),
+            events[1].toObject().value("tid").toInt());
+}
+
+} // namespace
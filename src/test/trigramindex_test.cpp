@@ -0,0 +1,53 @@
+#include "library/trigramindex.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+class TrigramIndexTest : public testing::Test {
+  protected:
+    std::vector<int> findCandidates(const QString& substring) const {
+        std::vector<int> ids;
+        EXPECT_TRUE(m_index.findCandidates(substring, &ids));
+        return ids;
+    }
+
+    TrigramIndex m_index;
+};
+
+TEST_F(TrigramIndexTest, findCandidates) {
+    m_index.insert(0, "daft punk");
+    m_index.insert(1, "punk rock");
+    m_index.insert(2, "aphex twin");
+    // Large ids need more than one byte
+    m_index.insert(100000, "daft punk live");
+
+    EXPECT_EQ(std::vector<int>({0, 1, 100000}), findCandidates("punk"));
+    EXPECT_EQ(std::vector<int>({0, 100000}), findCandidates("daft"));
+    EXPECT_EQ(std::vector<int>({2}), findCandidates("twin"));
+    EXPECT_EQ(std::vector<int>(), findCandidates("jazz"));
+}
+
+TEST_F(TrigramIndexTest, candidatesNeedToBeVerified) {
+    // Contains all trigrams of "abcab", but not the substring
+    m_index.insert(0, "abca bcab");
+    EXPECT_EQ(std::vector<int>({0}), findCandidates("abcab"));
+}
+
+TEST_F(TrigramIndexTest, shortSubstrings) {
+    m_index.insert(0, "daft punk");
+    std::vector<int> ids;
+    EXPECT_FALSE(m_index.findCandidates("da", &ids));
+    EXPECT_FALSE(m_index.findCandidates(QString(), &ids));
+}
+
+TEST_F(TrigramIndexTest, clear) {
+    m_index.insert(0, "daft punk");
+    m_index.clear();
+    EXPECT_EQ(std::vector<int>(), findCandidates("daft"));
+    // Ids can be reused
+    m_index.insert(0, "daft punk");
+    EXPECT_EQ(std::vector<int>({0}), findCandidates("daft"));
+}
+
+} // namespace
@@ -0,0 +1,105 @@
+#include "waveform/waveform.h"
+
+#include <gtest/gtest.h>
+
+#include "util/math.h"
+
+namespace {
+
+class WaveformTest : public testing::Test {
+  protected:
+    WaveformTest()
+            // 100 visual samples = 50 visual frames
+            : m_waveform(100, 99, 100, -1) {
+    }
+
+    void setFrame(int frame, int channel, unsigned char value) {
+        WaveformData& datum = m_waveform.data()[frame * ChannelCount + channel];
+        datum.filtered.low = value;
+        datum.filtered.mid = value / 2;
+        datum.filtered.high = 255 - value;
+        datum.filtered.all = value;
+    }
+
+    // Compares each level with the maximum of the covered visual frames
+    void expectLevelsConsistent(const Waveform& waveform) {
+        const int frames = waveform.getDataSize() / ChannelCount;
+        for (int level = 0; level < waveform.getLevelCount(); ++level) {
+            const int levelFrames = Waveform::getLevelFrames(level);
+            const WaveformData* levelData = waveform.levelData(level);
+            ASSERT_EQ((frames + levelFrames - 1) / levelFrames * ChannelCount,
+                    waveform.getLevelDataSize(level));
+            for (int i = 0; i < waveform.getLevelDataSize(level); ++i) {
+                const int channel = i % ChannelCount;
+                const int firstFrame = (i / ChannelCount) * levelFrames;
+                const int lastFrame = math_min(firstFrame + levelFrames, frames);
+                unsigned char low = 0;
+                unsigned char high = 0;
+                for (int frame = firstFrame; frame < lastFrame; ++frame) {
+                    const WaveformData& datum = waveform.get(frame * ChannelCount + channel);
+                    low = math_max(low, datum.filtered.low);
+                    high = math_max(high, datum.filtered.high);
+                }
+                EXPECT_EQ(low, levelData[i].filtered.low) << "level " << level << " index " << i;
+                EXPECT_EQ(high, levelData[i].filtered.high) << "level " << level << " index " << i;
+            }
+        }
+    }
+
+    Waveform m_waveform;
+};
+
+TEST_F(WaveformTest, levels) {
+    ASSERT_EQ(100, m_waveform.getDataSize());
+    // 2, 4, 8 and 16 frames per value
+    EXPECT_EQ(4, m_waveform.getLevelCount());
+
+    for (int frame = 0; frame < 50; ++frame) {
+        setFrame(frame, Left, static_cast<unsigned char>((frame * 37) % 256));
+        setFrame(frame, Right, static_cast<unsigned char>((frame * 91) % 256));
+    }
+    m_waveform.updateLevels(0, m_waveform.getDataSize());
+    expectLevelsConsistent(m_waveform);
+}
+
+TEST_F(WaveformTest, updateLevelsIncrementally) {
+    // Like the analyzer, which appends a few frames at a time
+    for (int frame = 0; frame < 50; ++frame) {
+        setFrame(frame, Left, static_cast<unsigned char>(frame * 5));
+        setFrame(frame, Right, static_cast<unsigned char>(250 - frame * 5));
+        m_waveform.updateLevels(frame * ChannelCount, (frame + 1) * ChannelCount);
+    }
+    expectLevelsConsistent(m_waveform);
+
+    // The trailing value of each level only covers the remaining frames
+    EXPECT_EQ(49 * 5, m_waveform.levelData(3)[3 * ChannelCount + Left].filtered.low);
+    EXPECT_EQ(250 - 48 * 5, m_waveform.levelData(3)[3 * ChannelCount + Right].filtered.low);
+}
+
+TEST_F(WaveformTest, findLevel) {
+    EXPECT_EQ(-1, m_waveform.findLevel(0.5));
+    EXPECT_EQ(-1, m_waveform.findLevel(1.9));
+    EXPECT_EQ(0, m_waveform.findLevel(2.0));
+    EXPECT_EQ(1, m_waveform.findLevel(7.9));
+    EXPECT_EQ(3, m_waveform.findLevel(1000.0));
+}
+
+TEST_F(WaveformTest, serializeLevels) {
+    for (int frame = 0; frame < 50; ++frame) {
+        setFrame(frame, Left, static_cast<unsigned char>((frame * 13) % 256));
+        setFrame(frame, Right, static_cast<unsigned char>((frame * 29) % 256));
+    }
+    m_waveform.updateLevels(0, m_waveform.getDataSize());
+
+    const Waveform restored(m_waveform.toByteArray());
+    ASSERT_EQ(m_waveform.getDataSize(), restored.getDataSize());
+    ASSERT_EQ(m_waveform.getLevelCount(), restored.getLevelCount());
+    for (int level = 0; level < restored.getLevelCount(); ++level) {
+        for (int i = 0; i < restored.getLevelDataSize(level); ++i) {
+            EXPECT_EQ(m_waveform.levelData(level)[i].m_i, restored.levelData(level)[i].m_i);
+        }
+    }
+    expectLevelsConsistent(restored);
+}
+
+} // namespace
@@ -148,6 +148,10 @@ void CmdlineArgs::printUsage() {
 --developer             Enables developer-mode. Includes extra log info,\n\
                         stats on performance, and a Developer tools menu.\n\
 \n\
+--timelinePath PATH     Records a trace of the internal processing and\n\
+                        writes it to PATH on exit. The trace can be viewed\n\
+                        with chrome://tracing or https://ui.perfetto.dev\n\
+\n\
 --safeMode              Enables safe-mode. Disables OpenGL waveforms,\n\
                         and spinning vinyl widgets. Try this option if\n\
                         Mixxx is crashing on startup.\n\
@@ -0,0 +1,93 @@
+#include "util/cpufeatures.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace mixxx {
+
+namespace {
+
+struct Features {
+    bool sse2 = false;
+    bool avx2Fma = false;
+    bool neon = false;
+};
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+
+Features detectFeatures() {
+    Features features;
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    if (maxLeaf < 1) {
+        return features;
+    }
+    __cpuid(info, 1);
+    features.sse2 = (info[3] & (1 << 26)) != 0;
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (maxLeaf < 7 || !fma || !osxsave || !avx) {
+        return features;
+    }
+    // The OS must save and restore both the XMM and YMM registers
+    if ((_xgetbv(0) & 0x6) != 0x6) {
+        return features;
+    }
+    __cpuidex(info, 7, 0);
+    features.avx2Fma = (info[1] & (1 << 5)) != 0;
+    return features;
+}
+
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+Features detectFeatures() {
+    Features features;
+    // Also checks the OS support for the AVX register state
+    __builtin_cpu_init();
+    features.sse2 = __builtin_cpu_supports("sse2");
+    features.avx2Fma = __builtin_cpu_supports("avx2") &&
+            __builtin_cpu_supports("fma");
+    return features;
+}
+
+#else
+
+Features detectFeatures() {
+    Features features;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    // Compiled for a target that guarantees NEON, e.g. aarch64 or armhf
+    // with -mfpu=neon
+    features.neon = true;
+#endif
+    return features;
+}
+
+#endif
+
+const Features& features() {
+    static const Features s_features = detectFeatures();
+    return s_features;
+}
+
+} // anonymous namespace
+
+// static
+bool CpuFeatures::hasSse2() {
+    return features().sse2;
+}
+
+// static
+bool CpuFeatures::hasAvx2Fma() {
+    return features().avx2Fma;
+}
+
+// static
+bool CpuFeatures::hasNeon() {
+    return features().neon;
+}
+
+} // namespace mixxx
@@ -0,0 +1,24 @@
+#pragma once
+
+namespace mixxx {
+
+// Detects the instruction set extensions that are supported by the
+// CPU at runtime. Distribution builds only target a baseline instruction
+// set, this allows to pick optimized code paths for newer CPUs.
+//
+// The detection is done once, subsequent calls are cheap.
+class CpuFeatures final {
+  public:
+    // x86/x86_64: Always available on x86_64
+    static bool hasSse2();
+    // x86/x86_64: AVX2 and FMA3, including support by the OS for
+    // saving the extended register state
+    static bool hasAvx2Fma();
+    // ARM: Always available on aarch64
+    static bool hasNeon();
+
+  private:
+    CpuFeatures() = delete;
+};
+
+} // namespace mixxx
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+#include "util/platform.h"
+#include "util/sample.h"
+#include "util/types.h"
+
+// A table of the hot SampleUtil kernels implemented for a specific
+// instruction set.
+//
+// SampleUtil handles the trivial cases (e.g. unity or zero gain) itself
+// and forwards the remaining work to the kernels of the table returned
+// by active(). The table is selected once according to the features of
+// the CPU, see mixxx::CpuFeatures.
+//
+// All kernels must produce the same results as the scalar reference
+// implementation, apart from rounding errors caused by a different
+// order of operations or fused multiply-add instructions. The vectorized
+// convertFloat32ToS16 kernels saturate samples outside of [-1.0, 1.0)
+// instead of wrapping around.
+struct SampleUtilKernels {
+    const char* name;
+
+    void (*applyRampingGain)(CSAMPLE* pBuffer,
+            CSAMPLE_GAIN old_gain,
+            CSAMPLE_GAIN new_gain,
+            SINT numSamples);
+    void (*addWithRampingGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            CSAMPLE_GAIN old_gain,
+            CSAMPLE_GAIN new_gain,
+            SINT numSamples);
+    void (*copyWithRampingGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            CSAMPLE_GAIN old_gain,
+            CSAMPLE_GAIN new_gain,
+            SINT numSamples);
+    SampleUtil::CLIP_STATUS (*sumAbsPerChannel)(CSAMPLE* pfAbsL,
+            CSAMPLE* pfAbsR,
+            const CSAMPLE* pBuffer,
+            SINT numSamples);
+    void (*copyClampBuffer)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            SINT numSamples);
+    void (*convertFloat32ToS16)(SAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            SINT numSamples);
+    void (*interleaveBuffer)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc1,
+            const CSAMPLE* M_RESTRICT pSrc2,
+            SINT numFrames);
+
+    // The portable reference implementation, always available
+    static const SampleUtilKernels& scalar();
+
+    // The following variants return nullptr if they have not been
+    // compiled for the target architecture or if they are not supported
+    // by the CPU.
+    static const SampleUtilKernels* sse2();
+    static const SampleUtilKernels* avx2();
+    static const SampleUtilKernels* neon();
+
+    // All variants that are usable on this CPU, starting with scalar()
+    static std::vector<const SampleUtilKernels*> available();
+
+    // The fastest variant that is usable on this CPU
+    static const SampleUtilKernels& active();
+};
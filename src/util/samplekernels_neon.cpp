@@ -0,0 +1,224 @@
+#include "util/samplekernels.h"
+
+#include <cmath>
+
+#include "util/cpufeatures.h"
+#include "util/math.h"
+
+// Hand-written NEON kernels for ARM.
+//
+// NEON is mandatory on aarch64, 32-bit ARM builds only use these kernels
+// if they are compiled for a target with NEON, e.g. with -mfpu=neon.
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MIXXX_SAMPLEKERNELS_NEON
+#endif
+
+#ifdef MIXXX_SAMPLEKERNELS_NEON
+
+#include <arm_neon.h>
+
+namespace {
+
+constexpr CSAMPLE kS16ConversionFactor = -SAMPLE_MIN;
+
+// 4 samples = 2 stereo frames per vector, see rampingGainSse2()
+template<bool kAdd>
+void rampingGainNeon(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
+            / CSAMPLE_GAIN(numSamples / 2);
+    SINT i = 0;
+    if (gain_delta != 0) {
+        // The ramp only covers complete frames
+        const SINT numRampSamples = (numSamples / 2) * 2;
+        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        const float32x4_t vStartGain = vdupq_n_f32(start_gain);
+        const float32x4_t vFrameStep = vdupq_n_f32(2.0f);
+        const float kInitialFrames[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+        float32x4_t vFrame = vld1q_f32(kInitialFrames);
+        for (; i + 4 <= numRampSamples; i += 4) {
+            const float32x4_t vGain = vmlaq_n_f32(vStartGain, vFrame, gain_delta);
+            const float32x4_t vSrc = vld1q_f32(pSrc + i);
+            if (kAdd) {
+                vst1q_f32(pDest + i, vmlaq_f32(vld1q_f32(pDest + i), vSrc, vGain));
+            } else {
+                vst1q_f32(pDest + i, vmulq_f32(vSrc, vGain));
+            }
+            vFrame = vaddq_f32(vFrame, vFrameStep);
+        }
+        for (; i < numRampSamples; ++i) {
+            const CSAMPLE_GAIN gain = start_gain + gain_delta * static_cast<int>(i / 2);
+            if (kAdd) {
+                pDest[i] += pSrc[i] * gain;
+            } else {
+                pDest[i] = pSrc[i] * gain;
+            }
+        }
+    } else {
+        for (; i + 4 <= numSamples; i += 4) {
+            const float32x4_t vSrc = vld1q_f32(pSrc + i);
+            if (kAdd) {
+                vst1q_f32(pDest + i, vmlaq_n_f32(vld1q_f32(pDest + i), vSrc, old_gain));
+            } else {
+                vst1q_f32(pDest + i, vmulq_n_f32(vSrc, old_gain));
+            }
+        }
+        for (; i < numSamples; ++i) {
+            if (kAdd) {
+                pDest[i] += pSrc[i] * old_gain;
+            } else {
+                pDest[i] = pSrc[i] * old_gain;
+            }
+        }
+    }
+}
+
+void applyRampingGainNeon(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    rampingGainNeon<false>(pBuffer, pBuffer, old_gain, new_gain, numSamples);
+}
+
+void addWithRampingGainNeon(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    rampingGainNeon<true>(pDest, pSrc, old_gain, new_gain, numSamples);
+}
+
+void copyWithRampingGainNeon(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    rampingGainNeon<false>(pDest, pSrc, old_gain, new_gain, numSamples);
+}
+
+SampleUtil::CLIP_STATUS sumAbsPerChannelNeon(
+        CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numSamples) {
+    const SINT numFrameSamples = (numSamples / 2) * 2;
+    const float32x4_t vPeak = vdupq_n_f32(CSAMPLE_PEAK);
+    float32x4_t vSum = vdupq_n_f32(CSAMPLE_ZERO);
+    uint32x4_t vClipped = vdupq_n_u32(0);
+    SINT i = 0;
+    for (; i + 4 <= numFrameSamples; i += 4) {
+        const float32x4_t vAbs = vabsq_f32(vld1q_f32(pBuffer + i));
+        vSum = vaddq_f32(vSum, vAbs);
+        vClipped = vorrq_u32(vClipped, vcgtq_f32(vAbs, vPeak));
+    }
+    // Lanes 0 and 2 contain the left, lanes 1 and 3 the right channel
+    CSAMPLE fAbsL = vgetq_lane_f32(vSum, 0) + vgetq_lane_f32(vSum, 2);
+    CSAMPLE fAbsR = vgetq_lane_f32(vSum, 1) + vgetq_lane_f32(vSum, 3);
+    bool clippedL = (vgetq_lane_u32(vClipped, 0) | vgetq_lane_u32(vClipped, 2)) != 0;
+    bool clippedR = (vgetq_lane_u32(vClipped, 1) | vgetq_lane_u32(vClipped, 3)) != 0;
+    for (; i < numFrameSamples; i += 2) {
+        const CSAMPLE absl = std::abs(pBuffer[i]);
+        fAbsL += absl;
+        clippedL |= absl > CSAMPLE_PEAK;
+        const CSAMPLE absr = std::abs(pBuffer[i + 1]);
+        fAbsR += absr;
+        clippedR |= absr > CSAMPLE_PEAK;
+    }
+
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
+    if (clippedL) {
+        clipping |= SampleUtil::CLIPPING_LEFT;
+    }
+    if (clippedR) {
+        clipping |= SampleUtil::CLIPPING_RIGHT;
+    }
+    return clipping;
+}
+
+void copyClampBufferNeon(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    const float32x4_t vMin = vdupq_n_f32(-CSAMPLE_PEAK);
+    const float32x4_t vMax = vdupq_n_f32(CSAMPLE_PEAK);
+    SINT i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        const float32x4_t vIn = vld1q_f32(pSrc + i);
+        vst1q_f32(pDest + i, vmaxq_f32(vMin, vminq_f32(vMax, vIn)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = SampleUtil::clampSample(pSrc[i]);
+    }
+}
+
+void convertFloat32ToS16Neon(SAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    SINT i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        // The conversion to int32 truncates and saturates,
+        // the narrowing to int16 saturates
+        const int32x4_t vOut1 = vcvtq_s32_f32(
+                vmulq_n_f32(vld1q_f32(pSrc + i), kS16ConversionFactor));
+        const int32x4_t vOut2 = vcvtq_s32_f32(
+                vmulq_n_f32(vld1q_f32(pSrc + i + 4), kS16ConversionFactor));
+        vst1q_s16(pDest + i, vcombine_s16(vqmovn_s32(vOut1), vqmovn_s32(vOut2)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = SAMPLE(math_clamp(pSrc[i] * kS16ConversionFactor,
+                CSAMPLE(SAMPLE_MIN),
+                CSAMPLE(SAMPLE_MAX)));
+    }
+}
+
+void interleaveBufferNeon(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        float32x4x2_t vFrames;
+        vFrames.val[0] = vld1q_f32(pSrc1 + i);
+        vFrames.val[1] = vld1q_f32(pSrc2 + i);
+        vst2q_f32(pDest + 2 * i, vFrames);
+    }
+    for (; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+constexpr SampleUtilKernels kNeonKernels = {
+        "neon",
+        applyRampingGainNeon,
+        addWithRampingGainNeon,
+        copyWithRampingGainNeon,
+        sumAbsPerChannelNeon,
+        copyClampBufferNeon,
+        convertFloat32ToS16Neon,
+        interleaveBufferNeon,
+};
+
+} // anonymous namespace
+
+// static
+const SampleUtilKernels* SampleUtilKernels::neon() {
+    if (!mixxx::CpuFeatures::hasNeon()) {
+        return nullptr;
+    }
+    return &kNeonKernels;
+}
+
+#else // MIXXX_SAMPLEKERNELS_NEON
+
+// static
+const SampleUtilKernels* SampleUtilKernels::neon() {
+    return nullptr;
+}
+
+#endif // MIXXX_SAMPLEKERNELS_NEON
@@ -0,0 +1,472 @@
+#include "util/samplekernels.h"
+
+#include <cmath>
+
+#include "util/cpufeatures.h"
+#include "util/math.h"
+
+// Hand-written SSE2 and AVX2/FMA kernels for x86 and x86_64.
+//
+// Distribution builds only target the baseline instruction set. Instead
+// of compiling this file with different flags the instruction set is
+// enabled per function with the target attribute of GCC and Clang. MSVC
+// allows to use all intrinsics without special flags. The kernels must
+// only be called if the CPU supports the corresponding instruction set,
+// see SampleUtilKernels::sse2() and SampleUtilKernels::avx2().
+//
+// All loads and stores are unaligned. The buffers allocated by
+// SampleUtil::alloc() are aligned, but the kernels are also called with
+// offsets into these buffers.
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MIXXX_SAMPLEKERNELS_X86
+#endif
+
+#ifdef MIXXX_SAMPLEKERNELS_X86
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define MIXXX_TARGET_SSE2
+#define MIXXX_TARGET_AVX2_FMA
+#else
+#define MIXXX_TARGET_SSE2 __attribute__((target("sse2")))
+#define MIXXX_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#endif
+
+namespace {
+
+constexpr CSAMPLE kS16ConversionFactor = -SAMPLE_MIN;
+
+////////////////////////////////////////////////////////////////////////
+// SSE2: 4 samples = 2 stereo frames per vector
+////////////////////////////////////////////////////////////////////////
+
+// pDest[i] = pSrc[i] * gain (kAdd = false) or
+// pDest[i] += pSrc[i] * gain (kAdd = true)
+// with the same ramping as the scalar implementation. pDest and pSrc
+// may point to the same buffer.
+template<bool kAdd>
+MIXXX_TARGET_SSE2 void rampingGainSse2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
+            / CSAMPLE_GAIN(numSamples / 2);
+    SINT i = 0;
+    if (gain_delta != 0) {
+        // The ramp only covers complete frames
+        const SINT numRampSamples = (numSamples / 2) * 2;
+        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        const __m128 vStartGain = _mm_set1_ps(start_gain);
+        const __m128 vGainDelta = _mm_set1_ps(gain_delta);
+        const __m128 vFrameStep = _mm_set1_ps(2.0f);
+        __m128 vFrame = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+        for (; i + 4 <= numRampSamples; i += 4) {
+            const __m128 vGain = _mm_add_ps(vStartGain, _mm_mul_ps(vGainDelta, vFrame));
+            __m128 vOut = _mm_mul_ps(_mm_loadu_ps(pSrc + i), vGain);
+            if (kAdd) {
+                vOut = _mm_add_ps(_mm_loadu_ps(pDest + i), vOut);
+            }
+            _mm_storeu_ps(pDest + i, vOut);
+            vFrame = _mm_add_ps(vFrame, vFrameStep);
+        }
+        for (; i < numRampSamples; ++i) {
+            const CSAMPLE_GAIN gain = start_gain + gain_delta * static_cast<int>(i / 2);
+            if (kAdd) {
+                pDest[i] += pSrc[i] * gain;
+            } else {
+                pDest[i] = pSrc[i] * gain;
+            }
+        }
+    } else {
+        const __m128 vGain = _mm_set1_ps(old_gain);
+        for (; i + 4 <= numSamples; i += 4) {
+            __m128 vOut = _mm_mul_ps(_mm_loadu_ps(pSrc + i), vGain);
+            if (kAdd) {
+                vOut = _mm_add_ps(_mm_loadu_ps(pDest + i), vOut);
+            }
+            _mm_storeu_ps(pDest + i, vOut);
+        }
+        for (; i < numSamples; ++i) {
+            if (kAdd) {
+                pDest[i] += pSrc[i] * old_gain;
+            } else {
+                pDest[i] = pSrc[i] * old_gain;
+            }
+        }
+    }
+}
+
+MIXXX_TARGET_SSE2 void applyRampingGainSse2(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    rampingGainSse2<false>(pBuffer, pBuffer, old_gain, new_gain, numSamples);
+}
+
+MIXXX_TARGET_SSE2 void addWithRampingGainSse2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    rampingGainSse2<true>(pDest, pSrc, old_gain, new_gain, numSamples);
+}
+
+MIXXX_TARGET_SSE2 void copyWithRampingGainSse2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    rampingGainSse2<false>(pDest, pSrc, old_gain, new_gain, numSamples);
+}
+
+MIXXX_TARGET_SSE2 SampleUtil::CLIP_STATUS sumAbsPerChannelSse2(
+        CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numSamples) {
+    const SINT numFrameSamples = (numSamples / 2) * 2;
+    const __m128 vSignMask = _mm_set1_ps(-0.0f);
+    const __m128 vPeak = _mm_set1_ps(CSAMPLE_PEAK);
+    __m128 vSum = _mm_setzero_ps();
+    __m128 vClipped = _mm_setzero_ps();
+    SINT i = 0;
+    for (; i + 4 <= numFrameSamples; i += 4) {
+        const __m128 vAbs = _mm_andnot_ps(vSignMask, _mm_loadu_ps(pBuffer + i));
+        vSum = _mm_add_ps(vSum, vAbs);
+        vClipped = _mm_or_ps(vClipped, _mm_cmpgt_ps(vAbs, vPeak));
+    }
+    alignas(16) CSAMPLE sums[4];
+    _mm_store_ps(sums, vSum);
+    CSAMPLE fAbsL = sums[0] + sums[2];
+    CSAMPLE fAbsR = sums[1] + sums[3];
+    // Lanes 0 and 2 contain the left, lanes 1 and 3 the right channel
+    const int clippedMask = _mm_movemask_ps(vClipped);
+    bool clippedL = (clippedMask & 0x5) != 0;
+    bool clippedR = (clippedMask & 0xA) != 0;
+    for (; i < numFrameSamples; i += 2) {
+        const CSAMPLE absl = std::abs(pBuffer[i]);
+        fAbsL += absl;
+        clippedL |= absl > CSAMPLE_PEAK;
+        const CSAMPLE absr = std::abs(pBuffer[i + 1]);
+        fAbsR += absr;
+        clippedR |= absr > CSAMPLE_PEAK;
+    }
+
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
+    if (clippedL) {
+        clipping |= SampleUtil::CLIPPING_LEFT;
+    }
+    if (clippedR) {
+        clipping |= SampleUtil::CLIPPING_RIGHT;
+    }
+    return clipping;
+}
+
+MIXXX_TARGET_SSE2 void copyClampBufferSse2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    const __m128 vMin = _mm_set1_ps(-CSAMPLE_PEAK);
+    const __m128 vMax = _mm_set1_ps(CSAMPLE_PEAK);
+    SINT i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        const __m128 vIn = _mm_loadu_ps(pSrc + i);
+        _mm_storeu_ps(pDest + i, _mm_max_ps(vMin, _mm_min_ps(vMax, vIn)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = SampleUtil::clampSample(pSrc[i]);
+    }
+}
+
+MIXXX_TARGET_SSE2 void convertFloat32ToS16Sse2(SAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    const __m128 vFactor = _mm_set1_ps(kS16ConversionFactor);
+    // Saturate before converting, because out of range values are
+    // converted to INT_MIN regardless of their sign.
+    const __m128 vMin = _mm_set1_ps(SAMPLE_MIN);
+    const __m128 vMax = _mm_set1_ps(SAMPLE_MAX);
+    SINT i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        const __m128 vIn1 = _mm_mul_ps(_mm_loadu_ps(pSrc + i), vFactor);
+        const __m128 vIn2 = _mm_mul_ps(_mm_loadu_ps(pSrc + i + 4), vFactor);
+        const __m128i vOut1 = _mm_cvttps_epi32(_mm_max_ps(vMin, _mm_min_ps(vMax, vIn1)));
+        const __m128i vOut2 = _mm_cvttps_epi32(_mm_max_ps(vMin, _mm_min_ps(vMax, vIn2)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + i),
+                _mm_packs_epi32(vOut1, vOut2));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = SAMPLE(math_clamp(pSrc[i] * kS16ConversionFactor,
+                CSAMPLE(SAMPLE_MIN),
+                CSAMPLE(SAMPLE_MAX)));
+    }
+}
+
+MIXXX_TARGET_SSE2 void interleaveBufferSse2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m128 vSrc1 = _mm_loadu_ps(pSrc1 + i);
+        const __m128 vSrc2 = _mm_loadu_ps(pSrc2 + i);
+        _mm_storeu_ps(pDest + 2 * i, _mm_unpacklo_ps(vSrc1, vSrc2));
+        _mm_storeu_ps(pDest + 2 * i + 4, _mm_unpackhi_ps(vSrc1, vSrc2));
+    }
+    for (; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+constexpr SampleUtilKernels kSse2Kernels = {
+        "sse2",
+        applyRampingGainSse2,
+        addWithRampingGainSse2,
+        copyWithRampingGainSse2,
+        sumAbsPerChannelSse2,
+        copyClampBufferSse2,
+        convertFloat32ToS16Sse2,
+        interleaveBufferSse2,
+};
+
+////////////////////////////////////////////////////////////////////////
+// AVX2/FMA: 8 samples = 4 stereo frames per vector
+////////////////////////////////////////////////////////////////////////
+
+template<bool kAdd>
+MIXXX_TARGET_AVX2_FMA void rampingGainAvx2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
+            / CSAMPLE_GAIN(numSamples / 2);
+    SINT i = 0;
+    if (gain_delta != 0) {
+        // The ramp only covers complete frames
+        const SINT numRampSamples = (numSamples / 2) * 2;
+        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        const __m256 vStartGain = _mm256_set1_ps(start_gain);
+        const __m256 vGainDelta = _mm256_set1_ps(gain_delta);
+        const __m256 vFrameStep = _mm256_set1_ps(4.0f);
+        __m256 vFrame = _mm256_setr_ps(
+                0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+        for (; i + 8 <= numRampSamples; i += 8) {
+            const __m256 vGain = _mm256_fmadd_ps(vGainDelta, vFrame, vStartGain);
+            const __m256 vSrc = _mm256_loadu_ps(pSrc + i);
+            if (kAdd) {
+                _mm256_storeu_ps(pDest + i,
+                        _mm256_fmadd_ps(vSrc, vGain, _mm256_loadu_ps(pDest + i)));
+            } else {
+                _mm256_storeu_ps(pDest + i, _mm256_mul_ps(vSrc, vGain));
+            }
+            vFrame = _mm256_add_ps(vFrame, vFrameStep);
+        }
+        for (; i < numRampSamples; ++i) {
+            const CSAMPLE_GAIN gain = start_gain + gain_delta * static_cast<int>(i / 2);
+            if (kAdd) {
+                pDest[i] += pSrc[i] * gain;
+            } else {
+                pDest[i] = pSrc[i] * gain;
+            }
+        }
+    } else {
+        const __m256 vGain = _mm256_set1_ps(old_gain);
+        for (; i + 8 <= numSamples; i += 8) {
+            const __m256 vSrc = _mm256_loadu_ps(pSrc + i);
+            if (kAdd) {
+                _mm256_storeu_ps(pDest + i,
+                        _mm256_fmadd_ps(vSrc, vGain, _mm256_loadu_ps(pDest + i)));
+            } else {
+                _mm256_storeu_ps(pDest + i, _mm256_mul_ps(vSrc, vGain));
+            }
+        }
+        for (; i < numSamples; ++i) {
+            if (kAdd) {
+                pDest[i] += pSrc[i] * old_gain;
+            } else {
+                pDest[i] = pSrc[i] * old_gain;
+            }
+        }
+    }
+}
+
+MIXXX_TARGET_AVX2_FMA void applyRampingGainAvx2(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    rampingGainAvx2<false>(pBuffer, pBuffer, old_gain, new_gain, numSamples);
+}
+
+MIXXX_TARGET_AVX2_FMA void addWithRampingGainAvx2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    rampingGainAvx2<true>(pDest, pSrc, old_gain, new_gain, numSamples);
+}
+
+MIXXX_TARGET_AVX2_FMA void copyWithRampingGainAvx2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    rampingGainAvx2<false>(pDest, pSrc, old_gain, new_gain, numSamples);
+}
+
+MIXXX_TARGET_AVX2_FMA SampleUtil::CLIP_STATUS sumAbsPerChannelAvx2(
+        CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numSamples) {
+    const SINT numFrameSamples = (numSamples / 2) * 2;
+    const __m256 vSignMask = _mm256_set1_ps(-0.0f);
+    const __m256 vPeak = _mm256_set1_ps(CSAMPLE_PEAK);
+    __m256 vSum = _mm256_setzero_ps();
+    __m256 vClipped = _mm256_setzero_ps();
+    SINT i = 0;
+    for (; i + 8 <= numFrameSamples; i += 8) {
+        const __m256 vAbs = _mm256_andnot_ps(vSignMask, _mm256_loadu_ps(pBuffer + i));
+        vSum = _mm256_add_ps(vSum, vAbs);
+        vClipped = _mm256_or_ps(vClipped, _mm256_cmp_ps(vAbs, vPeak, _CMP_GT_OQ));
+    }
+    alignas(32) CSAMPLE sums[8];
+    _mm256_store_ps(sums, vSum);
+    CSAMPLE fAbsL = (sums[0] + sums[2]) + (sums[4] + sums[6]);
+    CSAMPLE fAbsR = (sums[1] + sums[3]) + (sums[5] + sums[7]);
+    // Even lanes contain the left, odd lanes the right channel
+    const int clippedMask = _mm256_movemask_ps(vClipped);
+    bool clippedL = (clippedMask & 0x55) != 0;
+    bool clippedR = (clippedMask & 0xAA) != 0;
+    for (; i < numFrameSamples; i += 2) {
+        const CSAMPLE absl = std::abs(pBuffer[i]);
+        fAbsL += absl;
+        clippedL |= absl > CSAMPLE_PEAK;
+        const CSAMPLE absr = std::abs(pBuffer[i + 1]);
+        fAbsR += absr;
+        clippedR |= absr > CSAMPLE_PEAK;
+    }
+
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
+    if (clippedL) {
+        clipping |= SampleUtil::CLIPPING_LEFT;
+    }
+    if (clippedR) {
+        clipping |= SampleUtil::CLIPPING_RIGHT;
+    }
+    return clipping;
+}
+
+MIXXX_TARGET_AVX2_FMA void copyClampBufferAvx2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    const __m256 vMin = _mm256_set1_ps(-CSAMPLE_PEAK);
+    const __m256 vMax = _mm256_set1_ps(CSAMPLE_PEAK);
+    SINT i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        const __m256 vIn = _mm256_loadu_ps(pSrc + i);
+        _mm256_storeu_ps(pDest + i, _mm256_max_ps(vMin, _mm256_min_ps(vMax, vIn)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = SampleUtil::clampSample(pSrc[i]);
+    }
+}
+
+MIXXX_TARGET_AVX2_FMA void convertFloat32ToS16Avx2(SAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    const __m256 vFactor = _mm256_set1_ps(kS16ConversionFactor);
+    const __m256 vMin = _mm256_set1_ps(SAMPLE_MIN);
+    const __m256 vMax = _mm256_set1_ps(SAMPLE_MAX);
+    SINT i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        const __m256 vIn1 = _mm256_mul_ps(_mm256_loadu_ps(pSrc + i), vFactor);
+        const __m256 vIn2 = _mm256_mul_ps(_mm256_loadu_ps(pSrc + i + 8), vFactor);
+        const __m256i vOut1 = _mm256_cvttps_epi32(
+                _mm256_max_ps(vMin, _mm256_min_ps(vMax, vIn1)));
+        const __m256i vOut2 = _mm256_cvttps_epi32(
+                _mm256_max_ps(vMin, _mm256_min_ps(vMax, vIn2)));
+        // Packing works within each 128-bit lane, restore the order
+        // of the 64-bit blocks afterwards
+        const __m256i vPacked = _mm256_packs_epi32(vOut1, vOut2);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDest + i),
+                _mm256_permute4x64_epi64(vPacked, 0xD8));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = SAMPLE(math_clamp(pSrc[i] * kS16ConversionFactor,
+                CSAMPLE(SAMPLE_MIN),
+                CSAMPLE(SAMPLE_MAX)));
+    }
+}
+
+MIXXX_TARGET_AVX2_FMA void interleaveBufferAvx2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m256 vSrc1 = _mm256_loadu_ps(pSrc1 + i);
+        const __m256 vSrc2 = _mm256_loadu_ps(pSrc2 + i);
+        // Unpacking works within each 128-bit lane:
+        // vLo = [a0 b0 a1 b1 | a4 b4 a5 b5]
+        // vHi = [a2 b2 a3 b3 | a6 b6 a7 b7]
+        const __m256 vLo = _mm256_unpacklo_ps(vSrc1, vSrc2);
+        const __m256 vHi = _mm256_unpackhi_ps(vSrc1, vSrc2);
+        _mm256_storeu_ps(pDest + 2 * i, _mm256_permute2f128_ps(vLo, vHi, 0x20));
+        _mm256_storeu_ps(pDest + 2 * i + 8, _mm256_permute2f128_ps(vLo, vHi, 0x31));
+    }
+    for (; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+constexpr SampleUtilKernels kAvx2Kernels = {
+        "avx2",
+        applyRampingGainAvx2,
+        addWithRampingGainAvx2,
+        copyWithRampingGainAvx2,
+        sumAbsPerChannelAvx2,
+        copyClampBufferAvx2,
+        convertFloat32ToS16Avx2,
+        interleaveBufferAvx2,
+};
+
+} // anonymous namespace
+
+// static
+const SampleUtilKernels* SampleUtilKernels::sse2() {
+    if (!mixxx::CpuFeatures::hasSse2()) {
+        return nullptr;
+    }
+    return &kSse2Kernels;
+}
+
+// static
+const SampleUtilKernels* SampleUtilKernels::avx2() {
+    if (!mixxx::CpuFeatures::hasAvx2Fma()) {
+        return nullptr;
+    }
+    return &kAvx2Kernels;
+}
+
+#else // MIXXX_SAMPLEKERNELS_X86
+
+// static
+const SampleUtilKernels* SampleUtilKernels::sse2() {
+    return nullptr;
+}
+
+// static
+const SampleUtilKernels* SampleUtilKernels::avx2() {
+    return nullptr;
+}
+
+#endif // MIXXX_SAMPLEKERNELS_X86
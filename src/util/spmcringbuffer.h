@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "util/assert.h"
+#include "util/class.h"
+#include "util/math.h"
+
+// A lock-free ring buffer with a single writer and multiple readers that
+// consume the same data independently.
+//
+// Each reader has its own read cursor and accesses the data in place,
+// i.e. the written data is never copied again for the individual
+// readers. The writer never overwrites data that has not been released
+// by all attached readers yet. If a reader falls behind, the writer
+// drops the samples that don't fit and accounts them to the lagging
+// reader, so the reader can report the overflow.
+//
+// Positions are counted modulo 2^32 and the capacity is a power of 2,
+// so all index arithmetic is correct after the counters wrap around.
+template <class DataType>
+class SpmcRingBuffer {
+  public:
+    static constexpr int kMaxReaders = 8;
+
+    explicit SpmcRingBuffer(int capacity)
+            : m_capacity(roundUpToPowerOf2(capacity)),
+              m_data(std::make_unique<DataType[]>(m_capacity)),
+              m_writePos(0) {
+        for (auto& reader : m_readers) {
+            reader.attached.store(false);
+            reader.readPos.store(0);
+            reader.overflowCount.store(0);
+        }
+    }
+
+    int capacity() const {
+        return m_capacity;
+    }
+
+    // Writer: The space that is available without overwriting the data
+    // of the slowest reader.
+    int writeAvailable() const {
+        const unsigned int writePos = m_writePos.load(std::memory_order_relaxed);
+        return m_capacity - static_cast<int>(writePos - minReadPos(writePos));
+    }
+
+    // Writer: Appends as much data as possible and returns the number of
+    // items written. The remaining items are dropped and counted as an
+    // overflow for each reader that is lagging behind.
+    int write(const DataType* pData, int count) {
+        const unsigned int writePos = m_writePos.load(std::memory_order_relaxed);
+        const int available = m_capacity - static_cast<int>(writePos - minReadPos(writePos));
+        const int written = math_min(count, available);
+        if (written < count) {
+            countOverflow(writePos, count, count - written);
+        }
+        const int offset = static_cast<int>(writePos & (m_capacity - 1));
+        const int size1 = math_min(written, m_capacity - offset);
+        std::copy(pData, pData + size1, m_data.get() + offset);
+        std::copy(pData + size1, pData + written, m_data.get());
+        // Publish the data for the readers
+        m_writePos.store(writePos + written, std::memory_order_release);
+        return written;
+    }
+
+    // Attaches a new reader that starts reading at the current write
+    // position. Returns -1 if all reader slots are in use. Thread-safe
+    // with respect to the writer, but readers must not be attached or
+    // detached concurrently.
+    int attachReader() {
+        for (int i = 0; i < kMaxReaders; ++i) {
+            Reader& reader = m_readers[i];
+            if (reader.attached.load(std::memory_order_acquire)) {
+                continue;
+            }
+            reader.overflowCount.store(0);
+            reader.readPos.store(m_writePos.load(std::memory_order_acquire));
+            reader.attached.store(true, std::memory_order_release);
+            // The writer might have overwritten the data at the read
+            // position before it noticed the new reader. All data up to
+            // the current write position is valid.
+            reader.readPos.store(m_writePos.load(std::memory_order_acquire),
+                    std::memory_order_release);
+            return i;
+        }
+        return -1;
+    }
+
+    void detachReader(int reader) {
+        VERIFY_OR_DEBUG_ASSERT(isValidReader(reader)) {
+            return;
+        }
+        m_readers[reader].attached.store(false, std::memory_order_release);
+    }
+
+    int readAvailable(int reader) const {
+        DEBUG_ASSERT(isValidReader(reader));
+        const unsigned int writePos = m_writePos.load(std::memory_order_acquire);
+        return static_cast<int>(
+                writePos - m_readers[reader].readPos.load(std::memory_order_relaxed));
+    }
+
+    // Returns up to count items that can be read in place. The regions
+    // stay valid until they are released.
+    int acquireReadRegions(int reader,
+            int count,
+            const DataType** dataPtr1,
+            int* sizePtr1,
+            const DataType** dataPtr2,
+            int* sizePtr2) const {
+        const int available = readAvailable(reader);
+        const int acquired = math_min(count, available);
+        const unsigned int readPos = m_readers[reader].readPos.load(std::memory_order_relaxed);
+        const int offset = static_cast<int>(readPos & (m_capacity - 1));
+        *sizePtr1 = math_min(acquired, m_capacity - offset);
+        *dataPtr1 = m_data.get() + offset;
+        *sizePtr2 = acquired - *sizePtr1;
+        *dataPtr2 = m_data.get();
+        return acquired;
+    }
+
+    void releaseReadRegions(int reader, int count) {
+        DEBUG_ASSERT(count <= readAvailable(reader));
+        Reader& r = m_readers[reader];
+        r.readPos.store(r.readPos.load(std::memory_order_relaxed) + count,
+                std::memory_order_release);
+    }
+
+    // Returns and resets the number of items that have been dropped,
+    // because the reader was not able to keep up with the writer.
+    int takeOverflowCount(int reader) {
+        DEBUG_ASSERT(isValidReader(reader));
+        return m_readers[reader].overflowCount.exchange(0);
+    }
+
+  private:
+    struct Reader {
+        std::atomic<bool> attached;
+        std::atomic<unsigned int> readPos;
+        std::atomic<int> overflowCount;
+    };
+
+    bool isValidReader(int reader) const {
+        return reader >= 0 && reader < kMaxReaders &&
+                m_readers[reader].attached.load(std::memory_order_relaxed);
+    }
+
+    // The position of the slowest reader or the write position if no
+    // reader is attached
+    unsigned int minReadPos(unsigned int writePos) const {
+        unsigned int maxUsed = 0;
+        for (const auto& reader : m_readers) {
+            if (!reader.attached.load(std::memory_order_acquire)) {
+                continue;
+            }
+            const unsigned int used = writePos - reader.readPos.load(std::memory_order_acquire);
+            maxUsed = math_max(maxUsed, used);
+        }
+        return writePos - maxUsed;
+    }
+
+    void countOverflow(unsigned int writePos, int requested, int dropped) {
+        // Only the readers that leave less space than requested are to blame
+        for (auto& reader : m_readers) {
+            if (!reader.attached.load(std::memory_order_acquire)) {
+                continue;
+            }
+            const int used = static_cast<int>(
+                    writePos - reader.readPos.load(std::memory_order_acquire));
+            if (m_capacity - used < requested) {
+                reader.overflowCount.fetch_add(dropped);
+            }
+        }
+    }
+
+    const int m_capacity;
+    const std::unique_ptr<DataType[]> m_data;
+    std::atomic<unsigned int> m_writePos;
+    Reader m_readers[kMaxReaders];
+
+    DISALLOW_COPY_AND_ASSIGN(SpmcRingBuffer<DataType>);
+};
@@ -1,11 +1,8 @@
 #include <QtDebug>
 #include <QMutexLocker>
-#include <QTextStream>
-#include <QFile>
 #include <QMetaType>
 
 #include "util/statsmanager.h"
-#include "util/cmdlineargs.h"
 #include "util/compatibility.h"
 
 // In practice we process stats pipes about once a minute @1ms latency.
@@ -70,95 +67,6 @@ StatsManager::~StatsManager() {
         }
     }
     qDebug() << "=====================================";
-
-    if (CmdlineArgs::Instance().getTimelineEnabled()) {
-        writeTimeline(CmdlineArgs::Instance().getTimelinePath());
-    }
-}
-
-class OrderByTime {
-  public:
-    inline bool operator()(const Event& e1, const Event& e2) {
-        return e1.m_time < e2.m_time;
-    }
-};
-
-QString humanizeNanos(qint64 nanos) {
-    double seconds = static_cast<double>(nanos) / 1e9;
-    if (seconds > 1) {
-        return QString("%1s").arg(QString::number(seconds));
-    }
-
-    double millis = static_cast<double>(nanos) / 1e6;
-    if (millis > 1) {
-        return QString("%1ms").arg(QString::number(millis));
-    }
-
-    double micros = static_cast<double>(nanos) / 1e3;
-    if (micros > 1) {
-        return QString("%1us").arg(QString::number(micros));
-    }
-
-    return QString("%1ns").arg(QString::number(nanos));
-}
-
-void StatsManager::writeTimeline(const QString& filename) {
-    QFile timeline(filename);
-    if (!timeline.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Could not open timeline file for writing:"
-                 << timeline.fileName();
-        return;
-    }
-
-    if (m_events.isEmpty()) {
-        qDebug() << "No events recorded.";
-        return;
-    }
-
-    // Sort by time.
-    std::sort(m_events.begin(), m_events.end(), OrderByTime());
-
-    mixxx::Duration last_time = m_events[0].m_time;
-
-    QMap<QString, qint64> startTimes;
-    QMap<QString, qint64> endTimes;
-
-    QTextStream out(&timeline);
-    foreach (const Event& event, m_events) {
-        qint64 last_start = startTimes.value(event.m_tag, -1);
-        qint64 last_end = endTimes.value(event.m_tag, -1);
-
-        qint64 duration_since_last_start = last_start == -1 ? 0 :
-                event.m_time.toIntegerNanos() - last_start;
-        qint64 duration_since_last_end = last_end == -1 ? 0 :
-                event.m_time.toIntegerNanos() - last_end;
-
-        if (event.m_type == Stat::EVENT_START) {
-            // We last saw a start and we just saw another start.
-            if (last_start > last_end) {
-                qDebug() << "Mismatched start/end pair" << event.m_tag;
-            }
-            startTimes[event.m_tag] = event.m_time.toIntegerNanos();
-        } else if (event.m_type == Stat::EVENT_END) {
-            // We last saw an end and we just saw another end.
-            if (last_end > last_start) {
-                qDebug() << "Mismatched start/end pair" << event.m_tag;
-            }
-            endTimes[event.m_tag] = event.m_time.toIntegerNanos();
-        }
-
-        // TODO(rryan): CSV escaping
-        qint64 elapsed = (event.m_time - last_time).toIntegerNanos();
-        out << event.m_time.toIntegerNanos() << ","
-            << "+" << humanizeNanos(elapsed) << ","
-            << "+" << humanizeNanos(duration_since_last_start) << ","
-            << "+" << humanizeNanos(duration_since_last_end) << ","
-            << Stat::statTypeToString(event.m_type) << ","
-            << event.m_tag << "\n";
-        last_time = event.m_time;
-    }
-
-    timeline.close();
 }
 
 void StatsManager::onStatsPipeDestroyed(StatsPipe* pPipe) {
@@ -221,17 +129,6 @@ void StatsManager::processIncomingStatReports() {
                 base.m_compute = report.compute;
                 base.processReport(report);
             }
-
-            if (CmdlineArgs::Instance().getTimelineEnabled() &&
-                    (report.type == Stat::EVENT ||
-                     report.type == Stat::EVENT_START ||
-                     report.type == Stat::EVENT_END)) {
-                Event event;
-                event.m_tag = tag;
-                event.m_type = report.type;
-                event.m_time = mixxx::Duration::fromNanos(report.time);
-                m_events.append(event);
-            }
         }
     }
 }
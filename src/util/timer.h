@@ -9,6 +9,7 @@
 #include "util/parented_ptr.h"
 #include "util/performancetimer.h"
 #include "util/stat.h"
+#include "util/tracing.h"
 
 const Stat::ComputeFlags kDefaultComputeFlags = Stat::COUNT | Stat::SUM | Stat::AVERAGE |
         Stat::MAX | Stat::MIN | Stat::SAMPLE_VARIANCE;
@@ -55,7 +56,8 @@ class ScopedTimer {
   public:
     ScopedTimer(const char* key, int i,
                 Stat::ComputeFlags compute = kDefaultComputeFlags)
-            : m_pTimer(NULL),
+            : m_trace(key, i),
+              m_pTimer(NULL),
               m_cancel(false) {
         if (CmdlineArgs::Instance().getDeveloper()) {
             initialize(QString(key), QString::number(i), compute);
@@ -64,7 +66,8 @@ class ScopedTimer {
 
     ScopedTimer(const char* key, const char *arg = NULL,
                 Stat::ComputeFlags compute = kDefaultComputeFlags)
-            : m_pTimer(NULL),
+            : m_trace(key),
+              m_pTimer(NULL),
               m_cancel(false) {
         if (CmdlineArgs::Instance().getDeveloper()) {
             initialize(QString(key), arg ? QString(arg) : QString(), compute);
@@ -73,7 +76,8 @@ class ScopedTimer {
 
     ScopedTimer(const char* key, const QString& arg,
                 Stat::ComputeFlags compute = kDefaultComputeFlags)
-            : m_pTimer(NULL),
+            : m_trace(key),
+              m_pTimer(NULL),
               m_cancel(false) {
         if (CmdlineArgs::Instance().getDeveloper()) {
             initialize(QString(key), arg, compute);
@@ -105,6 +109,9 @@ class ScopedTimer {
         m_cancel = true;
     }
   private:
+    // Recorded independent of developer mode without formatting the key,
+    // which must be a string literal.
+    mixxx::ScopedTrace m_trace;
     Timer* m_pTimer;
     char m_timerMem[sizeof(Timer)];
     bool m_cancel;
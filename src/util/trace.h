@@ -9,12 +9,14 @@
 #include "util/event.h"
 #include "util/performancetimer.h"
 #include "util/stat.h"
+#include "util/tracing.h"
 
 class Trace {
   public:
     Trace(const char* tag, const char* arg=NULL,
           bool writeToStdout=false, bool time=true)
-            : m_writeToStdout(writeToStdout),
+            : m_trace(tag),
+              m_writeToStdout(writeToStdout),
               m_time(time) {
         if (writeToStdout || CmdlineArgs::Instance().getDeveloper()) {
             initialize(tag, arg);
@@ -23,7 +25,8 @@ class Trace {
 
     Trace(const char* tag, int arg,
           bool writeToStdout=false, bool time=true)
-            : m_writeToStdout(writeToStdout),
+            : m_trace(tag, arg),
+              m_writeToStdout(writeToStdout),
               m_time(time) {
         if (writeToStdout || CmdlineArgs::Instance().getDeveloper()) {
             initialize(tag, QString::number(arg));
@@ -32,7 +35,8 @@ class Trace {
 
     Trace(const char* tag, const QString& arg,
           bool writeToStdout=false, bool time=true)
-            : m_writeToStdout(writeToStdout),
+            : m_trace(tag),
+              m_writeToStdout(writeToStdout),
               m_time(time) {
         if (writeToStdout || CmdlineArgs::Instance().getDeveloper()) {
             initialize(tag, arg);
@@ -86,6 +90,9 @@ class Trace {
         }
     }
 
+    // Recorded independent of developer mode without formatting the tag,
+    // which must be a string literal.
+    mixxx::ScopedTrace m_trace;
     QString m_tag;
     const bool m_writeToStdout, m_time;
     PerformanceTimer m_timer;
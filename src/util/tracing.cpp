@@ -0,0 +1,256 @@
+#include "util/tracing.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "util/logger.h"
+#include "util/time.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("Tracing");
+
+// All events belong to the same process
+const int kProcessId = 1;
+
+// The phase of an event as defined by the trace event format
+enum class Phase : char {
+    Complete = 'X',
+    Instant = 'i',
+    Counter = 'C',
+};
+
+struct TraceEvent {
+    const char* name;
+    qint64 timestampNanos;
+    qint64 durationNanos;
+    qint64 arg;
+    Phase phase;
+};
+
+// A ring buffer with a single writer that keeps the most recent events.
+// Readers copy the events without blocking the writer and discard the
+// events that have been overwritten while copying.
+class ThreadBuffer {
+  public:
+    ThreadBuffer(int threadId, const QString& threadName)
+            : m_threadId(threadId),
+              m_threadName(threadName),
+              m_events(Tracing::kEventsPerThread),
+              m_writePos(0) {
+    }
+
+    int threadId() const {
+        return m_threadId;
+    }
+    const QString& threadName() const {
+        return m_threadName;
+    }
+
+    void append(const TraceEvent& event) {
+        const quint64 writePos = m_writePos.load(std::memory_order_relaxed);
+        m_events[writePos & kIndexMask] = event;
+        m_writePos.store(writePos + 1, std::memory_order_release);
+    }
+
+    void copyEvents(std::vector<TraceEvent>* pEvents) const {
+        const quint64 endPos = m_writePos.load(std::memory_order_acquire);
+        const quint64 beginPos = firstValidPos(endPos);
+        const auto firstIndex = pEvents->size();
+        for (quint64 pos = beginPos; pos < endPos; ++pos) {
+            pEvents->push_back(m_events[pos & kIndexMask]);
+        }
+        // The writer might have overwritten the oldest events meanwhile,
+        // including the slot of the event that it is currently writing
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const quint64 validPos = firstValidPos(m_writePos.load(std::memory_order_relaxed) + 1);
+        if (validPos > beginPos) {
+            const auto invalidCount = std::min<quint64>(validPos - beginPos, endPos - beginPos);
+            pEvents->erase(pEvents->begin() + firstIndex,
+                    pEvents->begin() + firstIndex + invalidCount);
+        }
+    }
+
+    void clear() {
+        m_writePos.store(0, std::memory_order_release);
+    }
+
+  private:
+    static constexpr quint64 kIndexMask = Tracing::kEventsPerThread - 1;
+
+    static quint64 firstValidPos(quint64 endPos) {
+        return endPos > static_cast<quint64>(Tracing::kEventsPerThread)
+                ? endPos - Tracing::kEventsPerThread
+                : 0;
+    }
+
+    const int m_threadId;
+    const QString m_threadName;
+    std::vector<TraceEvent> m_events;
+    std::atomic<quint64> m_writePos;
+};
+
+static_assert((Tracing::kEventsPerThread & (Tracing::kEventsPerThread - 1)) == 0,
+        "The number of events per thread must be a power of 2");
+
+// The buffers are never deleted, because the events of a thread that has
+// finished are still needed for writing the trace.
+QMutex s_threadBuffersMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> s_threadBuffers;
+
+thread_local ThreadBuffer* t_pThreadBuffer = nullptr;
+
+ThreadBuffer* threadBuffer() {
+    if (t_pThreadBuffer) {
+        return t_pThreadBuffer;
+    }
+    QMutexLocker locker(&s_threadBuffersMutex);
+    const int threadId = static_cast<int>(s_threadBuffers.size()) + 1;
+    QString threadName = QThread::currentThread()->objectName();
+    if (threadName.isEmpty()) {
+        threadName = QStringLiteral("Thread %1").arg(threadId);
+    }
+    s_threadBuffers.push_back(std::make_unique<ThreadBuffer>(threadId, threadName));
+    t_pThreadBuffer = s_threadBuffers.back().get();
+    return t_pThreadBuffer;
+}
+
+void record(const char* name, Phase phase, qint64 timestampNanos, qint64 durationNanos, qint64 arg) {
+    if (!Tracing::isEnabled()) {
+        return;
+    }
+    threadBuffer()->append(TraceEvent{name, timestampNanos, durationNanos, arg, phase});
+}
+
+double toMicros(qint64 nanos) {
+    return static_cast<double>(nanos) / 1000.0;
+}
+
+QJsonObject threadNameEvent(const ThreadBuffer& buffer) {
+    QJsonObject event;
+    event.insert(QStringLiteral("name"), QStringLiteral("thread_name"));
+    event.insert(QStringLiteral("ph"), QStringLiteral("M"));
+    event.insert(QStringLiteral("pid"), kProcessId);
+    event.insert(QStringLiteral("tid"), buffer.threadId());
+    event.insert(QStringLiteral("args"),
+            QJsonObject{{QStringLiteral("name"), buffer.threadName()}});
+    return event;
+}
+
+QJsonObject traceEvent(const TraceEvent& traceEvent, int threadId) {
+    QJsonObject event;
+    event.insert(QStringLiteral("name"), QString::fromUtf8(traceEvent.name));
+    event.insert(QStringLiteral("ph"), QString(QChar(static_cast<char>(traceEvent.phase))));
+    event.insert(QStringLiteral("ts"), toMicros(traceEvent.timestampNanos));
+    event.insert(QStringLiteral("pid"), kProcessId);
+    event.insert(QStringLiteral("tid"), threadId);
+    switch (traceEvent.phase) {
+    case Phase::Complete:
+        event.insert(QStringLiteral("dur"), toMicros(traceEvent.durationNanos));
+        break;
+    case Phase::Instant:
+        // Only spans the thread and not the whole process
+        event.insert(QStringLiteral("s"), QStringLiteral("t"));
+        break;
+    case Phase::Counter:
+        break;
+    }
+    if (traceEvent.arg != Tracing::kNoArg) {
+        const QString argName = traceEvent.phase == Phase::Counter
+                ? QStringLiteral("value")
+                : QStringLiteral("arg");
+        event.insert(QStringLiteral("args"),
+                QJsonObject{{argName, static_cast<double>(traceEvent.arg)}});
+    }
+    return event;
+}
+
+} // anonymous namespace
+
+// static
+std::atomic<bool> Tracing::s_enabled(false);
+
+// static
+qint64 Tracing::now() {
+    return Time::elapsed().toIntegerNanos();
+}
+
+// static
+void Tracing::complete(const char* name,
+        qint64 startNanos,
+        qint64 durationNanos,
+        qint64 arg) {
+    record(name, Phase::Complete, startNanos, durationNanos, arg);
+}
+
+// static
+void Tracing::instant(const char* name, qint64 arg) {
+    record(name, Phase::Instant, now(), 0, arg);
+}
+
+// static
+void Tracing::counter(const char* name, qint64 value) {
+    record(name, Phase::Counter, now(), 0, value);
+}
+
+// static
+bool Tracing::writeChromeTrace(QIODevice* pDevice) {
+    QJsonArray events;
+    std::vector<TraceEvent> threadEvents;
+    threadEvents.reserve(kEventsPerThread);
+    {
+        QMutexLocker locker(&s_threadBuffersMutex);
+        for (const auto& pBuffer : s_threadBuffers) {
+            threadEvents.clear();
+            pBuffer->copyEvents(&threadEvents);
+            if (threadEvents.empty()) {
+                continue;
+            }
+            events.append(threadNameEvent(*pBuffer));
+            for (const auto& event : threadEvents) {
+                events.append(traceEvent(event, pBuffer->threadId()));
+            }
+        }
+    }
+
+    QJsonObject trace;
+    trace.insert(QStringLiteral("traceEvents"), events);
+    trace.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ns"));
+    const QByteArray json = QJsonDocument(trace).toJson(QJsonDocument::Compact);
+    if (pDevice->write(json) != json.size()) {
+        kLogger.warning() << "Failed to write trace:" << pDevice->errorString();
+        return false;
+    }
+    return true;
+}
+
+// static
+bool Tracing::writeChromeTrace(const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        kLogger.warning() << "Failed to open trace file for writing:" << fileName;
+        return false;
+    }
+    kLogger.info() << "Writing trace to" << fileName;
+    return writeChromeTrace(&file);
+}
+
+// static
+void Tracing::clear() {
+    QMutexLocker locker(&s_threadBuffersMutex);
+    for (const auto& pBuffer : s_threadBuffers) {
+        pBuffer->clear();
+    }
+}
+
+} // namespace mixxx
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <limits>
+
+#include "util/class.h"
+
+class QIODevice;
+
+namespace mixxx {
+
+// Low overhead tracing of the internal processing that is exported in the
+// Chrome trace event format. The resulting JSON file can be opened with
+// chrome://tracing or https://ui.perfetto.dev.
+//
+// Events are identified by a name with static storage duration, usually a
+// string literal, that is only referenced and never copied. Each thread
+// records fixed-size events into its own lock-free ring buffer that keeps
+// the most recent kEventsPerThread events, so recording an event neither
+// allocates nor locks. Only the first event of each thread allocates the
+// buffer of the thread. While tracing is disabled, recording costs a single
+// relaxed atomic load.
+class Tracing {
+  public:
+    // Marks events without an argument
+    static constexpr qint64 kNoArg = std::numeric_limits<qint64>::min();
+    // Must be a power of 2
+    static constexpr int kEventsPerThread = 8192;
+
+    static void setEnabled(bool enabled) {
+        s_enabled.store(enabled, std::memory_order_relaxed);
+    }
+    static bool isEnabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    // The timestamp of events in nanoseconds since Mixxx started
+    static qint64 now();
+
+    // Records an event with a duration. The name must have static storage
+    // duration.
+    static void complete(const char* name,
+            qint64 startNanos,
+            qint64 durationNanos,
+            qint64 arg = kNoArg);
+    // Records an event without a duration. The name must have static storage
+    // duration.
+    static void instant(const char* name, qint64 arg = kNoArg);
+    // Records the value of a counter. The name must have static storage
+    // duration.
+    static void counter(const char* name, qint64 value);
+
+    // Writes the events that have been recorded by all threads. Can be
+    // invoked while other threads are recording events.
+    static bool writeChromeTrace(QIODevice* pDevice);
+    static bool writeChromeTrace(const QString& fileName);
+
+    // Discards all events that have been recorded so far. Must not be
+    // invoked while other threads are recording events.
+    static void clear();
+
+  private:
+    static std::atomic<bool> s_enabled;
+};
+
+// Records the execution of the enclosing scope as a single event
+class ScopedTrace {
+  public:
+    // The name must have static storage duration, usually a string literal
+    explicit ScopedTrace(const char* name, qint64 arg = Tracing::kNoArg)
+            : m_name(Tracing::isEnabled() ? name : nullptr),
+              m_arg(arg),
+              m_startNanos(m_name ? Tracing::now() : 0) {
+    }
+    ~ScopedTrace() {
+        if (m_name) {
+            Tracing::complete(m_name, m_startNanos, Tracing::now() - m_startNanos, m_arg);
+        }
+    }
+
+  private:
+    const char* const m_name;
+    const qint64 m_arg;
+    const qint64 m_startNanos;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedTrace);
+};
+
+} // namespace mixxx
@@ -1,6 +1,7 @@
 #include <QTimer>
 
 #include "waveform/guitick.h"
+#include "control/controlchangebatcher.h"
 #include "control/controlobject.h"
 
 GuiTick::GuiTick() {
@@ -20,4 +21,8 @@ void GuiTick::process() {
         m_lastUpdateTime = m_cpuTimeLastTick;
         m_pCOGuiTick50ms->set(cpuTimeLastTickSeconds);
     }
+
+    // Deliver the latest values of all controls with coalesced
+    // change notifications that have changed since the last tick
+    ControlChangeBatcher::notifySubscribers();
 }
@@ -4,6 +4,7 @@
 #include <QGLFramebufferObject>
 
 #include "track/track.h"
+#include "util/math.h"
 #include "waveform/renderers/waveformwidgetrenderer.h"
 #include "waveform/waveform.h"
 #include "waveform/waveformwidgetfactory.h"
@@ -13,6 +14,8 @@ GLSLWaveformRendererSignal::GLSLWaveformRendererSignal(WaveformWidgetRenderer* w
         : WaveformRendererSignalBase(waveformWidgetRenderer),
           m_unitQuadListId(-1),
           m_textureId(0),
+          m_textureWidth(0),
+          m_textureHeight(0),
           m_textureRenderedWaveformCompletion(0),
           m_bDumpPng(false),
           m_shadersValid(false),
@@ -125,9 +128,13 @@ bool GLSLWaveformRendererSignal::loadTexture() {
         if (error) {
             qDebug() << "GLSLWaveformRendererSignal::loadTexture - glTexImage2D error" << error;
         }
+        m_textureWidth = textureWidth;
+        m_textureHeight = textureHeight;
     } else {
         glDeleteTextures(1, &m_textureId);
         m_textureId = 0;
+        m_textureWidth = 0;
+        m_textureHeight = 0;
     }
 
     glDisable(GL_TEXTURE_2D);
@@ -135,6 +142,41 @@ bool GLSLWaveformRendererSignal::loadTexture() {
     return true;
 }
 
+void GLSLWaveformRendererSignal::updateTexture(int firstIndex, int lastIndex) {
+    TrackPointer trackInfo = m_waveformRenderer->getTrackInfo();
+    ConstWaveformPointer waveform = trackInfo ? trackInfo->getWaveform() : ConstWaveformPointer();
+    if (!waveform || waveform->getDataSize() <= 1 || !waveform->data()) {
+        return;
+    }
+    const int textureWidth = waveform->getTextureStride();
+    const int textureHeight = waveform->getTextureSize() / textureWidth;
+    if (m_textureId == 0 ||
+            textureWidth != m_textureWidth ||
+            textureHeight != m_textureHeight) {
+        // The texture needs to be reallocated
+        loadTexture();
+        return;
+    }
+
+    // The last row might have been uploaded partially before
+    const int firstRow = math_max(firstIndex, 0) / textureWidth;
+    const int lastRow = math_min(
+            (lastIndex + textureWidth - 1) / textureWidth, textureHeight);
+    if (firstRow >= lastRow) {
+        return;
+    }
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, m_textureId);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, textureWidth, lastRow - firstRow,
+            GL_RGBA, GL_UNSIGNED_BYTE, waveform->data() + firstRow * textureWidth);
+    int error = glGetError();
+    if (error) {
+        qDebug() << "GLSLWaveformRendererSignal::updateTexture - glTexSubImage2D error" << error;
+    }
+    glDisable(GL_TEXTURE_2D);
+}
+
 void GLSLWaveformRendererSignal::createGeometry() {
 
     if (m_unitQuadListId != -1) {
@@ -278,7 +320,9 @@ void GLSLWaveformRendererSignal::draw(QPainter* painter, QPaintEvent* /*event*/)
     // do not remove currenCompletion temp variable !
     const int currentCompletion = waveform->getCompletion();
     if (m_textureRenderedWaveformCompletion < currentCompletion) {
-        loadTexture();
+        // Only upload the data that has been analyzed since the last
+        // frame instead of the whole texture
+        updateTexture(m_textureRenderedWaveformCompletion, currentCompletion);
         m_textureRenderedWaveformCompletion = currentCompletion;
     }
 
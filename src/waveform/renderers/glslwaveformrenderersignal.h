@@ -30,6 +30,9 @@ class GLSLWaveformRendererSignal: public QObject,
     void debugClick();
     bool loadShaders();
     bool loadTexture();
+    // Uploads only the texture rows that contain the waveform data in
+    // the range [firstIndex, lastIndex) into the existing texture.
+    void updateTexture(int firstIndex, int lastIndex);
 
   public slots:
     void slotWaveformUpdated();
@@ -40,6 +43,9 @@ class GLSLWaveformRendererSignal: public QObject,
 
     GLint m_unitQuadListId;
     GLuint m_textureId;
+    // The dimensions of the allocated texture
+    int m_textureWidth;
+    int m_textureHeight;
 
     TrackPointer m_loadedTrack;
     int m_textureRenderedWaveformCompletion;
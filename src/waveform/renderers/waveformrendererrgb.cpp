@@ -82,6 +82,13 @@ void WaveformRendererRGB::draw(QPainter* painter,
     painter->setPen(m_pColors->getAxesColor());
     painter->drawLine(QLineF(0, halfBreadth, m_waveformRenderer->getLength(), halfBreadth));
 
+    // When zoomed out, read the pre-aggregated peaks instead of scanning
+    // all visual frames that are covered by each pixel.
+    const int level = waveform->findLevel(gain / 2.0);
+    const WaveformData* levelData = level < 0 ? data : waveform->levelData(level);
+    const int levelDataSize = level < 0 ? dataSize : waveform->getLevelDataSize(level);
+    const int levelFrames = level < 0 ? 1 : Waveform::getLevelFrames(level);
+
     for (int x = 0; x < m_waveformRenderer->getLength(); ++x) {
         // Width of the x position in visual indices.
         const double xSampleWidth = gain * x;
@@ -110,8 +117,8 @@ void WaveformRendererRGB::draw(QPainter* painter,
         visualFrameStart = math_clamp(visualFrameStart, 0, lastVisualFrame);
         visualFrameStop = math_clamp(visualFrameStop, 0, lastVisualFrame);
 
-        int visualIndexStart = visualFrameStart * 2;
-        int visualIndexStop  = visualFrameStop * 2;
+        int visualIndexStart = (visualFrameStart / levelFrames) * 2;
+        int visualIndexStop  = (visualFrameStop / levelFrames) * 2;
 
         unsigned char maxLow  = 0;
         unsigned char maxMid  = 0;
@@ -120,9 +127,9 @@ void WaveformRendererRGB::draw(QPainter* painter,
         float maxAllNext = 0.;
 
         for (int i = visualIndexStart;
-             i >= 0 && i + 1 < dataSize && i + 1 <= visualIndexStop; i += 2) {
-            const WaveformData& waveformData = data[i];
-            const WaveformData& waveformDataNext = data[i + 1];
+             i >= 0 && i + 1 < levelDataSize && i + 1 <= visualIndexStop; i += 2) {
+            const WaveformData& waveformData = levelData[i];
+            const WaveformData& waveformDataNext = levelData[i + 1];
 
             maxLow  = math_max3(maxLow,  waveformData.filtered.low,  waveformDataNext.filtered.low);
             maxMid  = math_max3(maxMid,  waveformData.filtered.mid,  waveformDataNext.filtered.mid);
@@ -2,11 +2,63 @@
 
 #include "waveform/waveform.h"
 #include "proto/waveform.pb.h"
+#include "util/math.h"
 
 using namespace mixxx::track;
 
 const int kNumChannels = 2;
 
+namespace {
+
+// Coarser levels with less values per channel are not worth it
+const int kMinLevelValues = 2;
+
+WaveformData maxWaveformData(const WaveformData& lhs, const WaveformData& rhs) {
+    WaveformData result;
+    result.filtered.low = math_max(lhs.filtered.low, rhs.filtered.low);
+    result.filtered.mid = math_max(lhs.filtered.mid, rhs.filtered.mid);
+    result.filtered.high = math_max(lhs.filtered.high, rhs.filtered.high);
+    result.filtered.all = math_max(lhs.filtered.all, rhs.filtered.all);
+    return result;
+}
+
+void writeLevel(const std::vector<WaveformData>& data, int framesPerValue,
+        io::Waveform::Level* level) {
+    level->set_frames_per_value(framesPerValue);
+    io::Waveform::Signal* all = level->mutable_signal_all();
+    io::Waveform::Signal* low = level->mutable_signal_filtered()->mutable_low();
+    io::Waveform::Signal* mid = level->mutable_signal_filtered()->mutable_mid();
+    io::Waveform::Signal* high = level->mutable_signal_filtered()->mutable_high();
+    for (const auto& datum : data) {
+        all->add_value(datum.filtered.all);
+        low->add_value(datum.filtered.low);
+        mid->add_value(datum.filtered.mid);
+        high->add_value(datum.filtered.high);
+    }
+}
+
+bool readLevel(const io::Waveform::Level& level, int framesPerValue,
+        std::vector<WaveformData>* pData) {
+    const int size = static_cast<int>(pData->size());
+    if (level.frames_per_value() != framesPerValue ||
+            level.signal_all().value_size() != size ||
+            level.signal_filtered().low().value_size() != size ||
+            level.signal_filtered().mid().value_size() != size ||
+            level.signal_filtered().high().value_size() != size) {
+        return false;
+    }
+    for (int i = 0; i < size; ++i) {
+        WaveformData& datum = (*pData)[i];
+        datum.filtered.all = static_cast<unsigned char>(level.signal_all().value(i));
+        datum.filtered.low = static_cast<unsigned char>(level.signal_filtered().low().value(i));
+        datum.filtered.mid = static_cast<unsigned char>(level.signal_filtered().mid().value(i));
+        datum.filtered.high = static_cast<unsigned char>(level.signal_filtered().high().value(i));
+    }
+    return true;
+}
+
+} // anonymous namespace
+
 // Return the smallest power of 2 which is greater than the desired size when
 // squared.
 int computeTextureStride(int size) {
@@ -115,6 +167,10 @@ QByteArray Waveform::toByteArray() const {
         high->add_value(datum.filtered.high);
     }
 
+    for (int level = 0; level < getLevelCount(); ++level) {
+        writeLevel(m_levels[level], getLevelFrames(level), waveform.add_levels());
+    }
+
     qDebug() << "Writing waveform from byte array:"
              << "dataSize" << dataSize
              << "allSignalSize" << all->value_size()
@@ -193,6 +249,15 @@ void Waveform::readByteArray(const QByteArray& data) {
         m_data[i].filtered.mid = use_mid ? static_cast<unsigned char>(mid.value(i)) : 0;
         m_data[i].filtered.high = use_high ? static_cast<unsigned char>(high.value(i)) : 0;
     }
+
+    bool levelsValid = waveform.levels_size() == getLevelCount();
+    for (int level = 0; levelsValid && level < getLevelCount(); ++level) {
+        levelsValid = readLevel(waveform.levels(level), getLevelFrames(level), &m_levels[level]);
+    }
+    if (!levelsValid) {
+        // Stored by a previous version
+        updateLevels(0, dataSize);
+    }
     m_completion = dataSize;
     m_saveState = SaveState::Saved;
 }
@@ -201,15 +266,68 @@ void Waveform::resize(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.resize(m_textureStride * m_textureStride);
+    allocateLevels();
 }
 
 void Waveform::assign(int size, int value) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.assign(m_textureStride * m_textureStride, value);
+    allocateLevels();
     m_saveState = SaveState::SavePending;
 }
 
+void Waveform::allocateLevels() {
+    m_levels.clear();
+    const int frames = m_dataSize / kNumChannels;
+    for (int level = 0; frames / getLevelFrames(level) >= kMinLevelValues; ++level) {
+        const int levelFrames = getLevelFrames(level);
+        const int values = (frames + levelFrames - 1) / levelFrames;
+        m_levels.emplace_back(values * kNumChannels, WaveformData(0));
+    }
+}
+
+int Waveform::findLevel(double visualFramesPerPixel) const {
+    int result = -1;
+    for (int level = 0; level < getLevelCount(); ++level) {
+        if (getLevelFrames(level) > visualFramesPerPixel) {
+            break;
+        }
+        result = level;
+    }
+    return result;
+}
+
+void Waveform::updateLevels(int firstIndex, int lastIndex) {
+    if (firstIndex >= lastIndex) {
+        return;
+    }
+    // Each level is derived from the next finer one. Only the values
+    // that cover the modified range are updated.
+    int firstFrame = math_max(firstIndex, 0) / kNumChannels;
+    int lastFrame = (math_min(lastIndex, m_dataSize) + kNumChannels - 1) / kNumChannels;
+    const std::vector<WaveformData>* pSource = &m_data;
+    int sourceFrames = m_dataSize / kNumChannels;
+    for (auto& levelData : m_levels) {
+        const int frames = static_cast<int>(levelData.size()) / kNumChannels;
+        firstFrame /= 2;
+        lastFrame = math_min((lastFrame + 1) / 2, frames);
+        for (int frame = firstFrame; frame < lastFrame; ++frame) {
+            for (int channel = 0; channel < kNumChannels; ++channel) {
+                const int sourceFrame = frame * 2;
+                WaveformData value = (*pSource)[sourceFrame * kNumChannels + channel];
+                if (sourceFrame + 1 < sourceFrames) {
+                    value = maxWaveformData(value,
+                            (*pSource)[(sourceFrame + 1) * kNumChannels + channel]);
+                }
+                levelData[frame * kNumChannels + channel] = value;
+            }
+        }
+        pSource = &levelData;
+        sourceFrames = frames;
+    }
+}
+
 void Waveform::dump() const {
     qDebug() << "Waveform" << this
              << "size("+QString::number(getDataSize())+")"
@@ -133,12 +133,38 @@ class Waveform {
     // constructor runs.
     const WaveformData* data() const { return &m_data[0];}
 
+    // The waveform data is also kept as a pyramid of pre-aggregated peaks
+    // for wide zoom levels. Each value of level n contains the maximum
+    // of getLevelFrames(n) consecutive visual frames, interleaved by
+    // channel like the waveform data itself.
+    static int getLevelFrames(int level) {
+        return 2 << level;
+    }
+    int getLevelCount() const {
+        return static_cast<int>(m_levels.size());
+    }
+    int getLevelDataSize(int level) const {
+        return static_cast<int>(m_levels[level].size());
+    }
+    const WaveformData* levelData(int level) const {
+        return m_levels[level].data();
+    }
+    // Returns the coarsest level that doesn't aggregate more visual
+    // frames than visualFramesPerPixel or -1 if the waveform data itself
+    // needs to be used.
+    int findLevel(double visualFramesPerPixel) const;
+
+    // Updates the pyramid after the waveform data in the range
+    // [firstIndex, lastIndex) has been modified.
+    void updateLevels(int firstIndex, int lastIndex);
+
     void dump() const;
 
   private:
     void readByteArray(const QByteArray& data);
     void resize(int size);
     void assign(int size, int value = 0);
+    void allocateLevels();
 
     inline WaveformData& at(int i) { return m_data[i];}
     inline unsigned char& low(int i) { return m_data[i].filtered.low;}
@@ -165,6 +191,9 @@ class Waveform {
     // TODO(XXX): In the future we should switch to QVector and use the raw data
     // pointer when performance matters.
     std::vector<WaveformData> m_data;
+    // The pyramid of pre-aggregated peaks. Allocated together with m_data
+    // and not resized afterwards.
+    std::vector<std::vector<WaveformData>> m_levels;
     // Not allowed to change after the constructor runs.
     double m_visualSampleRate;
     // Not allowed to change after the constructor runs.
@@ -14,7 +14,13 @@ ControlWidgetConnection::ControlWidgetConnection(
         : m_pWidget(pBaseWidget),
           m_pValueTransformer(pTransformer) {
     m_pControl = new ControlProxy(key, this, ControlFlag::NoAssertIfMissing);
-    m_pControl->connectValueChanged(this, &ControlWidgetConnection::slotControlValueChanged);
+    if (pBaseWidget->coalesceControlUpdates()) {
+        m_pControl->connectValueChangedCoalesced(
+                this, &ControlWidgetConnection::slotControlValueChanged);
+    } else {
+        m_pControl->connectValueChanged(
+                this, &ControlWidgetConnection::slotControlValueChanged);
+    }
 }
 
 void ControlWidgetConnection::setControlParameter(double parameter) {
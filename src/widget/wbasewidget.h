@@ -61,6 +61,13 @@ class WBaseWidget {
         return m_leftConnections;
     };
 
+    // Widgets that only display controls which are changed frequently by
+    // the engine can opt in to receive the latest value of their connected
+    // controls once per GuiTick instead of every single change.
+    virtual bool coalesceControlUpdates() const {
+        return false;
+    }
+
 
   protected:
     // Whenever a connected control is changed, onConnectedControlChanged is
@@ -97,6 +97,7 @@ void WLibraryTableView::moveSelection(int delta) {
         if(delta > 0) {
             // i is positive, so we want to move the highlight down
             int row = current.row();
+            fetchRowsUntil(row + 1);
             if (row + 1 < pModel->rowCount()) {
                 selectRow(row + 1);
             }
@@ -114,6 +115,31 @@ void WLibraryTableView::moveSelection(int delta) {
     }
 }
 
+void WLibraryTableView::selectAll() {
+    fetchAllRows();
+    QTableView::selectAll();
+}
+
+void WLibraryTableView::fetchRowsUntil(int row) {
+    QAbstractItemModel* pModel = model();
+    if (!pModel) {
+        return;
+    }
+    while (row >= pModel->rowCount() && pModel->canFetchMore(QModelIndex())) {
+        pModel->fetchMore(QModelIndex());
+    }
+}
+
+void WLibraryTableView::fetchAllRows() {
+    QAbstractItemModel* pModel = model();
+    if (!pModel) {
+        return;
+    }
+    while (pModel->canFetchMore(QModelIndex())) {
+        pModel->fetchMore(QModelIndex());
+    }
+}
+
 void WLibraryTableView::saveVScrollBarPos(TrackModel* key){
     m_vScrollBarPosValues[key] = verticalScrollBar()->value();
 }
@@ -46,6 +46,10 @@ class WLibraryTableView : public QTableView, public virtual LibraryView {
     void scrollValueChanged(int);
 
   public slots:
+    // Selects all rows, including those that the model
+    // has not published yet
+    void selectAll() override;
+
     void setTrackTableFont(const QFont& font);
     void setTrackTableRowHeight(int rowHeight);
     void setSelectedClick(bool enable);
@@ -53,6 +57,11 @@ class WLibraryTableView : public QTableView, public virtual LibraryView {
   protected:
     void focusInEvent(QFocusEvent* event) override;
 
+    // Fetches more rows from the model until the given row becomes
+    // available. Track models might not have published all rows yet.
+    void fetchRowsUntil(int row);
+    void fetchAllRows();
+
     void saveNoSearchVScrollBarPos();
     void restoreNoSearchVScrollBarPos();
 
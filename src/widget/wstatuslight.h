@@ -38,6 +38,12 @@ class WStatusLight : public WWidget  {
 
     void setup(const QDomNode& node, const SkinContext& context);
 
+    // Status lights mostly display frequently changing indicators
+    // like beat_active
+    bool coalesceControlUpdates() const override {
+        return true;
+    }
+
   public slots:
     void onConnectedControlChanged(double dParameter, double dValue) override;
 
@@ -621,6 +621,9 @@ void WTrackTableView::dropEvent(QDropEvent * event) {
         }
 
         // Destination row, if destIndex is invalid we set it to last row + 1
+        if (destIndex.row() < 0) {
+            fetchAllRows();
+        }
         int destRow = destIndex.row() < 0 ? model()->rowCount() : destIndex.row();
 
         int selectedRowCount = selectedRows.count();
@@ -703,6 +706,9 @@ void WTrackTableView::dropEvent(QDropEvent * event) {
 
         // If the track was dropped into an empty playlist, start at row
         // 0 not -1 :)
+        if (destIndex.row() == -1) {
+            fetchAllRows();
+        }
         if ((destIndex.row() == -1) && (model()->rowCount() == 0)) {
             selectionStartRow = 0;
         } else if ((destIndex.row() == -1) && (model()->rowCount() > 0)) {
@@ -830,6 +836,7 @@ void WTrackTableView::setSelectedTracks(const QList<TrackId>& trackIds) {
         const auto gts = pTrackModel->getTrackRows(trackId);
 
         for (int trackRow : gts) {
+            fetchRowsUntil(trackRow);
             pSelectionModel->select(model()->index(trackRow, 0),
                     QItemSelectionModel::Select | QItemSelectionModel::Rows);
         }
@@ -912,6 +919,10 @@ void WTrackTableView::doSortByColumn(int headerSection, Qt::SortOrder sortOrder)
         }
     }
 
+    if (!selectedRows.isEmpty()) {
+        fetchRowsUntil(selectedRows.lastKey());
+    }
+
     // Select the first row of the previous selection.
     // This scrolls to that row and with the leftmost cell being focused we have
     // a starting point (currentIndex) for navigation with Up/Down keys.
@@ -46,6 +46,11 @@ class WVuMeter : public WWidget  {
             double scaleFactor);
     void onConnectedControlChanged(double dParameter, double dValue) override;
 
+    // The meter is repainted with the waveform frame rate anyway
+    bool coalesceControlUpdates() const override {
+        return true;
+    }
+
   public slots:
     void maybeUpdate();
 